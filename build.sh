@@ -24,6 +24,8 @@ print_usage()
   echo "       --nojobs     : Disables multi-processor build on unix"
   echo "       --noomp      : Disables openmp build"
   echo "       --nocmd      : Disables mm software building"
+  echo "       --nobench    : Disables mmbench benchmark building"
+  echo "       --noapi      : Disables mmapi shared library building"
   echo "";
   echo "    Examples:";
   echo "      $0 "; 
@@ -57,6 +59,8 @@ while [[ $# -gt 0 ]] ; do
     --nojobs      ) NUMBER_OF_PROCESSORS=1;;
     --noomp       ) CMAKE_FLAGS+=( "-DUSE_OPENMP=OFF" );;
     --nocmd       ) CMAKE_FLAGS+=( "-DMM_BUILD_CMD=OFF" );;
+    --nobench     ) CMAKE_FLAGS+=( "-DMM_BUILD_BENCH=OFF" );;
+    --noapi       ) CMAKE_FLAGS+=( "-DMM_BUILD_API=OFF" );;
     *             ) print_usage "unsupported arguments: $C ";;
   esac
   shift;
@@ -54,6 +54,8 @@
 #include <cmath>   // for abs()
 #include <cstdlib> // for abs()
 #include <limits>
+#include <list>
+#include <mutex>
 
 // Avoid conflicting declaration of min/max macros in windows headers
 #if !defined(NOMINMAX) && (defined(_WIN32) || defined(_WIN32_)  || defined(WIN32) || defined(_WIN64))
@@ -72,6 +74,11 @@ namespace nanoflann
   	/** Library version: 0xMmP (M=Major,m=minor,P=patch) */
 	#define NANOFLANN_VERSION 0x123
 
+	/** Minimum number of points of a subtree built as a separate OpenMP task by divideTree() */
+	#ifndef NANOFLANN_TASK_MIN_SIZE
+	#define NANOFLANN_TASK_MIN_SIZE 4096
+	#endif
+
 	/** @addtogroup result_sets_grp Result set classes
 	  *  @{ */
 	template <typename DistanceType, typename IndexType = size_t, typename CountType = size_t>
@@ -811,6 +818,10 @@ namespace nanoflann
 		 */
 		PooledAllocator pool;
 
+		/** Pools of the subtrees built as separate tasks, each task allocates its nodes from its own pool */
+		std::list<PooledAllocator> task_pools;
+		std::mutex task_pools_mutex;
+
 	public:
 
 		Distance distance;
@@ -848,6 +859,7 @@ namespace nanoflann
 		void freeIndex()
 		{
 			pool.free_all();
+			task_pools.clear();
 			root_node=NULL;
 			m_size_at_index_build = 0;
 		}
@@ -862,7 +874,7 @@ namespace nanoflann
 			m_size_at_index_build = m_size;
 			if(m_size == 0) return;
 			computeBoundingBox(root_bbox);
-			root_node = divideTree(0, m_size, root_bbox );   // construct the tree
+			root_node = divideTree(pool, 0, m_size, root_bbox );   // construct the tree
 		}
 
 		/** Returns number of points in dataset  */
@@ -879,7 +891,9 @@ namespace nanoflann
 		 */
 		size_t usedMemory() const
 		{
-			return pool.usedMemory+pool.wastedMemory+dataset.kdtree_get_point_count()*sizeof(IndexType);  // pool memory and vind array memory
+			size_t memory = pool.usedMemory+pool.wastedMemory+dataset.kdtree_get_point_count()*sizeof(IndexType);  // pool memory and vind array memory
+			for (const PooledAllocator& task_pool : task_pools) memory += task_pool.usedMemory+task_pool.wastedMemory;
+			return memory;
 		}
 
 		/** \name Query methods
@@ -1031,16 +1045,25 @@ namespace nanoflann
 		}
 
 
+		/** Adds the pool of a subtree built as a separate task, kept until freeIndex() */
+		PooledAllocator* newTaskPool()
+		{
+			std::lock_guard<std::mutex> lock(task_pools_mutex);
+			task_pools.emplace_back();
+			return &task_pools.back();
+		}
+
 		/**
 		 * Create a tree node that subdivides the list of vecs from vind[first]
 		 * to vind[last].  The routine is called recursively on each sublist.
 		 *
+		 * @param node_pool pool of the nodes, owned by the task building the subtree
 		 * @param left index of the first vector
 		 * @param right index of the last vector
 		 */
-		NodePtr divideTree(const IndexType left, const IndexType right, BoundingBox& bbox)
+		NodePtr divideTree(PooledAllocator& node_pool, const IndexType left, const IndexType right, BoundingBox& bbox)
 		{
-			NodePtr node = pool.allocate<Node>(); // allocate memory
+			NodePtr node = node_pool.allocate<Node>(); // allocate memory
 
 			/* If too few exemplars remain, then make this a leaf node. */
 			if ( (right-left) <= static_cast<IndexType>(m_leaf_max_size) ) {
@@ -1070,11 +1093,21 @@ namespace nanoflann
 
 				BoundingBox left_bbox(bbox);
 				left_bbox[cutfeat].high = cutval;
-				node->child1 = divideTree(left, left+idx, left_bbox);
-
 				BoundingBox right_bbox(bbox);
 				right_bbox[cutfeat].low = cutval;
-				node->child2 = divideTree(left+idx, right, right_bbox);
+
+				// the two subtrees work on disjoint ranges of vind, large ones are built as tasks
+				// when called from a parallel region, the tree is the same as the serial build
+				if (idx > NANOFLANN_TASK_MIN_SIZE) {
+					PooledAllocator* task_pool = newTaskPool();
+#pragma omp task shared(left_bbox) firstprivate(task_pool)
+					node->child1 = divideTree(*task_pool, left, left+idx, left_bbox);
+				}
+				else {
+					node->child1 = divideTree(node_pool, left, left+idx, left_bbox);
+				}
+				node->child2 = divideTree(node_pool, left+idx, right, right_bbox);
+#pragma omp taskwait
 
 				node->node_type.sub.divlow = left_bbox[cutfeat].high;
 				node->node_type.sub.divhigh = right_bbox[cutfeat].low;
@@ -361,4 +361,80 @@ public:
   }
 };
 
+// Single precision point set, one array per attribute.
+// Positions use the interleaved xyz layout of mm::Model so the conversion is a bulk copy,
+// the KD-tree reads 12 bytes per point instead of the 96 bytes stride of Point.
+// Colors are replaced by their interpolated Lab values once computed (see compute_pcqm),
+// Lab is kept on double since the color features are sensitive to its rounding.
+class CompactPointSet {
+public:
+  std::vector<float> positions;  // x0 y0 z0 x1 y1 z1 ...
+  std::vector<float> colors;     // r0 g0 b0 r1 g1 b1 ... RGB8 stored on float
+  std::vector<double> lab;       // L0 a0 b0 L1 a1 b1 ... filled from colors
+
+  double xmin, ymin, zmin;
+  double xmax, ymax, zmax;
+
+  CompactPointSet() { xmin = ymin = zmin = xmax = ymax = zmax = 0.0; }
+
+  // copy a PointSet, keeps positions, colors and bbox
+  void fromPointSet(const PointSet& ptset) {
+    positions.resize(ptset.pts.size() * 3);
+    colors.resize(ptset.pts.size() * 3);
+    for (size_t i = 0; i < ptset.pts.size(); ++i) {
+      positions[i * 3 + 0] = (float)ptset.pts[i].x;
+      positions[i * 3 + 1] = (float)ptset.pts[i].y;
+      positions[i * 3 + 2] = (float)ptset.pts[i].z;
+      colors[i * 3 + 0] = (float)ptset.pts[i].r;
+      colors[i * 3 + 1] = (float)ptset.pts[i].g;
+      colors[i * 3 + 2] = (float)ptset.pts[i].b;
+    }
+    xmin = ptset.xmin; ymin = ptset.ymin; zmin = ptset.zmin;
+    xmax = ptset.xmax; ymax = ptset.ymax; zmax = ptset.zmax;
+  }
+
+  // update the bbox from the positions, same initialization as PointSet::read_ply_file
+  void computeBBox() {
+    xmin = ymin = zmin = std::numeric_limits<double>::max();
+    xmax = ymax = zmax = std::numeric_limits<double>::min();
+    for (size_t i = 0; i < positions.size(); i += 3) {
+      const double x = positions[i], y = positions[i + 1], z = positions[i + 2];
+      xmax = xmax > x ? xmax : x;
+      ymax = ymax > y ? ymax : y;
+      zmax = zmax > z ? zmax : z;
+      xmin = xmin < x ? xmin : x;
+      ymin = ymin < y ? ymin : y;
+      zmin = zmin < z ? zmin : z;
+    }
+  }
+
+  int npts() const { return (int)(positions.size() / 3); }
+
+  inline Eigen::Vector3d point(const size_t idx) const {
+    return Eigen::Vector3d(positions[idx * 3], positions[idx * 3 + 1], positions[idx * 3 + 2]);
+  }
+
+  // Must return the number of data points
+  inline size_t kdtree_get_point_count() const { return positions.size() / 3; }
+
+  // Returns the distance between the vector "p1[0:size-1]" and the data point
+  // with index "idx_p2" stored in the class:
+  inline double kdtree_distance(const double* p1, const size_t idx_p2, size_t size) const {
+    const double d0 = p1[0] - positions[idx_p2 * 3];
+    const double d1 = p1[1] - positions[idx_p2 * 3 + 1];
+    const double d2 = p1[2] - positions[idx_p2 * 3 + 2];
+    return d0 * d0 + d1 * d1 + d2 * d2;
+  }
+
+  // Returns the dim'th component of the idx'th point in the class:
+  inline double kdtree_get_pt(const size_t idx, int dim) const { return positions[idx * 3 + dim]; }
+
+  // Optional bounding-box computation: return false to default to a standard
+  // bbox computation loop.
+  template <class BBOX>
+  bool kdtree_get_bbox(BBOX& bb) const {
+    return false;
+  }
+};
+
 #endif
@@ -20,6 +20,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 
 #include <Eigen/Dense>
 #include "utilities.h"
@@ -182,19 +183,138 @@ void initMatLABCH(
 }
 
 
+// Neighborhoods up to this size reuse cached fit systems, larger ones use temporary matrices.
+#define PCQM_MAX_FIT_ROWS 128
+
+/**
+* \struct PcqmScratch
+* \brief Per thread buffers reused by the feature kernels.
+*
+* The vectors keep their capacity from one point to the next. The quadric fit matrices and their
+* QR decompositions are cached per neighbor count, Eigen only reallocates on size changes.
+* After the first points the only remaining allocations are Eigen's Householder update temporaries.
+*/
+struct PcqmScratch {
+	// knn search results
+	std::vector<size_t> knn_index_ref;
+	std::vector<size_t> knn_index_reg;
+	std::vector<double> knn_dist_ref;
+	std::vector<double> knn_dist_reg;
+	// radius search results
+	std::vector<std::pair<size_t, double>> matches_ref;
+	std::vector<std::pair<size_t, double>> matches_reg;
+	std::vector<size_t> index_ref;
+	std::vector<size_t> index_reg;
+	// statistics weights
+	std::vector<double> distance_reg;
+	std::vector<double> distance_ref;
+	std::vector<double> weight_reg;
+	std::vector<double> weight_ref;
+	// quadric fit systems indexed by neighbor count
+	std::vector<MatrixXd> fit_matrix;
+	std::vector<ColPivHouseholderQR<MatrixXd>> fit_qr;
+
+	PcqmScratch(int threshold_knnsearch)
+		: knn_index_ref(threshold_knnsearch), knn_index_reg(threshold_knnsearch),
+		  knn_dist_ref(threshold_knnsearch), knn_dist_reg(threshold_knnsearch),
+		  fit_matrix(PCQM_MAX_FIT_ROWS + 1), fit_qr(PCQM_MAX_FIT_ROWS + 1) {}
+};
+
+
+/**
+* \struct PcqmReferenceIndex
+* \brief KD-tree of a reference point set, can be kept by the caller from one call to the next.
+*
+* The tree indexes its own copy of the reference positions. Sequences compared against
+* a static reference find the same positions at each frame and skip the tree construction.
+*/
+struct PcqmReferenceIndex {
+	CompactPointSet ptset;
+	CompactKdTree tree;
+
+	PcqmReferenceIndex(const CompactPointSet& refptset)
+		: tree(3, ptset, KDTreeSingleIndexAdaptorParams(10)) {
+		ptset.positions = refptset.positions;
+	}
+};
+
+/**
+* \fn void buildKdTree(CompactKdTree& tree)
+* \brief Builds the tree, large subtrees are built as concurrent OpenMP tasks.
+*/
+static void buildKdTree(CompactKdTree& tree) {
+#pragma omp parallel
+#pragma omp single
+	tree.buildIndex();
+}
+
+std::shared_ptr<PcqmReferenceIndex> build_pcqm_reference_index(
+	const CompactPointSet& refptset,
+	std::shared_ptr<PcqmReferenceIndex> previous)
+{
+	if (previous && previous->ptset.positions == refptset.positions) {
+		std::cout << "Reusing reference KD-tree" << std::endl;
+		return previous;
+	}
+	// released before the new tree is built
+	previous.reset();
+	std::shared_ptr<PcqmReferenceIndex> index = std::make_shared<PcqmReferenceIndex>(refptset);
+	buildKdTree(index->tree);
+	return index;
+}
+
+
+/**
+* \fn void buildQuadricSystem(const Vector3d& origin, const CompactPointSet& refpoints, const std::vector<size_t>& indices,
+	const Vector3d& t1, const Vector3d& t2, const Vector3d& n, MatrixType& A, VectorType& B)
+* \brief Fills the least squares system of the height function z = f(x,y) in the local frame (t1,t2,n).
+*/
+template <typename MatrixType, typename VectorType>
+void buildQuadricSystem(const Vector3d& origin, const CompactPointSet& refpoints, const std::vector<size_t>& indices,
+	const Vector3d& t1, const Vector3d& t2, const Vector3d& n, MatrixType& A, VectorType& B) {
+
+	int nneighbors = indices.size();
+
+	// build linear system
+	for (int i = 0; i < nneighbors; ++i) {
+		const float* p = &refpoints.positions[indices[i] * 3];
+		double xglob = p[0] - origin(0);
+		double yglob = p[1] - origin(1);
+		double zglob = p[2] - origin(2);
+		Vector3d v(xglob, yglob, zglob);
+		double x = v.transpose() * t1;
+		double y = v.transpose() * t2;
+		double z = v.transpose() * n;
+
+		A(i, 0) = x * x;
+		A(i, 1) = y * y;
+		A(i, 2) = x * y;
+		A(i, 3) = x;
+		A(i, 4) = y;
+		A(i, 5) = 1;
+
+		B(i) = z;
+	}
+}
+
+
 /**
-* \fn void computeProjectionAndCurvature(const Point &origin, const std::vector<Point> &refpoints, std::vector<size_t> indices, Point &proj, double &H)
+* \fn void computeProjectionAndCurvature(const Vector3d &origin, const CompactPointSet &refpoints, const std::vector<size_t> &indices, Vector3d &proj, double &H, PcqmScratch& scratch)
 * \brief Compute the projection of an origin point onto the polynomial approximation of a set of neighbors given by a list of indices.
 *
+* The covariance eigen solve uses a stack allocated 3x3 matrix and the fit system is taken from the scratch.
+* Matrix sizes stay dynamic so Eigen runs the same code paths as with temporary MatrixXd, results are unchanged.
+*
 * \param origin : Point to be projected.
 * \param refpoints : Contains all points from ref points cloud.
 * \param indices : Index of points in refpoints cloud used to compute the projection.
 * \param proj : Reference containing the point resulting from the projection.
 * \param H : Reference containing the mean curvature of the projected point.
+* \param scratch : Buffers of the calling thread.
 * \return Returns both the projection and the mean curvature (Referenced variables).
 */
-void computeProjectionAndCurvature(const Point& origin, const std::vector<Point>& refpoints,
-	std::vector<size_t>& indices, Point& proj, double& H) {
+void computeProjectionAndCurvature(const Vector3d& origin, const CompactPointSet& refpoints,
+	const std::vector<size_t>& indices, Vector3d& proj, double& H, PcqmScratch& scratch) {
 
 	Matrix3d M;
 	M.setZero();
@@ -203,8 +323,7 @@ void computeProjectionAndCurvature(const Point& origin, const std::vector<Point>
 	int nneighbors = indices.size();
 
 	for (int i = 0; i < nneighbors; ++i) {
-		Point p = refpoints[indices[i]];
-		Vector3d neighbor(p.x, p.y, p.z);
+		Vector3d neighbor = refpoints.point(indices[i]);
 		mu = mu + neighbor;
 		M = M + neighbor * neighbor.transpose();
 	}
@@ -213,38 +332,27 @@ void computeProjectionAndCurvature(const Point& origin, const std::vector<Point>
 	M = 1. / ((double)nneighbors) * M - mu * mu.transpose();
 
 	// get local frame
-	Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eig(M);
+	Eigen::SelfAdjointEigenSolver<Matrix<double, Dynamic, Dynamic, 0, 3, 3>> eig(M);
 
 
 	Eigen::Vector3d t1 = eig.eigenvectors().col(2);
 	Eigen::Vector3d t2 = eig.eigenvectors().col(1);
 	Eigen::Vector3d n = eig.eigenvectors().col(0);
 
-	MatrixXd A(nneighbors, 6);
-	VectorXd B(nneighbors);
-
-	// build linear system
-	for (int i = 0; i < nneighbors; ++i) {
-		double xglob = refpoints[indices[i]].x - origin.x;
-		double yglob = refpoints[indices[i]].y - origin.y;
-		double zglob = refpoints[indices[i]].z - origin.z;
-		Vector3d v(xglob, yglob, zglob);
-		double x = v.transpose() * t1;
-		double y = v.transpose() * t2;
-		double z = v.transpose() * n;
-
-		A(i, 0) = x * x;
-		A(i, 1) = y * y;
-		A(i, 2) = x * y;
-		A(i, 3) = x;
-		A(i, 4) = y;
-		A(i, 5) = 1;
-
-		B(i) = z;
+	Matrix<double, 6, 1> coeffs;
+	if (nneighbors <= PCQM_MAX_FIT_ROWS) {
+		MatrixXd& A = scratch.fit_matrix[nneighbors];
+		Matrix<double, Dynamic, 1, 0, PCQM_MAX_FIT_ROWS, 1> B(nneighbors);
+		A.resize(nneighbors, 6);
+		buildQuadricSystem(origin, refpoints, indices, t1, t2, n, A, B);
+		coeffs = scratch.fit_qr[nneighbors].compute(A).solve(B);
+	}
+	else {
+		MatrixXd A(nneighbors, 6);
+		VectorXd B(nneighbors);
+		buildQuadricSystem(origin, refpoints, indices, t1, t2, n, A, B);
+		coeffs = A.colPivHouseholderQr().solve(B);
 	}
-
-
-	VectorXd coeffs = A.colPivHouseholderQr().solve(B);
 
 	// corresponding point:
 	Vector3d delta = coeffs(5) * n;
@@ -262,15 +370,15 @@ void computeProjectionAndCurvature(const Point& origin, const std::vector<Point>
 
 
 /**
-* \fn double compute_distance(Point &a, Point &b)
+* \fn double compute_distance(const Vector3d &a, const Vector3d &b)
 * \brief Compute the Euclidean distance between two points.
 *
 * \param a : Point a.
 * \param b : Point b.
 * \return Returns the Euclidean distance between a and b.
 */
-double compute_distance(Point& a, Point& b) {
-	return std::sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y) + (b.z - a.z) * (b.z - a.z));
+double compute_distance(const Vector3d& a, const Vector3d& b) {
+	return std::sqrt((b(0) - a(0)) * (b(0) - a(0)) + (b(1) - a(1)) * (b(1) - a(1)) + (b(2) - a(2)) * (b(2) - a(2)));
 }
 
 
@@ -401,6 +509,38 @@ void RGBtoLCH(double R, double G, double B, double& L, double& C, double& H) {
 	LabtoLCH(_L, _a, _b, L, C, H);
 }
 
+/**
+* \fn void computeInterpolatedLab(CompactPointSet& ptset, std::vector<double>& init_grid_L, std::vector<double>& grid_L,
+	std::vector<std::vector<std::pair<double, double>>>& init_grid_AB)
+* \brief Convert the colors of every point to interpolated Lab, once per point instead of once per query.
+*
+* The RGB colors are released after the conversion.
+*/
+void computeInterpolatedLab(CompactPointSet& ptset, std::vector<double>& init_grid_L, std::vector<double>& grid_L,
+	std::vector<std::vector<std::pair<double, double>>>& init_grid_AB)
+{
+	if (ptset.colors.empty() && ptset.lab.size() == ptset.positions.size()) return; // already converted
+
+	ptset.lab.resize(ptset.positions.size());
+
+#pragma omp parallel for
+	for (int i = 0; i < ptset.npts(); ++i) {
+		double L_star = 0.0;
+		double A_star = 0.0;
+		double B_star = 0.0;
+
+		RGBtoLab(ptset.colors[i * 3], ptset.colors[i * 3 + 1], ptset.colors[i * 3 + 2], L_star, A_star, B_star);
+
+		std::pair<double, double> a_b = interpolate2_process(init_grid_AB, A_star, B_star);
+
+		ptset.lab[i * 3] = interpolate1_process(init_grid_L, grid_L, L_star);
+		ptset.lab[i * 3 + 1] = a_b.first;
+		ptset.lab[i * 3 + 2] = a_b.second;
+	}
+
+	std::vector<float>().swap(ptset.colors);
+}
+
 /**
 * \fn std::string remove_extension(const std::string& filename)
 * \brief Remove the extension of an input filename
@@ -741,14 +881,12 @@ void compute_geometric_feature(int index_array, const size_t nMatches_Reg, std::
 
 
 /**
-* \fn void compute_statistics(double radius, const double maxDim, PointSet& regptset, KdTree& m_kdtree2,
-	std::vector<Point>& projectedpointsOnRef, std::vector<Point>& projectedpointsOnMe,
+* \fn void compute_statistics(double radius, const double maxDim, CompactPointSet& regptset, CompactKdTree& m_kdtree2,
+	std::vector<Vector3d>& projectedpointsOnRef, std::vector<Vector3d>& projectedpointsOnMe,
 	std::vector<double>& meancurvaturesProj, std::vector<double>& meancurvaturesMe,
 	std::vector<double>& geom_lightness_field, std::vector<double>& geom_contrast_field,
 	std::vector<double>& geom_structure_field, double& PCQM, const double radius_factor,
 	std::vector<double>& tab_lstar_me, std::vector<double>& tab_lstar_proj,
-	std::vector<double>& tab_astar_me, std::vector<double>& tab_astar_proj, 
-	std::vector<double>& tab_bstar_me, std::vector<double>& tab_bstar_proj, 
 	std::vector<double>& tab_chroma_me, std::vector<double>& tab_chroma_proj, 
 	std::vector<double>& tab_hue_me, std::vector<double>& tab_hue_proj, 
 	std::vector<double>& color_lightness_field, std::vector<double>& color_chroma_field,
@@ -758,14 +896,12 @@ void compute_geometric_feature(int index_array, const size_t nMatches_Reg, std::
 */
 void compute_statistics(
     const std::string reffile, const std::string regfile, // for log
-    double radius, const double maxDim, PointSet& regptset, KdTree& m_kdtree2,
-	std::vector<Point>& projectedpointsOnRef, std::vector<Point>& projectedpointsOnMe,
+    double radius, const double maxDim, CompactPointSet& regptset, CompactKdTree& m_kdtree2,
+	std::vector<Vector3d>& projectedpointsOnRef, std::vector<Vector3d>& projectedpointsOnMe,
 	std::vector<double>& meancurvaturesProj, std::vector<double>& meancurvaturesMe,
 	std::vector<double>& geom_lightness_field, std::vector<double>& geom_contrast_field,
 	std::vector<double>& geom_structure_field, double& PCQM, const double radius_factor,
 	std::vector<double>& tab_lstar_me, std::vector<double>& tab_lstar_proj,
-	std::vector<double>& tab_astar_me, std::vector<double>& tab_astar_proj, 
-	std::vector<double>& tab_bstar_me, std::vector<double>& tab_bstar_proj, 
 	std::vector<double>& tab_chroma_me, std::vector<double>& tab_chroma_proj, 
 	std::vector<double>& tab_hue_me, std::vector<double>& tab_hue_proj, 
 	std::vector<double>& color_lightness_field, std::vector<double>& color_chroma_field,
@@ -782,28 +918,35 @@ void compute_statistics(
 	params.sorted = false;
 
 	//FEATURES COMPUTATION
-#pragma omp parallel for
+#pragma omp parallel
+	{
+	PcqmScratch scratch(threshold_knnsearch);
+#pragma omp for
 	for (int i = 0; i < regptset.npts(); i++) {
 
 		double search_radius_neighborhood = static_cast<double>(radius * radius_factor);
 
-		Point origin = regptset.pts[i];
+		const Vector3d origin = regptset.point(i);
 
 		// Structure containing indexes and distances returned from KNN
-		std::vector<std::pair<size_t, double>> ret_matches_Reg;
+		std::vector<std::pair<size_t, double>>& ret_matches_Reg = scratch.matches_reg;
 
 		// Distances
-		std::vector<double> ret_distance_Reg;
-		std::vector<double> ret_distance_Ref;
+		std::vector<double>& ret_distance_Reg = scratch.distance_reg;
+		std::vector<double>& ret_distance_Ref = scratch.distance_ref;
 
 		// Weights
-		std::vector<double> ret_weight_Reg;
-		std::vector<double> ret_weight_Ref;
+		std::vector<double>& ret_weight_Reg = scratch.weight_reg;
+		std::vector<double>& ret_weight_Ref = scratch.weight_ref;
+		ret_distance_Reg.clear();
+		ret_distance_Ref.clear();
+		ret_weight_Reg.clear();
+		ret_weight_Ref.clear();
 		double sum_distances_me = 0.0;
 		double sum_distances_proj = 0.0;
 
 
-		double query_pt[3] = { origin.x, origin.y, origin.z };
+		double query_pt[3] = { origin(0), origin(1), origin(2) };
 
 		// Looking for neighbors of REGISTERED to compute statistics
 		const size_t nMatches_Reg =
@@ -818,8 +961,8 @@ void compute_statistics(
 			ret_distance_Reg.push_back(std::sqrt(ret_matches_Reg[cpt_reg].second));
 
 			// manually computing distance REFERENCE
-			Point p_orig_proj = projectedpointsOnRef[i];
-			Point p_neigh_proj = projectedpointsOnRef[ret_matches_Reg[cpt_reg].first];
+			const Vector3d& p_orig_proj = projectedpointsOnRef[i];
+			const Vector3d& p_neigh_proj = projectedpointsOnRef[ret_matches_Reg[cpt_reg].first];
 
 
 			ret_distance_Ref.push_back(compute_distance(p_orig_proj, p_neigh_proj));
@@ -882,6 +1025,7 @@ void compute_statistics(
 		f6 += color_structure_field[i];
 		
 
+	}
 	}
 
 	double size_tab = (double)color_lightness_field.size();
@@ -938,12 +1082,37 @@ float compute_pcqm(
 	const int threshold_knnsearch,
 	const double radius_factor)
 {
+	CompactPointSet refcompact;
+	CompactPointSet regcompact;
+	refcompact.fromPointSet(refptset);
+	regcompact.fromPointSet(regptset);
+
+	return compute_pcqm(
+        refcompact, regcompact,
+        reffile, regfile,
+        RadiusCurvature,
+        threshold_knnsearch,
+        radius_factor );
+}
 
-	//Build KDtree
-	KdTree m_kdtree(3, refptset, KDTreeSingleIndexAdaptorParams(10));
-	m_kdtree.buildIndex();
-	KdTree m_kdtree2(3, regptset, KDTreeSingleIndexAdaptorParams(10));
-	m_kdtree2.buildIndex();
+float compute_pcqm(
+    CompactPointSet& refptset,
+	CompactPointSet& regptset,
+    // 
+    const std::string reffile,
+	const std::string regfile,
+	// PCQM params
+	const double RadiusCurvature,
+	const int threshold_knnsearch,
+	const double radius_factor,
+	std::shared_ptr<PcqmReferenceIndex> referenceIndex)
+{
+
+	//Build KDtrees, the reference one is given by the caller if already built
+	if (!referenceIndex) referenceIndex = build_pcqm_reference_index(refptset);
+	CompactKdTree& m_kdtree = referenceIndex->tree;
+	CompactKdTree m_kdtree2(3, regptset, KDTreeSingleIndexAdaptorParams(10));
+	buildKdTree(m_kdtree2);
 
 	//Color interpolation structures 
 	std::vector<double> init_grid_L;
@@ -952,12 +1121,14 @@ float compute_pcqm(
 
 	initMatLABCH(init_grid_L, grid_L, init_grid_AB);
 
+	computeInterpolatedLab(refptset, init_grid_L, grid_L, init_grid_AB);
+	computeInterpolatedLab(regptset, init_grid_L, grid_L, init_grid_AB);
 
 
-	std::vector<Point> projectedpointsOnRef;
-	std::vector<Point> projectedpointsOnMe;
-	projectedpointsOnRef.assign(regptset.npts(), Point());
-	projectedpointsOnMe.assign(regptset.npts(), Point());
+	std::vector<Vector3d> projectedpointsOnRef;
+	std::vector<Vector3d> projectedpointsOnMe;
+	projectedpointsOnRef.assign(regptset.npts(), Vector3d::Zero());
+	projectedpointsOnMe.assign(regptset.npts(), Vector3d::Zero());
 
 	std::vector<double> meancurvaturesProj;
 	std::vector<double> meancurvaturesMe;
@@ -966,8 +1137,6 @@ float compute_pcqm(
 	std::vector<double> geom_structure_field;
 
 
-	std::vector<double> tab_radius;
-
 	meancurvaturesProj.assign(regptset.npts(), 0.0);
 	meancurvaturesMe.assign(regptset.npts(), 0.0);
 	
@@ -976,8 +1145,6 @@ float compute_pcqm(
 	geom_contrast_field.assign(regptset.npts(), 0.0);
 	geom_structure_field.assign(regptset.npts(), 0.0);
 
-	tab_radius.assign(regptset.npts(), 0.0);
-
 	//Local color features Storage
 	std::vector<double> color_lightness_field, color_chroma_field, color_hue_field, color_contrast_field, color_structure_field;
 
@@ -992,18 +1159,12 @@ float compute_pcqm(
 
 	//Point Color data
 	std::vector<double> tab_lstar_me, tab_lstar_proj,
-						tab_astar_me, tab_astar_proj,
-						tab_bstar_me, tab_bstar_proj,
 						tab_chroma_me, tab_chroma_proj,
 						tab_hue_me, tab_hue_proj;
 
 
 	tab_lstar_me.assign(regptset.npts(), 0.0);
 	tab_lstar_proj.assign(regptset.npts(), 0.0);
-	tab_astar_me.assign(regptset.npts(), 0.0);
-	tab_astar_proj.assign(regptset.npts(), 0.0);
-	tab_bstar_me.assign(regptset.npts(), 0.0);
-	tab_bstar_proj.assign(regptset.npts(), 0.0);
 	tab_chroma_me.assign(regptset.npts(), 0.0);
 	tab_chroma_proj.assign(regptset.npts(), 0.0);
 	tab_hue_me.assign(regptset.npts(), 0.0);
@@ -1026,43 +1187,45 @@ float compute_pcqm(
 
 	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
 
-#pragma omp parallel for
+#pragma omp parallel
+	{
+	PcqmScratch scratch(threshold_knnsearch);
+#pragma omp for
 	for (int i = 0; i < regptset.npts(); ++i) {
-		Point origin = regptset.pts[i];
+		const Vector3d origin = regptset.point(i);
 
 		double H = 0;
 		double K = 0;
-		Point proj;
-		Point projOnMe;
+		Vector3d proj;
+		Vector3d projOnMe;
 
-		double query_pt[3] = { origin.x, origin.y, origin.z };
+		double query_pt[3] = { origin(0), origin(1), origin(2) };
 
 		// KNN_SEARCH
 		// Indexes
-		std::vector<size_t> ret_index_ref_init(threshold_knnsearch);
-		std::vector<size_t> ret_index_reg_init(threshold_knnsearch);
+		std::vector<size_t>& ret_index_ref_init = scratch.knn_index_ref;
+		std::vector<size_t>& ret_index_reg_init = scratch.knn_index_reg;
 		// Distances
-		std::vector<double> out_dist_sqr_ref(threshold_knnsearch);
-		std::vector<double> out_dist_sqr_reg(threshold_knnsearch);
-		std::vector<double>::iterator result1;
-		std::vector<double>::iterator result2;
+		std::vector<double>& out_dist_sqr_ref = scratch.knn_dist_ref;
+		std::vector<double>& out_dist_sqr_reg = scratch.knn_dist_reg;
 
 
 		// Safe knnSearch on REFERENCE and REGISTER
 		m_kdtree.knnSearch(&query_pt[0], threshold_knnsearch, &ret_index_ref_init[0], &out_dist_sqr_ref[0]);
 		m_kdtree2.knnSearch(&query_pt[0], threshold_knnsearch, &ret_index_reg_init[0], &out_dist_sqr_reg[0]);
 		
-		params.sorted = true; //Neighbors are sorted distance wise
-		//Radius search results container
-		std::vector<std::pair<size_t, double>> ret_matches_Ref;
-		std::vector<std::pair<size_t, double>> ret_matches_Me;
+		//Radius search results container (params.sorted, neighbors are sorted distance wise)
+		std::vector<std::pair<size_t, double>>& ret_matches_Ref = scratch.matches_ref;
+		std::vector<std::pair<size_t, double>>& ret_matches_Me = scratch.matches_reg;
 
 		//Radius search
 		size_t nMatches_Ref = m_kdtree.radiusSearch(&query_pt[0], radius * radius, ret_matches_Ref, params);
 		size_t nMatches_Reg = m_kdtree2.radiusSearch(&query_pt[0], radius * radius, ret_matches_Me, params);
 
-		std::vector<size_t> ret_index_ref(nMatches_Ref);
-		std::vector<size_t> ret_index_reg(nMatches_Reg);
+		std::vector<size_t>& ret_index_ref = scratch.index_ref;
+		std::vector<size_t>& ret_index_reg = scratch.index_reg;
+		ret_index_ref.resize(nMatches_Ref);
+		ret_index_reg.resize(nMatches_Reg);
 
 
 		for (size_t cpt_ref = 0; cpt_ref < nMatches_Ref; cpt_ref++) {
@@ -1077,18 +1240,18 @@ float compute_pcqm(
 
 		// We used the neihgborhood computed with a KNN search to compute PROJECTION
 		double dummy_double;
-		computeProjectionAndCurvature(origin, refptset.pts, ret_index_ref_init, proj, dummy_double);
-		computeProjectionAndCurvature(origin, regptset.pts, ret_index_reg_init, projOnMe, dummy_double);
+		computeProjectionAndCurvature(origin, refptset, ret_index_ref_init, proj, dummy_double, scratch);
+		computeProjectionAndCurvature(origin, regptset, ret_index_reg_init, projOnMe, dummy_double, scratch);
 
 
 		// We used the neihgborhood computed with a radius search to compute CURVATURE
-		Point dummy_point;
-		computeProjectionAndCurvature(origin, refptset.pts, ret_index_ref, dummy_point, H);
-		computeProjectionAndCurvature(origin, regptset.pts, ret_index_reg, dummy_point, K);
+		Vector3d dummy_point;
+		computeProjectionAndCurvature(origin, refptset, ret_index_ref, dummy_point, H, scratch);
+		computeProjectionAndCurvature(origin, regptset, ret_index_reg, dummy_point, K, scratch);
 
 
-		Point closest_point_from_origin_ref = refptset.pts[ret_index_ref_init[0]];
-		Point closest_point_from_origin_reg = regptset.pts[ret_index_reg_init[0]];
+		const Vector3d closest_point_from_origin_ref = refptset.point(ret_index_ref_init[0]);
+		const Vector3d closest_point_from_origin_reg = regptset.point(ret_index_reg_init[0]);
 
 		double distance_ori_proj = compute_distance(origin, proj);
 		double distance_ori_closest = compute_distance(origin, closest_point_from_origin_ref);
@@ -1107,53 +1270,31 @@ float compute_pcqm(
 
 		////////////////////////////////////// LAB projection //////////////////////////////////////
 
+		// Lab values are precomputed per point, see computeInterpolatedLab
+		const double* lab_me = &regptset.lab[i * 3];
+		//refptset.lab[ret_index_ref_init[0]] is the nearest neighboor
+		const double* lab_proj = &refptset.lab[ret_index_ref_init[0] * 3];
 
-		double L_star = 0.0;
-		double A_star = 0.0;
-		double B_star = 0.0;
-		
-		RGBtoLab(regptset.pts[i].r, regptset.pts[i].g, regptset.pts[i].b, L_star, A_star, B_star);
-
-		L_star = interpolate1_process(init_grid_L, grid_L, L_star);
-
-		std::pair<double, double> me_a_b = interpolate2_process(init_grid_AB, A_star, B_star);
-		
-		A_star = me_a_b.first;
-		B_star = me_a_b.second;
-
-		tab_lstar_me[i] = L_star;
-		tab_astar_me[i] = A_star;
-		tab_bstar_me[i] = B_star;
-
-
-		//refptset.pts[ret_index_ref_init[0]] is the nearest neighboor
-		RGBtoLab(refptset.pts[ret_index_ref_init[0]].r, refptset.pts[ret_index_ref_init[0]].g,
-			refptset.pts[ret_index_ref_init[0]].b, L_star, A_star, B_star); 
+		tab_lstar_me[i] = lab_me[0];
+		tab_lstar_proj[i] = lab_proj[0];
 
-
-		L_star = interpolate1_process(init_grid_L, grid_L, L_star);
-		std::pair<double, double> proj_a_b = interpolate2_process(init_grid_AB, A_star, B_star);
-		A_star = proj_a_b.first;
-		B_star = proj_a_b.second;
-
-		tab_lstar_proj[i] = L_star;
-		tab_astar_proj[i] = A_star;
-		tab_bstar_proj[i] = B_star;
+		const double astar_me = lab_me[1];
+		const double bstar_me = lab_me[2];
+		const double astar_proj = lab_proj[1];
+		const double bstar_proj = lab_proj[2];
 
 
 		////////////////////////////////////// CHROMA projection //////////////////////////////////////
 
-		tab_chroma_me[i] =
-			std::sqrt(tab_astar_me[i] * tab_astar_me[i] + tab_bstar_me[i] * tab_bstar_me[i]);
-		tab_chroma_proj[i] = std::sqrt(tab_astar_proj[i] * tab_astar_proj[i] +
-			tab_bstar_proj[i] * tab_bstar_proj[i]);
+		tab_chroma_me[i] = std::sqrt(astar_me * astar_me + bstar_me * bstar_me);
+		tab_chroma_proj[i] = std::sqrt(astar_proj * astar_proj + bstar_proj * bstar_proj);
 
 
 		////////////////////////////////////// HUE projection //////////////////////////////////////
 
 		double delta_HUE =
-			(tab_astar_me[i] - tab_astar_proj[i]) * (tab_astar_me[i] - tab_astar_proj[i]) +
-			(tab_bstar_me[i] - tab_bstar_proj[i]) * (tab_bstar_me[i] - tab_bstar_proj[i]) -
+			(astar_me - astar_proj) * (astar_me - astar_proj) +
+			(bstar_me - bstar_proj) * (bstar_me - bstar_proj) -
 			(tab_chroma_me[i] - tab_chroma_proj[i]) * (tab_chroma_me[i] - tab_chroma_proj[i]);
 
 		tab_hue_me[i] = (delta_HUE > 0) ? std::sqrt(delta_HUE) : 0.0;
@@ -1162,6 +1303,7 @@ float compute_pcqm(
 		////////////////////////////////////////////////////////////////////////////////////////////
 
 
+	}
 	}
 
 	std::chrono::steady_clock::time_point end_projection = std::chrono::steady_clock::now();
@@ -1175,7 +1317,7 @@ float compute_pcqm(
 	compute_statistics(reffile, regfile,
         radius, maxDim, regptset, m_kdtree2, projectedpointsOnRef, projectedpointsOnMe,
 		meancurvaturesProj, meancurvaturesMe, geom_lightness_field, geom_contrast_field, geom_structure_field, PCQM, radius_factor,
-		tab_lstar_me, tab_lstar_proj, tab_astar_me, tab_astar_proj, tab_bstar_me, tab_bstar_proj,
+		tab_lstar_me, tab_lstar_proj,
 		tab_chroma_me, tab_chroma_proj, tab_hue_me, tab_hue_proj, color_lightness_field, color_chroma_field, color_hue_field, color_contrast_field,
 		color_structure_field, threshold_knnsearch);
 
@@ -23,9 +23,12 @@
 #ifndef  PCQM_H_
 #define  PCQM_H_
 
+#include <memory>
 #include <string>
 #include "PointSet.h"
 
+struct PcqmReferenceIndex;
+
 /**
 * \brief Computes PCQM using point sets given as parameter
 * \return EXIT_SUCCESS if the code executed successfuly.
@@ -41,6 +44,34 @@ float compute_pcqm(
 	const int threshold_knnsearch = 20,
 	const double radius_factor = 2.0);
 
+/**
+* \brief Computes PCQM using single precision point sets given as parameter
+* The point colors are converted to Lab in place and released.
+* \return EXIT_SUCCESS if the code executed successfuly.
+*/
+float compute_pcqm(
+    CompactPointSet& refptset,
+	CompactPointSet& regptset,
+    // associated file names (for logging)
+    const std::string reffile,
+	const std::string regfile,
+	// PCQM params
+	const double RadiusCurvature = 0.004,
+	const int threshold_knnsearch = 20,
+	const double radius_factor = 2.0,
+	// KD-tree of refptset, built by the call if null
+	std::shared_ptr<PcqmReferenceIndex> referenceIndex = nullptr);
+
+/**
+* \brief Builds the KD-tree of a single precision reference point set
+* previous is returned as is if it indexes the same positions, so a caller keeping
+* the index between calls (e.g. frames against a static reference) builds it once.
+* \return the index to give to compute_pcqm.
+*/
+std::shared_ptr<PcqmReferenceIndex> build_pcqm_reference_index(
+	const CompactPointSet& refptset,
+	std::shared_ptr<PcqmReferenceIndex> previous = nullptr);
+
 /**
 * \brief Computes PCQM using filenames given as parameter
 * \return EXIT_SUCCESS if the code executed successfuly.
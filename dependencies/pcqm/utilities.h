@@ -16,6 +16,12 @@ typedef KDTreeSingleIndexAdaptor<
  PointSet,
  3 /* dim */> 
 KdTree;
+
+typedef KDTreeSingleIndexAdaptor<
+ L2_Simple_Adaptor<double, CompactPointSet > ,
+ CompactPointSet,
+ 3 /* dim */> 
+CompactKdTree;
  
 static void save(std::vector<double> &scalars, const char *filename)
 {
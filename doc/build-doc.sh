@@ -38,13 +38,21 @@ echo -e "\n# Command references \n\`\`\`\n" >> ${MAINDIR}/README.md
 ${CMD} >> ${MAINDIR}/README.md
 echo -e "\`\`\`\n\n" >> ${MAINDIR}/README.md
 
-for cmd in analyse compare degrade dequantize normals quantize reindex render sample sequence
+for cmd in analyse compare degrade dequantize generate merge normals quantize reindex render sample sequence
 do 
 	echo -e "## ${cmd^} \n\`\`\`\n" >> ${MAINDIR}/README.md	
 	${CMD} ${cmd} >> ${MAINDIR}/README.md
 	echo -e "\`\`\`\n\n" >> ${MAINDIR}/README.md
 done
 
+echo -e "## Serve \n\`\`\`\n" >> ${MAINDIR}/README.md
+${CMD} serve --help >> ${MAINDIR}/README.md
+echo -e "\`\`\`\n\n" >> ${MAINDIR}/README.md
+
+echo -e "## Client \n\`\`\`\n" >> ${MAINDIR}/README.md
+${CMD} client >> ${MAINDIR}/README.md
+echo -e "\`\`\`\n\n" >> ${MAINDIR}/README.md
+
 cat ${MAINDIR}/LICENSE.md >> ${MAINDIR}/README.md
 
 cat ${MAINDIR}/doc/FOOTER.md >> ${MAINDIR}/README.md
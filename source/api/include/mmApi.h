@@ -0,0 +1,278 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MM_API_H_
+#define _MM_API_H_
+
+// C interface of the mm library, to sample and compare models in process
+// (e.g. score the decoded meshes at encode time) without writing them to files.
+//
+// All the functions return MM_OK on success. On error, a message can be read with
+// mm_get_last_error, until the next call from the same thread.
+// Parameter and result structures start with their size, set by the init functions,
+// so that fields can be appended in later versions without breaking the binary interface.
+// Models copy the arrays given to the setters. Images are views of the caller pixels.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined( _WIN32 )
+#  ifdef MM_API_EXPORTS
+#    define MM_API __declspec( dllexport )
+#  else
+#    define MM_API __declspec( dllimport )
+#  endif
+#else
+#  define MM_API __attribute__( ( visibility( "default" ) ) )
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// incremented when the interface changes, fields and functions are only added
+#define MM_API_VERSION 1
+
+typedef enum {
+  MM_OK                 = 0,
+  MM_ERROR_ARGUMENT     = 1,  // invalid handle, array or parameter
+  MM_ERROR_PROCESSING   = 2,  // the processing failed
+  MM_ERROR_INCOMPATIBLE = 3,  // structure size not supported by this version of the library
+  MM_ERROR_IO           = 4   // an input file cannot be read or is invalid
+} mm_status;
+
+// opaque handles
+typedef struct mm_model   mm_model;
+typedef struct mm_image   mm_image;
+typedef struct mm_compare mm_compare;
+
+// version of the interface implemented by the library, compare with MM_API_VERSION
+MM_API int mm_get_api_version( void );
+
+// version of the library (e.g. "1.1.7")
+MM_API const char* mm_get_version( void );
+
+// message of the last error of the calling thread, empty string if none
+MM_API const char* mm_get_last_error( void );
+
+// number of threads used by the processings, 0 for all the cores (default)
+MM_API mm_status mm_set_thread_count( size_t count );
+
+// prints the logs of the processings on the standard output if not 0, silent by default
+MM_API void mm_set_verbose( int verbose );
+
+// ---------------------------------------------------------------------------------------------
+// models, meshes (with triangles) or point clouds (without)
+
+MM_API mm_model* mm_model_create( void );
+MM_API void      mm_model_destroy( mm_model* model );
+
+// the setters copy count elements (x,y,z or u,v or r,g,b), NULL or 0 clears the attribute
+MM_API mm_status mm_model_set_positions( mm_model* model, const float* xyz, size_t count );
+MM_API mm_status mm_model_set_normals( mm_model* model, const float* xyz, size_t count );
+// colors in [0,255]
+MM_API mm_status mm_model_set_colors( mm_model* model, const float* rgb, size_t count );
+MM_API mm_status mm_model_set_uvs( mm_model* model, const float* uv, size_t count );
+// the index setters return MM_ERROR_ARGUMENT and keep the model unchanged if an index is out of range,
+// the positions and uvs must be set before the triangles that index them
+// position indices of count triangles, 3 per triangle, all the triangles use the first texture
+MM_API mm_status mm_model_set_triangles( mm_model* model, const int32_t* indices, size_t count );
+// index of the texture of each triangle, count is the triangle count (e.g. one per obj material),
+// the processings given textures return MM_ERROR_ARGUMENT if an index exceeds their texture count
+MM_API mm_status mm_model_set_triangle_textures( mm_model* model, const int32_t* indices, size_t count );
+// uv indices of count triangles, optional if the uvs are per vertex
+MM_API mm_status mm_model_set_triangle_uvs( mm_model* model, const int32_t* indices, size_t count );
+
+// the getters return the element counts and pointers valid until the model is modified or destroyed
+MM_API size_t         mm_model_get_position_count( const mm_model* model );
+MM_API const float*   mm_model_get_positions( const mm_model* model );
+MM_API size_t         mm_model_get_normal_count( const mm_model* model );
+MM_API const float*   mm_model_get_normals( const mm_model* model );
+MM_API size_t         mm_model_get_color_count( const mm_model* model );
+MM_API const float*   mm_model_get_colors( const mm_model* model );
+MM_API size_t         mm_model_get_uv_count( const mm_model* model );
+MM_API const float*   mm_model_get_uvs( const mm_model* model );
+MM_API size_t         mm_model_get_triangle_count( const mm_model* model );
+MM_API const int32_t* mm_model_get_triangles( const mm_model* model );
+MM_API const int32_t* mm_model_get_triangle_uvs( const mm_model* model );
+
+// ---------------------------------------------------------------------------------------------
+// texture maps, 8 bits per component, components interleaved, rows from top to bottom
+
+// view of the pixels, which are neither copied nor modified and must outlive the image
+MM_API mm_image* mm_image_create_view( const uint8_t* pixels, int width, int height, int components );
+MM_API void      mm_image_destroy( mm_image* image );
+
+// ---------------------------------------------------------------------------------------------
+// sampling of a mesh into a point cloud, see mm sample --help for the modes
+
+typedef enum {
+  MM_SAMPLE_FACE = 0,
+  MM_SAMPLE_GRID = 1,
+  MM_SAMPLE_MAP  = 2,
+  MM_SAMPLE_SDIV = 3,
+  MM_SAMPLE_EDIV = 4,
+  MM_SAMPLE_PRND = 5
+} mm_sample_mode;
+
+typedef struct {
+  size_t         size;             // set by mm_sample_params_init
+  mm_sample_mode mode;             // default MM_SAMPLE_FACE
+  int            bilinear;         // bilinear texture filtering, default 0
+  size_t         resolution;       // face and ediv modes, default 1024
+  float          thickness;        // face mode, default 0
+  size_t         gridSize;         // grid mode, default 1024
+  int            useNormal;        // grid mode, default 0
+  int            useFixedPoint;    // grid mode, default 0
+  float          minPos[3];        // grid mode, bounding box, computed if minPos equals maxPos (default)
+  float          maxPos[3];        //
+  int            maxDepth;         // sdiv mode, default 100
+  float          areaThreshold;    // sdiv mode, default 1
+  int            mapThreshold;     // sdiv mode, default 0
+  float          lengthThreshold;  // ediv mode, 0 to use resolution (default)
+  size_t         nbSamples;        // prnd mode, default 2000000
+  uint32_t       seed;             // prnd mode, default 0
+  size_t         nbSamplesMin;     // face, grid, sdiv and ediv modes, point count range if not 0, default 0
+  size_t         nbSamplesMax;     //
+  size_t         maxIterations;    // default 10
+} mm_sample_params;
+
+// sets the defaults of mm sample
+MM_API void mm_sample_params_init( mm_sample_params* params );
+
+// samples the mesh input with its textures into the point cloud output
+MM_API mm_status mm_sample( const mm_model* input, const mm_image* const* textures, size_t textureCount,
+                            const mm_sample_params* params, mm_model* output );
+
+// ---------------------------------------------------------------------------------------------
+// comparison of a model A (reference) and a model B, see mm compare --help for the modes
+// textures are optional (NULL and 0)
+
+// keeps the state shared by the comparisons of a sequence (e.g. the renderers of ibsm)
+MM_API mm_compare* mm_compare_create( void );
+MM_API void        mm_compare_destroy( mm_compare* compare );
+
+typedef struct {
+  size_t size;                          // set by mm_pcc_params_init
+  int    singlePass;                    // default 0
+  int    hausdorff;                     // default 0
+  int    color;                         // default 1
+  float  resolution;                    // 0 for the diagonal of the bounding box (default)
+  int    neighborsProc;                 // default 1
+  int    dropDuplicates;                // default 2
+  int    averageNormals;                // default 1
+  int    normalCalcModificationEnable;  // default 1
+} mm_pcc_params;
+
+typedef struct {
+  size_t size;  // set by mm_pcc_results_init
+  double c2c_mse, c2c_hausdorff, c2p_mse, c2p_hausdorff;
+  double color_mse[3], color_rgb_hausdorff[3];
+  double c2c_psnr, c2c_hausdorff_psnr, c2p_psnr, c2p_hausdorff_psnr;
+  double color_psnr[3], color_rgb_hausdorff_psnr[3];
+  double resolution;  // resolution used, computed if the parameter is 0
+} mm_pcc_results;
+
+MM_API void      mm_pcc_params_init( mm_pcc_params* params );
+MM_API void      mm_pcc_results_init( mm_pcc_results* results );
+MM_API mm_status mm_compare_pcc( mm_compare* compare, const mm_model* modelA, const mm_image* const* texturesA,
+                                 size_t textureCountA, const mm_model* modelB, const mm_image* const* texturesB,
+                                 size_t textureCountB, const mm_pcc_params* params, mm_pcc_results* results );
+
+typedef struct {
+  size_t size;                // set by mm_pcqm_params_init
+  double radiusCurvature;     // default 0.001
+  int    thresholdKnnSearch;  // default 20
+  double radiusFactor;        // default 2
+} mm_pcqm_params;
+
+typedef struct {
+  size_t size;  // set by mm_pcqm_results_init
+  double pcqm;
+  double pcqm_psnr;
+} mm_pcqm_results;
+
+MM_API void      mm_pcqm_params_init( mm_pcqm_params* params );
+MM_API void      mm_pcqm_results_init( mm_pcqm_results* results );
+MM_API mm_status mm_compare_pcqm( mm_compare* compare, const mm_model* modelA, const mm_image* const* texturesA,
+                                  size_t textureCountA, const mm_model* modelB, const mm_image* const* texturesB,
+                                  size_t textureCountB, const mm_pcqm_params* params, mm_pcqm_results* results );
+
+typedef struct {
+  size_t      size;               // set by mm_ibsm_params_init
+  uint32_t    resolution;         // default 2048
+  uint32_t    cameraCount;        // default 16
+  float       cameraRotation[3];  // default 0 0 0
+  const char* renderer;           // "sw_raster" (default) or "gl12_raster"
+  int         disableReordering;  // default 0
+  int         disableCulling;     // default 0
+} mm_ibsm_params;
+
+typedef struct {
+  size_t size;        // set by mm_ibsm_results_init
+  double rgbMSE[4];   // R, G, B, components mean
+  double rgbPSNR[4];  //
+  double yuvMSE[4];   // Y, U, V, 6/1/1 mean
+  double yuvPSNR[4];  //
+  double depthMSE;
+  double depthPSNR;
+  double boxRatio;                  // ( B box size / A box size ) * 100
+  double unmatchedPixelPercentage;  //
+} mm_ibsm_results;
+
+MM_API void      mm_ibsm_params_init( mm_ibsm_params* params );
+MM_API void      mm_ibsm_results_init( mm_ibsm_results* results );
+MM_API mm_status mm_compare_ibsm( mm_compare* compare, const mm_model* modelA, const mm_image* const* texturesA,
+                                  size_t textureCountA, const mm_model* modelB, const mm_image* const* texturesB,
+                                  size_t textureCountB, const mm_ibsm_params* params, mm_ibsm_results* results );
+
+// equality of the models and textures, epsilon 0 for exact comparison
+// difference is 0 if equal, else 1 or, with epsilon > 0 and same sizes, the number of differences
+MM_API mm_status mm_compare_equ( mm_compare* compare, const mm_model* modelA, const mm_image* const* texturesA,
+                                 size_t textureCountA, const mm_model* modelB, const mm_image* const* texturesB,
+                                 size_t textureCountB, float epsilon, int earlyReturn, int unoriented,
+                                 int* difference );
+
+// equivalence of the topologies up to a face index shift, using the face and vertex map files
+// (see mm compare --mode topo), difference is 0 if equivalent
+// returns MM_ERROR_IO if a map file cannot be read or is invalid
+MM_API mm_status mm_compare_topo( mm_compare* compare, const mm_model* modelA, const mm_model* modelB,
+                                  const char* faceMapFilename, const char* vertexMapFilename, int* difference );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,541 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <string>
+#include <vector>
+#include <exception>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+
+// internal headers
+#include "mmModel.h"
+#include "mmImage.h"
+#include "mmSample.h"
+#include "mmCompare.h"
+#include "mmThreadPool.h"
+#include "mmVersion.h"
+// the exported interface
+#include "mmApi.h"
+
+// the handles wrap the objects of the library
+struct mm_model {
+  mm::ModelPtr model = mm::ModelPtr( new mm::Model() );
+};
+struct mm_image {
+  mm::ImagePtr image;
+};
+struct mm_compare {
+  mm::Compare compare;
+};
+
+static thread_local std::string s_lastError;
+static std::atomic<bool>        s_verbose( false );
+
+static mm_status fail( mm_status status, const std::string& message ) {
+  s_lastError = message;
+  return status;
+}
+
+// no exception can cross the C interface
+template <typename Function>
+static mm_status guard( const char* function, Function body ) {
+  s_lastError.clear();
+  try {
+    return body();
+  } catch ( const std::exception& e ) {
+    return fail( MM_ERROR_PROCESSING, std::string( function ) + ": " + e.what() );
+  } catch ( ... ) { return fail( MM_ERROR_PROCESSING, std::string( function ) + ": unknown exception" ); }
+}
+
+// copies count elements of n components, NULL or 0 clears the array
+template <typename T>
+static mm_status setArray( mm_model* model, std::vector<T> mm::Model::*array, const T* values, size_t count,
+                           size_t n, const char* function ) {
+  if ( model == NULL ) return fail( MM_ERROR_ARGUMENT, std::string( function ) + ": NULL model" );
+  return guard( function, [&] {
+    std::vector<T>& dst = ( *model->model ).*array;
+    if ( values == NULL || count == 0 ) {
+      dst.clear();
+    } else {
+      dst.assign( values, values + count * n );
+    }
+    return MM_OK;
+  } );
+}
+
+// true if the count * n indices are in [0, bound)
+static bool checkIndices( const int32_t* indices, size_t count, size_t n, size_t bound ) {
+  if ( indices == NULL ) return true;
+  for ( size_t i = 0; i < count * n; ++i ) {
+    if ( indices[i] < 0 || (size_t)indices[i] >= bound ) return false;
+  }
+  return true;
+}
+
+// the texture indices of the triangles must select one of the textures if any are given
+static mm_status checkTextureIndices( const mm_model* model, size_t textureCount, const char* function ) {
+  const std::vector<int>& matIdx = model->model->triangleMatIdx;
+  if ( textureCount != 0 && !checkIndices( matIdx.data(), matIdx.size(), 1, textureCount ) )
+    return fail( MM_ERROR_ARGUMENT, std::string( function ) + ": triangle texture index out of the texture range" );
+  return MM_OK;
+}
+
+// the images of the handles, NULL handles are rejected
+static bool getTextures( const mm_image* const* textures, size_t count, std::vector<mm::ImagePtr>& images ) {
+  if ( count != 0 && textures == NULL ) return false;
+  for ( size_t i = 0; i < count; ++i ) {
+    if ( textures[i] == NULL ) return false;
+    images.push_back( textures[i]->image );
+  }
+  return true;
+}
+
+// common checks of the compare functions
+static mm_status checkCompare( const mm_compare* compare, const mm_model* modelA, const mm_image* const* texturesA,
+                               size_t textureCountA, const mm_model* modelB, const mm_image* const* texturesB,
+                               size_t textureCountB, std::vector<mm::ImagePtr>& mapsA,
+                               std::vector<mm::ImagePtr>& mapsB, const char* function ) {
+  if ( compare == NULL || modelA == NULL || modelB == NULL )
+    return fail( MM_ERROR_ARGUMENT, std::string( function ) + ": NULL compare or model" );
+  if ( !getTextures( texturesA, textureCountA, mapsA ) || !getTextures( texturesB, textureCountB, mapsB ) )
+    return fail( MM_ERROR_ARGUMENT, std::string( function ) + ": NULL texture" );
+  const mm_status status = checkTextureIndices( modelA, textureCountA, function );
+  return status != MM_OK ? status : checkTextureIndices( modelB, textureCountB, function );
+}
+
+extern "C" {
+
+int mm_get_api_version( void ) { return MM_API_VERSION; }
+
+const char* mm_get_version( void ) { return MM_VERSION; }
+
+const char* mm_get_last_error( void ) { return s_lastError.c_str(); }
+
+mm_status mm_set_thread_count( size_t count ) {
+  return guard( "mm_set_thread_count", [&] {
+    mm::ThreadPool::setThreadCount( count );
+    return MM_OK;
+  } );
+}
+
+void mm_set_verbose( int verbose ) { s_verbose = verbose != 0; }
+
+// models
+
+mm_model* mm_model_create( void ) {
+  try {
+    return new mm_model();
+  } catch ( ... ) { return NULL; }
+}
+
+void mm_model_destroy( mm_model* model ) { delete model; }
+
+mm_status mm_model_set_positions( mm_model* model, const float* xyz, size_t count ) {
+  return setArray( model, &mm::Model::vertices, xyz, count, 3, "mm_model_set_positions" );
+}
+
+mm_status mm_model_set_normals( mm_model* model, const float* xyz, size_t count ) {
+  return setArray( model, &mm::Model::normals, xyz, count, 3, "mm_model_set_normals" );
+}
+
+mm_status mm_model_set_colors( mm_model* model, const float* rgb, size_t count ) {
+  return setArray( model, &mm::Model::colors, rgb, count, 3, "mm_model_set_colors" );
+}
+
+mm_status mm_model_set_uvs( mm_model* model, const float* uv, size_t count ) {
+  return setArray( model, &mm::Model::uvcoords, uv, count, 2, "mm_model_set_uvs" );
+}
+
+mm_status mm_model_set_triangles( mm_model* model, const int32_t* indices, size_t count ) {
+  if ( model != NULL && !checkIndices( indices, count, 3, model->model->getPositionCount() ) )
+    return fail( MM_ERROR_ARGUMENT, "mm_model_set_triangles: index out of the position range" );
+  const mm_status status = setArray<int>( model, &mm::Model::triangles, indices, count, 3, "mm_model_set_triangles" );
+  // the triangles use the first texture, as loaded from a file with a single material
+  if ( status == MM_OK ) return guard( "mm_model_set_triangles", [&] {
+      model->model->triangleMatIdx.assign( model->model->getTriangleCount(), 0 );
+      return MM_OK;
+    } );
+  return status;
+}
+
+mm_status mm_model_set_triangle_textures( mm_model* model, const int32_t* indices, size_t count ) {
+  if ( model != NULL && count != model->model->getTriangleCount() )
+    return fail( MM_ERROR_ARGUMENT, "mm_model_set_triangle_textures: count differs from the triangle count" );
+  // the texture count is only known by the processings, which check the upper bound
+  if ( !checkIndices( indices, count, 1, SIZE_MAX ) )
+    return fail( MM_ERROR_ARGUMENT, "mm_model_set_triangle_textures: negative index" );
+  return setArray<int>( model, &mm::Model::triangleMatIdx, indices, count, 1, "mm_model_set_triangle_textures" );
+}
+
+mm_status mm_model_set_triangle_uvs( mm_model* model, const int32_t* indices, size_t count ) {
+  if ( model != NULL && !checkIndices( indices, count, 3, model->model->getUvCount() ) )
+    return fail( MM_ERROR_ARGUMENT, "mm_model_set_triangle_uvs: index out of the uv range" );
+  return setArray<int>( model, &mm::Model::trianglesuv, indices, count, 3, "mm_model_set_triangle_uvs" );
+}
+
+size_t mm_model_get_position_count( const mm_model* model ) {
+  return model ? model->model->getPositionCount() : 0;
+}
+
+const float* mm_model_get_positions( const mm_model* model ) {
+  return model && !model->model->vertices.empty() ? model->model->vertices.data() : NULL;
+}
+
+size_t mm_model_get_normal_count( const mm_model* model ) { return model ? model->model->getNormalCount() : 0; }
+
+const float* mm_model_get_normals( const mm_model* model ) {
+  return model && !model->model->normals.empty() ? model->model->normals.data() : NULL;
+}
+
+size_t mm_model_get_color_count( const mm_model* model ) { return model ? model->model->getColorCount() : 0; }
+
+const float* mm_model_get_colors( const mm_model* model ) {
+  return model && !model->model->colors.empty() ? model->model->colors.data() : NULL;
+}
+
+size_t mm_model_get_uv_count( const mm_model* model ) { return model ? model->model->getUvCount() : 0; }
+
+const float* mm_model_get_uvs( const mm_model* model ) {
+  return model && !model->model->uvcoords.empty() ? model->model->uvcoords.data() : NULL;
+}
+
+size_t mm_model_get_triangle_count( const mm_model* model ) {
+  return model ? model->model->getTriangleCount() : 0;
+}
+
+const int32_t* mm_model_get_triangles( const mm_model* model ) {
+  return model && !model->model->triangles.empty() ? model->model->triangles.data() : NULL;
+}
+
+const int32_t* mm_model_get_triangle_uvs( const mm_model* model ) {
+  return model && !model->model->trianglesuv.empty() ? model->model->trianglesuv.data() : NULL;
+}
+
+// images
+
+mm_image* mm_image_create_view( const uint8_t* pixels, int width, int height, int components ) {
+  if ( pixels == NULL || width <= 0 || height <= 0 || components < 3 || components > 4 ) {
+    s_lastError = "mm_image_create_view: invalid pixels, size or component count (3 or 4)";
+    return NULL;
+  }
+  try {
+    mm_image* image = new mm_image();
+    // the processings only read the textures
+    image->image = mm::ImagePtr( new mm::Image( width, height, components, const_cast<uint8_t*>( pixels ) ) );
+    return image;
+  } catch ( ... ) { return NULL; }
+}
+
+void mm_image_destroy( mm_image* image ) { delete image; }
+
+// sampling
+
+void mm_sample_params_init( mm_sample_params* params ) {
+  if ( params == NULL ) return;
+  *params                 = mm_sample_params();
+  params->size            = sizeof( mm_sample_params );
+  params->mode            = MM_SAMPLE_FACE;
+  params->resolution      = 1024;
+  params->gridSize        = 1024;
+  params->maxDepth        = 100;
+  params->areaThreshold   = 1.0F;
+  params->nbSamples       = 2000000;
+  params->maxIterations   = 10;
+}
+
+mm_status mm_sample( const mm_model* input, const mm_image* const* textures, size_t textureCount,
+                     const mm_sample_params* params, mm_model* output ) {
+  std::vector<mm::ImagePtr> maps;
+  if ( input == NULL || output == NULL || params == NULL )
+    return fail( MM_ERROR_ARGUMENT, "mm_sample: NULL model or parameters" );
+  if ( params->size < sizeof( mm_sample_params ) )
+    return fail( MM_ERROR_INCOMPATIBLE, "mm_sample: unsupported parameters size" );
+  if ( !getTextures( textures, textureCount, maps ) ) return fail( MM_ERROR_ARGUMENT, "mm_sample: NULL texture" );
+  const mm_status status = checkTextureIndices( input, textureCount, "mm_sample" );
+  if ( status != MM_OK ) return status;
+  if ( !input->model->isMesh() ) return fail( MM_ERROR_ARGUMENT, "mm_sample: input is not a mesh" );
+  return guard( "mm_sample", [&] {
+    const mm::Model& in       = *input->model;
+    mm::Model        out;
+    const bool       bilinear = params->bilinear != 0;
+    const bool       count    = params->nbSamplesMin != 0;
+    size_t           computedResolution;
+    float            computedThres;
+    glm::vec3        minPos( params->minPos[0], params->minPos[1], params->minPos[2] );
+    glm::vec3        maxPos( params->maxPos[0], params->maxPos[1], params->maxPos[2] );
+    switch ( params->mode ) {
+      case MM_SAMPLE_FACE:
+        if ( count )
+          mm::Sample::meshToPcFace( in, out, maps, params->nbSamplesMin, params->nbSamplesMax, params->maxIterations,
+                                    params->thickness, bilinear, s_verbose, computedResolution );
+        else
+          mm::Sample::meshToPcFace( in, out, maps, params->resolution, params->thickness, bilinear, s_verbose );
+        break;
+      case MM_SAMPLE_GRID:
+        if ( count )
+          mm::Sample::meshToPcGrid( in, out, maps, params->nbSamplesMin, params->nbSamplesMax, params->maxIterations,
+                                    bilinear, s_verbose, params->useNormal != 0, params->useFixedPoint != 0, minPos,
+                                    maxPos, computedResolution );
+        else
+          mm::Sample::meshToPcGrid( in, out, maps, params->gridSize, bilinear, s_verbose, params->useNormal != 0,
+                                    params->useFixedPoint != 0, minPos, maxPos, s_verbose );
+        break;
+      case MM_SAMPLE_MAP: mm::Sample::meshToPcMap( in, out, maps, s_verbose ); break;
+      case MM_SAMPLE_SDIV:
+        if ( count )
+          mm::Sample::meshToPcDiv( in, out, maps, params->nbSamplesMin, params->nbSamplesMax, params->maxIterations,
+                                   bilinear, s_verbose, computedThres );
+        else
+          mm::Sample::meshToPcDiv( in, out, maps, params->maxDepth, params->areaThreshold,
+                                   params->mapThreshold != 0, bilinear, s_verbose );
+        break;
+      case MM_SAMPLE_EDIV:
+        if ( count )
+          mm::Sample::meshToPcDivEdge( in, out, maps, params->nbSamplesMin, params->nbSamplesMax,
+                                       params->maxIterations, bilinear, s_verbose, computedThres );
+        else
+          mm::Sample::meshToPcDivEdge( in, out, maps, params->lengthThreshold, params->resolution, bilinear, s_verbose,
+                                       computedThres );
+        break;
+      case MM_SAMPLE_PRND:
+        mm::Sample::meshToPcPrnd( in, out, maps, params->nbSamples, bilinear, s_verbose, nullptr, params->seed );
+        break;
+      default: return fail( MM_ERROR_ARGUMENT, "mm_sample: invalid mode" );
+    }
+    // the output may be the input
+    *output->model = std::move( out );
+    return MM_OK;
+  } );
+}
+
+// comparisons
+
+mm_compare* mm_compare_create( void ) {
+  try {
+    return new mm_compare();
+  } catch ( ... ) { return NULL; }
+}
+
+void mm_compare_destroy( mm_compare* compare ) { delete compare; }
+
+void mm_pcc_params_init( mm_pcc_params* params ) {
+  if ( params == NULL ) return;
+  // same defaults as mm compare
+  *params                              = mm_pcc_params();
+  params->size                         = sizeof( mm_pcc_params );
+  params->color                        = 1;
+  params->neighborsProc                = 1;
+  params->dropDuplicates               = 2;
+  params->averageNormals               = 1;
+  params->normalCalcModificationEnable = 1;
+}
+
+void mm_pcc_results_init( mm_pcc_results* results ) {
+  if ( results == NULL ) return;
+  *results      = mm_pcc_results();
+  results->size = sizeof( mm_pcc_results );
+}
+
+mm_status mm_compare_pcc( mm_compare* compare, const mm_model* modelA, const mm_image* const* texturesA,
+                          size_t textureCountA, const mm_model* modelB, const mm_image* const* texturesB,
+                          size_t textureCountB, const mm_pcc_params* params, mm_pcc_results* results ) {
+  std::vector<mm::ImagePtr> mapsA, mapsB;
+  mm_status status = checkCompare( compare, modelA, texturesA, textureCountA, modelB, texturesB, textureCountB, mapsA,
+                                   mapsB, "mm_compare_pcc" );
+  if ( status != MM_OK ) return status;
+  if ( params == NULL || results == NULL ) return fail( MM_ERROR_ARGUMENT, "mm_compare_pcc: NULL parameters or results" );
+  if ( params->size < sizeof( mm_pcc_params ) || results->size < sizeof( mm_pcc_results ) )
+    return fail( MM_ERROR_INCOMPATIBLE, "mm_compare_pcc: unsupported parameters or results size" );
+  return guard( "mm_compare_pcc", [&] {
+    pcc_quality::commandPar pccParams;
+    pccParams.singlePass                   = params->singlePass != 0;
+    pccParams.hausdorff                    = params->hausdorff != 0;
+    pccParams.bColor                       = params->color != 0;
+    pccParams.bLidar                       = false;
+    pccParams.resolution                   = params->resolution;
+    pccParams.neighborsProc                = params->neighborsProc;
+    pccParams.dropDuplicates               = params->dropDuplicates;
+    pccParams.bAverageNormals              = params->averageNormals != 0;
+    pccParams.normalCalcModificationEnable = params->normalCalcModificationEnable != 0;
+    mm::Model outputA, outputB;
+    if ( compare->compare.pcc( *modelA->model, *modelB->model, mapsA, mapsB, pccParams, outputA, outputB,
+                               s_verbose ) != 0 )
+      return fail( MM_ERROR_PROCESSING, "mm_compare_pcc: metric computation failed" );
+    const pcc_quality::qMetric& qm = compare->compare.getPccResults().second;
+    results->c2c_mse               = qm.c2c_mse;
+    results->c2c_hausdorff         = qm.c2c_hausdorff;
+    results->c2p_mse               = qm.c2p_mse;
+    results->c2p_hausdorff         = qm.c2p_hausdorff;
+    results->c2c_psnr              = qm.c2c_psnr;
+    results->c2c_hausdorff_psnr    = qm.c2c_hausdorff_psnr;
+    results->c2p_psnr              = qm.c2p_psnr;
+    results->c2p_hausdorff_psnr    = qm.c2p_hausdorff_psnr;
+    for ( size_t c = 0; c < 3; ++c ) {
+      results->color_mse[c]                = qm.color_mse[c];
+      results->color_rgb_hausdorff[c]      = qm.color_rgb_hausdorff[c];
+      results->color_psnr[c]               = qm.color_psnr[c];
+      results->color_rgb_hausdorff_psnr[c] = qm.color_rgb_hausdorff_psnr[c];
+    }
+    results->resolution = pccParams.resolution;
+    return MM_OK;
+  } );
+}
+
+void mm_pcqm_params_init( mm_pcqm_params* params ) {
+  if ( params == NULL ) return;
+  *params                    = mm_pcqm_params();
+  params->size               = sizeof( mm_pcqm_params );
+  params->radiusCurvature    = 0.001;
+  params->thresholdKnnSearch = 20;
+  params->radiusFactor       = 2.0;
+}
+
+void mm_pcqm_results_init( mm_pcqm_results* results ) {
+  if ( results == NULL ) return;
+  *results      = mm_pcqm_results();
+  results->size = sizeof( mm_pcqm_results );
+}
+
+mm_status mm_compare_pcqm( mm_compare* compare, const mm_model* modelA, const mm_image* const* texturesA,
+                           size_t textureCountA, const mm_model* modelB, const mm_image* const* texturesB,
+                           size_t textureCountB, const mm_pcqm_params* params, mm_pcqm_results* results ) {
+  std::vector<mm::ImagePtr> mapsA, mapsB;
+  mm_status status = checkCompare( compare, modelA, texturesA, textureCountA, modelB, texturesB, textureCountB, mapsA,
+                                   mapsB, "mm_compare_pcqm" );
+  if ( status != MM_OK ) return status;
+  if ( params == NULL || results == NULL )
+    return fail( MM_ERROR_ARGUMENT, "mm_compare_pcqm: NULL parameters or results" );
+  if ( params->size < sizeof( mm_pcqm_params ) || results->size < sizeof( mm_pcqm_results ) )
+    return fail( MM_ERROR_INCOMPATIBLE, "mm_compare_pcqm: unsupported parameters or results size" );
+  return guard( "mm_compare_pcqm", [&] {
+    mm::ModelPtr outputA( new mm::Model() ), outputB( new mm::Model() );
+    if ( compare->compare.pcqm( modelA->model, modelB->model, mapsA, mapsB, params->radiusCurvature,
+                                params->thresholdKnnSearch, params->radiusFactor, outputA, outputB, s_verbose ) != 0 )
+      return fail( MM_ERROR_PROCESSING, "mm_compare_pcqm: metric computation failed" );
+    const auto& res    = compare->compare.getPcqmResults();
+    results->pcqm      = std::get<1>( res );
+    results->pcqm_psnr = std::get<2>( res );
+    return MM_OK;
+  } );
+}
+
+void mm_ibsm_params_init( mm_ibsm_params* params ) {
+  if ( params == NULL ) return;
+  *params              = mm_ibsm_params();
+  params->size         = sizeof( mm_ibsm_params );
+  params->resolution   = 2048;
+  params->cameraCount  = 16;
+  params->renderer     = "sw_raster";
+}
+
+void mm_ibsm_results_init( mm_ibsm_results* results ) {
+  if ( results == NULL ) return;
+  *results      = mm_ibsm_results();
+  results->size = sizeof( mm_ibsm_results );
+}
+
+mm_status mm_compare_ibsm( mm_compare* compare, const mm_model* modelA, const mm_image* const* texturesA,
+                           size_t textureCountA, const mm_model* modelB, const mm_image* const* texturesB,
+                           size_t textureCountB, const mm_ibsm_params* params, mm_ibsm_results* results ) {
+  std::vector<mm::ImagePtr> mapsA, mapsB;
+  mm_status status = checkCompare( compare, modelA, texturesA, textureCountA, modelB, texturesB, textureCountB, mapsA,
+                                   mapsB, "mm_compare_ibsm" );
+  if ( status != MM_OK ) return status;
+  if ( params == NULL || results == NULL )
+    return fail( MM_ERROR_ARGUMENT, "mm_compare_ibsm: NULL parameters or results" );
+  if ( params->size < sizeof( mm_ibsm_params ) || results->size < sizeof( mm_ibsm_results ) )
+    return fail( MM_ERROR_INCOMPATIBLE, "mm_compare_ibsm: unsupported parameters or results size" );
+  const std::string renderer = params->renderer ? params->renderer : "sw_raster";
+  if ( renderer != "sw_raster" && renderer != "gl12_raster" )
+    return fail( MM_ERROR_ARGUMENT, "mm_compare_ibsm: invalid renderer " + renderer );
+  return guard( "mm_compare_ibsm", [&] {
+    mm::ModelPtr    outputA( new mm::Model() ), outputB( new mm::Model() );
+    const glm::vec3 rotation( params->cameraRotation[0], params->cameraRotation[1], params->cameraRotation[2] );
+    if ( compare->compare.ibsm( modelA->model, modelB->model, mapsA, mapsB, params->disableReordering != 0, params->resolution,
+                                params->cameraCount, rotation, renderer, "", params->disableCulling != 0, outputA,
+                                outputB, s_verbose ) != 0 )
+      return fail( MM_ERROR_PROCESSING, "mm_compare_ibsm: metric computation failed" );
+    const mm::Compare::IbsmResults& res = compare->compare.getIbsmResults().second;
+    for ( size_t c = 0; c < 4; ++c ) {
+      results->rgbMSE[c]  = res.rgbMSE[c];
+      results->rgbPSNR[c] = res.rgbPSNR[c];
+      results->yuvMSE[c]  = res.yuvMSE[c];
+      results->yuvPSNR[c] = res.yuvPSNR[c];
+    }
+    results->depthMSE                 = res.depthMSE;
+    results->depthPSNR                = res.depthPSNR;
+    results->boxRatio                 = res.boxRatio;
+    results->unmatchedPixelPercentage = res.unmatchedPixelPercentage;
+    return MM_OK;
+  } );
+}
+
+mm_status mm_compare_equ( mm_compare* compare, const mm_model* modelA, const mm_image* const* texturesA,
+                          size_t textureCountA, const mm_model* modelB, const mm_image* const* texturesB,
+                          size_t textureCountB, float epsilon, int earlyReturn, int unoriented, int* difference ) {
+  std::vector<mm::ImagePtr> mapsA, mapsB;
+  mm_status status = checkCompare( compare, modelA, texturesA, textureCountA, modelB, texturesB, textureCountB, mapsA,
+                                   mapsB, "mm_compare_equ" );
+  if ( status != MM_OK ) return status;
+  if ( difference == NULL ) return fail( MM_ERROR_ARGUMENT, "mm_compare_equ: NULL difference" );
+  return guard( "mm_compare_equ", [&] {
+    mm::Model outputA, outputB;
+    *difference = compare->compare.equ( *modelA->model, *modelB->model, mapsA, mapsB, epsilon, earlyReturn != 0,
+                                        unoriented != 0, outputA, outputB );
+    return MM_OK;
+  } );
+}
+
+mm_status mm_compare_topo( mm_compare* compare, const mm_model* modelA, const mm_model* modelB,
+                           const char* faceMapFilename, const char* vertexMapFilename, int* difference ) {
+  if ( compare == NULL || modelA == NULL || modelB == NULL || difference == NULL )
+    return fail( MM_ERROR_ARGUMENT, "mm_compare_topo: NULL compare, model or difference" );
+  const std::string faceMap   = faceMapFilename ? faceMapFilename : "";
+  const std::string vertexMap = vertexMapFilename ? vertexMapFilename : "";
+  for ( const auto& filename : { faceMap, vertexMap } ) {
+    if ( !std::ifstream( filename ) ) return fail( MM_ERROR_IO, "mm_compare_topo: cannot read map file " + filename );
+  }
+  return guard( "mm_compare_topo", [&] {
+    // topo returns 1 when the topologies are equivalent, 0 when they differ, -1 on invalid map files
+    const int equivalent = compare->compare.topo( *modelA->model, *modelB->model, faceMap, vertexMap );
+    if ( equivalent < 0 )
+      return fail( MM_ERROR_IO, "mm_compare_topo: invalid map file " + faceMap + " or " + vertexMap );
+    *difference = equivalent ? 0 : 1;
+    return MM_OK;
+  } );
+}
+
+}  // extern "C"
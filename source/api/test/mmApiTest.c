@@ -0,0 +1,259 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// checks the C interface of the mmapi library on the test data sets
+// usage: mmapitest dataDirectory, prints "Error: ..." and returns 1 on failure
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "mmApi.h"
+
+static int s_failures = 0;
+
+#define CHECK( condition, message )                                                          \
+  do {                                                                                       \
+    if ( !( condition ) ) {                                                                  \
+      printf( "Error: %s (%s:%d) %s\n", message, __FILE__, __LINE__, mm_get_last_error() ); \
+      s_failures++;                                                                          \
+    }                                                                                        \
+  } while ( 0 )
+
+// growing arrays of the obj reader
+typedef struct {
+  float* data;
+  size_t size, capacity;
+} FloatArray;
+typedef struct {
+  int32_t* data;
+  size_t   size, capacity;
+} IntArray;
+
+static void pushFloat( FloatArray* array, float value ) {
+  if ( array->size == array->capacity ) {
+    array->capacity = array->capacity ? array->capacity * 2 : 64;
+    array->data     = (float*)realloc( array->data, array->capacity * sizeof( float ) );
+  }
+  array->data[array->size++] = value;
+}
+
+static void pushInt( IntArray* array, int32_t value ) {
+  if ( array->size == array->capacity ) {
+    array->capacity = array->capacity ? array->capacity * 2 : 64;
+    array->data     = (int32_t*)realloc( array->data, array->capacity * sizeof( int32_t ) );
+  }
+  array->data[array->size++] = value;
+}
+
+// reads the positions, uvs and triangles "f v/vt v/vt v/vt" of an obj file into a new model
+static mm_model* loadObj( const char* filename ) {
+  FILE* file = fopen( filename, "r" );
+  if ( file == NULL ) return NULL;
+  FloatArray positions = { 0 }, uvs = { 0 };
+  IntArray   triangles = { 0 }, triangleUvs = { 0 };
+  char       line[1024];
+  while ( fgets( line, sizeof( line ), file ) ) {
+    float x, y, z;
+    int   v[3], t[3];
+    if ( sscanf( line, "v %f %f %f", &x, &y, &z ) == 3 ) {
+      pushFloat( &positions, x );
+      pushFloat( &positions, y );
+      pushFloat( &positions, z );
+    } else if ( sscanf( line, "vt %f %f", &x, &y ) == 2 ) {
+      pushFloat( &uvs, x );
+      pushFloat( &uvs, y );
+    } else if ( sscanf( line, "f %d/%d %d/%d %d/%d", &v[0], &t[0], &v[1], &t[1], &v[2], &t[2] ) == 6 ) {
+      for ( int i = 0; i < 3; ++i ) {
+        pushInt( &triangles, v[i] - 1 );
+        pushInt( &triangleUvs, t[i] - 1 );
+      }
+    }
+  }
+  fclose( file );
+  mm_model* model = mm_model_create();
+  if ( model != NULL ) {
+    mm_model_set_positions( model, positions.data, positions.size / 3 );
+    mm_model_set_uvs( model, uvs.data, uvs.size / 2 );
+    mm_model_set_triangles( model, triangles.data, triangles.size / 3 );
+    mm_model_set_triangle_uvs( model, triangleUvs.data, triangleUvs.size / 3 );
+  }
+  free( positions.data );
+  free( uvs.data );
+  free( triangles.data );
+  free( triangleUvs.data );
+  return model;
+}
+
+int main( int argc, char* argv[] ) {
+  if ( argc < 2 ) {
+    printf( "Usage: %s dataDirectory\n", argv[0] );
+    return 1;
+  }
+  char path[1024];
+
+  CHECK( mm_get_api_version() == MM_API_VERSION, "unexpected api version" );
+  printf( "mmapi version %s, api %d\n", mm_get_version(), mm_get_api_version() );
+
+  // the plane and the shifted plane (same topology, shifted face and vertex indices)
+  snprintf( path, sizeof( path ), "%s/plane.obj", argv[1] );
+  mm_model* plane = loadObj( path );
+  snprintf( path, sizeof( path ), "%s/plane_shifted.obj", argv[1] );
+  mm_model* shifted = loadObj( path );
+  if ( plane == NULL || shifted == NULL ) {
+    printf( "Error: cannot load the models from %s\n", argv[1] );
+    return 1;
+  }
+  printf( "Loaded plane, %zu positions, %zu triangles\n", mm_model_get_position_count( plane ),
+          mm_model_get_triangle_count( plane ) );
+  CHECK( mm_model_get_position_count( plane ) == 5 && mm_model_get_triangle_count( plane ) == 4,
+         "unexpected plane size" );
+
+  // the texture is a view of pixels kept by the caller
+  int width, height, components;
+  snprintf( path, sizeof( path ), "%s/plane_10_10.png", argv[1] );
+  uint8_t* pixels = stbi_load( path, &width, &height, &components, 3 );
+  if ( pixels == NULL ) {
+    printf( "Error: cannot load the texture %s\n", path );
+    return 1;
+  }
+  const size_t pixelBytes = (size_t)width * height * 3;
+  uint8_t*     copy       = (uint8_t*)malloc( pixelBytes );
+  memcpy( copy, pixels, pixelBytes );
+  mm_image* texture = mm_image_create_view( pixels, width, height, 3 );
+  CHECK( texture != NULL, "mm_image_create_view failed" );
+  CHECK( mm_image_create_view( NULL, width, height, 3 ) == NULL, "mm_image_create_view accepted NULL pixels" );
+
+  // grid sampling, same as mm sample --mode grid --gridSize 10 (see refs/sample_grid_plane_10_nearest_10_10.ply)
+  mm_sample_params sampleParams;
+  mm_sample_params_init( &sampleParams );
+  sampleParams.mode     = MM_SAMPLE_GRID;
+  sampleParams.gridSize = 10;
+  mm_model*       points      = mm_model_create();
+  const mm_image* textures[1] = { texture };
+  CHECK( mm_sample( plane, textures, 1, &sampleParams, points ) == MM_OK, "mm_sample failed" );
+  const size_t pointCount = mm_model_get_position_count( points );
+  printf( "Sampled %zu points\n", pointCount );
+  CHECK( pointCount == 100, "unexpected point count" );
+  CHECK( mm_model_get_color_count( points ) == pointCount, "unexpected color count" );
+  CHECK( mm_model_get_triangle_count( points ) == 0, "sampled model is not a point cloud" );
+  if ( pointCount == 100 && mm_model_get_color_count( points ) == pointCount ) {
+    const float* xyz = mm_model_get_positions( points );
+    const float* rgb = mm_model_get_colors( points );
+    printf( "First point %g %g %g color %g %g %g\n", xyz[0], xyz[1], xyz[2], rgb[0], rgb[1], rgb[2] );
+    CHECK( xyz[0] == -5.0F && xyz[1] == -5.0F && xyz[2] == 0.0F, "unexpected first point position" );
+    CHECK( rgb[0] == 0.0F && rgb[1] == 162.0F && rgb[2] == 232.0F, "unexpected first point color" );
+  }
+
+  // out of range indices are rejected and the model is unchanged
+  mm_model* invalid = mm_model_create();
+  CHECK( invalid != NULL, "mm_model_create failed" );
+  const float   xyz[9]    = { 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F };
+  const float   uv[6]     = { 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 1.0F };
+  const int32_t valid[3]  = { 0, 1, 2 };
+  const int32_t beyond[3] = { 0, 1, 3 };
+  const int32_t negative  = -1;
+  mm_model_set_positions( invalid, xyz, 3 );
+  mm_model_set_uvs( invalid, uv, 3 );
+  CHECK( mm_model_set_triangles( invalid, beyond, 1 ) == MM_ERROR_ARGUMENT, "out of range position index accepted" );
+  CHECK( mm_model_get_triangle_count( invalid ) == 0, "model modified by invalid triangles" );
+  CHECK( mm_model_set_triangles( invalid, valid, 1 ) == MM_OK, "mm_model_set_triangles failed" );
+  CHECK( mm_model_set_triangle_uvs( invalid, beyond, 1 ) == MM_ERROR_ARGUMENT, "out of range uv index accepted" );
+  CHECK( mm_model_set_triangle_uvs( invalid, valid, 1 ) == MM_OK, "mm_model_set_triangle_uvs failed" );
+  CHECK( mm_model_set_triangle_textures( invalid, &negative, 1 ) == MM_ERROR_ARGUMENT,
+         "negative texture index accepted" );
+  CHECK( mm_model_set_triangle_textures( invalid, &valid[1], 1 ) == MM_OK, "mm_model_set_triangle_textures failed" );
+  CHECK( mm_sample( invalid, textures, 1, &sampleParams, points ) == MM_ERROR_ARGUMENT,
+         "texture index beyond the texture count accepted" );
+  mm_model_destroy( invalid );
+
+  // the view neither copies nor modifies the pixels, destroying it keeps them
+  mm_image_destroy( texture );
+  CHECK( memcmp( pixels, copy, pixelBytes ) == 0, "texture pixels modified" );
+  stbi_image_free( pixels );
+  free( copy );
+
+  // status codes of invalid calls
+  CHECK( mm_sample( NULL, NULL, 0, &sampleParams, points ) == MM_ERROR_ARGUMENT, "NULL input accepted" );
+  CHECK( strlen( mm_get_last_error() ) != 0, "missing error message" );
+  sampleParams.size = 1;
+  CHECK( mm_sample( plane, NULL, 0, &sampleParams, points ) == MM_ERROR_INCOMPATIBLE, "invalid size accepted" );
+
+  mm_compare* compare = mm_compare_create();
+  CHECK( compare != NULL, "mm_compare_create failed" );
+
+  // a model equals itself
+  int difference = -1;
+  CHECK( mm_compare_equ( compare, points, NULL, 0, points, NULL, 0, 0.0F, 1, 0, &difference ) == MM_OK,
+         "mm_compare_equ failed" );
+  printf( "Equality difference %d\n", difference );
+  CHECK( difference == 0, "model differs from itself" );
+
+  // pcc of a point cloud with itself has no geometry error
+  mm_pcc_params  pccParams;
+  mm_pcc_results pccResults;
+  mm_pcc_params_init( &pccParams );
+  mm_pcc_results_init( &pccResults );
+  CHECK( mm_compare_pcc( compare, points, NULL, 0, points, NULL, 0, &pccParams, &pccResults ) == MM_OK,
+         "mm_compare_pcc failed" );
+  printf( "PCC c2c mse %g, c2p mse %g\n", pccResults.c2c_mse, pccResults.c2p_mse );
+  CHECK( pccResults.c2c_mse == 0.0 && pccResults.c2p_mse == 0.0, "unexpected pcc mse" );
+  CHECK( fabs( pccResults.resolution - sqrt( 200.0 ) ) < 1e-4, "unexpected pcc resolution" );
+
+  // topology of the shifted plane, then missing map files
+  char faceMap[1024], vertexMap[1024];
+  snprintf( faceMap, sizeof( faceMap ), "%s/plane_shifted_topo_face.txt", argv[1] );
+  snprintf( vertexMap, sizeof( vertexMap ), "%s/plane_shifted_topo_vert.txt", argv[1] );
+  difference = -1;
+  CHECK( mm_compare_topo( compare, plane, shifted, faceMap, vertexMap, &difference ) == MM_OK,
+         "mm_compare_topo failed" );
+  printf( "Topology difference %d\n", difference );
+  CHECK( difference == 0, "shifted plane topology differs" );
+  snprintf( faceMap, sizeof( faceMap ), "%s/missing_topo_face.txt", argv[1] );
+  CHECK( mm_compare_topo( compare, plane, shifted, faceMap, vertexMap, &difference ) == MM_ERROR_IO,
+         "missing map file not reported" );
+
+  mm_compare_destroy( compare );
+  mm_model_destroy( points );
+  mm_model_destroy( shifted );
+  mm_model_destroy( plane );
+
+  printf( "%s\n", s_failures == 0 ? "All api checks passed" : "Some api checks failed" );
+  return s_failures == 0 ? 0 : 1;
+}
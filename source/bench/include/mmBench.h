@@ -0,0 +1,93 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MM_BENCH_H_
+#define _MM_BENCH_H_
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace mm {
+
+// Minimal benchmark harness of mmbench.
+// Each case is run warmup times untimed then repetitions times timed (wall clock),
+// its optional setup being executed before each run out of the timing.
+class Bench {
+ public:
+  struct Case {
+    std::string           name;
+    std::function<void()> setup;
+    std::function<void()> run;
+  };
+
+  struct Result {
+    std::string         name;
+    std::vector<double> samples;  // seconds
+    double              min    = 0;
+    double              median = 0;
+    double              mean   = 0;
+    double              max    = 0;
+    double              stddev = 0;
+  };
+
+  // registers a case, names are "group/case"
+  void add( const std::string& name, std::function<void()> run, std::function<void()> setup = nullptr );
+
+  // prints the names of the registered cases
+  void list( std::ostream& out ) const;
+
+  // runs the cases whose name contains filter (all if empty),
+  // the standard output of the cases is muted unless verbose
+  void run( const std::string& filter, size_t warmup, size_t repetitions, bool verbose );
+
+  // prints the results as a table in milliseconds
+  void print( std::ostream& out ) const;
+
+  // saves the results in JSON format, info is a list of (key, value) added to the header
+  bool save( const std::string&                                      filename,
+             const std::vector<std::pair<std::string, std::string>>& info ) const;
+
+  const std::vector<Result>& getResults( void ) const { return _results; }
+
+ private:
+  std::vector<Case>   _cases;
+  std::vector<Result> _results;
+};
+
+}  // namespace mm
+
+#endif
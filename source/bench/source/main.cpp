@@ -0,0 +1,401 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+//
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+// internal headers
+#include "dmetric/source/pcc_processing.hpp"
+#include "mmBench.h"
+#include "mmCompare.h"
+#include "mmContext.h"
+#include "mmIO.h"
+#include "mmImage.h"
+#include "mmModel.h"
+#include "mmRendererSw.h"
+#include "mmSample.h"
+#include "mmThreadPool.h"
+#include "mmTrace.h"
+#include "mmVersion.h"
+
+// the name of the application binary
+#ifdef _WIN32
+#  define APP_NAME "mmbench.exe"
+#else
+#  define APP_NAME "mmbench"
+#endif
+
+// synthetic height field of size x size vertices over [0,512]^2 with per vertex uv
+static void makeMesh( size_t size, mm::Model& output ) {
+  output.reset();
+  const float extent = 512.0F;
+  for ( size_t j = 0; j < size; ++j ) {
+    for ( size_t i = 0; i < size; ++i ) {
+      const float u = (float)i / (float)( size - 1 );
+      const float v = (float)j / (float)( size - 1 );
+      output.vertices.push_back( u * extent );
+      output.vertices.push_back( v * extent );
+      output.vertices.push_back( 32.0F * std::sin( 6.0F * u ) * std::cos( 6.0F * v ) );
+      output.uvcoords.push_back( u );
+      output.uvcoords.push_back( v );
+    }
+  }
+  for ( size_t j = 0; j + 1 < size; ++j ) {
+    for ( size_t i = 0; i + 1 < size; ++i ) {
+      const int i0 = (int)( j * size + i );
+      const int i1 = i0 + 1;
+      const int i2 = i0 + 1 + (int)size;
+      const int i3 = i0 + (int)size;
+      const int tris[6] = { i0, i1, i2, i0, i2, i3 };
+      output.triangles.insert( output.triangles.end(), tris, tris + 6 );
+      output.trianglesuv.insert( output.trianglesuv.end(), tris, tris + 6 );
+    }
+  }
+  // single material, as set by the loaders when no material library is given
+  output.triangleMatIdx.assign( output.triangles.size() / 3, 0 );
+  output.materialNames.push_back( "material0000" );
+}
+
+// synthetic texture map, color gradient with a checker pattern
+static void makeMap( int size, mm::Image& output ) {
+  output.reset( size, size );
+  for ( int y = 0; y < size; ++y ) {
+    for ( int x = 0; x < size; ++x ) {
+      const bool     checker = ( ( x / 32 ) + ( y / 32 ) ) % 2 == 0;
+      unsigned char* pixel   = output.data + ( (size_t)y * size + x ) * 3;
+      pixel[0]               = (unsigned char)( x * 255 / size );
+      pixel[1]               = (unsigned char)( y * 255 / size );
+      pixel[2]               = checker ? 224 : 32;
+    }
+  }
+}
+
+// distorted version of the input, positions are quantized
+static void quantize( const mm::Model& input, float step, mm::Model& output ) {
+  output = input;
+  for ( auto& value : output.vertices ) value = std::round( value / step ) * step;
+}
+
+int main( int argc, char* argv[] ) {
+  // this is mandatory to print floats with full precision
+  std::cout.precision( std::numeric_limits<float>::max_digits10 );
+
+  std::string filter;
+  size_t      repetitions = 5;
+  size_t      warmup      = 1;
+  size_t      size        = 128;
+  size_t      threads     = 0;
+  bool        verbose     = false;
+  std::string jsonFilename;
+  std::string inputModelFilename;
+  std::string inputMapFilename;
+  std::string tmpDir;
+
+  // command line parameters
+  try {
+    cxxopts::Options options( APP_NAME, "Benchmarks of the mm library processings" );
+    // clang-format off
+    options.add_options()
+      ( "filter", "runs only the benchmarks whose name contains the given string",
+        cxxopts::value<std::string>()->default_value( "" ) )
+      ( "repetitions", "number of timed runs per benchmark",
+        cxxopts::value<size_t>()->default_value( "5" ) )
+      ( "warmup", "number of untimed runs per benchmark before the timed ones",
+        cxxopts::value<size_t>()->default_value( "1" ) )
+      ( "size", "side size in vertices of the synthetic mesh",
+        cxxopts::value<size_t>()->default_value( "128" ) )
+      ( "inputModel", "path to an input mesh (obj or ply) used instead of the synthetic one",
+        cxxopts::value<std::string>() )
+      ( "inputMap", "path to the texture map of inputModel, a synthetic one is used otherwise",
+        cxxopts::value<std::string>() )
+      ( "threads", "number of threads, 0 for all the cores",
+        cxxopts::value<size_t>() )
+      ( "json", "saves the results in JSON format to the given file",
+        cxxopts::value<std::string>() )
+      ( "tmpDir", "directory of the temporary files, system temporary directory by default",
+        cxxopts::value<std::string>() )
+      ( "list", "prints the benchmark names and exits" )
+      ( "verbose", "prints the processings log" )
+      ( "h,help", "Print usage" )
+      ;
+    // clang-format on
+
+    auto result = options.parse( argc, argv );
+    if ( result.count( "help" ) ) {
+      std::cout << options.help() << std::endl;
+      return 0;
+    }
+    filter      = result["filter"].as<std::string>();
+    repetitions = result["repetitions"].as<size_t>();
+    warmup      = result["warmup"].as<size_t>();
+    size        = result["size"].as<size_t>();
+    verbose     = result.count( "verbose" ) != 0;
+    if ( result.count( "inputModel" ) ) inputModelFilename = result["inputModel"].as<std::string>();
+    if ( result.count( "inputMap" ) ) inputMapFilename = result["inputMap"].as<std::string>();
+    if ( result.count( "json" ) ) jsonFilename = result["json"].as<std::string>();
+    if ( result.count( "tmpDir" ) ) tmpDir = result["tmpDir"].as<std::string>();
+    else tmpDir = std::filesystem::temp_directory_path().string();
+    if ( result.count( "threads" ) ) {
+      threads = result["threads"].as<size_t>();
+      mm::ThreadPool::setThreadCount( threads );
+    }
+    if ( size < 2 ) {
+      std::cerr << "Error: --size must be greater than 1" << std::endl;
+      return 1;
+    }
+    if ( repetitions == 0 ) {
+      std::cerr << "Error: --repetitions must be greater than 0" << std::endl;
+      return 1;
+    }
+
+    // the inputs
+    Context context;
+    mm::IO::setContext( &context );
+    mm::ModelPtr model( new mm::Model() );
+    mm::ImagePtr map( new mm::Image() );
+    if ( inputModelFilename.empty() ) {
+      makeMesh( size, *model );
+    } else {
+      mm::ModelPtr input = mm::IO::loadModel( inputModelFilename );
+      if ( !input || !input->isMesh() ) {
+        std::cerr << "Error: invalid input mesh " << inputModelFilename << std::endl;
+        return 1;
+      }
+      *model = *input;
+    }
+    if ( inputMapFilename.empty() ) {
+      makeMap( 1024, *map );
+    } else {
+      mm::ImagePtr input = mm::IO::loadImage( inputMapFilename );
+      if ( !input ) return 1;
+      map = input;
+    }
+    mm::IO::purge();
+    const std::vector<mm::ImagePtr> maps = { map };
+
+    // distorted model for the comparisons, quantized to 1/1000 of the bounding box
+    glm::vec3 minBox, maxBox;
+    mm::Geometry::computeBBox( model->vertices, minBox, maxBox );
+    const float  step = glm::length( maxBox - minBox ) / 1000.0F;
+    mm::ModelPtr distorted( new mm::Model() );
+    quantize( *model, step, *distorted );
+
+    // temporary files of the io benchmarks
+    const std::string objFilename = ( std::filesystem::path( tmpDir ) / "mmbench.obj" ).string();
+    const std::string plyFilename = ( std::filesystem::path( tmpDir ) / "mmbench.ply" ).string();
+
+    // the benchmarks
+    mm::Bench    bench;
+    mm::Model    output;
+    mm::ModelPtr outputA( new mm::Model() );
+    mm::ModelPtr outputB( new mm::Model() );
+    auto         purge = [] { mm::IO::purge(); };
+
+    bench.add( "io/load_obj", [&] { mm::IO::loadModel( objFilename ); }, purge );
+    bench.add( "io/load_ply", [&] { mm::IO::loadModel( plyFilename ); }, purge );
+    bench.add( "io/load_obj_positions", [&] { mm::IO::loadModel( objFilename, mm::IO::POSITIONS ); }, purge );
+    bench.add( "io/save_obj", [&] { mm::IO::saveModel( objFilename, model ); }, purge );
+    bench.add( "io/save_ply", [&] { mm::IO::saveModel( plyFilename, model ); }, purge );
+
+    bench.add( "model/builder_push_vertex", [&] {
+      output.reset();
+      mm::ModelBuilder builder( output );
+      mm::Vertex       vertex;
+      vertex.hasUVCoord = model->hasUvCoords();
+      // each vertex is pushed twice, the second push is a duplicate
+      for ( size_t pass = 0; pass < 2; ++pass ) {
+        for ( size_t i = 0; i < model->getPositionCount(); ++i ) {
+          vertex.pos = glm::make_vec3( &model->vertices[i * 3] );
+          if ( vertex.hasUVCoord ) vertex.uv = glm::make_vec2( &model->uvcoords[( i % model->getUvCount() ) * 2] );
+          builder.pushVertex( vertex );
+        }
+      }
+    } );
+    bench.add( "model/reorder", [&] { mm::reorder( *model, "oriented", output ); } );
+    bench.add(
+      "model/compute_vertex_normals",
+      [&] { output.computeVertexNormals( true, true ); },
+      [&] {
+        output = *model;
+        output.normals.clear();
+      } );
+
+    bench.add( "sample/face", [&] {
+      output.reset();
+      mm::Sample::meshToPcFace( *model, output, maps, 1024, 0.0F, true, false );
+    } );
+    bench.add( "sample/grid", [&] {
+      output.reset();
+      glm::vec3 minPos( 0.0F ), maxPos( 0.0F );
+      mm::Sample::meshToPcGrid( *model, output, maps, 1024, true, false, false, false, minPos, maxPos, false );
+    } );
+    // the map sampling walks the texture through the uv coordinates
+    if ( model->hasUvCoords() ) {
+      bench.add( "sample/map", [&] {
+        output.reset();
+        mm::Sample::meshToPcMap( *model, output, maps, false );
+      } );
+    } else {
+      std::cout << "Skipping sample/map, the input model has no uv coordinates" << std::endl;
+    }
+    bench.add( "sample/sdiv", [&] {
+      output.reset();
+      mm::Sample::meshToPcDiv( *model, output, maps, 100, 1.0F, false, true, false );
+    } );
+    bench.add( "sample/ediv", [&] {
+      output.reset();
+      float computedThres = 0.0F;
+      mm::Sample::meshToPcDivEdge( *model, output, maps, 0.0F, 1024, true, false, computedThres );
+    } );
+    bench.add( "sample/prnd", [&] {
+      output.reset();
+      mm::Sample::meshToPcPrnd( *model, output, maps, 500000, true, false );
+    } );
+
+    bench.add( "compare/pcc", [&] {
+      mm::Compare             compare;
+      pcc_quality::commandPar params;
+      params.singlePass      = false;
+      params.hausdorff       = false;
+      params.bColor          = true;
+      params.bLidar          = false;
+      params.resolution      = 0.0;
+      params.neighborsProc   = 1;
+      params.dropDuplicates  = 2;
+      params.bAverageNormals = true;
+      params.normalCalcModificationEnable = true;
+      compare.pcc( *model, *distorted, maps, maps, params, *outputA, *outputB, false );
+    } );
+    bench.add( "compare/pcqm", [&] {
+      mm::Compare compare;
+      compare.pcqm( model, distorted, maps, maps, 0.001, 20, 2.0, outputA, outputB, false );
+    } );
+    bench.add( "compare/ibsm", [&] {
+      mm::Compare compare;
+      compare.ibsm( model,
+                    distorted,
+                    maps,
+                    maps,
+                    false,
+                    1024,
+                    16,
+                    glm::vec3( 0.0F ),
+                    "sw_raster",
+                    "",
+                    false,
+                    outputA,
+                    outputB,
+                    false );
+    } );
+
+    std::vector<uint8_t> fbuffer;
+    std::vector<float>   zbuffer;
+    mm::RendererSw       renderer;
+    bench.add(
+      "render/sw",
+      [&] {
+        renderer.render( outputA,
+                         maps,
+                         fbuffer,
+                         zbuffer,
+                         1024,
+                         1024,
+                         glm::vec3( 0.0F, 0.0F, 1.0F ),
+                         glm::vec3( 0.0F, 1.0F, 0.0F ),
+                         minBox,
+                         maxBox,
+                         false,
+                         false );
+      },
+      [&] {
+        *outputA = *model;
+        fbuffer.resize( 1024 * 1024 * 4 );
+        zbuffer.resize( 1024 * 1024 );
+      } );
+
+    if ( result.count( "list" ) ) {
+      bench.list( std::cout );
+      return 0;
+    }
+
+    // writes the inputs of the io benchmarks
+    {
+      std::streambuf* coutBuffer = std::cout.rdbuf();
+      std::cout.rdbuf( NULL );
+      const bool saved = mm::IO::saveModel( objFilename, model ) && mm::IO::saveModel( plyFilename, model );
+      std::cout.rdbuf( coutBuffer );
+      std::cout.clear();
+      mm::IO::purge();
+      if ( !saved ) {
+        std::cerr << "Error: cannot write the temporary files in " << tmpDir << std::endl;
+        return 1;
+      }
+    }
+
+    // execute
+    std::cout << APP_NAME << " v" << MM_VERSION << ", " << model->getPositionCount() << " vertices, "
+              << model->getTriangleCount() << " triangles, " << mm::ThreadPool::getThreadCount() << " threads"
+              << std::endl;
+    bench.run( filter, warmup, repetitions, verbose );
+    bench.print( std::cout );
+
+    // cleanup
+    std::filesystem::remove( objFilename );
+    std::filesystem::remove( plyFilename );
+
+    if ( !jsonFilename.empty() ) {
+      const std::vector<std::pair<std::string, std::string>> info = {
+        { "version", MM_VERSION },
+        { "model", inputModelFilename.empty() ? "synthetic " + std::to_string( size ) : inputModelFilename },
+        { "vertices", std::to_string( model->getPositionCount() ) },
+        { "triangles", std::to_string( model->getTriangleCount() ) },
+        { "threads", std::to_string( mm::ThreadPool::getThreadCount() ) },
+        { "warmup", std::to_string( warmup ) } };
+      if ( !bench.save( jsonFilename, info ) ) return 1;
+    }
+  } catch ( const cxxopts::OptionException& e ) {
+    std::cerr << "Error: parsing options, " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
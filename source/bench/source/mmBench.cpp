@@ -0,0 +1,135 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+// internal headers
+#include "mmBench.h"
+#include "mmTrace.h"
+
+using namespace mm;
+
+// stream buffer discarding everything, used to mute the cases
+class NullBuffer : public std::streambuf {
+ protected:
+  int overflow( int c ) override { return traits_type::not_eof( c ); }
+};
+
+void Bench::add( const std::string& name, std::function<void()> run, std::function<void()> setup ) {
+  _cases.push_back( { name, setup, run } );
+}
+
+void Bench::list( std::ostream& out ) const {
+  for ( const Case& benchCase : _cases ) out << benchCase.name << std::endl;
+}
+
+void Bench::run( const std::string& filter, size_t warmup, size_t repetitions, bool verbose ) {
+  NullBuffer      nullBuffer;
+  std::streambuf* coutBuffer = std::cout.rdbuf();
+  for ( const Case& benchCase : _cases ) {
+    if ( !filter.empty() && benchCase.name.find( filter ) == std::string::npos ) continue;
+    std::cerr << "Running " << benchCase.name << std::endl;
+    Result result;
+    result.name = benchCase.name;
+    if ( !verbose ) std::cout.rdbuf( &nullBuffer );
+    for ( size_t i = 0; i < warmup + repetitions; ++i ) {
+      if ( benchCase.setup ) benchCase.setup();
+      ScopedTimer timer( benchCase.name, "bench" );
+      benchCase.run();
+      timer.stop();
+      if ( i >= warmup ) result.samples.push_back( timer.elapsed() );
+    }
+    std::cout.rdbuf( coutBuffer );
+    // statistics
+    if ( !result.samples.empty() ) {
+      std::vector<double> sorted = result.samples;
+      std::sort( sorted.begin(), sorted.end() );
+      const size_t count = sorted.size();
+      result.min         = sorted.front();
+      result.max         = sorted.back();
+      result.median      = count % 2 ? sorted[count / 2] : ( sorted[count / 2 - 1] + sorted[count / 2] ) / 2.0;
+      double sum = 0.0, sum2 = 0.0;
+      for ( const double sample : sorted ) {
+        sum += sample;
+        sum2 += sample * sample;
+      }
+      result.mean   = sum / (double)count;
+      result.stddev = std::sqrt( std::max( 0.0, sum2 / (double)count - result.mean * result.mean ) );
+    }
+    _results.push_back( result );
+  }
+}
+
+void Bench::print( std::ostream& out ) const {
+  out << std::left << std::setw( 32 ) << "benchmark" << std::right << std::setw( 6 ) << "reps" << std::setw( 12 )
+      << "min (ms)" << std::setw( 12 ) << "median" << std::setw( 12 ) << "mean" << std::setw( 12 ) << "max"
+      << std::setw( 12 ) << "stddev" << std::endl;
+  out << std::fixed << std::setprecision( 3 );
+  for ( const Result& result : _results ) {
+    out << std::left << std::setw( 32 ) << result.name << std::right << std::setw( 6 ) << result.samples.size()
+        << std::setw( 12 ) << result.min * 1000.0 << std::setw( 12 ) << result.median * 1000.0 << std::setw( 12 )
+        << result.mean * 1000.0 << std::setw( 12 ) << result.max * 1000.0 << std::setw( 12 )
+        << result.stddev * 1000.0 << std::endl;
+  }
+  out << std::defaultfloat;
+}
+
+bool Bench::save( const std::string& filename, const std::vector<std::pair<std::string, std::string>>& info ) const {
+  std::ofstream out( filename );
+  if ( !out ) {
+    std::cerr << "Error: cannot open json file " << filename << std::endl;
+    return false;
+  }
+  out.precision( 9 );
+  out << "{" << std::endl;
+  for ( const auto& item : info ) out << "  \"" << item.first << "\": \"" << item.second << "\"," << std::endl;
+  out << "  \"unit\": \"ms\"," << std::endl;
+  out << "  \"benchmarks\": [";
+  for ( size_t i = 0; i < _results.size(); ++i ) {
+    const Result& result = _results[i];
+    out << ( i == 0 ? "\n" : ",\n" ) << "    { \"name\": \"" << result.name << "\""
+        << ", \"repetitions\": " << result.samples.size() << ", \"min\": " << result.min * 1000.0
+        << ", \"median\": " << result.median * 1000.0 << ", \"mean\": " << result.mean * 1000.0
+        << ", \"max\": " << result.max * 1000.0 << ", \"stddev\": " << result.stddev * 1000.0 << ", \"samples\": [";
+    for ( size_t j = 0; j < result.samples.size(); ++j ) out << ( j == 0 ? "" : ", " ) << result.samples[j] * 1000.0;
+    out << "] }";
+  }
+  out << std::endl << "  ]" << std::endl << "}" << std::endl;
+  return (bool)out;
+}
@@ -35,10 +35,13 @@
 #ifndef _MM_CMD_COMPARE_H_
 #define _MM_CMD_COMPARE_H_
 
+#include <set>
+
 // internal headers
 #include "mmCommand.h"
 #include "mmModel.h"
 #include "mmCompare.h"
+#include "mmMemo.h"
 
 class CmdCompare : Command {
  private:
@@ -49,6 +52,11 @@ class CmdCompare : Command {
   std::vector<std::string> _inputTextureAFilenames, _inputTextureBFilenames;
   std::string _outputModelAFilename, _outputModelBFilename;
   std::string _outputCsvFilename;
+  std::string _checkpointFilename;
+  // frames restored from the checkpoint
+  std::set<uint32_t> _checkpointFrames;
+  // the store of memoized results
+  mm::Memo _memo;
   // the type of processing
   std::string _mode = "equ";
   // Equ options
@@ -64,6 +72,7 @@ class CmdCompare : Command {
   std::string _topoVertexMapFilename;
   // Pcc options
   pcc_quality::commandPar _pccParams;
+  std::string             _pccOutputPerPointFilename;
   // PCQM options
   double _pcqmRadiusCurvature    = 0.001;
   int    _pcqmThresholdKnnSearch = 20;
@@ -82,6 +91,17 @@ class CmdCompare : Command {
   // Compare
   mm::Compare _compare;
 
+  // fingerprint of the inputs and parameters of the metric
+  uint64_t getMemoKey( const mm::Model&                  modelA,
+                       const mm::Model&                  modelB,
+                       const std::vector<mm::ImagePtr>& mapSetA,
+                       const std::vector<mm::ImagePtr>& mapSetB );
+  // adds the results of key from the memo store, returns false if not found
+  // state receives the parameters updated by the metric (pcc resolution and color)
+  bool restoreMemo( uint64_t key, std::vector<double>& state );
+  // writes the results of index to the memo store
+  bool storeMemo( uint64_t key, size_t index );
+
  public:
   CmdCompare() {
     _pccParams.singlePass      = false;
@@ -108,7 +128,8 @@ class CmdCompare : Command {
   virtual bool initialize( Context* ctx, std::string app, int argc, char* argv[] );
   virtual bool process( uint32_t frame );  
   virtual bool finalize();
-  
+  // the OpenGL context of the ibsm renderer is created by the first process
+  virtual bool isMainThreadOnly( void ) const { return _mode == "ibsm" && _ibsmRenderer == "gl12_raster"; }
 };
 
 #endif
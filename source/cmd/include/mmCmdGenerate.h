@@ -0,0 +1,92 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _MM_CMD_GENERATE_H_
+#define _MM_CMD_GENERATE_H_
+
+// internal headers
+#include "mmCommand.h"
+#include "mmModel.h"
+#include "mmImage.h"
+
+class CmdGenerate : Command {
+ private:
+  // the command options
+  std::string _outputModelFilename;
+  std::string _distortedModelFilename;
+  std::string _type        = "sphere";
+  size_t      _triangles   = 100000;  // target number of triangles
+  size_t      _points      = 0;       // if not 0 generates a point cloud of about this number of points
+  float       _scale       = 512.0F;  // sphere radius or terrain half size
+  size_t      _materials   = 1;       // number of materials, one texture map per material
+  size_t      _mapSize     = 1024;    // texture maps size, 0 for no uv and no texture map
+  bool        _colors      = false;   // adds per vertex colors
+  bool        _normals     = false;   // adds per vertex normals
+  size_t      _nonManifold = 0;       // number of non manifold edges added
+  bool        _shuffle     = false;   // shuffles the triangles order
+  float       _noise       = 0.001F;  // distortion amplitude relative to the bounding box diagonal
+  uint32_t    _seed        = 1;
+
+ public:
+  CmdGenerate(){};
+
+  // Description of the command
+  static const char* name;
+  static const char* brief;
+  // command creator
+  static Command* create();
+
+  // the command main program
+  virtual bool initialize( Context* ctx, std::string app, int argc, char* argv[] );
+  virtual bool process( uint32_t frame );
+  virtual bool finalize() { return true; };
+
+ private:
+  // latitude/longitude sphere, uv seam on the first meridian
+  void generateSphere( size_t triangles, mm::Model& output );
+  // height field over a regular grid, heights from fractal value noise
+  void generateTerrain( size_t triangles, uint64_t key, mm::Model& output );
+  // one procedural texture map per material
+  void generateMaps( std::vector<mm::ImagePtr>& maps );
+  // adds count fins sharing an edge with existing triangles
+  void addNonManifoldEdges( size_t count, uint64_t key, mm::Model& output );
+  // shuffles the triangles order
+  void shuffleTriangles( uint64_t key, mm::Model& output );
+  // displaces the positions of input by a uniform noise
+  void distort( const mm::Model& input, float amplitude, uint64_t key, mm::Model& output );
+  // writes the material file and the texture maps next to the obj file
+  bool saveMaterials( const std::string& modelFilename, const std::vector<std::string>& mapFilenames, mm::Model& model );
+};
+
+#endif
@@ -96,6 +96,8 @@ class CmdRender : Command {
   virtual bool initialize( Context* ctx, std::string app, int argc, char* argv[] );
   virtual bool process( uint32_t frame );
   virtual bool finalize();
+  // the OpenGL context is created by initialize
+  virtual bool isMainThreadOnly( void ) const { return renderer == "gl12_raster"; }
 };
 
 #endif
\ No newline at end of file
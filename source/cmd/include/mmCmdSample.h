@@ -39,6 +39,7 @@
 #include "mmCommand.h"
 #include "mmModel.h"
 #include "mmImage.h"
+#include "mmSample.h"
 
 class CmdSample : Command {
  private:
@@ -76,8 +77,16 @@ class CmdSample : Command {
   size_t _nbSamplesMin  = 0;
   size_t _nbSamplesMax  = 0;
   size_t _maxIterations = 10;
+  // out of core sampling by tiles, points are streamed to the output file
+  size_t _streamTiles = 0;
   // Prnd options
-  size_t _nbSamples = 2000000;
+  size_t   _nbSamples = 2000000;
+  uint32_t _seed      = 0;
+  // sample template, reused while connectivity does not change
+  std::string        _templateFilename;
+  std::string        _templateParameters;  // mode and sampling parameters stored in the template
+  mm::SampleTemplate _template;
+  bool               _templateValid = false;
 
  public:
   CmdSample(){};
@@ -51,6 +51,8 @@
 
 class Command {
  public:  // Command API, to be specialized by command implementation
+  virtual ~Command() {}
+
   // must be overloaded to parse arguments and init the command
   virtual bool initialize( Context*, std::string app, int argc, char* argv[] ) = 0;
 
@@ -60,6 +62,9 @@ class Command {
   // must be overloaded to collect temporal results after all frames processing
   virtual bool finalize( void ) = 0;
 
+  // may be overloaded, true if process must be called by the main thread (e.g. OpenGL context)
+  virtual bool isMainThreadOnly( void ) const { return false; }
+
  public:  // Command managment API
   // command creator function type
   typedef Command* ( *Creator )( void );
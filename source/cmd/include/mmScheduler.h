@@ -0,0 +1,86 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _MM_SCHEDULER_H_
+#define _MM_SCHEDULER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mmCommand.h"
+
+namespace mm {
+
+class CaptureBuffer;
+
+// Runs the commands of a frame in dependency order (see mm --concurrent).
+// The resources of a command are the values of its input and output options (ID:xxx
+// names, model, map, csv, checkpoint files...). A command depends on the previous
+// command in argv order sharing one of its resources, so a chain gives the same results
+// as a sequential execution. Independent commands run concurrently on the thread pool,
+// their standard and error outputs are buffered and printed in argv order.
+class Scheduler {
+ public:
+  Scheduler();
+  // restores the standard and error outputs
+  ~Scheduler();
+
+  // adds a command, argv[0] is the command name followed by its options
+  void add( Command* command, int argc, char* argv[] );
+
+  // prints the commands and their dependencies
+  void log( std::ostream& out ) const;
+
+  // processes the commands for the given frame, returns the number of failed commands
+  int process( uint32_t frame );
+
+ private:
+  struct Node {
+    Command*                 command;
+    std::string              name;
+    std::vector<std::string> resources;
+    std::vector<size_t>      predecessors;  // commands to wait for
+    std::vector<size_t>      successors;    // commands waiting for this one
+    bool                     mainThread;    // see Command::isMainThreadOnly
+  };
+  std::vector<Node> _nodes;
+  // installed on std::cout and std::cerr by the first concurrent process, kept until the
+  // end so the outputs of other threads (e.g. AsyncWriter) never see a stream buffer change
+  std::unique_ptr<CaptureBuffer> _out, _err;
+};
+
+}  // namespace mm
+
+#endif
@@ -0,0 +1,62 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _MM_SERVER_H_
+#define _MM_SERVER_H_
+
+#include <string>
+
+namespace mm {
+
+// Persistent batch server over a local (Unix domain) socket.
+// The server runs the command chains sent by the clients one after the other in the same
+// process, so the thread pool stays warm and the loaded models and images are kept in the
+// IO file cache between the requests (see IO::setFileCacheSize). The client forwards its
+// arguments with its working directory, prints the streamed standard and error outputs
+// and returns the exit code of the request, as a drop-in replacement of a direct call.
+class Server {
+ public:
+  // runs the global options and commands of a request, argv[0] is ignored, returns the exit code
+  typedef int ( *RunFunction )( int argc, char* argv[] );
+
+  // parses the serve options (argv[0] is "serve") and processes the requests until shutdown
+  static int serve( const std::string& app, int argc, char* argv[], RunFunction run );
+
+  // parses the client options (argv[0] is "client") and sends the remaining arguments
+  static int client( const std::string& app, int argc, char* argv[] );
+};
+
+}  // namespace mm
+
+#endif
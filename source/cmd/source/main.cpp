@@ -36,13 +36,18 @@
 #include <iostream>
 #include <vector>
 #include <limits>
-#include <time.h>
+#include <cstdlib>
 
 // internal headers
 #include "mmIO.h"
 #include "mmContext.h"
 #include "mmCommand.h"
 #include "mmVersion.h"
+#include "mmMemory.h"
+#include "mmThreadPool.h"
+#include "mmTrace.h"
+#include "mmAsyncWriter.h"
+#include "mmTextureCache.h"
 
 // the name of the application binary
 // i.e argv[0] minus the eventual path
@@ -56,6 +61,8 @@
 #include "mmCmdAnalyse.h"
 #include "mmCmdCompare.h"
 #include "mmCmdDegrade.h"
+#include "mmCmdGenerate.h"
+#include "mmCmdMerge.h"
 #include "mmCmdQuantize.h"
 #include "mmCmdDequantize.h"
 #include "mmCmdReindex.h"
@@ -63,38 +70,99 @@
 #include "mmCmdSequence.h"
 #include "mmCmdNormals.h"
 #include "mmCmdRender.h"
+// batch server
+#include "mmServer.h"
+// concurrent commands
+#include "mmScheduler.h"
 
-// analyse command line and run processings
-int main( int argc, char* argv[] ) {
-  // this is mandatory to print floats with full precision
-  std::cout.precision( std::numeric_limits<float>::max_digits10 );
-
-  // register the commands
-  Command::addCreator( CmdAnalyse::name, CmdAnalyse::brief, CmdAnalyse::create );
-  Command::addCreator( CmdCompare::name, CmdCompare::brief, CmdCompare::create );
-  Command::addCreator( CmdDegrade::name, CmdDegrade::brief, CmdDegrade::create );
-  Command::addCreator( CmdQuantize::name, CmdQuantize::brief, CmdQuantize::create );
-  Command::addCreator( CmdDequantize::name, CmdDequantize::brief, CmdDequantize::create );
-  Command::addCreator( CmdReindex::name, CmdReindex::brief, CmdReindex::create );
-  Command::addCreator( CmdSample::name, CmdSample::brief, CmdSample::create );
-  Command::addCreator( CmdSequence::name, CmdSequence::brief, CmdSequence::create );
-  Command::addCreator( CmdNormals::name, CmdNormals::brief, CmdNormals::create );
-  Command::addCreator( CmdRender::name, CmdRender::brief, CmdRender::create );
+// parse the global options placed before the first command, argv[0] is ignored
+// startIdx is set to the index of the first command (argc if none)
+// served is true when invoked by mm serve for a client request
+// concurrent is set if the independent commands of a frame can run concurrently
+static bool parseGlobalOptions( int argc, char* argv[], bool served, int& startIdx, bool& concurrent ) {
+  startIdx   = 1;
+  concurrent = false;
+  while ( startIdx < argc && std::string( argv[startIdx] ).compare( 0, 2, "--" ) == 0 ) {
+    const std::string arg = argv[startIdx];
+    const size_t      eq  = arg.find( '=' );
+    const std::string key = arg.substr( 0, eq );
+    std::string       value;
+    if ( key == "--memory" && eq == std::string::npos ) {
+      // the accounting hooks the allocations of the whole process
+      if ( served && !mm::Memory::isEnabled() ) {
+        std::cerr << "Error: --memory must be given to " << APP_NAME << " serve, not to the client" << std::endl;
+        return false;
+      }
+      if ( !served ) mm::Memory::enable();
+      startIdx++;
+      continue;
+    }
+    if ( key == "--concurrent" && eq == std::string::npos ) {
+      concurrent = true;
+      startIdx++;
+      continue;
+    }
+    if ( key != "--threads" && key != "--writers" && key != "--trace" && key != "--textureCache" ) {
+      std::cerr << "Error: unknown global option " << arg << std::endl;
+      return false;
+    }
+    if ( eq != std::string::npos ) {
+      value = arg.substr( eq + 1 );
+    } else if ( startIdx + 1 < argc ) {
+      value = argv[++startIdx];
+    }
+    if ( key == "--threads" || key == "--writers" ) {
+      char*      end   = NULL;
+      const long count = strtol( value.c_str(), &end, 10 );
+      if ( value.empty() || *end != '\0' || count < 0 ) {
+        std::cerr << "Error: invalid " << ( key == "--threads" ? "thread" : "writer" ) << " count " << value
+                  << std::endl;
+        return false;
+      }
+      if ( key == "--threads" ) {
+        mm::ThreadPool::setThreadCount( (size_t)count );
+      } else {
+        mm::AsyncWriter::start( (size_t)count );
+      }
+    } else if ( key == "--textureCache" ) {
+      if ( value.empty() ) {
+        std::cerr << "Error: missing texture cache directory" << std::endl;
+        return false;
+      }
+      mm::TextureCache::setDirectory( value );
+    } else {
+      if ( value.empty() ) {
+        std::cerr << "Error: missing trace file name" << std::endl;
+        return false;
+      }
+      mm::Trace::enable( value );
+    }
+    startIdx++;
+  }
+  return true;
+}
 
+// run the commands starting at argv[startIdx], prints the help if there is none
+// returns 0 if all the commands succeeded
+static int run( int argc, char* argv[], int startIdx, bool concurrent ) {
   // execute the commands
-  if ( argc > 1 ) {
-    // global timer
-    clock_t t1 = clock();
+  if ( startIdx < argc ) {
+    // global timer, wall clock
+    mm::ScopedTimer timer( "mm", "mm" );
 
     // context shared among commands
     Context context;
     mm::IO::setContext( &context );
     // set of commands to be executer in order
     std::vector<Command*> commands;
+    // and their names for the timings
+    std::vector<std::string> commandNames;
+    // dependencies of the commands if they run concurrently
+    mm::Scheduler scheduler;
 
     // 1 - initialize the command list
-    int startIdx = 1;
     int endIdx;
+    int initErrors = 0;
 
     do {
       // search for end of command (END or end of argv)
@@ -108,24 +176,51 @@ int main( int argc, char* argv[] ) {
 
       // create a new command
       Command* newCmd = NULL;
-      if ( ( newCmd = Command::create( APP_NAME, std::string( argv[startIdx] ) ) ) == NULL ) { return 1; }
+      if ( ( newCmd = Command::create( APP_NAME, std::string( argv[startIdx] ) ) ) == NULL ) {
+        initErrors++;
+        break;
+      }
       commands.push_back( newCmd );
+      commandNames.push_back( argv[startIdx] );
 
       // initialize the command
-      if ( !newCmd->initialize( &context, APP_NAME, subArgc, &argv[startIdx] ) ) { return 1; }
+      if ( !newCmd->initialize( &context, APP_NAME, subArgc, &argv[startIdx] ) ) {
+        initErrors++;
+        break;
+      }
+      if ( concurrent ) scheduler.add( newCmd, subArgc, &argv[startIdx] );
 
       // start of next command
       startIdx = endIdx + 1;
 
     } while ( startIdx < argc );
+    if ( initErrors != 0 ) {
+      for ( Command* command : commands ) delete command;
+      mm::IO::purge();
+      mm::AsyncWriter::stop();
+      return 1;
+    }
 
     // 2 - execute each command for each frame
+    if ( concurrent ) scheduler.log( std::cout );
     int procErrors = 0;
-    for ( uint32_t frame = context.getFirstFrame(); frame <= context.getLastFrame(); ++frame ) {
+    for ( const uint32_t frame : context.getFrames() ) {
       std::cout << "Processing frame " << frame << std::endl;
+      mm::ScopedTimer frameTimer( "frame " + std::to_string( frame ), "frame" );
       context.setFrame( frame );
-      for ( size_t cmdIndex = 0; cmdIndex < commands.size(); ++cmdIndex ) {
-        if ( !commands[cmdIndex]->process( frame ) ) { procErrors++; }
+      if ( concurrent ) {
+        procErrors += scheduler.process( frame );
+      } else {
+        for ( size_t cmdIndex = 0; cmdIndex < commands.size(); ++cmdIndex ) {
+          MM_TRACE_SCOPE( commandNames[cmdIndex], "command" );
+          if ( !commands[cmdIndex]->process( frame ) ) { procErrors++; }
+        }
+      }
+      frameTimer.stop();
+      // print the memory used by the stages of the frame
+      if ( mm::Memory::isEnabled() ) {
+        mm::Memory::printFrame( std::cout, frame, mm::IO::getModelsByteSize(), mm::IO::getImagesByteSize() );
+        mm::Memory::resetFrame();
       }
       // purge the models, clean IO for next frame
       mm::IO::purge();
@@ -135,21 +230,60 @@ int main( int argc, char* argv[] ) {
     // 3 - collect results
     int finErrors = 0;
     for ( size_t cmdIndex = 0; cmdIndex < commands.size(); ++cmdIndex ) {
+      MM_TRACE_SCOPE( commandNames[cmdIndex] + " finalize", "command" );
       if ( !commands[cmdIndex]->finalize() ) { finErrors++; }
     }
     if ( finErrors != 0 ) { std::cerr << "There was " << finErrors << " finalization errors" << std::endl; }
 
-    clock_t t2 = clock();
-    std::cout << "Time on overall processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+    // complete the background writes of the output files
+    const size_t writeErrors = mm::AsyncWriter::stop();
+    if ( writeErrors != 0 ) {
+      std::cerr << "There was " << writeErrors << " write errors" << std::endl;
+      finErrors += (int)writeErrors;
+    }
+
+    timer.stop();
+    std::cout << "Time on overall processing: " << timer.elapsed() << " sec." << std::endl;
+
+    // save the timings
+    if ( mm::Trace::isEnabled() && !mm::Trace::save() ) { finErrors++; }
+
+    // release the commands, the server runs the next requests in the same process
+    for ( Command* command : commands ) delete command;
 
     // all commands were executed
     return procErrors + finErrors;
   }
 
   // print help
+  mm::AsyncWriter::stop();
   std::cout << "3D model processing commands v" << MM_VERSION << std::endl;
   std::cout << "Usage:" << std::endl;
-  std::cout << "  " << APP_NAME << " command [OPTION...]" << std::endl;
+  std::cout << "  " << APP_NAME
+            << " [--threads n] [--writers n] [--trace file] [--memory] [--concurrent] [--textureCache dir] command"
+            << " [OPTION...]" << std::endl;
+  std::cout << "  " << APP_NAME << " [--threads n] [--memory] serve [--socket path] [--cacheSize MB] [--timeout sec]" << std::endl;
+  std::cout << "  " << APP_NAME
+            << " client [--socket path] [--shutdown] [--threads n] [--writers n] [--trace file] [--concurrent]"
+            << " [--textureCache dir] command [OPTION...]" << std::endl;
+  std::cout << std::endl;
+  std::cout << "Global options:" << std::endl;
+  std::cout << "  --threads n\tnumber of threads used by the processings, 0 for all the cores (default)" << std::endl;
+  std::cout << "  --writers n\tnumber of background threads writing the output models and images, 0 writes them in"
+            << " the commands (default)" << std::endl;
+  std::cout << "  --trace file\tsaves the wall clock timings of the processings as Chrome trace events (json)"
+            << std::endl;
+  std::cout << "  --memory\tprints the memory used by the processings per frame, appended to compare --outputCsv"
+            << std::endl;
+  std::cout << "  --concurrent\truns concurrently the commands of a frame not sharing any input or output,"
+            << " their logs are printed in order" << std::endl;
+  std::cout << "  --textureCache dir\tdirectory of the decoded texture maps, mapped by the next loads of the same"
+            << " image files instead of decoding them again" << std::endl;
+  std::cout << std::endl;
+  std::cout << "Batch server:" << std::endl;
+  std::cout << "  serve\t\truns the requests of the clients in a persistent process, loaded files are kept in a cache"
+            << std::endl;
+  std::cout << "  client\t\tsends its arguments to the server, prints the outputs and returns the exit code" << std::endl;
   std::cout << std::endl;
   std::cout << "Command help:" << std::endl;
   std::cout << "  " << APP_NAME << " command --help" << std::endl;
@@ -160,3 +294,46 @@ int main( int argc, char* argv[] ) {
 
   return 0;
 }
+
+// analyse command line and run processings
+int main( int argc, char* argv[] ) {
+  // this is mandatory to print floats with full precision
+  std::cout.precision( std::numeric_limits<float>::max_digits10 );
+
+  // register the commands
+  Command::addCreator( CmdAnalyse::name, CmdAnalyse::brief, CmdAnalyse::create );
+  Command::addCreator( CmdCompare::name, CmdCompare::brief, CmdCompare::create );
+  Command::addCreator( CmdDegrade::name, CmdDegrade::brief, CmdDegrade::create );
+  Command::addCreator( CmdGenerate::name, CmdGenerate::brief, CmdGenerate::create );
+  Command::addCreator( CmdMerge::name, CmdMerge::brief, CmdMerge::create );
+  Command::addCreator( CmdQuantize::name, CmdQuantize::brief, CmdQuantize::create );
+  Command::addCreator( CmdDequantize::name, CmdDequantize::brief, CmdDequantize::create );
+  Command::addCreator( CmdReindex::name, CmdReindex::brief, CmdReindex::create );
+  Command::addCreator( CmdSample::name, CmdSample::brief, CmdSample::create );
+  Command::addCreator( CmdSequence::name, CmdSequence::brief, CmdSequence::create );
+  Command::addCreator( CmdNormals::name, CmdNormals::brief, CmdNormals::create );
+  Command::addCreator( CmdRender::name, CmdRender::brief, CmdRender::create );
+
+  // client of a batch server, all the arguments are forwarded
+  if ( argc > 1 && std::string( argv[1] ) == "client" ) return mm::Server::client( APP_NAME, argc - 1, &argv[1] );
+
+  int  startIdx;
+  bool concurrent;
+  if ( !parseGlobalOptions( argc, argv, false, startIdx, concurrent ) ) return 1;
+
+  // batch server, the global options apply to the server process
+  if ( startIdx < argc && std::string( argv[startIdx] ) == "serve" ) {
+    if ( mm::Trace::isEnabled() ) {
+      std::cerr << "Error: --trace is given per request to " << APP_NAME << " client, not to serve" << std::endl;
+      return 1;
+    }
+    return mm::Server::serve( APP_NAME, argc - startIdx, &argv[startIdx], []( int argc, char* argv[] ) {
+      int  startIdx;
+      bool concurrent;
+      if ( !parseGlobalOptions( argc, argv, true, startIdx, concurrent ) ) return 1;
+      return run( argc, argv, startIdx, concurrent );
+    } );
+  }
+
+  return run( argc, argv, startIdx, concurrent );
+}
@@ -52,6 +52,7 @@
 #include "mmImage.h"
 #include "mmGeometry.h"
 #include "mmStatistics.h"
+#include "mmTrace.h"
 
 const char* CmdAnalyse::name  = "analyse";
 const char* CmdAnalyse::brief = "Analyse model and/or texture map";
@@ -130,7 +131,7 @@ bool CmdAnalyse::process( uint32_t frame ) {
   // create or open in append mode output csv if needed
   std::ofstream fout;
   if ( _outputCsvFilename != "" ) {
-    if ( frame == _context->getFirstFrame() ) {
+    if ( _context->isFirstProcessedFrame( frame ) ) {
       fout.open( _outputCsvFilename.c_str(), std::ios::out );
     } else {
       fout.open( _outputCsvFilename.c_str(), std::ios::out | std::ofstream::app );
@@ -140,7 +141,7 @@ bool CmdAnalyse::process( uint32_t frame ) {
   }
 
   // Perform the processings
-  clock_t t1 = clock();
+  mm::ScopedTimer timer( "processing", "command" );
 
   glm::vec3 minPos, maxPos;
   glm::vec3 minNrm, maxNrm;
@@ -193,7 +194,7 @@ bool CmdAnalyse::process( uint32_t frame ) {
   // print to output csv if needed
   if ( fout ) {
     // print the header if needed
-    if ( frame == _context->getFirstFrame() ) {
+    if ( _context->isFirstProcessedFrame( frame ) ) {
       fout << "frame";
       if ( inputModel != NULL ) {
         fout << ";triangles;vertices;uvcoords;colors;normals;materials"
@@ -232,8 +233,8 @@ bool CmdAnalyse::process( uint32_t frame ) {
   }
 
   // done
-  clock_t t2 = clock();
-  std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+  timer.stop();
+  std::cout << "Time on processing: " << timer.elapsed() << " sec." << std::endl;
 
   // success
   return true;
@@ -39,6 +39,7 @@
 #include <time.h>
 #include <math.h>
 #include <string>
+#include <sstream>
 #include <vector>
 // mathematics
 #include <glm/vec3.hpp>
@@ -62,7 +63,12 @@
 #include "mmRendererHw.h"
 #include "mmStatistics.h"
 #include "mmCompare.h"
+#include "mmCheckpoint.h"
+#include "mmHash.h"
+#include "mmVersion.h"
 #include "mmCmdCompare.h"
+#include "mmMemory.h"
+#include "mmTrace.h"
 
 // "implementation" done in mmRendererHW
 #include <stb_image_write.h>
@@ -98,6 +104,10 @@ bool CmdCompare::initialize( Context* context, std::string app, int argc, char*
 				cxxopts::value<std::string>()->default_value(""))
 			("mode", "the comparison mode in [equ,eqTFAN,pcc,pcqm,topo,ibsm]",
 				cxxopts::value<std::string>()->default_value("equ"))
+			("memo", "pcc, pcqm and ibsm modes, directory of a memo store. Results of inputs (same content) and parameters already compared are read from the store instead of being computed, new results are added to the store. Not used for frames that save output models or per point results.",
+				cxxopts::value<std::string>())
+			("checkpoint", "pcc, pcqm and ibsm modes, filename of a checkpoint where per frame results are appended. Frames found in an existing checkpoint are restored and not processed again. Checkpoints of shards are combined with the merge command.",
+				cxxopts::value<std::string>())
 			("h,help", "Print usage")
 			;
 		options.add_options("equ mode")
@@ -139,6 +149,8 @@ bool CmdCompare::initialize( Context* context, std::string app, int argc, char*
 				cxxopts::value<bool>()->default_value("true"))
             ("normalCalcModificationEnable", "0: Calculate normal of cloudB from cloudA, 1: Use normal of cloudB(default).",
                 cxxopts::value<bool>()->default_value("true"))
+			("outputPerPoint", "path to a binary columnar file where to write the per point results of each frame, use %d for sequences. Enables the per point computation.",
+				cxxopts::value<std::string>())
 			;
 		options.add_options("pcqm mode")
 			("radiusCurvature", "Set a radius for the construction of the neighborhood. As the bounding box is already computed with this program, use proposed value.",
@@ -226,6 +238,7 @@ bool CmdCompare::initialize( Context* context, std::string app, int argc, char*
     if ( result.count( "neighborsProc" ) ) _pccParams.neighborsProc = result["neighborsProc"].as<int>();
     if ( result.count( "averageNormals" ) ) _pccParams.bAverageNormals = result["averageNormals"].as<bool>();
     if ( result.count("normalCalcModificationEnable")) _pccParams.normalCalcModificationEnable = result["normalCalcModificationEnable"].as<bool>();
+    if ( result.count( "outputPerPoint" ) ) _pccOutputPerPointFilename = result["outputPerPoint"].as<std::string>();
     // PCQM
     if ( result.count( "radiusCurvature" ) ) _pcqmRadiusCurvature = result["radiusCurvature"].as<double>();
     if ( result.count( "thresholdKnnSearch" ) ) _pcqmThresholdKnnSearch = result["thresholdKnnSearch"].as<int>();
@@ -253,6 +266,46 @@ bool CmdCompare::initialize( Context* context, std::string app, int argc, char*
     if ( result.count( "ibsmDisableReordering" ) ) _ibsmDisableReordering = result["ibsmDisableReordering"].as<bool>();
 
     if ( result.count( "ibsmOutputPrefix" ) ) _ibsmOutputPrefix = result["ibsmOutputPrefix"].as<std::string>();
+
+    // memo store
+    if ( result.count( "memo" ) ) {
+      _memo.setDirectory( result["memo"].as<std::string>() );
+      if ( _mode != "pcc" && _mode != "pcqm" && _mode != "ibsm" ) {
+        std::cerr << "Error: --memo is only supported by pcc, pcqm and ibsm modes" << std::endl;
+        return false;
+      }
+    }
+
+    // checkpoint, resume from the frames already processed
+    if ( result.count( "checkpoint" ) ) {
+      _checkpointFilename = result["checkpoint"].as<std::string>();
+      if ( _mode != "pcc" && _mode != "pcqm" && _mode != "ibsm" ) {
+        std::cerr << "Error: --checkpoint is only supported by pcc, pcqm and ibsm modes" << std::endl;
+        return false;
+      }
+      if ( mm::Checkpoint::exists( _checkpointFilename ) ) {
+        std::string              mode;
+        mm::Checkpoint::Records records;
+        if ( !mm::Checkpoint::load( _checkpointFilename, mode, records ) ) return false;
+        if ( mode != _mode ) {
+          std::cerr << "Error: checkpoint " << _checkpointFilename << " has results of mode " << mode
+                    << ", expected " << _mode << std::endl;
+          return false;
+        }
+        for ( const auto& record : records ) {
+          if ( !_compare.addResultValues( _mode, record.second ) ) {
+            std::cerr << "Error: invalid results of frame " << record.first << " in checkpoint "
+                      << _checkpointFilename << std::endl;
+            return false;
+          }
+          _checkpointFrames.insert( record.first );
+        }
+        // rewritten to remove an eventual incomplete record before appending
+        if ( !mm::Checkpoint::save( _checkpointFilename, _mode, records ) ) return false;
+        std::cout << "Restored " << records.size() << " frames from checkpoint " << _checkpointFilename
+                  << std::endl;
+      }
+    }
   } catch ( const cxxopts::OptionException& e ) {
     std::cout << "error parsing options: " << e.what() << std::endl;
     return false;
@@ -291,16 +344,95 @@ std::ofstream& openOutputFile( const std::string& fileName, std::ofstream& fileO
   //
   return fileOut;
 };
+
+// memory usage columns of the csv outputs, empty unless mm --memory is used
+std::string memoryCsv( void ) {
+  return mm::Memory::getCsvValues( mm::IO::getModelsByteSize(), mm::IO::getImagesByteSize() );
+}
+
+uint64_t CmdCompare::getMemoKey(const mm::Model& modelA, const mm::Model& modelB,
+    const std::vector<mm::ImagePtr>& mapSetA, const std::vector<mm::ImagePtr>& mapSetB) {
+    mm::ScopedTimer timer("memo key", "compare");
+    // the parameters that change the results, pcc parameters are the values before the call
+    std::ostringstream params;
+    params.precision(std::numeric_limits<double>::max_digits10);
+    params << "mm " << MM_VERSION << " memo 1 " << _mode;
+    if (_mode == "pcc") {
+        params << " " << _pccParams.singlePass << " " << _pccParams.hausdorff << " " << _pccParams.bColor << " "
+            << _pccParams.resolution << " " << _pccParams.neighborsProc << " " << _pccParams.dropDuplicates << " "
+            << _pccParams.bAverageNormals << " " << _pccParams.normalCalcModificationEnable;
+    }
+    else if (_mode == "pcqm") {
+        params << " " << _pcqmRadiusCurvature << " " << _pcqmThresholdKnnSearch << " " << _pcqmRadiusFactor;
+    }
+    else if (_mode == "ibsm") {
+        params << " " << _ibsmRenderer << " " << _ibsmCameraCount << " " << _ibsmCamRotParams.x << " "
+            << _ibsmCamRotParams.y << " " << _ibsmCamRotParams.z << " " << _ibsmResolution << " "
+            << _ibsmDisableCulling << " " << _ibsmDisableReordering;
+    }
+    uint64_t key = mm::Hash::string(params.str());
+    key = mm::Hash::combine(key, mm::Hash::model(modelA));
+    key = mm::Hash::combine(key, mm::Hash::model(modelB));
+    key = mm::Hash::combine(key, mapSetA.size());
+    for (const auto& map : mapSetA) key = mm::Hash::combine(key, mm::Hash::image(*map));
+    key = mm::Hash::combine(key, mapSetB.size());
+    for (const auto& map : mapSetB) key = mm::Hash::combine(key, mm::Hash::image(*map));
+    // 0 means no key
+    return key != 0 ? key : 1;
+}
+
+bool CmdCompare::restoreMemo(uint64_t key, std::vector<double>& state) {
+    std::vector<double> values;
+    if (!_memo.get(key, _mode, values)) return false;
+    // pcc entries end with the resolution and color parameters updated by the metric
+    state.clear();
+    if (_mode == "pcc" && values.size() >= 2) {
+        state.assign(values.end() - 2, values.end());
+        values.resize(values.size() - 2);
+    }
+    if ((_mode == "pcc" && state.empty()) || !_compare.addResultValues(_mode, values)) {
+        std::cout << "Warning: ignoring invalid memo entry " << _memo.getFilename(key) << std::endl;
+        return false;
+    }
+    std::cout << "Results restored from memo " << _memo.getFilename(key) << std::endl;
+    return true;
+}
+
+bool CmdCompare::storeMemo(uint64_t key, size_t index) {
+    std::vector<double> values;
+    if (!_compare.getResultValues(_mode, index, values)) return false;
+    if (_mode == "pcc") {
+        values.push_back(_pccParams.resolution);
+        values.push_back(_pccParams.bColor ? 1.0 : 0.0);
+    }
+    return _memo.put(key, _mode, values);
+}
+
 bool CmdCompare::process(uint32_t frame) {
-    
+
+    // results restored from the checkpoint
+    if (_checkpointFrames.count(frame)) {
+        std::cout << "Frame " << frame << " restored from checkpoint, skipping" << std::endl;
+        return true;
+    }
+    const size_t resultCount = _compare.getResultCount(_mode);
+
+    // the attributes and maps used by the mode, topo only uses the positions and triangles,
+    // topo and pcc without color and output models do not use the maps.
+    // the material urls are kept for the csv outputs, pcc needs the uvs (same sampling).
+    const bool useMaps = !(_mode == "topo"
+        || (_mode == "pcc" && !_pccParams.bColor && _outputModelAFilename == "" && _outputModelBFilename == ""));
+    const uint32_t attributes =
+        _mode == "topo" ? mm::IO::POSITIONS | mm::IO::FACES | mm::IO::MATERIALS : mm::IO::ALL;
+
     // the input
-    mm::ModelPtr inputModelA = mm::IO::loadModel(_inputModelAFilename);
+    mm::ModelPtr inputModelA = mm::IO::loadModel(_inputModelAFilename, attributes);
     if (!inputModelA) { return false; }
     if (inputModelA->vertices.size() == 0) {
         std::cout << "Error: input model from " << _inputModelAFilename << " has no vertices" << std::endl;
         return false;
     }
-    mm::ModelPtr inputModelB = mm::IO::loadModel(_inputModelBFilename);
+    mm::ModelPtr inputModelB = mm::IO::loadModel(_inputModelBFilename, attributes);
     if (!inputModelB ) { return false; }
     if (inputModelB->vertices.size() == 0) {
         std::cout << "Error: input model from " << _inputModelBFilename << " has no vertices" << std::endl;
@@ -322,7 +454,7 @@ bool CmdCompare::process(uint32_t frame) {
     // does nothing if lists are empty
     
     std::vector<mm::ImagePtr> textureMapAList;
-    mm::IO::loadImages(textureMapAUrls, textureMapAList);
+    if (useMaps) mm::IO::loadImages(textureMapAUrls, textureMapAList);
     bool perVertexColorA = false;
     if (textureMapAList.empty()) {
         std::cout << "Skipping map read, will parse/use vertex color if any" << std::endl;
@@ -339,7 +471,7 @@ bool CmdCompare::process(uint32_t frame) {
 
 
     std::vector<mm::ImagePtr> textureMapBList;
-    mm::IO::loadImages(textureMapBUrls, textureMapBList);
+    if (useMaps) mm::IO::loadImages(textureMapBUrls, textureMapBList);
     bool perVertexColorB = false;
     if (textureMapBList.empty()) {
         std::cout << "Skipping map read, will parse/use vertex color if any" << std::endl;
@@ -354,7 +486,19 @@ bool CmdCompare::process(uint32_t frame) {
     openOutputFile(_outputCsvFilename, csvFileOut, csvFileLength);
 
     // Perform the processings
-    clock_t t1 = clock();
+    mm::ScopedTimer timer("processing", "command");
+
+    // memoized results, the metric is not computed if the inputs and parameters are known
+    uint64_t            memoKey = 0;
+    bool                memoHit = false;
+    std::vector<double> memoState;
+    if (_memo.getDirectory() != "") {
+        memoKey = getMemoKey(*inputModelA, *inputModelB, textureMapAList, textureMapBList);
+        // the outputs of the metric cannot be restored
+        const bool hasOutputs = _outputModelAFilename != "" || _outputModelBFilename != ""
+            || (_mode == "pcc" && _pccOutputPerPointFilename != "") || (_mode == "ibsm" && _ibsmOutputPrefix != "");
+        if (!hasOutputs) memoHit = restoreMemo(memoKey, memoState);
+    }
     if (_mode == "equ") {
         std::cout << "Compare models for equality" << std::endl;
         std::cout << "  Epsilon = " << _equEpsilon << std::endl;
@@ -373,14 +517,14 @@ bool CmdCompare::process(uint32_t frame) {
             // print the header if file is empty
             if (csvFileLength == 0) {
                 csvFileOut << "modelA;textureA;modelB;textureB;frame;epsilon;earlyReturn;unoriented;meshEquality;textureDiffs"
-                    << std::endl;
+                    << mm::Memory::getCsvHeader() << std::endl;
             }
             // print stats
             csvFileOut << _inputModelAFilename << ";" << textureMapAUrls[0] << ";" << _inputModelBFilename << ";"
                 << textureMapBUrls[0] << ";" << frame << ";" << _equEpsilon << ";" << _equEarlyReturn << ";"
                 << _equUnoriented << ";"
                 << "TODO"
-                << "TODO" << std::endl;
+                << "TODO" << memoryCsv() << std::endl;
             // done
             csvFileOut.close();
         }
@@ -403,14 +547,14 @@ bool CmdCompare::process(uint32_t frame) {
             // print the header if file is empty
             if (csvFileLength == 0) {
                 csvFileOut << "modelA;textureA;modelB;textureB;frame;epsilon;earlyReturn;unoriented;meshEquality;textureDiffs"
-                    << std::endl;
+                    << mm::Memory::getCsvHeader() << std::endl;
             }
             // print stats
             csvFileOut << _inputModelAFilename << ";" << textureMapAUrls[0] << ";" << _inputModelBFilename << ";"
                 << textureMapBUrls[0] << ";" << frame << ";" << _eqTFANEpsilon << ";" << _eqTFANEarlyReturn << ";"
                 << _eqTFANUnoriented << ";"
                 << "TODO"
-                << "TODO" << std::endl;
+                << "TODO" << memoryCsv() << std::endl;
             // done
             csvFileOut.close();
         }
@@ -427,13 +571,13 @@ bool CmdCompare::process(uint32_t frame) {
         if (csvFileOut) {
             // print the header if file is empty
             if (csvFileLength == 0) {
-                csvFileOut << "modelA;textureA;modelB;textureB;faceMap;vertexMap;frame;equivalence" << std::endl;
+                csvFileOut << "modelA;textureA;modelB;textureB;faceMap;vertexMap;frame;equivalence" << mm::Memory::getCsvHeader() << std::endl;
             }
             // print stats
             csvFileOut << _inputModelAFilename << ";" << textureMapAUrls[0] << ";" << _inputModelBFilename << ";"
                 << textureMapBUrls[0] << ";" << faceMapFilenameResolved << ";" << vertexMapFilenameResolved << ";"
                 << frame << ";"
-                << "TODO" << std::endl;
+                << "TODO" << memoryCsv() << std::endl;
             // done
             csvFileOut.close();
         }
@@ -450,8 +594,16 @@ bool CmdCompare::process(uint32_t frame) {
 
         // just backup for logging because it might be modified by pcc function call if auto mode
         float paramsResolution = _pccParams.resolution;
-        res =
-            _compare.pcc(*inputModelA, *inputModelB, textureMapAList, textureMapBList, _pccParams, *outputModelA, *outputModelB);
+        const bool perPoint = _pccOutputPerPointFilename != "";
+        if (memoHit) {
+            // parameters updated by the metric
+            _pccParams.resolution = (float)memoState[0];
+            _pccParams.bColor = memoState[1] != 0.0;
+            res = 0;
+        }
+        else
+            res = _compare.pcc(*inputModelA, *inputModelB, textureMapAList, textureMapBList, _pccParams, *outputModelA, *outputModelB,
+                true, true, true, perPoint, mm::IO::resolveName(_context->getFrame(), _pccOutputPerPointFilename));
 
         // print the stats
         // TODO add all parameters in the output
@@ -483,7 +635,7 @@ bool CmdCompare::process(uint32_t frame) {
                     << "color_psnr[2];"
                     << "haus_rgb_psnr[0];"
                     << "haus_rgb_psnr[1];"
-                    << "haus_rgb_psnr[2]" << std::endl;
+                    << "haus_rgb_psnr[2]" << mm::Memory::getCsvHeader() << std::endl;
             }
             // print stats
             csvFileOut << _inputModelAFilename << ";"                             // inputModelA
@@ -509,7 +661,7 @@ bool CmdCompare::process(uint32_t frame) {
                 << frameResults.second.color_rgb_hausdorff_psnr[0] << ";"  // haus_rgb_psnr[0]
                 << frameResults.second.color_rgb_hausdorff_psnr[1] << ";"  // haus_rgb_psnr[1]
                 << frameResults.second.color_rgb_hausdorff_psnr[2]         // haus_rgb_psnr[2]
-                << std::endl;
+                << memoryCsv() << std::endl;
             // done
             csvFileOut.close();
         }
@@ -519,7 +671,10 @@ bool CmdCompare::process(uint32_t frame) {
         std::cout << "  radiusCurvature = " << _pcqmRadiusCurvature << std::endl;
         std::cout << "  thresholdKnnSearch = " << _pcqmThresholdKnnSearch << std::endl;
         std::cout << "  radiusFactor = " << _pcqmRadiusFactor << std::endl;
-        res = _compare.pcqm(
+        if (memoHit)
+            res = 0;
+        else
+            res = _compare.pcqm(
             inputModelA,
             inputModelB,
             textureMapAList,
@@ -539,13 +694,13 @@ bool CmdCompare::process(uint32_t frame) {
             if (csvFileLength == 0) {
                 csvFileOut << "p_inputModelA;p_inputModelB;p_inputMapA;p_inputMapB;"
                     << "p_radiusCurvature;p_thresholdKnnSearch;p_radiusFactor;"
-                    << "frame;pcqm;pcqm_psnr" << std::endl;
+                    << "frame;pcqm;pcqm_psnr" << mm::Memory::getCsvHeader() << std::endl;
             }
             // print stats
             csvFileOut << _inputModelAFilename << ";" << _inputModelBFilename << ";" << textureMapAUrls[0] << ";"
                 << textureMapBUrls[0] << ";" << _pcqmRadiusCurvature << ";" << _pcqmThresholdKnnSearch << ";"
                 << _pcqmRadiusFactor << ";" << frame << ";" << (double)std::get<1>(frameResults) << ";"
-                << (double)std::get<2>(frameResults) << std::endl;
+                << (double)std::get<2>(frameResults) << memoryCsv() << std::endl;
             // done
             csvFileOut.close();
         }
@@ -559,7 +714,10 @@ bool CmdCompare::process(uint32_t frame) {
         std::cout << "  ibsmDisableCulling = " << _ibsmDisableCulling << std::endl;
         std::cout << "  ibsmOutputPrefix = " << _ibsmOutputPrefix << std::endl;
 
-        res = _compare.ibsm(
+        if (memoHit)
+            res = 0;
+        else
+            res = _compare.ibsm(
             inputModelA,
             inputModelB,
             textureMapAList,
@@ -585,7 +743,7 @@ bool CmdCompare::process(uint32_t frame) {
                     << "p_ibsmRenderer;p_ibsmCameraCount;p_ibsmCameraRotation;p_ibsmResolution;"
                     << "p_ibsmDisableCulling;p_ibsmOutputPrefix;"
                     << "frame;geo_psnr;rgb_psnr;r_psnr;g_psnr;b_psnr;"
-                    << "yuv_psnr;y_psnr;u_psnr;v_psnr;processingTime" << std::endl;
+                    << "yuv_psnr;y_psnr;u_psnr;v_psnr;processingTime" << mm::Memory::getCsvHeader() << std::endl;
             }
             // print stats
             csvFileOut << _inputModelAFilename << ";" << _inputModelBFilename << ";" << textureMapAUrls[0] << ";"
@@ -596,7 +754,7 @@ bool CmdCompare::process(uint32_t frame) {
                 << frameResults.second.rgbPSNR[1] << ";" << frameResults.second.rgbPSNR[2] << ";"
                 << frameResults.second.yuvPSNR[3] << ";" << frameResults.second.yuvPSNR[0] << ";"
                 << frameResults.second.yuvPSNR[1] << ";" << frameResults.second.yuvPSNR[2] << ";"
-                << ((float)(clock() - t1)) / CLOCKS_PER_SEC << std::endl;
+                << timer.elapsed() << memoryCsv() << std::endl;
             // done
             csvFileOut.close();
         }
@@ -605,8 +763,20 @@ bool CmdCompare::process(uint32_t frame) {
         std::cerr << "Error: invalid --mode " << _mode << std::endl;
         return false;
     }
-    clock_t t2 = clock();
-    std::cout << "Time on processing: " << ((float)(t2 - t1)) / CLOCKS_PER_SEC << " sec." << std::endl;
+    timer.stop();
+    std::cout << "Time on processing: " << timer.elapsed() << " sec." << std::endl;
+
+    // append the results of the frame to the checkpoint
+    std::vector<double> checkpointValues;
+    if (_checkpointFilename != "" && _compare.getResultCount(_mode) > resultCount
+        && _compare.getResultValues(_mode, resultCount, checkpointValues)) {
+        if (!mm::Checkpoint::append(_checkpointFilename, _mode, frame, checkpointValues)) return false;
+    }
+
+    // add the new results to the memo store
+    if (memoKey != 0 && !memoHit && _compare.getResultCount(_mode) > resultCount) {
+        if (!storeMemo(memoKey, resultCount)) return false;
+    }
 
     // save the result
     if (_outputModelAFilename != "") {
@@ -53,6 +53,7 @@
 #include "mmModel.h"
 #include "mmImage.h"
 #include "mmCmdDegrade.h"
+#include "mmTrace.h"
 
 // Descriptions of the command
 const char* CmdDegrade::name  = "degrade";
@@ -131,7 +132,7 @@ bool CmdDegrade::process( uint32_t frame ) {
   mm::ModelPtr outputModel = mm::ModelPtr( new mm::Model() );
 
   // Perform the processings
-  clock_t t1 = clock();
+  mm::ScopedTimer timer( "processing", "command" );
   if ( _mode == "delface" ) {
     size_t skipped = 0;
     if ( _nthFace != 0 ) {
@@ -149,8 +150,8 @@ bool CmdDegrade::process( uint32_t frame ) {
     return false;
   }
 
-  clock_t t2 = clock();
-  std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+  timer.stop();
+  std::cout << "Time on processing: " << timer.elapsed() << " sec." << std::endl;
 
   // save the result
   return mm::IO::saveModel( _outputModelFilename, outputModel );
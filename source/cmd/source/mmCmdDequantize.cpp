@@ -53,6 +53,7 @@
 #include "mmGeometry.h"
 #include "mmColor.h"
 #include "mmCmdDequantize.h"
+#include "mmTrace.h"
 
 const char* CmdDequantize::name  = "dequantize";
 const char* CmdDequantize::brief = "Dequantize model (mesh or point cloud) ";
@@ -245,7 +246,7 @@ bool CmdDequantize::process( uint32_t frame ) {
   mm::ModelPtr outputModel = mm::ModelPtr( new mm::Model() );
 
   // Perform the processings
-  clock_t t1 = clock();
+  mm::ScopedTimer timer( "processing", "command" );
 
   std::cout << "De-quantizing" << std::endl;
   std::cout << "  qp = " << _qp << std::endl;
@@ -270,8 +271,8 @@ bool CmdDequantize::process( uint32_t frame ) {
                               _useFixedPoint,
                               _colorSpaceConversion );
 
-  clock_t t2 = clock();
-  std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+  timer.stop();
+  std::cout << "Time on processing: " << timer.elapsed() << " sec." << std::endl;
 
   // save the result
   return mm::IO::saveModel( _outputModelFilename, outputModel );
@@ -0,0 +1,482 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+// mathematics
+#include <glm/vec3.hpp>
+#include <glm/gtc/type_ptr.hpp>
+// argument parsing
+#include <cxxopts.hpp>
+// image writing
+#include <stb_image_write.h>
+
+// internal headers
+#include "mmGeometry.h"
+#include "mmIO.h"
+#include "mmModel.h"
+#include "mmImage.h"
+#include "mmThreadPool.h"
+#include "mmCmdGenerate.h"
+#include "mmTrace.h"
+
+// Descriptions of the command
+const char* CmdGenerate::name  = "generate";
+const char* CmdGenerate::brief = "Generate synthetic models and texture maps";
+
+//
+Command* CmdGenerate::create() { return new CmdGenerate(); }
+
+// splitmix64 finalizer, the generated values only depend on (key,index)
+// so the models can be generated in any order or on any thread
+static inline uint64_t hash64( uint64_t x ) {
+  x = ( x ^ ( x >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+  x = ( x ^ ( x >> 27 ) ) * 0x94D049BB133111EBULL;
+  return x ^ ( x >> 31 );
+}
+
+// uniform value in [0,1)
+static inline float random01( uint64_t key, uint64_t index ) {
+  return (float)( hash64( key + hash64( index + 0x9E3779B97F4A7C15ULL ) ) >> 40 ) * ( 1.0F / 16777216.0F );
+}
+
+// 2D value noise in [0,1] with smooth interpolation of the lattice values
+static float valueNoise( float x, float y, uint64_t key ) {
+  const float    fx = std::floor( x ), fy = std::floor( y );
+  const uint32_t ix = (uint32_t)(int32_t)fx, iy = (uint32_t)(int32_t)fy;
+  const auto     lattice = [&]( uint32_t i, uint32_t j ) { return random01( key, ( (uint64_t)i << 32 ) | j ); };
+  const float    tx = x - fx, ty = y - fy;
+  const float    sx = tx * tx * ( 3.0F - 2.0F * tx ), sy = ty * ty * ( 3.0F - 2.0F * ty );
+  const float    a = lattice( ix, iy ) + sx * ( lattice( ix + 1, iy ) - lattice( ix, iy ) );
+  const float    b = lattice( ix, iy + 1 ) + sx * ( lattice( ix + 1, iy + 1 ) - lattice( ix, iy + 1 ) );
+  return a + sy * ( b - a );
+}
+
+// fractal sum of 6 octaves of value noise over the unit square, result in [-1,1]
+static float fractalNoise( float u, float v, uint64_t key ) {
+  float sum = 0.0F, norm = 0.0F, amplitude = 1.0F, frequency = 4.0F;
+  for ( uint64_t octave = 0; octave < 6; ++octave ) {
+    sum += amplitude * valueNoise( u * frequency, v * frequency, key + octave );
+    norm += amplitude;
+    amplitude *= 0.5F;
+    frequency *= 2.0F;
+  }
+  return 2.0F * sum / norm - 1.0F;
+}
+
+// procedural texture, one base color per material modulated by a checker and the uv gradient
+static glm::vec3 pattern( float u, float v, size_t material ) {
+  static const glm::vec3 palette[8] = { { 230, 80, 60 },  { 70, 160, 230 }, { 90, 200, 90 },   { 240, 200, 60 },
+                                        { 170, 90, 220 }, { 60, 200, 190 }, { 240, 140, 190 }, { 150, 150, 150 } };
+  const bool             checker    = ( ( (int)( u * 16.0F ) + (int)( v * 16.0F ) ) & 1 ) != 0;
+  const glm::vec3        gradient( 255.0F * u, 255.0F * v, 128.0F );
+  const glm::vec3        color = palette[material % 8] * ( checker ? 1.0F : 0.6F );
+  return glm::clamp( 0.75F * color + 0.25F * gradient, glm::vec3( 0.0F ), glm::vec3( 255.0F ) );
+}
+
+//
+bool CmdGenerate::initialize( Context* ctx, std::string app, int argc, char* argv[] ) {
+  // command line parameters
+  try {
+    cxxopts::Options options( app + " " + name, brief );
+    // clang-format off
+    options.add_options()
+      ("o,outputModel", "path to output model (obj or ply file). Texture maps are saved next to it as png files, "
+        "plus a material file for obj.",
+        cxxopts::value<std::string>())
+      ("type", "the generated model in [sphere, terrain]. sphere: latitude/longitude subdivided sphere, "
+        "terrain: height field from fractal noise.",
+        cxxopts::value<std::string>()->default_value("sphere"))
+      ("triangles", "target number of triangles.",
+        cxxopts::value<size_t>()->default_value("100000"))
+      ("points", "if not 0, generates a colored point cloud of about this number of points instead of a mesh.",
+        cxxopts::value<size_t>()->default_value("0"))
+      ("scale", "radius of the sphere or half size of the terrain.",
+        cxxopts::value<float>()->default_value("512"))
+      ("materials", "number of materials, one texture map per material. Triangles are assigned by bands along u.",
+        cxxopts::value<size_t>()->default_value("1"))
+      ("mapSize", "size of the texture maps, 0 for no uv coordinates and no texture map.",
+        cxxopts::value<size_t>()->default_value("1024"))
+      ("colors", "adds per vertex colors from the texture pattern.",
+        cxxopts::value<bool>()->default_value("false"))
+      ("normals", "adds per vertex normals.",
+        cxxopts::value<bool>()->default_value("false"))
+      ("nonManifold", "number of non manifold edges, made by adding fins sharing an edge with existing triangles.",
+        cxxopts::value<size_t>()->default_value("0"))
+      ("shuffle", "shuffles the order of the triangles.",
+        cxxopts::value<bool>()->default_value("false"))
+      ("distortedModel", "path to an optional distorted copy of the output model (obj or ply file), "
+        "same topology and texture maps, positions displaced by a uniform noise.",
+        cxxopts::value<std::string>())
+      ("noise", "amplitude of the distortion noise, relative to the bounding box diagonal.",
+        cxxopts::value<float>()->default_value("0.001"))
+      ("seed", "seed of the pseudo random values, frame n of a sequence uses seed + n.",
+        cxxopts::value<uint32_t>()->default_value("1"))
+      ("h,help", "Print usage")
+      ;
+    // clang-format on
+
+    auto result = options.parse( argc, argv );
+
+    // Analyse the options
+    if ( result.count( "help" ) || result.arguments().size() == 0 ) {
+      std::cout << options.help() << std::endl;
+      return false;
+    }
+    //
+    if ( result.count( "outputModel" ) ) _outputModelFilename = result["outputModel"].as<std::string>();
+    else {
+      std::cerr << "Error: missing outputModel parameter" << std::endl;
+      std::cout << options.help() << std::endl;
+      return false;
+    }
+    //
+    if ( result.count( "type" ) ) _type = result["type"].as<std::string>();
+    if ( _type != "sphere" && _type != "terrain" ) {
+      std::cerr << "Error: invalid type " << _type << std::endl;
+      return false;
+    }
+    if ( result.count( "triangles" ) ) _triangles = result["triangles"].as<size_t>();
+    if ( result.count( "points" ) ) _points = result["points"].as<size_t>();
+    if ( result.count( "scale" ) ) _scale = result["scale"].as<float>();
+    if ( result.count( "materials" ) ) _materials = std::max( result["materials"].as<size_t>(), (size_t)1 );
+    if ( result.count( "mapSize" ) ) _mapSize = result["mapSize"].as<size_t>();
+    if ( result.count( "colors" ) ) _colors = result["colors"].as<bool>();
+    if ( result.count( "normals" ) ) _normals = result["normals"].as<bool>();
+    if ( result.count( "nonManifold" ) ) _nonManifold = result["nonManifold"].as<size_t>();
+    if ( result.count( "shuffle" ) ) _shuffle = result["shuffle"].as<bool>();
+    if ( result.count( "distortedModel" ) ) _distortedModelFilename = result["distortedModel"].as<std::string>();
+    if ( result.count( "noise" ) ) _noise = result["noise"].as<float>();
+    if ( result.count( "seed" ) ) _seed = result["seed"].as<uint32_t>();
+    if ( _triangles < 2 && _points == 0 ) {
+      std::cerr << "Error: triangles must be greater than 1" << std::endl;
+      return false;
+    }
+
+  } catch ( const cxxopts::OptionException& e ) {
+    std::cout << "error parsing options: " << e.what() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool CmdGenerate::process( uint32_t frame ) {
+  const uint64_t key        = hash64( ( (uint64_t)_seed + frame ) * 0x9E3779B97F4A7C15ULL );
+  const bool     pointCloud = _points != 0;
+
+  // Perform the processings
+  mm::ScopedTimer timer( "processing", "command" );
+  mm::ModelPtr    outputModel = mm::ModelPtr( new mm::Model() );
+  // a mesh has about half as many vertices as triangles
+  const size_t triangles = pointCloud ? 2 * _points : _triangles;
+  if ( _type == "sphere" ) generateSphere( triangles, *outputModel );
+  else generateTerrain( triangles, key, *outputModel );
+
+  if ( !pointCloud && _nonManifold != 0 ) addNonManifoldEdges( _nonManifold, key + 1, *outputModel );
+  if ( !pointCloud && _shuffle ) shuffleTriangles( key + 2, *outputModel );
+
+  // per vertex colors from the pattern of the material, the last triangle using a vertex wins
+  mm::Model& model = *outputModel;
+  if ( _colors || pointCloud ) {
+    model.colors.resize( model.vertices.size() );
+    for ( size_t t = 0; t < model.getTriangleCount(); ++t ) {
+      for ( size_t c = 0; c < 3; ++c ) {
+        const int       pos = model.triangles[t * 3 + c];
+        const int       uv  = model.trianglesuv[t * 3 + c];
+        const glm::vec3 rgb = pattern( model.uvcoords[uv * 2], model.uvcoords[uv * 2 + 1], model.triangleMatIdx[t] );
+        for ( glm::vec3::length_type i = 0; i < 3; ++i ) model.colors[pos * 3 + i] = std::round( rgb[i] );
+      }
+    }
+  }
+  if ( _normals ) {
+    model.computeVertexNormals( true, false );
+    model.faceNormals.clear();
+  }
+  if ( pointCloud ) {
+    model.uvcoords.clear();
+    model.triangles.clear();
+    model.trianglesuv.clear();
+    model.triangleMatIdx.clear();
+    model.materialNames.clear();
+  } else if ( _mapSize == 0 ) {
+    model.uvcoords.clear();
+    model.trianglesuv.clear();
+  }
+
+  std::vector<mm::ImagePtr> maps;
+  if ( !pointCloud && _mapSize != 0 ) generateMaps( maps );
+
+  // the distorted copy
+  mm::ModelPtr distortedModel;
+  if ( !_distortedModelFilename.empty() ) {
+    distortedModel = mm::ModelPtr( new mm::Model() );
+    distort( model, _noise, key + 3, *distortedModel );
+  }
+
+  timer.stop();
+  std::cout << "Generated " << _type << ( pointCloud ? " point cloud" : "" ) << ": V = " << model.getPositionCount()
+            << " UV = " << model.getUvCount() << " F = " << model.getTriangleCount()
+            << " Materials = " << model.materialNames.size() << std::endl;
+  std::cout << "Time on processing: " << timer.elapsed() << " sec." << std::endl;
+
+  // save the texture maps next to the output model
+  const std::string        outputModelFilename = mm::IO::resolveName( frame, _outputModelFilename );
+  std::vector<std::string> mapFilenames;
+  for ( size_t m = 0; m < maps.size(); ++m ) {
+    std::filesystem::path path( outputModelFilename );
+    path.replace_filename( path.stem().string() + ( maps.size() == 1 ? "" : "_" + std::to_string( m ) ) + ".png" );
+    mapFilenames.push_back( path.string() );
+    mm::ScopedTimer saveTimer( "save " + path.string(), "io" );
+    const mm::Image& map = *maps[m];
+    if ( !stbi_write_png( path.string().c_str(), map.width, map.height, map.nbc, map.data, map.width * map.nbc ) ) {
+      std::cerr << "Error: can't write texture map " << path.string() << std::endl;
+      return false;
+    }
+    std::cout << "Texture map: " << path.string() << std::endl;
+  }
+
+  // save the models
+  if ( !saveMaterials( outputModelFilename, mapFilenames, model ) ) return false;
+  if ( !mm::IO::saveModel( _outputModelFilename, outputModel ) ) return false;
+  if ( distortedModel ) {
+    const std::string distortedModelFilename = mm::IO::resolveName( frame, _distortedModelFilename );
+    if ( !saveMaterials( distortedModelFilename, mapFilenames, *distortedModel ) ) return false;
+    if ( !mm::IO::saveModel( _distortedModelFilename, distortedModel ) ) return false;
+  }
+  return true;
+}
+
+void CmdGenerate::generateSphere( size_t triangles, mm::Model& output ) {
+  // rows latitude bands of cols = 2 * rows quads, the quads of the pole bands are
+  // single triangles, so there are 2 * cols * ( rows - 1 ) = 4 * rows * ( rows - 1 ) triangles
+  const size_t rows = std::max( (size_t)2, (size_t)std::llround( ( 1.0 + std::sqrt( 1.0 + (double)triangles ) ) / 2.0 ) );
+  const size_t cols = 2 * rows;
+  const double pi   = 3.14159265358979323846;
+
+  output.reset();
+  output.vertices.resize( ( 2 + ( rows - 1 ) * cols ) * 3 );
+  output.uvcoords.resize( ( rows + 1 ) * ( cols + 1 ) * 2 );
+  output.triangles.resize( 2 * cols * ( rows - 1 ) * 3 );
+  output.trianglesuv.resize( output.triangles.size() );
+  output.triangleMatIdx.resize( output.triangles.size() / 3 );
+  for ( size_t m = 0; m < _materials; ++m ) {
+    char materialName[32];
+    snprintf( materialName, sizeof( materialName ), "material%04zu", m );
+    output.materialNames.push_back( materialName );
+  }
+
+  // position index of latitude row i and longitude column j, the poles are single vertices
+  const auto pos = [&]( size_t i, size_t j ) -> int {
+    if ( i == 0 ) return 0;
+    if ( i == rows ) return (int)( 1 + ( rows - 1 ) * cols );
+    return (int)( 1 + ( i - 1 ) * cols + j % cols );
+  };
+  // uv index of row i and column j, the first meridian has two uv coordinates (seam)
+  const auto uv = [&]( size_t i, size_t j ) -> int { return (int)( i * ( cols + 1 ) + j ); };
+
+  mm::parallelFor( 0, rows + 1, 16, [&]( size_t i ) {
+    const double theta = pi * (double)i / (double)rows;
+    for ( size_t j = 0; j <= cols; ++j ) {
+      const double phi = 2.0 * pi * (double)j / (double)cols;
+      if ( j < cols && ( ( i != 0 && i != rows ) || j == 0 ) ) {
+        float* vertex = &output.vertices[pos( i, j ) * 3];
+        vertex[0]     = (float)( _scale * std::sin( theta ) * std::cos( phi ) );
+        vertex[1]     = (float)( _scale * std::cos( theta ) );
+        vertex[2]     = (float)( -_scale * std::sin( theta ) * std::sin( phi ) );
+      }
+      output.uvcoords[uv( i, j ) * 2]     = (float)j / (float)cols;
+      output.uvcoords[uv( i, j ) * 2 + 1] = 1.0F - (float)i / (float)rows;
+    }
+  } );
+
+  mm::parallelFor( 0, rows, 16, [&]( size_t i ) {
+    size_t t = i == 0 ? 0 : cols + ( i - 1 ) * 2 * cols;
+    for ( size_t j = 0; j < cols; ++j ) {
+      const int material = (int)( j * _materials / cols );
+      // the second triangle of the north pole quads and the first of the south pole quads are degenerate
+      if ( i != rows - 1 ) {
+        const size_t corners[3][2] = { { i, j }, { i + 1, j }, { i + 1, j + 1 } };
+        for ( size_t c = 0; c < 3; ++c ) {
+          output.triangles[t * 3 + c]   = pos( corners[c][0], corners[c][1] );
+          output.trianglesuv[t * 3 + c] = uv( corners[c][0], corners[c][1] );
+        }
+        output.triangleMatIdx[t++] = material;
+      }
+      if ( i != 0 ) {
+        const size_t corners[3][2] = { { i, j }, { i + 1, j + 1 }, { i, j + 1 } };
+        for ( size_t c = 0; c < 3; ++c ) {
+          output.triangles[t * 3 + c]   = pos( corners[c][0], corners[c][1] );
+          output.trianglesuv[t * 3 + c] = uv( corners[c][0], corners[c][1] );
+        }
+        output.triangleMatIdx[t++] = material;
+      }
+    }
+  } );
+}
+
+void CmdGenerate::generateTerrain( size_t triangles, uint64_t key, mm::Model& output ) {
+  // size x size vertices, 2 * ( size - 1 )^2 triangles
+  const size_t size = std::max( (size_t)2, (size_t)std::llround( std::sqrt( (double)triangles / 2.0 ) ) + 1 );
+
+  output.reset();
+  output.vertices.resize( size * size * 3 );
+  output.uvcoords.resize( size * size * 2 );
+  output.triangles.resize( 2 * ( size - 1 ) * ( size - 1 ) * 3 );
+  output.triangleMatIdx.resize( output.triangles.size() / 3 );
+  for ( size_t m = 0; m < _materials; ++m ) {
+    char materialName[32];
+    snprintf( materialName, sizeof( materialName ), "material%04zu", m );
+    output.materialNames.push_back( materialName );
+  }
+
+  mm::parallelFor( 0, size, 16, [&]( size_t j ) {
+    const float v = (float)j / (float)( size - 1 );
+    for ( size_t i = 0; i < size; ++i ) {
+      const float  u      = (float)i / (float)( size - 1 );
+      const size_t index  = j * size + i;
+      output.vertices[index * 3]     = _scale * ( 2.0F * u - 1.0F );
+      output.vertices[index * 3 + 1] = 0.25F * _scale * fractalNoise( u, v, key );
+      output.vertices[index * 3 + 2] = _scale * ( 2.0F * v - 1.0F );
+      output.uvcoords[index * 2]     = u;
+      output.uvcoords[index * 2 + 1] = 1.0F - v;
+    }
+  } );
+
+  mm::parallelFor( 0, size - 1, 16, [&]( size_t j ) {
+    for ( size_t i = 0; i + 1 < size; ++i ) {
+      const size_t t        = ( j * ( size - 1 ) + i ) * 2;
+      const int    a        = (int)( j * size + i );
+      const int    tris[6]  = { a, a + (int)size, a + (int)size + 1, a, a + (int)size + 1, a + 1 };
+      const int    material = (int)( i * _materials / ( size - 1 ) );
+      std::copy( tris, tris + 6, &output.triangles[t * 3] );
+      output.triangleMatIdx[t]     = material;
+      output.triangleMatIdx[t + 1] = material;
+    }
+  } );
+  // one uv per position
+  output.trianglesuv = output.triangles;
+}
+
+void CmdGenerate::generateMaps( std::vector<mm::ImagePtr>& maps ) {
+  const int size = (int)_mapSize;
+  for ( size_t m = 0; m < _materials; ++m ) {
+    mm::ImagePtr map( new mm::Image() );
+    map->reset( size, size );
+    mm::parallelFor( 0, size, 16, [&]( size_t y ) {
+      for ( int x = 0; x < size; ++x ) {
+        // row 0 is the top of the map, v = 1
+        const glm::vec3 rgb = pattern( ( x + 0.5F ) / size, 1.0F - ( y + 0.5F ) / size, m );
+        map->storeRGB( x, y, glm::round( rgb ) );
+      }
+    } );
+    maps.push_back( map );
+  }
+}
+
+void CmdGenerate::addNonManifoldEdges( size_t count, uint64_t key, mm::Model& output ) {
+  const size_t triangleCount = output.getTriangleCount();
+  for ( size_t f = 0; f < count; ++f ) {
+    // a random edge of a random triangle
+    const size_t t = (size_t)( random01( key, f * 2 ) * triangleCount ) % triangleCount;
+    const size_t e = (size_t)( random01( key, f * 2 + 1 ) * 3 ) % 3;
+    const int    a = output.triangles[t * 3 + e], b = output.triangles[t * 3 + ( e + 1 ) % 3];
+    const int    uva = output.trianglesuv[t * 3 + e], uvb = output.trianglesuv[t * 3 + ( e + 1 ) % 3];
+    // the fin stands along the face normal from the middle of the edge
+    glm::vec3 v1, v2, v3, normal;
+    output.fetchTriangleVertices( t, v1, v2, v3 );
+    mm::Geometry::triangleNormal( v1, v2, v3, normal );
+    const glm::vec3 pa  = glm::make_vec3( &output.vertices[a * 3] );
+    const glm::vec3 pb  = glm::make_vec3( &output.vertices[b * 3] );
+    const glm::vec3 tip = ( pa + pb ) * 0.5F + normal * glm::length( pb - pa );
+    const int       c   = (int)output.getPositionCount();
+    const int       uvc = (int)output.getUvCount();
+    output.vertices.insert( output.vertices.end(), { tip.x, tip.y, tip.z } );
+    output.uvcoords.push_back( ( output.uvcoords[uva * 2] + output.uvcoords[uvb * 2] ) * 0.5F );
+    output.uvcoords.push_back( ( output.uvcoords[uva * 2 + 1] + output.uvcoords[uvb * 2 + 1] ) * 0.5F );
+    output.triangles.insert( output.triangles.end(), { b, a, c } );
+    output.trianglesuv.insert( output.trianglesuv.end(), { uvb, uva, uvc } );
+    output.triangleMatIdx.push_back( output.triangleMatIdx[t] );
+  }
+}
+
+void CmdGenerate::shuffleTriangles( uint64_t key, mm::Model& output ) {
+  // Fisher-Yates shuffle
+  for ( size_t t = output.getTriangleCount() - 1; t > 0; --t ) {
+    const size_t other = (size_t)( hash64( key + hash64( t ) ) % ( t + 1 ) );
+    std::swap_ranges( &output.triangles[t * 3], &output.triangles[t * 3] + 3, &output.triangles[other * 3] );
+    std::swap_ranges( &output.trianglesuv[t * 3], &output.trianglesuv[t * 3] + 3, &output.trianglesuv[other * 3] );
+    std::swap( output.triangleMatIdx[t], output.triangleMatIdx[other] );
+  }
+}
+
+void CmdGenerate::distort( const mm::Model& input, float amplitude, uint64_t key, mm::Model& output ) {
+  glm::vec3 minPos, maxPos;
+  mm::Geometry::computeBBox( input.vertices, minPos, maxPos );
+  const float scale = amplitude * glm::length( maxPos - minPos );
+  output            = input;
+  mm::parallelFor( 0, output.vertices.size(), 65536, [&]( size_t i ) {
+    output.vertices[i] += scale * ( 2.0F * random01( key, i ) - 1.0F );
+  } );
+}
+
+bool CmdGenerate::saveMaterials( const std::string&              modelFilename,
+                                 const std::vector<std::string>& mapFilenames,
+                                 mm::Model&                      model ) {
+  std::filesystem::path path( modelFilename );
+  std::string           ext = path.extension().string();
+  std::for_each( ext.begin(), ext.end(), []( char& c ) { c = ::tolower( c ); } );
+  if ( ext != ".obj" || mapFilenames.empty() ) return true;
+
+  // the map paths are relative to the material file
+  path.replace_extension( ".mtl" );
+  const std::filesystem::path directory = std::filesystem::absolute( path ).parent_path();
+  std::ofstream               out( path );
+  if ( !out ) {
+    std::cerr << "Error: can't open file " << path.string() << std::endl;
+    return false;
+  }
+  for ( size_t m = 0; m < mapFilenames.size(); ++m ) {
+    const std::filesystem::path map = std::filesystem::absolute( mapFilenames[m] ).lexically_relative( directory );
+    out << "newmtl " << model.materialNames[m] << std::endl;
+    out << "Ka 1.0 1.0 1.0" << std::endl;
+    out << "Kd 1.0 1.0 1.0" << std::endl;
+    out << "map_Kd " << map.generic_string() << std::endl << std::endl;
+  }
+  model.header = "mtllib " + path.filename().string();
+  return true;
+}
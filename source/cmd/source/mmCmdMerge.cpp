@@ -0,0 +1,139 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iostream>
+#include <algorithm>
+
+// argument parsing
+#include <cxxopts.hpp>
+
+// internal headers
+#include "mmCheckpoint.h"
+#include "mmCmdMerge.h"
+
+const char* CmdMerge::name  = "merge";
+const char* CmdMerge::brief = "Merge checkpoints of compare runs and compute the sequence statistics";
+
+//
+Command* CmdMerge::create() { return new CmdMerge(); }
+
+//
+bool CmdMerge::initialize( Context* ctx, std::string app, int argc, char* argv[] ) {
+  // command line parameters
+  try {
+    cxxopts::Options options( app + " " + name, brief );
+    // clang-format off
+		options.add_options()
+			("inputCheckpoints", "paths to the checkpoints written by compare --checkpoint, surrounded by double quotes and separated by spaces.",
+				cxxopts::value<std::string>())
+			("outputCheckpoint", "path to the merged checkpoint, optional.",
+				cxxopts::value<std::string>())
+			("h,help", "Print usage")
+			;
+    // clang-format on
+
+    auto result = options.parse( argc, argv );
+
+    // Analyse the options
+    if ( result.count( "help" ) || result.arguments().size() == 0 ) {
+      std::cout << options.help() << std::endl;
+      return false;
+    }
+    //
+    if ( result.count( "inputCheckpoints" ) )
+      parseStringList( result["inputCheckpoints"].as<std::string>(), _inputCheckpointFilenames );
+    if ( _inputCheckpointFilenames.empty() || _inputCheckpointFilenames[0] == "" ) {
+      std::cerr << "Error: missing inputCheckpoints parameter" << std::endl;
+      std::cout << options.help() << std::endl;
+      return false;
+    }
+    //
+    if ( result.count( "outputCheckpoint" ) ) _outputCheckpointFilename = result["outputCheckpoint"].as<std::string>();
+
+  } catch ( const cxxopts::OptionException& e ) {
+    std::cout << "Error: parsing options, " << e.what() << std::endl;
+    return false;
+  }
+
+  // load and merge the records, in frame order as in a single run
+  mm::Checkpoint::Records merged;
+  for ( const auto& filename : _inputCheckpointFilenames ) {
+    std::string             mode;
+    mm::Checkpoint::Records records;
+    if ( !mm::Checkpoint::load( filename, mode, records ) ) return false;
+    if ( _mode == "" ) _mode = mode;
+    if ( mode != _mode ) {
+      std::cerr << "Error: checkpoint " << filename << " has results of mode " << mode << ", expected " << _mode
+                << std::endl;
+      return false;
+    }
+    std::cout << "Loaded " << records.size() << " frames from " << filename << std::endl;
+    for ( const auto& record : records ) {
+      auto it = merged.find( record.first );
+      if ( it == merged.end() ) {
+        merged.insert( record );
+      } else if ( it->second != record.second ) {
+        std::cout << "Warning: frame " << record.first << " of " << filename
+                  << " differs from a previous checkpoint, the first results are kept" << std::endl;
+      }
+    }
+  }
+  for ( const auto& record : merged ) {
+    if ( !_compare.addResultValues( _mode, record.second ) ) {
+      std::cerr << "Error: invalid results of frame " << record.first << " for mode " << _mode << std::endl;
+      return false;
+    }
+  }
+  if ( !merged.empty() ) {
+    const uint32_t first = merged.begin()->first;
+    const uint32_t last  = merged.rbegin()->first;
+    std::cout << "Merged " << merged.size() << " frames of mode " << _mode << " in [" << first << "," << last << "]"
+              << std::endl;
+    if ( merged.size() != (size_t)( last - first + 1 ) )
+      std::cout << "Warning: " << ( last - first + 1 - merged.size() ) << " frames of the range are missing"
+                << std::endl;
+  }
+  if ( _outputCheckpointFilename != "" && !mm::Checkpoint::save( _outputCheckpointFilename, _mode, merged ) )
+    return false;
+
+  return true;
+}
+
+bool CmdMerge::finalize() {
+  // Collect the statistics
+  if ( _mode == "pcc" ) { _compare.pccFinalize(); }
+  if ( _mode == "pcqm" ) { _compare.pcqmFinalize(); }
+  if ( _mode == "ibsm" ) { _compare.ibsmFinalize(); }
+  return true;
+}
@@ -52,6 +52,7 @@
 #include "mmGeometry.h"
 
 #include "mmCmdNormals.h"
+#include "mmTrace.h"
 
 const char* CmdNormals::name  = "normals";
 const char* CmdNormals::brief = "Computes the mesh normals.";
@@ -128,7 +129,7 @@ bool CmdNormals::process( uint32_t frame ) {
   *outputModel = *inputModel;
 
   // Perform the processings
-  clock_t t1 = clock();
+  mm::ScopedTimer timer( "processing", "command" );
 
   std::cout << "Normals generation" << std::endl;
   std::cout << "  NoSeams = " << _noSeams << std::endl;
@@ -136,8 +137,8 @@ bool CmdNormals::process( uint32_t frame ) {
 
   outputModel->computeVertexNormals( _normalized, _noSeams );
 
-  clock_t t2 = clock();
-  std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+  timer.stop();
+  std::cout << "Time on processing: " << timer.elapsed() << " sec." << std::endl;
 
   // save the result
   return mm::IO::saveModel( _outputModelFilename, outputModel );
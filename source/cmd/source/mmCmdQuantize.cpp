@@ -54,6 +54,7 @@
 #include "mmGeometry.h"
 #include "mmColor.h"
 #include "mmCmdQuantize.h"
+#include "mmTrace.h"
 
 const char* CmdQuantize::name  = "quantize";
 const char* CmdQuantize::brief = "Quantize model (mesh or point cloud)";
@@ -228,7 +229,7 @@ bool CmdQuantize::process( uint32_t frame ) {
   mm::ModelPtr outputModel( new mm::Model() );
 
   // Perform the processings
-  clock_t t1 = clock();
+  mm::ScopedTimer timer( "processing", "command" );
 
   std::cout << "Quantizing" << std::endl;
   std::cout << "  qp = " << _qp << std::endl;
@@ -307,8 +308,8 @@ bool CmdQuantize::process( uint32_t frame ) {
                             maxCol );
   }
 
-  clock_t t2 = clock();
-  std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+  timer.stop();
+  std::cout << "Time on processing: " << timer.elapsed() << " sec." << std::endl;
 
   // save the result
   return mm::IO::saveModel( _outputModelFilename, outputModel );
@@ -51,6 +51,7 @@
 #include "mmImage.h"
 #include "mmGeometry.h"
 #include "mmCmdReindex.h"
+#include "mmTrace.h"
 
 const char* CmdReindex::name  = "reindex";
 const char* CmdReindex::brief = "Reindex mesh and optionaly sort vertices and face indices";
@@ -120,7 +121,7 @@ bool CmdReindex::process( uint32_t frame ) {
   outputModel->comments  = inputModel->comments;
 
   // Perform the processings
-  clock_t t1 = clock();
+  mm::ScopedTimer timer( "processing", "command" );
 
   std::cout << "Reindex" << std::endl;
   std::cout << "  sort = " << _sort << std::endl;
@@ -132,8 +133,8 @@ bool CmdReindex::process( uint32_t frame ) {
     std::cout << "Error: invalid sorting method " << _sort << std::endl;
   }
 
-  clock_t t2 = clock();
-  std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+  timer.stop();
+  std::cout << "Time on processing: " << timer.elapsed() << " sec." << std::endl;
 
   // save the result
   return mm::IO::saveModel( _outputModelFilename, outputModel );
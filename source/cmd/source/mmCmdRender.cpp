@@ -51,6 +51,7 @@
 #include "mmImage.h"
 
 #include "mmCmdRender.h"
+#include "mmTrace.h"
 
 // Descriptions of the command
 const char* CmdRender::name  = "render";
@@ -249,7 +250,7 @@ bool CmdRender::process( uint32_t frame ) {
   if ( glm::distance( glm::abs( viewDir ), glm::vec3( 0, 1, 0 ) ) < 1e-6 ) viewUp = glm::vec3( 0, 0, 1 );
 
   // Perform the processings
-  clock_t t1 = clock();
+  mm::ScopedTimer timer( "processing", "command" );
   bool    res;
   if ( renderer == "sw_raster" ) {
     std::cout << "Render sw_raster" << std::endl;
@@ -286,8 +287,8 @@ bool CmdRender::process( uint32_t frame ) {
     return false;
   }
 
-  clock_t t2 = clock();
-  std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+  timer.stop();
+  std::cout << "Time on processing: " << timer.elapsed() << " sec." << std::endl;
 
   return success;
 }
@@ -36,6 +36,8 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <limits>
 #include <set>
 #include <time.h>
 #include <math.h>
@@ -53,6 +55,7 @@
 #include "mmModel.h"
 #include "mmImage.h"
 #include "mmCmdSample.h"
+#include "mmTrace.h"
 
 // Descriptions of the command
 const char* CmdSample::name = "sample";
@@ -82,6 +85,8 @@ bool CmdSample::initialize(Context* context, std::string app, int argc, char* ar
                 cxxopts::value<bool>()->default_value("false"))
             ("outputCsv", "filename of the file where per frame statistics will append.",
                 cxxopts::value<std::string>()->default_value(""))
+            ("template", "path to a sample template file. If the file exists and the input connectivity matches, points are evaluated from the recorded (triangle, barycentric) pairs, otherwise full sampling is performed and the template is written. Not available in map mode.",
+                cxxopts::value<std::string>()->default_value(""))
             ("h,help", "Print usage")
             ;
         options.add_options("face mode")
@@ -117,6 +122,8 @@ bool CmdSample::initialize(Context* context, std::string app, int argc, char* ar
         options.add_options("prnd mode")
             ("nbSamples", "integer value specifying the traget number of points in the output point cloud",
                 cxxopts::value<size_t>()->default_value("2000000"))
+            ("seed", "integer seed of the pseudo random generator, 0 uses the deterministic R2 sequence. A given seed produces the same points whatever the number of threads.",
+                cxxopts::value<uint32_t>()->default_value("0"))
             ;
         options.add_options("face and ediv modes")
             ("resolution", "integer value in [1,maxuint], step/edgeLength = resolution / size(largest bbox side). In ediv mode, the resolution is used only if lengthThreshold=0.",
@@ -126,12 +133,14 @@ bool CmdSample::initialize(Context* context, std::string app, int argc, char* ar
         options.add_options("grid, face, sdiv and ediv modes.")
             ("bilinear", "if set, texture filtering will be bilinear, nearest otherwise",
                 cxxopts::value<bool>()->default_value("false"))
-            ("nbSamplesMin", "if set different from 0, the system will rerun the sampling multiple times to find the best parameter producing a number of samples in [nbAmplesMin, nbSamplesMax]. This process is very time comsuming.",
+            ("nbSamplesMin", "if set different from 0, the system will rerun the sampling multiple times to find the best parameter producing a number of samples in [nbAmplesMin, nbSamplesMax]. The parameter is first searched using a point count estimator so the sampling is usually run only a few times.",
                 cxxopts::value<size_t>()->default_value("0"))
             ("nbSamplesMax", "see --nbSamplesMin documentation. Must be > to --nbSamplesMin.",
                 cxxopts::value<size_t>()->default_value("0"))
             ("maxIterations", "Maximum number of iterations in sample count constrained sampling, i.e. when --nbSampleMin > 0.",
                 cxxopts::value<size_t>()->default_value("10"))
+            ("streamTiles", "if set different from 0, the model box is split in streamTiles^3 tiles sampled one after the other and the points are streamed to the output binary ply file. Peak memory is bounded by the tile size instead of the output size. Not compatible with --nbSamplesMin and --template, output must be a ply file.",
+                cxxopts::value<size_t>()->default_value("0"))
             ;
         // clang-format on
 
@@ -172,6 +181,13 @@ bool CmdSample::initialize(Context* context, std::string app, int argc, char* ar
         //
         if (result.count("outputCsv")) _outputCsvFilename = result["outputCsv"].as<std::string>();
 
+        //
+        if (result.count("template")) _templateFilename = result["template"].as<std::string>();
+        if (_templateFilename != "" && mode == "map") {
+            std::cerr << "Error: template is not available in map mode" << std::endl;
+            return false;
+        }
+
         //
         if (result.count("hideProgress")) hideProgress = result["hideProgress"].as<bool>();
         //
@@ -193,9 +209,27 @@ bool CmdSample::initialize(Context* context, std::string app, int argc, char* ar
             }
         }
         if (result.count("maxIterations")) _maxIterations = result["maxIterations"].as<size_t>();
+        if (result.count("streamTiles")) _streamTiles = result["streamTiles"].as<size_t>();
+        if (_streamTiles != 0) {
+            if (mode != "face" && mode != "grid" && mode != "sdiv" && mode != "ediv") {
+                std::cerr << "Error: streamTiles is only available in face, grid, sdiv and ediv modes" << std::endl;
+                return false;
+            }
+            if (_nbSamplesMin != 0 || _templateFilename != "") {
+                std::cerr << "Error: streamTiles is not compatible with nbSamplesMin and template" << std::endl;
+                return false;
+            }
+            std::string ext = outputModelFilename.size() > 4 ? outputModelFilename.substr(outputModelFilename.size() - 4) : "";
+            std::for_each(ext.begin(), ext.end(), [](char& c) { c = ::tolower(c); });
+            if (outputModelFilename.substr(0, 3) == "ID:" || ext != ".ply") {
+                std::cerr << "Error: streamTiles requires a ply output file" << std::endl;
+                return false;
+            }
+        }
 
         // prnd options
         if (result.count("nbSamples")) _nbSamples = result["nbSamples"].as<size_t>();
+        if (result.count("seed")) _seed = result["seed"].as<uint32_t>();
 
         // grid options
         if (result.count("minPos")) {
@@ -216,6 +250,33 @@ bool CmdSample::initialize(Context* context, std::string app, int argc, char* ar
         }
         if (result.count("useFixedPoint")) { _useFixedPoint = result["useFixedPoint"].as<bool>(); }
 
+        // the parameters that place the points, a template recorded with other ones is resampled
+        std::ostringstream parameters;
+        parameters.precision(std::numeric_limits<float>::max_digits10);
+        parameters << "mode=" << mode;
+        if (mode == "face") {
+            parameters << " resolution=" << _resolution << " thickness=" << thickness;
+        }
+        else if (mode == "grid") {
+            parameters << " gridSize=" << _gridSize << " useNormal=" << _useNormal << " useFixedPoint=" << _useFixedPoint
+                << " minPos=" << _minPos.x << "," << _minPos.y << "," << _minPos.z << " maxPos=" << _maxPos.x << ","
+                << _maxPos.y << "," << _maxPos.z;
+        }
+        else if (mode == "sdiv") {
+            parameters << " maxDepth=" << maxDepth << " areaThreshold=" << areaThreshold << " mapThreshold=" << mapThreshold;
+        }
+        else if (mode == "ediv") {
+            parameters << " lengthThreshold=" << lengthThreshold << " resolution=" << _resolution;
+        }
+        else if (mode == "prnd") {
+            parameters << " nbSamples=" << _nbSamples << " seed=" << _seed;
+        }
+        if (mode != "prnd") {
+            parameters << " nbSamplesMin=" << _nbSamplesMin << " nbSamplesMax=" << _nbSamplesMax
+                << " maxIterations=" << _maxIterations;
+        }
+        _templateParameters = parameters.str();
+
     }
     catch (const cxxopts::OptionException& e) {
         std::cout << "error parsing options: " << e.what() << std::endl;
@@ -272,8 +333,39 @@ bool CmdSample::process(uint32_t frame) {
         csvFileOut.precision(std::numeric_limits<float>::max_digits10);
     }
 
+    // reload the template recorded by a previous run if any
+    if (_templateFilename != "" && !_templateValid && std::ifstream(_templateFilename)) {
+        _templateValid = mm::Sample::loadTemplate(_templateFilename, _template);
+        if (_templateValid && _template.parameters != _templateParameters) {
+            std::cout << "Template parameters (" << _template.parameters << ") do not match the command line ("
+                << _templateParameters << "), resampling" << std::endl;
+            _templateValid = false;
+        }
+    }
+    mm::SampleTemplate* templateRecorder = _templateFilename != "" ? &_template : nullptr;
+
+    // out of core sampling, points are streamed to the output file tile by tile
+    mm::PlyStreamWriter streamWriter;
+    size_t streamCount = 0;
+    bool   streamOk = true;
+    const auto sampleTiles = [&](const std::function<void(const mm::Model&, const glm::vec3&, const glm::vec3&, mm::Model&)>& sampler) {
+        streamOk = streamWriter.open(mm::IO::resolveName(frame, outputModelFilename));
+        if (!streamOk) return;
+        mm::Sample::meshToPcTiles(*inputModel, _streamTiles, mode == "face" ? thickness : 0.0F, sampler,
+            [&](const mm::Model& points) { streamOk = streamWriter.write(points) && streamOk; }, !hideProgress);
+        streamOk = streamWriter.close() && streamOk;
+        streamCount = streamWriter.getCount();
+    };
+    const auto outputCount = [&]() { return _streamTiles != 0 ? streamCount : outputModel->getPositionCount(); };
+
     // Perform the processings
-    clock_t t1 = clock();
+    mm::ScopedTimer timer("processing", "command");
+    bool fromTemplate = _templateValid
+        && mm::Sample::meshToPcTemplate(*inputModel, *outputModel, textureMapList, _template, bilinear, !hideProgress);
+    if (fromTemplate) {
+        std::cout << "Sampling from template " << _templateFilename << std::endl;
+        std::cout << "  nbPoints = " << _template.size() << std::endl;
+    }
     if (mode == "face") {
         std::cout << "Sampling in FACE mode" << std::endl;
         std::cout << "  Resolution = " << _resolution << std::endl;
@@ -284,8 +376,11 @@ bool CmdSample::process(uint32_t frame) {
         std::cout << "  nbSamplesMax = " << _nbSamplesMax << std::endl;
         std::cout << "  maxIterations = " << _maxIterations << std::endl;
         size_t computedResolution = 0;
-        if (_nbSamplesMin != 0) {
-            std::cout << "  using contrained mode with nbSamples (costly!)" << std::endl;
+        if (fromTemplate) {
+            std::cout << "  using template" << std::endl;
+        }
+        else if (_nbSamplesMin != 0) {
+            std::cout << "  using contrained mode with nbSamples" << std::endl;
             mm::Sample::meshToPcFace(
                 *inputModel,
                 *outputModel,
@@ -296,12 +391,20 @@ bool CmdSample::process(uint32_t frame) {
                 thickness,
                 bilinear,
                 !hideProgress,
-                computedResolution);
+                computedResolution,
+                templateRecorder);
+        }
+        else if (_streamTiles != 0) {
+            std::cout << "  using streaming by tiles" << std::endl;
+            sampleTiles([&](const mm::Model& tile, const glm::vec3& minBox, const glm::vec3& maxBox, mm::Model& points) {
+                mm::Sample::meshToPcFace(
+                    tile, points, textureMapList, _resolution, thickness, bilinear, false, minBox, maxBox);
+            });
         }
         else {
             std::cout << "  using contrained mode with resolution " << std::endl;
             mm::Sample::meshToPcFace(
-                *inputModel, *outputModel, textureMapList, _resolution, thickness, bilinear, !hideProgress);
+                *inputModel, *outputModel, textureMapList, _resolution, thickness, bilinear, !hideProgress, templateRecorder);
         }
         // print the stats
         if (csvFileOut) {
@@ -313,7 +416,7 @@ bool CmdSample::process(uint32_t frame) {
             // print stats
             csvFileOut << inputModelFilename << ";" << textureMapUrls[0] << ";" << frame << ";" << _resolution << ";"
                 << thickness << ";" << bilinear << ";" << _nbSamplesMin << ";" << _nbSamplesMax << ";"
-                << _maxIterations << ";" << computedResolution << ";" << outputModel->getPositionCount() << std::endl;
+                << _maxIterations << ";" << computedResolution << ";" << outputCount() << std::endl;
             // done
             csvFileOut.close();
         }
@@ -328,8 +431,11 @@ bool CmdSample::process(uint32_t frame) {
         std::cout << "  nbSamplesMax = " << _nbSamplesMax << std::endl;
         std::cout << "  maxIterations = " << _maxIterations << std::endl;
         size_t computedResolution = 0;
-        if (_nbSamplesMin != 0) {
-            std::cout << "  using contrained mode with nbSamples (costly!)" << std::endl;
+        if (fromTemplate) {
+            std::cout << "  using template" << std::endl;
+        }
+        else if (_nbSamplesMin != 0) {
+            std::cout << "  using contrained mode with nbSamples" << std::endl;
             mm::Sample::meshToPcGrid(*inputModel,
                 *outputModel,
                 textureMapList,
@@ -342,7 +448,22 @@ bool CmdSample::process(uint32_t frame) {
                 _useFixedPoint,
                 _minPos,
                 _maxPos,
-                computedResolution);
+                computedResolution,
+                templateRecorder);
+        }
+        else if (_streamTiles != 0) {
+            std::cout << "  using streaming by tiles" << std::endl;
+            sampleTiles([&](const mm::Model& tile, const glm::vec3& minBox, const glm::vec3& maxBox, mm::Model& points) {
+                // without a range the model box is given, the sampler then ignores the fixed point as for a computed box
+                glm::vec3 minPos = _minPos, maxPos = _maxPos;
+                const bool useFixedPoint = _useFixedPoint && minPos != maxPos;
+                if (minPos == maxPos) {
+                    minPos = minBox;
+                    maxPos = maxBox;
+                }
+                mm::Sample::meshToPcGrid(tile, points, textureMapList, _gridSize, bilinear, false, _useNormal,
+                    useFixedPoint, minPos, maxPos, false);
+            });
         }
         else {
             std::cout << "  using contrained mode with gridSize " << std::endl;
@@ -355,7 +476,10 @@ bool CmdSample::process(uint32_t frame) {
                 _useNormal,
                 _useFixedPoint,
                 _minPos,
-                _maxPos);
+                _maxPos,
+                true,
+                nullptr,
+                templateRecorder);
         }
         // print the stats
         if (csvFileOut) {
@@ -367,7 +491,7 @@ bool CmdSample::process(uint32_t frame) {
             // print stats
             csvFileOut << inputModelFilename << ";" << textureMapUrls[0] << ";" << frame << ";" << mode << ";" << _gridSize
                 << ";" << _useNormal << ";" << bilinear << ";" << _nbSamplesMin << ";" << _nbSamplesMax << ";"
-                << _maxIterations << ";" << computedResolution << ";" << outputModel->getPositionCount() << std::endl;
+                << _maxIterations << ";" << computedResolution << ";" << outputCount() << std::endl;
             // done
             csvFileOut.close();
         }
@@ -382,7 +506,7 @@ bool CmdSample::process(uint32_t frame) {
             if (csvFileLength == 0) { csvFileOut << "model;texture;frame;mode;nbSamples" << std::endl; }
             // print stats
             csvFileOut << inputModelFilename << ";" << textureMapUrls[0] << ";" << frame << ";" << mode << ";"
-                << outputModel->getPositionCount() << std::endl;
+                << outputCount() << std::endl;
             // done
             csvFileOut.close();
         }
@@ -398,8 +522,11 @@ bool CmdSample::process(uint32_t frame) {
         std::cout << "  nbSamplesMax = " << _nbSamplesMax << std::endl;
         std::cout << "  maxIterations = " << _maxIterations << std::endl;
         float computedThres = 0.0f;
-        if (_nbSamplesMin != 0) {
-            std::cout << "  using contrained mode with nbSamples (costly!)" << std::endl;
+        if (fromTemplate) {
+            std::cout << "  using template" << std::endl;
+        }
+        else if (_nbSamplesMin != 0) {
+            std::cout << "  using contrained mode with nbSamples" << std::endl;
             mm::Sample::meshToPcDiv(*inputModel,
                 *outputModel,
                 textureMapList,
@@ -408,11 +535,20 @@ bool CmdSample::process(uint32_t frame) {
                 _maxIterations,
                 bilinear,
                 !hideProgress,
-                computedThres);
+                computedThres,
+                templateRecorder);
+        }
+        else if (_streamTiles != 0) {
+            std::cout << "  using streaming by tiles" << std::endl;
+            sampleTiles([&](const mm::Model& tile, const glm::vec3&, const glm::vec3&, mm::Model& points) {
+                mm::Sample::meshToPcDiv(
+                    tile, points, textureMapList, maxDepth, areaThreshold, mapThreshold, bilinear, false);
+            });
         }
         else {
             mm::Sample::meshToPcDiv(
-                *inputModel, *outputModel, textureMapList, maxDepth, areaThreshold, mapThreshold, bilinear, !hideProgress);
+                *inputModel, *outputModel, textureMapList, maxDepth, areaThreshold, mapThreshold, bilinear, !hideProgress,
+                templateRecorder);
         }
         // print the stats
         if (csvFileOut) {
@@ -424,7 +560,7 @@ bool CmdSample::process(uint32_t frame) {
             // print stats
             csvFileOut << inputModelFilename << ";" << textureMapUrls[0] << ";" << frame << ";" << mode << ";"
                 << areaThreshold << ";" << bilinear << ";" << _nbSamplesMin << ";" << _nbSamplesMax << ";"
-                << _maxIterations << ";" << computedThres << ";" << outputModel->getPositionCount() << std::endl;
+                << _maxIterations << ";" << computedThres << ";" << outputCount() << std::endl;
             // done
             csvFileOut.close();
         }
@@ -439,8 +575,11 @@ bool CmdSample::process(uint32_t frame) {
         std::cout << "  nbSamplesMax = " << _nbSamplesMax << std::endl;
         std::cout << "  maxIterations = " << _maxIterations << std::endl;
         float computedThres = 0.0f;
-        if (_nbSamplesMin != 0) {
-            std::cout << "  using contrained mode with nbSamples (costly!)" << std::endl;
+        if (fromTemplate) {
+            std::cout << "  using template" << std::endl;
+        }
+        else if (_nbSamplesMin != 0) {
+            std::cout << "  using contrained mode with nbSamples" << std::endl;
             mm::Sample::meshToPcDivEdge(*inputModel,
                 *outputModel,
                 textureMapList,
@@ -449,11 +588,26 @@ bool CmdSample::process(uint32_t frame) {
                 _maxIterations,
                 bilinear,
                 !hideProgress,
-                computedThres);
+                computedThres,
+                templateRecorder);
+        }
+        else if (_streamTiles != 0) {
+            std::cout << "  using streaming by tiles" << std::endl;
+            sampleTiles([&](const mm::Model& tile, const glm::vec3& minBox, const glm::vec3& maxBox, mm::Model& points) {
+                // the threshold derived from the resolution uses the model box, as the sampler would
+                float length = lengthThreshold;
+                if (length == 0 && _resolution != 0) {
+                    const glm::vec3 diag = maxBox - minBox;
+                    length = computedThres = std::max(diag.x, std::max(diag.y, diag.z)) / _resolution;
+                }
+                mm::Sample::meshToPcDivEdge(
+                    tile, points, textureMapList, length, _resolution, bilinear, false, computedThres);
+            });
         }
         else {
             mm::Sample::meshToPcDivEdge(
-                *inputModel, *outputModel, textureMapList, lengthThreshold, _resolution, bilinear, !hideProgress, computedThres);
+                *inputModel, *outputModel, textureMapList, lengthThreshold, _resolution, bilinear, !hideProgress, computedThres,
+                templateRecorder);
         }
         // print the stats
         if (csvFileOut) {
@@ -466,7 +620,7 @@ bool CmdSample::process(uint32_t frame) {
             csvFileOut << inputModelFilename << ";" << textureMapUrls[0] << ";" << frame << ";" << mode << ";"
                 << _resolution << ";" << lengthThreshold << ";" << bilinear << ";" << _nbSamplesMin << ";"
                 << _nbSamplesMax << ";" << _maxIterations << ";" << computedThres << ";"
-                << outputModel->getPositionCount() << std::endl;
+                << outputCount() << std::endl;
             // done
             csvFileOut.close();
         }
@@ -474,9 +628,13 @@ bool CmdSample::process(uint32_t frame) {
     else if (mode == "prnd") {
         std::cout << "Sampling in PRND mode" << std::endl;
         std::cout << "  nbSamples = " << _nbSamples << std::endl;
+        std::cout << "  seed = " << _seed << std::endl;
         std::cout << "  Bilinear = " << bilinear << std::endl;
         std::cout << "  hideProgress = " << hideProgress << std::endl;
-        mm::Sample::meshToPcPrnd(*inputModel, *outputModel, textureMapList, _nbSamples, bilinear, !hideProgress);
+        if (!fromTemplate) {
+            mm::Sample::meshToPcPrnd(
+                *inputModel, *outputModel, textureMapList, _nbSamples, bilinear, !hideProgress, templateRecorder, _seed);
+        }
         // print the stats
         if (csvFileOut) {
             // print the header if file is empty
@@ -485,13 +643,23 @@ bool CmdSample::process(uint32_t frame) {
             }
             // print stats
             csvFileOut << inputModelFilename << ";" << textureMapUrls[0] << ";" << frame << ";" << mode << ";"
-                << _nbSamples << ";" << bilinear << ";" << outputModel->getPositionCount() << std::endl;
+                << _nbSamples << ";" << bilinear << ";" << outputCount() << std::endl;
             // done
             csvFileOut.close();
         }
     }
-    clock_t t2 = clock();
-    std::cout << "Time on processing: " << ((float)(t2 - t1)) / CLOCKS_PER_SEC << " sec." << std::endl;
+    timer.stop();
+    std::cout << "Time on processing: " << timer.elapsed() << " sec." << std::endl;
+
+    // record the template for the next frames
+    if (templateRecorder && !fromTemplate) {
+        std::cout << "Saving template " << _templateFilename << std::endl;
+        _template.parameters = _templateParameters;
+        _templateValid = mm::Sample::saveTemplate(_templateFilename, _template);
+    }
+
+    // points were already written
+    if (_streamTiles != 0) return streamOk;
 
     // save the result
     return mm::IO::saveModel(outputModelFilename, outputModel);
@@ -33,9 +33,11 @@
  */
 
 #include <iostream>
+#include <cstdio>
 #include <algorithm>
 #include <fstream>
 #include <unordered_map>
+#include <sstream>
 #include <time.h>
 
 // argument parsing
@@ -48,6 +50,32 @@
 const char* CmdSequence::name  = "sequence";
 const char* CmdSequence::brief = "Sequence global parameters";
 
+// parses a comma separated list of frames and inclusive frame ranges, e.g. "1,3,10-20",
+// the frames must lie in [firstFrame,lastFrame], checked before a range is expanded
+static bool parseFrameList( const std::string&     str,
+                            const long             firstFrame,
+                            const long             lastFrame,
+                            std::vector<uint32_t>& frames ) {
+  std::istringstream iss( str );
+  std::string        token;
+  while ( std::getline( iss, token, ',' ) ) {
+    if ( token.empty() ) continue;
+    const size_t dash = token.find( '-', 1 );
+    char*        end  = NULL;
+    const long   from = strtol( token.c_str(), &end, 10 );
+    long         to   = from;
+    if ( dash != std::string::npos ) {
+      if ( end != token.c_str() + dash ) return false;
+      to = strtol( token.c_str() + dash + 1, &end, 10 );
+    }
+    if ( *end != '\0' || from < firstFrame || to > lastFrame || to < from ) return false;
+    for ( long frame = from; frame <= to; ++frame ) frames.push_back( (uint32_t)frame );
+  }
+  std::sort( frames.begin(), frames.end() );
+  frames.erase( std::unique( frames.begin(), frames.end() ), frames.end() );
+  return !frames.empty();
+}
+
 //
 Command* CmdSequence::create() { return new CmdSequence(); }
 
@@ -62,6 +90,10 @@ bool CmdSequence::initialize( Context* ctx, std::string app, int argc, char* arg
 				cxxopts::value<int>()->default_value("0"))
 			("lastFrame", "Sets the last frame of the sequence, included. Must be >= to firstFrame.",
 				cxxopts::value<int>()->default_value("0"))
+			("frames", "Restricts the processing to a list of frames of the sequence, comma separated frames or ranges such as 1,3,10-20.",
+				cxxopts::value<std::string>())
+			("frameShard", "Restricts the processing to the shard i of N contiguous blocks of the frames to process, formatted as i/N with 0 <= i < N.",
+				cxxopts::value<std::string>())
 			("h,help", "Print usage")
 			;
     // clang-format on
@@ -84,6 +116,37 @@ bool CmdSequence::initialize( Context* ctx, std::string app, int argc, char* arg
       return false;
     }
     ctx->setFrameRange( firstFrame, lastFrame );
+    // subset of the frames
+    std::vector<uint32_t> frames = ctx->getFrames();
+    if ( result.count( "frames" ) ) {
+      const std::string list = result["frames"].as<std::string>();
+      frames.clear();
+      if ( !parseFrameList( list, firstFrame, lastFrame, frames ) || !ctx->setFrames( frames ) ) {
+        std::cerr << "Error: invalid --frames \"" << list << "\", expected frames or ranges in [" << firstFrame
+                  << "," << lastFrame << "]" << std::endl;
+        return false;
+      }
+    }
+    if ( result.count( "frameShard" ) ) {
+      const std::string shard = result["frameShard"].as<std::string>();
+      unsigned int      index = 0, count = 0;
+      char              sep = 0, extra = 0;
+      if ( sscanf( shard.c_str(), "%u %c %u %c", &index, &sep, &count, &extra ) != 3 || sep != '/' || count == 0 ||
+           index >= count ) {
+        std::cerr << "Error: invalid --frameShard \"" << shard << "\", expected i/N with 0 <= i < N" << std::endl;
+        return false;
+      }
+      // contiguous blocks of balanced sizes, shard sizes differ by one frame at most
+      const size_t          first = frames.size() * index / count;
+      const size_t          last  = frames.size() * ( index + 1 ) / count;
+      std::vector<uint32_t> shardFrames( frames.begin() + first, frames.begin() + last );
+      if ( shardFrames.empty() ) {
+        std::cerr << "Error: --frameShard " << shard << " has no frame, only " << frames.size()
+                  << " frames to process" << std::endl;
+        return false;
+      }
+      ctx->setFrames( shardFrames );
+    }
   } catch ( const cxxopts::OptionException& e ) {
     std::cout << "Error: parsing options, " << e.what() << std::endl;
     return false;
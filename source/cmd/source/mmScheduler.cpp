@@ -0,0 +1,311 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// internal headers
+#include "mmThreadPool.h"
+#include "mmTrace.h"
+#include "mmScheduler.h"
+
+using namespace mm;
+
+// true if the values of the option are read or written by the command
+static bool isResourceOption( const std::string& option ) {
+  static const char* others[] = { "checkpoint",  "memo",         "template",        "distortedModel",
+                                  "faceMapFile", "vertexMapFile", "ibsmOutputPrefix" };
+  if ( option.compare( 0, 5, "input" ) == 0 || option.compare( 0, 6, "output" ) == 0 ) return true;
+  for ( const char* other : others )
+    if ( option == other ) return true;
+  return false;
+}
+
+// long names of the short options declared by the commands (e.g. "i,inputModel"),
+// empty if the alias is not a resource option
+static std::string longOption( char alias ) {
+  switch ( alias ) {
+    case 'i': return "inputModel";
+    case 'm': return "inputMap";
+    case 'o': return "outputModel";  // or outputImage for render
+    default: return "";
+  }
+}
+
+// lists of maps and checkpoints are separated by spaces or commas
+static void addResources( const std::string& value, std::vector<std::string>& resources ) {
+  size_t start = 0;
+  while ( start < value.size() ) {
+    size_t end = value.find_first_of( " ,", start );
+    if ( end == std::string::npos ) end = value.size();
+    if ( end > start ) resources.push_back( value.substr( start, end - start ) );
+    start = end + 1;
+  }
+}
+
+//
+void Scheduler::add( Command* command, int argc, char* argv[] ) {
+  Node node;
+  node.command    = command;
+  node.name       = argv[0];
+  node.mainThread = command->isMainThreadOnly();
+  for ( int i = 1; i < argc; ++i ) {
+    const std::string arg = argv[i];
+    std::string       option, value;
+    bool              hasValue = false;
+    if ( arg.compare( 0, 2, "--" ) == 0 ) {
+      const size_t eq = arg.find( '=' );
+      option          = arg.substr( 2, eq == std::string::npos ? std::string::npos : eq - 2 );
+      if ( eq != std::string::npos ) {
+        value    = arg.substr( eq + 1 );
+        hasValue = true;
+      }
+    } else if ( arg.size() >= 2 && arg[0] == '-' ) {
+      // short option, -i value, -ivalue or -i=value
+      option = longOption( arg[1] );
+      if ( arg.size() > 2 ) {
+        value    = arg.substr( arg[2] == '=' ? 3 : 2 );
+        hasValue = true;
+      }
+    } else {
+      continue;
+    }
+    if ( option.empty() || !isResourceOption( option ) ) continue;
+    if ( hasValue ) {
+      addResources( value, node.resources );
+    } else if ( i + 1 < argc && std::string( argv[i + 1] ).compare( 0, 2, "--" ) != 0 ) {
+      addResources( argv[++i], node.resources );
+    }
+  }
+  // the last previous user of each resource must be done first
+  for ( const std::string& resource : node.resources ) {
+    for ( size_t prev = _nodes.size(); prev-- != 0; ) {
+      const std::vector<std::string>& used = _nodes[prev].resources;
+      if ( std::find( used.begin(), used.end(), resource ) == used.end() ) continue;
+      if ( std::find( node.predecessors.begin(), node.predecessors.end(), prev ) == node.predecessors.end() ) {
+        node.predecessors.push_back( prev );
+        _nodes[prev].successors.push_back( _nodes.size() );
+      }
+      break;
+    }
+  }
+  std::sort( node.predecessors.begin(), node.predecessors.end() );
+  _nodes.push_back( node );
+}
+
+//
+void Scheduler::log( std::ostream& out ) const {
+  out << "Concurrent processing of the commands:" << std::endl;
+  for ( size_t i = 0; i < _nodes.size(); ++i ) {
+    out << "  " << i << " " << _nodes[i].name;
+    if ( !_nodes[i].predecessors.empty() ) {
+      out << " after";
+      for ( size_t prev : _nodes[i].predecessors ) out << " " << prev;
+    }
+    if ( _nodes[i].mainThread ) out << " (main thread)";
+    out << std::endl;
+  }
+}
+
+// the buffers receiving the standard and error outputs of the command run by the thread
+static thread_local std::string* s_targets[2] = { NULL, NULL };
+
+// stream buffer installed on std::cout or std::cerr, the writes of a thread
+// running a command go to the buffer of the command, others to the original buffer
+class mm::CaptureBuffer : public std::streambuf {
+ public:
+  CaptureBuffer( std::ostream& stream, size_t index ) : _stream( stream ), _index( index ) {
+    _original = _stream.rdbuf( this );
+  }
+  ~CaptureBuffer() { _stream.rdbuf( _original ); }
+
+  // writes the buffered output of a command
+  void write( const std::string& text ) {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _original->sputn( text.data(), (std::streamsize)text.size() );
+    _original->pubsync();
+  }
+
+ protected:
+  int overflow( int c ) override {
+    if ( c == traits_type::eof() ) return traits_type::not_eof( c );
+    const char ch = (char)c;
+    return xsputn( &ch, 1 ) == 1 ? c : traits_type::eof();
+  }
+
+  std::streamsize xsputn( const char* s, std::streamsize n ) override {
+    if ( s_targets[_index] != NULL ) {
+      s_targets[_index]->append( s, (size_t)n );
+      return n;
+    }
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _original->sputn( s, n );
+  }
+
+  int sync() override {
+    if ( s_targets[_index] != NULL ) return 0;
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _original->pubsync();
+  }
+
+ private:
+  std::ostream&   _stream;
+  size_t          _index;
+  std::streambuf* _original;
+  std::mutex      _mutex;
+};
+
+//
+Scheduler::Scheduler() {}
+
+//
+Scheduler::~Scheduler() {}
+
+//
+int Scheduler::process( uint32_t frame ) {
+  const size_t count = _nodes.size();
+
+  // nothing can overlap, same as the sequential processing
+  if ( count < 2 || ThreadPool::getThreadCount() <= 1 ) {
+    int errors = 0;
+    for ( const Node& node : _nodes ) {
+      MM_TRACE_SCOPE( node.name, "command" );
+      if ( !node.command->process( frame ) ) errors++;
+    }
+    return errors;
+  }
+
+  struct State {
+    std::string out, err;
+    size_t      waiting;
+    bool        done    = false;
+    bool        success = false;
+  };
+  std::vector<State> states( count );
+  for ( size_t i = 0; i < count; ++i ) states[i].waiting = _nodes[i].predecessors.size();
+
+  if ( !_out ) {
+    _out.reset( new CaptureBuffer( std::cout, 0 ) );
+    _err.reset( new CaptureBuffer( std::cerr, 1 ) );
+  }
+  std::mutex              mutex;
+  std::condition_variable cond;
+  std::deque<size_t>      mainReady;  // commands ready to run on the main thread
+  size_t                  doneCount = 0;
+  size_t                  printed   = 0;
+  bool                    hasMain   = false;
+  for ( const Node& node : _nodes ) hasMain = hasMain || node.mainThread;
+
+  TaskGroup                     group;
+  std::function<void( size_t )> launch;
+
+  // runs command i and captures its outputs, the targets are restored since a thread waiting
+  // for nested tasks of a command may run another command meanwhile
+  auto execute = [&]( size_t i ) {
+    std::string* saved[2] = { s_targets[0], s_targets[1] };
+    s_targets[0]          = &states[i].out;
+    s_targets[1]          = &states[i].err;
+    try {
+      MM_TRACE_SCOPE( _nodes[i].name, "command" );
+      states[i].success = _nodes[i].command->process( frame );
+    } catch ( const std::exception& e ) {
+      states[i].err += std::string( "Error: " ) + e.what() + "\n";
+      states[i].success = false;
+    }
+    s_targets[0] = saved[0];
+    s_targets[1] = saved[1];
+  };
+
+  // marks command i as done, prints the outputs available in argv order, launches the ready successors
+  auto finish = [&]( size_t i ) {
+    std::vector<size_t> ready;
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      states[i].done = true;
+      doneCount++;
+      while ( printed < count && states[printed].done ) {
+        _out->write( states[printed].out );
+        _err->write( states[printed].err );
+        printed++;
+      }
+      for ( size_t next : _nodes[i].successors )
+        if ( --states[next].waiting == 0 ) ready.push_back( next );
+    }
+    cond.notify_all();
+    for ( size_t next : ready ) launch( next );
+  };
+
+  launch = [&]( size_t i ) {
+    if ( _nodes[i].mainThread ) {
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+        mainReady.push_back( i );
+      }
+      cond.notify_all();
+    } else {
+      group.run( [&, i]() {
+        execute( i );
+        finish( i );
+      } );
+    }
+  };
+
+  for ( size_t i = 0; i < count; ++i )
+    if ( states[i].waiting == 0 ) launch( i );
+
+  // runs the commands that must stay on the main thread (e.g. OpenGL context) as they get ready
+  if ( hasMain ) {
+    std::unique_lock<std::mutex> lock( mutex );
+    while ( true ) {
+      cond.wait( lock, [&] { return !mainReady.empty() || doneCount == count; } );
+      if ( mainReady.empty() ) break;
+      const size_t i = mainReady.front();
+      mainReady.pop_front();
+      lock.unlock();
+      execute( i );
+      finish( i );
+      lock.lock();
+    }
+  }
+  group.wait();
+
+  int errors = 0;
+  for ( const State& state : states )
+    if ( !state.success ) errors++;
+  return errors;
+}
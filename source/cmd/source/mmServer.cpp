@@ -0,0 +1,551 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+
+#ifndef _WIN32
+#  include <unistd.h>
+#  include <poll.h>
+#  include <signal.h>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <sys/un.h>
+#endif
+
+// argument parsing
+#include <cxxopts.hpp>
+
+// internal headers
+#include "mmIO.h"
+#include "mmThreadPool.h"
+#include "mmTrace.h"
+#include "mmTextureCache.h"
+#include "mmServer.h"
+
+using namespace mm;
+
+// request: magic, protocol version, kind, argument count, then each argument as length + bytes
+// the first argument is the working directory of the client
+// response: frames of type + length + payload, 'o' standard output, 'e' error output,
+// 'r' the exit code as a 32 bits integer, last frame of the response
+static const char     s_magic[4]        = { 'M', 'M', 'S', 'V' };
+static const uint32_t s_version         = 1;
+static const uint32_t s_kindRun         = 0;
+static const uint32_t s_kindShutdown    = 1;
+static const char*    s_defaultSocket   = "/tmp/mm.sock";
+static const uint32_t s_maxArgumentSize = 1 << 20;
+
+#ifndef _WIN32
+
+// writes the whole buffer, returns false if the peer is gone
+static bool sendAll( int fd, const void* data, size_t size ) {
+  const char* ptr = (const char*)data;
+  while ( size != 0 ) {
+    const ssize_t sent = ::send( fd, ptr, size, MSG_NOSIGNAL );
+    if ( sent < 0 && errno == EINTR ) continue;
+    if ( sent <= 0 ) return false;
+    ptr += sent;
+    size -= (size_t)sent;
+  }
+  return true;
+}
+
+// reads exactly size bytes, returns false on end of stream or error
+static bool recvAll( int fd, void* data, size_t size ) {
+  char* ptr = (char*)data;
+  while ( size != 0 ) {
+    const ssize_t received = ::recv( fd, ptr, size, 0 );
+    if ( received < 0 && errno == EINTR ) continue;
+    if ( received <= 0 ) return false;
+    ptr += received;
+    size -= (size_t)received;
+  }
+  return true;
+}
+
+static bool sendUint32( int fd, uint32_t value ) { return sendAll( fd, &value, sizeof( value ) ); }
+
+static bool recvUint32( int fd, uint32_t& value ) { return recvAll( fd, &value, sizeof( value ) ); }
+
+typedef std::chrono::steady_clock::time_point Deadline;
+
+// reads exactly size bytes before the deadline, returns false on end of stream, error or timeout
+static bool recvAll( int fd, void* data, size_t size, const Deadline& deadline ) {
+  char* ptr = (char*)data;
+  while ( size != 0 ) {
+    const auto remaining =
+      std::chrono::duration_cast<std::chrono::milliseconds>( deadline - std::chrono::steady_clock::now() ).count();
+    if ( remaining <= 0 ) return false;
+    pollfd    request = { fd, POLLIN, 0 };
+    const int ready   = ::poll( &request, 1, (int)remaining );
+    if ( ready < 0 && errno == EINTR ) continue;
+    if ( ready <= 0 ) return false;
+    const ssize_t received = ::recv( fd, ptr, size, 0 );
+    if ( received < 0 && errno == EINTR ) continue;
+    if ( received <= 0 ) return false;
+    ptr += received;
+    size -= (size_t)received;
+  }
+  return true;
+}
+
+static bool recvUint32( int fd, uint32_t& value, const Deadline& deadline ) {
+  return recvAll( fd, &value, sizeof( value ), deadline );
+}
+
+static bool sendFrame( int fd, char type, const char* data, uint32_t size ) {
+  return sendAll( fd, &type, 1 ) && sendUint32( fd, size ) && ( size == 0 || sendAll( fd, data, size ) );
+}
+
+// fills the socket address, returns false if the path does not fit
+static bool makeAddress( const std::string& path, sockaddr_un& address ) {
+  memset( &address, 0, sizeof( address ) );
+  address.sun_family = AF_UNIX;
+  if ( path.empty() || path.size() >= sizeof( address.sun_path ) ) {
+    std::cerr << "Error: invalid socket path " << path << ", at most " << sizeof( address.sun_path ) - 1
+              << " characters" << std::endl;
+    return false;
+  }
+  memcpy( address.sun_path, path.c_str(), path.size() );
+  return true;
+}
+
+// connected socket or -1
+static int connectTo( const sockaddr_un& address ) {
+  const int fd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+  if ( fd < 0 ) return -1;
+  if ( ::connect( fd, (const sockaddr*)&address, sizeof( address ) ) != 0 ) {
+    ::close( fd );
+    return -1;
+  }
+  return fd;
+}
+
+// removes a socket file left at path, any other kind of file is kept
+// returns false if the path exists and is not a socket
+static bool removeSocketFile( const std::string& path ) {
+  struct stat status;
+  if ( ::lstat( path.c_str(), &status ) != 0 ) return errno == ENOENT;
+  if ( !S_ISSOCK( status.st_mode ) ) {
+    std::cerr << "Error: " << path << " exists and is not a socket, not removed" << std::endl;
+    return false;
+  }
+  ::unlink( path.c_str() );
+  return true;
+}
+
+// stream buffer forwarding the outputs of a request to the client as frames of the given type
+// the logs can be written by several threads, the buffer is unbuffered for the stream
+// (no put area) so that every write goes through the locked overflow and xsputn
+class SocketBuffer : public std::streambuf {
+ public:
+  SocketBuffer( int fd, char type ) : _fd( fd ), _type( type ) { setp( nullptr, nullptr ); }
+  ~SocketBuffer() { sync(); }
+
+  // writes to the buffer from another thread
+  void write( const char* s, size_t n ) { xsputn( s, (std::streamsize)n ); }
+
+ protected:
+  virtual int_type overflow( int_type c ) {
+    if ( !traits_type::eq_int_type( c, traits_type::eof() ) ) {
+      const char ch = traits_type::to_char_type( c );
+      xsputn( &ch, 1 );
+    }
+    return traits_type::not_eof( c );
+  }
+  virtual std::streamsize xsputn( const char* s, std::streamsize n ) {
+    std::lock_guard<std::mutex> lock( _mutex );
+    if ( n > (std::streamsize)sizeof( _buffer ) - (std::streamsize)_size ) {
+      flush();
+      if ( n > (std::streamsize)sizeof( _buffer ) ) {
+        send( s, (size_t)n );
+        return n;
+      }
+    }
+    memcpy( _buffer + _size, s, (size_t)n );
+    _size += (size_t)n;
+    return n;
+  }
+  virtual int sync() {
+    std::lock_guard<std::mutex> lock( _mutex );
+    flush();
+    return 0;
+  }
+
+ private:
+  void flush( void ) {
+    send( _buffer, _size );
+    _size = 0;
+  }
+  // once the client is gone the outputs are dropped, the request still completes
+  void send( const char* data, size_t size ) {
+    if ( size != 0 && _connected ) _connected = sendFrame( _fd, _type, data, (uint32_t)size );
+  }
+
+  int        _fd;
+  char       _type;
+  bool       _connected = true;
+  char       _buffer[4096];
+  size_t     _size = 0;
+  std::mutex _mutex;
+};
+
+// redirects a standard file descriptor (e.g. printf of the dependencies) to a stream buffer
+// while in scope, through a pipe read by a thread
+class DescriptorCapture {
+ public:
+  DescriptorCapture( int fd, FILE* file, SocketBuffer& buffer ) : _fd( fd ), _file( file ) {
+    int pipeFds[2];
+    fflush( _file );
+    if ( ::pipe( pipeFds ) != 0 ) return;
+    _saved = ::dup( _fd );
+    ::dup2( pipeFds[1], _fd );
+    ::close( pipeFds[1] );
+    const int readFd = pipeFds[0];
+    _reader          = std::thread( [readFd, &buffer] {
+      char    data[4096];
+      ssize_t size;
+      while ( ( size = ::read( readFd, data, sizeof( data ) ) ) != 0 ) {
+        if ( size > 0 ) buffer.write( data, (size_t)size );
+        else if ( errno != EINTR ) break;
+      }
+      ::close( readFd );
+    } );
+  }
+  ~DescriptorCapture() {
+    if ( _saved < 0 ) return;
+    // restoring the descriptor closes the last write end of the pipe, the reader ends
+    fflush( _file );
+    ::dup2( _saved, _fd );
+    ::close( _saved );
+    _reader.join();
+  }
+
+ private:
+  int         _fd;
+  FILE*       _file;
+  int         _saved = -1;
+  std::thread _reader;
+};
+
+// reads a request, returns false if it is malformed or not complete before the deadline
+static bool recvRequest( int fd, const Deadline& deadline, uint32_t& kind, std::vector<std::string>& args ) {
+  char     magic[4];
+  uint32_t version, count;
+  if ( !recvAll( fd, magic, sizeof( magic ), deadline ) || memcmp( magic, s_magic, sizeof( magic ) ) != 0 )
+    return false;
+  if ( !recvUint32( fd, version, deadline ) || version != s_version ) return false;
+  if ( !recvUint32( fd, kind, deadline ) || !recvUint32( fd, count, deadline ) ) return false;
+  for ( uint32_t i = 0; i < count; ++i ) {
+    uint32_t size;
+    if ( !recvUint32( fd, size, deadline ) || size > s_maxArgumentSize ) return false;
+    std::string arg( size, '\0' );
+    if ( size != 0 && !recvAll( fd, &arg[0], size, deadline ) ) return false;
+    args.push_back( arg );
+  }
+  return true;
+}
+
+// runs a request with the outputs redirected to the client, returns the exit code
+static int runRequest( int fd, std::vector<std::string>& args, Server::RunFunction run ) {
+  SocketBuffer  outBuffer( fd, 'o' );
+  SocketBuffer  errBuffer( fd, 'e' );
+  std::ios      outFormat( NULL ), errFormat( NULL );
+  outFormat.copyfmt( std::cout );
+  errFormat.copyfmt( std::cerr );
+  std::streambuf* outPrevious = std::cout.rdbuf( &outBuffer );
+  std::streambuf* errPrevious = std::cerr.rdbuf( &errBuffer );
+
+  int             code = 1;
+  std::error_code error;
+  std::filesystem::current_path( args[0], error );
+  DescriptorCapture outCapture( STDOUT_FILENO, stdout, outBuffer );
+  DescriptorCapture errCapture( STDERR_FILENO, stderr, errBuffer );
+  if ( error ) {
+    std::cerr << "Error: cannot change the server directory to " << args[0] << std::endl;
+  } else {
+    // argv[0] is the working directory, ignored by run as the application name
+    std::vector<char*> argv;
+    for ( auto& arg : args ) argv.push_back( &arg[0] );
+    argv.push_back( NULL );
+    try {
+      code = run( (int)args.size(), argv.data() );
+    } catch ( const std::exception& e ) {
+      std::cerr << "Error: " << e.what() << std::endl;
+      code = 1;
+    }
+  }
+  std::cout.flush();
+  std::cerr.flush();
+
+  // restore the server state for the next request
+  std::cout.rdbuf( outPrevious );
+  std::cerr.rdbuf( errPrevious );
+  std::cout.copyfmt( outFormat );
+  std::cerr.copyfmt( errFormat );
+  IO::purge();
+  Trace::disable();
+  TextureCache::setDirectory( "" );
+  return code;
+}
+
+#endif
+
+//
+int Server::serve( const std::string& app, int argc, char* argv[], RunFunction run ) {
+  std::string socketPath = s_defaultSocket;
+  size_t      cacheSize  = 1024;
+  double      timeout    = 10.0;
+  // command line parameters
+  try {
+    cxxopts::Options options( app + " serve", "Runs the requests of " + app + " client in a persistent process" );
+    // clang-format off
+		options.add_options()
+			("socket", "path of the local socket to listen to.",
+				cxxopts::value<std::string>()->default_value( s_defaultSocket ))
+			("cacheSize", "memory in MB of the cache of the loaded models and images, shared by the requests. 0 to disable.",
+				cxxopts::value<size_t>()->default_value( "1024" ))
+			("timeout", "seconds given to a client to send its request, the connection is closed after it.",
+				cxxopts::value<double>()->default_value( "10" ))
+			("h,help", "Print usage")
+			;
+    // clang-format on
+
+    auto result = options.parse( argc, argv );
+
+    if ( result.count( "help" ) ) {
+      std::cout << options.help() << std::endl;
+      return 0;
+    }
+    socketPath = result["socket"].as<std::string>();
+    cacheSize  = result["cacheSize"].as<size_t>();
+    timeout    = result["timeout"].as<double>();
+    if ( timeout <= 0.0 ) {
+      std::cout << "Error: --timeout must be greater than 0" << std::endl;
+      return 1;
+    }
+
+  } catch ( const cxxopts::OptionException& e ) {
+    std::cout << "Error: parsing options, " << e.what() << std::endl;
+    return 1;
+  }
+
+#ifdef _WIN32
+  std::cerr << "Error: " << app << " serve is not supported on this platform" << std::endl;
+  return 1;
+#else
+  sockaddr_un address;
+  if ( !makeAddress( socketPath, address ) ) return 1;
+
+  // a socket file left by a stopped server is replaced, a running server is kept
+  const int running = connectTo( address );
+  if ( running >= 0 ) {
+    ::close( running );
+    std::cerr << "Error: a server is already listening to " << socketPath << std::endl;
+    return 1;
+  }
+  if ( !removeSocketFile( socketPath ) ) return 1;
+
+  const int listener = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+  if ( listener < 0 || ::bind( listener, (const sockaddr*)&address, sizeof( address ) ) != 0 ||
+       ::listen( listener, 16 ) != 0 ) {
+    std::cerr << "Error: cannot listen to " << socketPath << ", " << strerror( errno ) << std::endl;
+    if ( listener >= 0 ) ::close( listener );
+    return 1;
+  }
+  // a client leaving before the end of its request must not stop the server
+  signal( SIGPIPE, SIG_IGN );
+
+  IO::setFileCacheSize( cacheSize * 1024 * 1024 );
+  // the global options of the server are restored after each request
+  const bool   threadCountSet = ThreadPool::isThreadCountSet();
+  const size_t threadCount    = ThreadPool::getThreadCount();
+  std::error_code error;
+  const auto      serverPath = std::filesystem::current_path( error );
+
+  std::cout << "Listening to " << socketPath << " with " << threadCount << " threads and a " << cacheSize
+            << " MB file cache" << std::endl;
+
+  // requests are processed in arrival order, one at a time
+  size_t requests = 0;
+  bool   stop     = false;
+  while ( !stop ) {
+    const int fd = ::accept( listener, NULL, NULL );
+    if ( fd < 0 ) {
+      if ( errno == EINTR ) continue;
+      std::cerr << "Error: accept failed, " << strerror( errno ) << std::endl;
+      break;
+    }
+    // a client that does not send its whole request in time cannot hold the server
+    const Deadline deadline = std::chrono::steady_clock::now() +
+                              std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>( timeout ) );
+    uint32_t                 kind;
+    std::vector<std::string> args;
+    if ( !recvRequest( fd, deadline, kind, args ) || ( kind == s_kindRun && args.empty() ) ) {
+      std::cerr << "Error: invalid request" << std::endl;
+      ::close( fd );
+      continue;
+    }
+    int32_t code = 0;
+    if ( kind == s_kindShutdown ) {
+      std::cout << "Shutdown requested" << std::endl;
+      stop = true;
+    } else {
+      const auto start = std::chrono::steady_clock::now();
+      code             = runRequest( fd, args, run );
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      std::filesystem::current_path( serverPath, error );
+      if ( threadCountSet ) {
+        ThreadPool::setThreadCount( threadCount );
+      } else {
+        ThreadPool::clearThreadCount();
+      }
+      std::cout << "Request " << ++requests << ":";
+      for ( size_t i = 1; i < args.size(); ++i ) std::cout << " " << args[i];
+      std::cout << std::endl;
+      std::cout << "  exit code " << code << " in " << elapsed.count() << " sec., file cache "
+                << IO::getFileCacheByteSize() / 1024 << " KB" << std::endl;
+    }
+    sendFrame( fd, 'r', (const char*)&code, sizeof( code ) );
+    ::close( fd );
+  }
+  ::close( listener );
+  removeSocketFile( socketPath );
+  IO::setFileCacheSize( 0 );
+  return stop ? 0 : 1;
+#endif
+}
+
+//
+int Server::client( const std::string& app, int argc, char* argv[] ) {
+  // client options come first, the remaining arguments are the request
+  std::string socketPath = s_defaultSocket;
+  uint32_t    kind       = s_kindRun;
+  int         startIdx   = 1;
+  while ( startIdx < argc ) {
+    const std::string arg = argv[startIdx];
+    if ( arg == "--socket" && startIdx + 1 < argc ) {
+      socketPath = argv[startIdx + 1];
+      startIdx += 2;
+    } else if ( arg == "--shutdown" ) {
+      kind = s_kindShutdown;
+      startIdx++;
+    } else {
+      break;
+    }
+  }
+  if ( kind == s_kindRun && ( startIdx == argc || std::string( argv[startIdx] ) == "--help" ||
+                              std::string( argv[startIdx] ) == "-h" ) ) {
+    std::cout << "Sends a request to " << app << " serve and prints its outputs" << std::endl;
+    std::cout << "Usage:" << std::endl;
+    std::cout << "  " << app
+              << " client [--socket path] [--threads n] [--writers n] [--trace file] [--concurrent] [--textureCache dir]"
+              << " command [OPTION...]" << std::endl;
+    std::cout << "  " << app << " client [--socket path] --shutdown" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  --socket path\tpath of the local socket of the server (default: " << s_defaultSocket << ")"
+              << std::endl;
+    std::cout << "  --shutdown\tstops the server after the running request" << std::endl;
+    std::cout << std::endl;
+    std::cout << "The arguments after the client options are processed as by " << app << ", relative paths"
+              << std::endl;
+    std::cout << "being resolved from the working directory of the client. The exit code is the one of the request."
+              << std::endl;
+    return startIdx == argc ? 1 : 0;
+  }
+
+#ifdef _WIN32
+  std::cerr << "Error: " << app << " client is not supported on this platform" << std::endl;
+  return 1;
+#else
+  sockaddr_un address;
+  if ( !makeAddress( socketPath, address ) ) return 1;
+  const int fd = connectTo( address );
+  if ( fd < 0 ) {
+    std::cerr << "Error: cannot connect to " << app << " serve on " << socketPath << ", " << strerror( errno )
+              << std::endl;
+    return 1;
+  }
+  signal( SIGPIPE, SIG_IGN );
+
+  // the working directory then the arguments
+  std::error_code          error;
+  std::vector<std::string> args( 1, std::filesystem::current_path( error ).string() );
+  if ( kind == s_kindRun )
+    for ( int i = startIdx; i < argc; ++i ) args.push_back( argv[i] );
+  bool sent = sendAll( fd, s_magic, sizeof( s_magic ) ) && sendUint32( fd, s_version ) && sendUint32( fd, kind ) &&
+              sendUint32( fd, (uint32_t)args.size() );
+  for ( size_t i = 0; sent && i < args.size(); ++i )
+    sent = sendUint32( fd, (uint32_t)args[i].size() ) && sendAll( fd, args[i].data(), args[i].size() );
+  if ( !sent ) {
+    std::cerr << "Error: cannot send the request to " << socketPath << std::endl;
+    ::close( fd );
+    return 1;
+  }
+
+  // print the outputs until the exit code
+  std::vector<char> payload;
+  char              type;
+  uint32_t          size;
+  while ( recvAll( fd, &type, 1 ) && recvUint32( fd, size ) ) {
+    payload.resize( size );
+    if ( size != 0 && !recvAll( fd, payload.data(), size ) ) break;
+    if ( type == 'o' ) {
+      std::cout.write( payload.data(), size );
+      std::cout.flush();
+    } else if ( type == 'e' ) {
+      std::cerr.write( payload.data(), size );
+      std::cerr.flush();
+    } else if ( type == 'r' && size == sizeof( int32_t ) ) {
+      int32_t code;
+      memcpy( &code, payload.data(), sizeof( code ) );
+      ::close( fd );
+      return code;
+    }
+  }
+  ::close( fd );
+  std::cerr << "Error: connection to " << socketPath << " closed before the end of the request" << std::endl;
+  return 1;
+#endif
+}
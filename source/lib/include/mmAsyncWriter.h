@@ -0,0 +1,72 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MM_ASYNC_WRITER_H_
+#define _MM_ASYNC_WRITER_H_
+
+#include <functional>
+#include <string>
+
+namespace mm {
+
+// Background writing of the output files (e.g. mm --writers).
+// The jobs own a snapshot of the data they write, so the processing of the next
+// commands and frames continues while the files are encoded and flushed. The jobs
+// writing a same file run in submission order on the same writer thread, and
+// submit blocks while too many jobs are pending to bound the memory of the snapshots.
+class AsyncWriter {
+ public:
+  // starts count writer threads, 0 (default) writes the files in the calling thread.
+  // The pending jobs of a previous start are completed first.
+  static void start( size_t count );
+
+  // completes the pending jobs and stops the threads,
+  // returns the number of jobs that failed since start
+  static size_t stop( void );
+
+  // true if the jobs run on the writer threads
+  static bool isEnabled( void );
+
+  // runs job on a writer thread, or immediately if not enabled
+  // returns the result of job if run immediately, true otherwise
+  static bool submit( const std::string& filename, std::function<bool( void )> job );
+
+  // waits for the pending jobs writing filename (e.g. before loading it)
+  static void wait( const std::string& filename );
+};
+
+}  // namespace mm
+
+#endif
@@ -0,0 +1,77 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MM_CHECKPOINT_H_
+#define _MM_CHECKPOINT_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mm {
+
+// Per frame results of a metric saved along the processing, so that interrupted
+// runs can resume and runs of sequence shards can be merged (see mm merge).
+// Text file, first line "mmcheckpoint <version> <mode>", then one line per frame
+// "<frame> <values...>" with full double precision.
+class Checkpoint {
+ public:
+  static const uint32_t version = 1;
+
+  // the records of a checkpoint, values of each frame in frame order
+  typedef std::map<uint32_t, std::vector<double>> Records;
+
+  // loads the records of filename, an incomplete last line (interrupted write) is dropped
+  // returns false on error
+  static bool load( const std::string& filename, std::string& mode, Records& records );
+
+  // writes all the records, replacing the file if it exists, returns false on error
+  static bool save( const std::string& filename, const std::string& mode, const Records& records );
+
+  // appends the record of a frame, the file is created with its header if needed
+  // the file is flushed and closed so that completed frames survive an interruption
+  static bool append( const std::string& filename,
+                      const std::string& mode,
+                      uint32_t           frame,
+                      const std::vector<double>& values );
+
+  // true if filename exists
+  static bool exists( const std::string& filename );
+};
+
+}  // namespace mm
+
+#endif
@@ -42,6 +42,9 @@
 // MPEG PCC metric
 #include "dmetric/source/pcc_distortion.hpp"
 
+// PCQM KD-tree of a reference point set
+struct PcqmReferenceIndex;
+
 namespace mm {
 
     class Compare {
@@ -57,6 +60,13 @@ namespace mm {
             double unmatchedPixelPercentage = 0;	// ( unmatchedPixelsSum /  maskSizeSum ) * 100.0
         };
 
+        // compact per point pcc results, only the exported fields, clipped
+        // field order: c2c, c2p, color[0..2], c2c hausdorff, c2p hausdorff, rgb hausdorff[0..2]
+        struct PccPointResults {
+            float psnr[10];
+            float mse[10];
+        };
+
         Compare();
         ~Compare();
 
@@ -65,11 +75,25 @@ namespace mm {
         std::vector<std::pair<uint32_t, pcc_quality::qMetric> > _pccResults;
         // PCQM results array of <frame, pcqm, pcqm-psnr>
         std::vector<std::tuple<uint32_t, double, double> > _pcqmResults;
+        // KD-tree of the last PCQM reference, reused by the next frame if the reference is unchanged
+        std::shared_ptr<PcqmReferenceIndex> _pcqmReference;
         // Raster results array of <frame, result>
         std::vector<std::pair<uint32_t, IbsmResults> > _ibsmResults;
 
-        //per Point
-        std::vector<std::pair<uint32_t, std::vector<pcc_quality::qMetric>>> _pccResultsPerPoint[2];
+        // per point results of the last frame, [A, B]
+        std::vector<PccPointResults> _pccResultsPerPoint[2];
+        // running per point sums over the frames, [A, B], 20 values per point (psnr then mse)
+        std::vector<double> _pccSumsPerPoint[2];
+        // number of frames accumulated in the per point sums
+        size_t _pccFramesPerPoint;
+
+        // stores the per point results of the frame and updates the running sums
+        void pccStorePerPoint(
+            const int abIndex,
+            const std::vector<pcc_quality::qMetric>& qmPoints );
+
+        // writes the per point results of the last frame to a columnar binary file
+        bool pccSavePerPoint( const std::string& filename );
 
         // Renderers for the ibsm metric
         mm::RendererSw _swRenderer;             // the Software renderer
@@ -92,8 +116,18 @@ namespace mm {
         std::vector<double> getPcqmResults(const size_t index);
         std::vector<double> getIbsmResults(const size_t index);
 
+        // serialization of the results of one frame, for checkpoints, mode in [pcc, pcqm, ibsm]
+        // number of frame results of the mode
+        size_t getResultCount( const std::string& mode );
+        // the unclipped values of the frame results of index, returns false if mode or index is invalid
+        bool getResultValues( const std::string& mode, const size_t index, std::vector<double>& values );
+        // appends frame results made of values, returns false if mode or the value count is invalid
+        bool addResultValues( const std::string& mode, const std::vector<double>& values );
+
+        // per point results averaged over all the frames
         std::vector <std::vector<double>> getPccResultsPerPoint(const int abIndex);
         std::vector <std::vector<double>> getPccResultsPerPointMse(const int abIndex);
+        // per point results of frame index, only the last frame is retained (zeros otherwise)
         std::vector<double> getPccResultsPerPoint(const int abIndex, const size_t index, const size_t pointIndex);
         std::vector<double> getPccResultsPerPointMse(const int abIndex, const size_t index, const size_t pointIndex);
 
@@ -134,6 +168,7 @@ namespace mm {
         // - Test if number of triangles of output matches input number of triangles
         // - Test if the proposed association tables for face and vertex are bijective
         // - Test if each output triangle respects the orientation of its associated input triangle
+        // returns 1 if the topologies are matching, 0 if they differ, -1 if a map file cannot be read or is invalid
         int topo(
             const mm::Model& modelA,
             const mm::Model& modelB,
@@ -141,6 +176,12 @@ namespace mm {
             const std::string& vertexMapFilenane = "");
 
         // compare two meshes using MPEG pcc_distortion metric
+        // if calcMetPerPoint is set, the per point results are computed and, if
+        // perPointFilename is not empty, written to this file (%d to be resolved before invocation)
+        // binary little endian columnar layout:
+        //   char[4] "MMPP", uint32 version (1), uint32 field count (20), uint64 point count A, uint64 point count B
+        //   field count null terminated field names
+        //   for A then B, for each field, point count float32 values
         int pcc(
             const mm::Model& modelA,
             const mm::Model& modelB,
@@ -152,7 +193,8 @@ namespace mm {
             const bool verbose = true,
             const bool removeDupA = true,
             const bool removeDupB = true,
-            const bool calcMetPerPoint = false);
+            const bool calcMetPerPoint = false,
+            const std::string& perPointFilename = "");
 
         // collect statics over sequence and compute results
         void pccFinalize(void);
@@ -37,11 +37,12 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <iostream>
 
 class Context {
  public:
-  Context() : _frame( 0 ), _firstFrame( 0 ), _lastFrame( 0 ) {}
+  Context() : _frame( 0 ), _firstFrame( 0 ), _lastFrame( 0 ), _frames( 1, 0 ) {}
 
   bool setFrame( uint32_t frame ) {
     if ( frame < _firstFrame || frame > _lastFrame ) { return false; }
@@ -55,9 +56,24 @@ class Context {
     if ( first > last ) return false;
     _firstFrame = first;
     _lastFrame  = last;
+    _frames.clear();
+    for ( uint32_t frame = first; frame <= last; ++frame ) _frames.push_back( frame );
     return true;
   }
 
+  // restricts the processing to a subset of the frame range (shards, frame lists)
+  // the frames must be sorted, not empty and in the frame range
+  bool setFrames( const std::vector<uint32_t>& frames ) {
+    if ( frames.empty() || frames.front() < _firstFrame || frames.back() > _lastFrame ) return false;
+    _frames = frames;
+    return true;
+  }
+
+  // the frames to be processed, in order
+  const std::vector<uint32_t>& getFrames( void ) { return _frames; }
+  // first frame processed by this run, the first frame of the range unless restricted
+  bool isFirstProcessedFrame( uint32_t frame ) { return frame == _frames.front(); }
+
   uint32_t getFirstFrame( void ) { return _firstFrame; }
   uint32_t getLastFrame( void ) { return _lastFrame; }
   uint32_t getFrameCount( void ) { return _lastFrame - _firstFrame + 1; }
@@ -66,6 +82,7 @@ class Context {
   uint32_t _frame;  // current frame
   uint32_t _firstFrame;
   uint32_t _lastFrame;
+  std::vector<uint32_t> _frames;  // frames to process
 };
 
 #endif
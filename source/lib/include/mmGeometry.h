@@ -189,6 +189,26 @@ class Geometry {
                                glm::vec3&       res,
                                float            epsilon = ZERO_TOLERANCE );
 
+// number of rays processed at once by evalRayTriangleBatch
+#define RAY_BATCH_SIZE 16
+
+  // evaluates count <= RAY_BATCH_SIZE rays sharing rayOrigin and rayDirection, except on component
+  // axis of the origin that is taken from coords[k] for ray k. Computations are performed on fixed
+  // size lanes so the compiler can vectorize them, results are bit exact with evalRayTriangle.
+  // hits[k] is set to 1 if ray k intersects and res[k] then contains (t,u,v) as for evalRayTriangle
+  // returns the number of intersecting rays
+  static size_t evalRayTriangleBatch( const glm::vec3&       rayOrigin,
+                                      const glm::vec3&       rayDirection,
+                                      glm::vec3::length_type axis,
+                                      const float*           coords,
+                                      size_t                 count,
+                                      const glm::vec3&       v0,
+                                      const glm::vec3&       v1,
+                                      const glm::vec3&       v2,
+                                      bool*                  hits,
+                                      glm::vec3*             res,
+                                      float                  epsilon = ZERO_TOLERANCE );
+
   // https://github.com/autonomousvision/occupancy_flow/blob/master/im2mesh/utils/libvoxelize/tribox2.h
   // https://fileadmin.cs.lth.se/cs/Personal/Tomas_Akenine-Moller/code/
   /********************************************************/
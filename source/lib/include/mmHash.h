@@ -0,0 +1,73 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MM_HASH_H_
+#define _MM_HASH_H_
+
+#include <cstdint>
+#include <string>
+
+namespace mm {
+
+class Model;
+class Image;
+
+// Fast non cryptographic 64 bits hashes, used as content fingerprints of the
+// processing inputs (see compare --memo). Buffers are hashed with an xxHash64
+// like function, by chunks of 1MB in parallel for large buffers. The results
+// do not depend on the thread count but do depend on the endianness.
+class Hash {
+ public:
+  // hash of size bytes
+  static uint64_t buffer( const void* data, size_t size, uint64_t seed = 0 );
+
+  // combines value into hash, order dependent
+  static uint64_t combine( uint64_t hash, uint64_t value );
+
+  static uint64_t string( const std::string& str, uint64_t seed = 0 ) { return buffer( str.data(), str.size(), seed ); }
+
+  // hash of the attribute arrays of the model (positions, uvs, normals, colors, face normals, indices, materials)
+  static uint64_t model( const Model& model );
+
+  // hash of the size and pixels of the image
+  static uint64_t image( const Image& image );
+
+  // 16 hexadecimal digits
+  static std::string toHex( uint64_t hash );
+};
+
+}  // namespace mm
+
+#endif
@@ -37,6 +37,8 @@
 
 #include <map>
 #include <string>
+#include <cstdio>
+#include <iostream>
 
 #include "mmModel.h"
 #include "mmImage.h"
@@ -56,9 +58,20 @@ class IO {
   // e.g. filename00%3d.png filename00156.png if frame is 156
   static std::string resolveName( const uint32_t frame, const std::string& input );
 
+  // attributes of the models, a model can be loaded with a subset of them (see loadModel)
+  static const uint32_t POSITIONS = 1;   // vertex positions
+  static const uint32_t UVCOORDS  = 2;   // uv coordinates and uv indices of the triangles
+  static const uint32_t NORMALS   = 4;   // vertex normals
+  static const uint32_t COLORS    = 8;   // vertex colors
+  static const uint32_t FACES     = 16;  // triangles
+  static const uint32_t MATERIALS = 32;  // material library, names and texture map urls (obj)
+  static const uint32_t ALL       = 63;
+
   // name can be filename or "ID:xxxx"
+  // attributes lists the attributes used by the caller, the parsers skip the other ones.
+  // a model of the store partially loaded from file is reloaded if more attributes are requested.
   // return invalid shared pointer in case of error (to check with isValid(model)).
-  static ModelPtr loadModel( std::string templateName );
+  static ModelPtr loadModel( std::string templateName, uint32_t attributes = ALL );
 
   static bool saveModel( std::string templateName, ModelPtr model );
 
@@ -71,6 +84,7 @@ class IO {
   // empty string urls are skipped silently and null is stored, but it is not considered an error (see materials without map)
   // names in imageUrlList can be filename or "ID:xxxx"
   // fills the images vector with images, some may be invalid shared pointer in case of error 
+  // the image files are decoded concurrently on the thread pool (see mm --threads)
   // returns false if at least one image load failed
   static bool loadImages( const std::vector< std::string >& imageUrlList, std::vector<mm::ImagePtr>& images );
 
@@ -80,6 +94,17 @@ class IO {
   // free all the models and images, and reset cache.
   static void purge( void );
 
+  // memory allocated by the models and images of the store in bytes
+  static size_t getModelsByteSize( void );
+  static size_t getImagesByteSize( void );
+
+  // persistent cache of the models and images loaded from files, kept by purge (see mm serve)
+  // entries are copied in and out of the cache, so processings can modify the loaded data,
+  // and are reloaded if the file size or modification time changes
+  // least recently used entries are freed above maxBytes, 0 disables the cache (default)
+  static void setFileCacheSize( size_t maxBytes );
+  static size_t getFileCacheByteSize( void );
+
  private:
   // access to context for frame name resolution
   static Context* _context;
@@ -91,19 +116,19 @@ class IO {
 
  public:
   // Automatic choice on extension
-  static bool _loadModel( std::string filename, Model& output );
+  static bool _loadModel( std::string filename, Model& output, uint32_t attributes = ALL );
   static bool _saveModel( std::string filename, const Model& input );
 
   // OBJ
-  static bool _loadObj( std::string filename, Model& output );
+  static bool _loadObj( std::string filename, Model& output, uint32_t attributes = ALL );
   static bool _saveObj( std::string filename, const Model& input );
 
   // PLY
-  static bool _loadPly( std::string filename, Model& output );
+  static bool _loadPly( std::string filename, Model& output, uint32_t attributes = ALL );
   static bool _savePly( std::string filename, const Model& input );
 
   // Images
-  static bool _loadImage( std::string filename, Image& output );
+  static bool _loadImage( std::string filename, Image& output, std::ostream& log = std::cout );
   static bool _saveImage( std::string filename, const Image& input, bool flipVertically = false );
   static bool _loadImageFromVideo( std::string filename, Image& output );
 
@@ -114,6 +139,37 @@ class IO {
       std::vector<std::string>& textMapFilename );
 };
 
+// Binary ply writer for point clouds of unknown size, points are appended by chunks
+// and the vertex count of the header is patched on close. Properties (normals, colors)
+// are set by the first non empty chunk, missing attributes of next chunks are written as zeros.
+class PlyStreamWriter {
+ public:
+  PlyStreamWriter() {}
+  ~PlyStreamWriter() { close(); }
+
+  // return false if the file cannot be created
+  bool open( const std::string& filename );
+  // appends the vertices of points to the file
+  bool write( const Model& points );
+  // writes the final vertex count and closes the file
+  bool close( void );
+
+  // number of points written so far
+  inline size_t getCount( void ) const { return _count; }
+
+ private:
+  bool writeHeader( void );
+
+  FILE*             _file       = nullptr;
+  std::string       _filename;
+  bool              _hasHeader  = false;
+  bool              _hasNormals = false;
+  bool              _hasColors  = false;
+  size_t            _count      = 0;
+  long              _countPos   = 0;  // file position of the vertex count in the header
+  std::vector<char> _buffer;
+};
+
 }  // namespace mm
 
 #endif
\ No newline at end of file
@@ -51,41 +51,63 @@ class Image {
   int            height;
   int            nbc;  // # 8-bit component per pixel
   unsigned char* data;
+  bool           ownsData;  // false for a view of pixels owned by the caller (see mmApi.h)
+  std::shared_ptr<void> storage;  // keeps alive the pixels of a view if set (see setView)
 
-  Image( void ) : width( 0 ), height( 0 ), nbc( 0 ), data( NULL ) {}
+  Image( void ) : width( 0 ), height( 0 ), nbc( 0 ), data( NULL ), ownsData( true ) {}
 
-  // copy constructor
-  Image( const Image& img ) : width( img.width ), height( img.height ), nbc( img.nbc ) {
+  // copy constructor, the copy of a view owns its pixels
+  Image( const Image& img ) : width( img.width ), height( img.height ), nbc( img.nbc ), ownsData( true ) {
     data = new unsigned char[width * height * nbc];
     std::memcpy( data, img.data, width * height * nbc );
   }
 
   // no default value
-  Image( const int _width, const int _height, unsigned char val ) : width( _width ), height( _height ), nbc( 3 ) {
+  Image( const int _width, const int _height, unsigned char val ) :
+      width( _width ), height( _height ), nbc( 3 ), ownsData( true ) {
     data = new unsigned char[width * height * nbc];
     std::memset( data, val, width * height * nbc );
   }
 
   // set each component to val
-  Image( const int _width, const int _height ) : width( _width ), height( _height ), nbc( 3 ) {
+  Image( const int _width, const int _height ) : width( _width ), height( _height ), nbc( 3 ), ownsData( true ) {
     data = new unsigned char[width * height * nbc];
   }
 
-  ~Image( void ) { delete[] data; }
+  // view of caller pixels (8 bits, _nbc components, rows top to bottom), not copied nor freed,
+  // pixels must outlive the image and are never written by the processings using it as a texture
+  Image( const int _width, const int _height, const int _nbc, unsigned char* pixels ) :
+      width( _width ), height( _height ), nbc( _nbc ), data( pixels ), ownsData( false ) {}
+
+  ~Image( void ) { freeData(); }
+
+  // view of pixels kept alive by storage (e.g. a memory mapped file), released with the image
+  inline void setView( const int _width, const int _height, const int _nbc, unsigned char* pixels,
+                       const std::shared_ptr<void>& _storage ) {
+    freeData();
+    width    = _width;
+    height   = _height;
+    nbc      = _nbc;
+    data     = pixels;
+    ownsData = false;
+    storage  = _storage;
+  }
 
   Image& operator=( const Image& img ) {
-    width  = img.width;
-    height = img.height;
-    nbc    = img.nbc;
-    delete[] data;
-    data = new unsigned char[width * height * nbc];
+    if ( this == &img ) return *this;
+    freeData();
+    width    = img.width;
+    height   = img.height;
+    nbc      = img.nbc;
+    ownsData = true;
+    data     = new unsigned char[width * height * nbc];
     std::memcpy( data, img.data, width * height * nbc );
     return *this;
   }
 
   // reset the map (resize if needed) - no default value
   inline void reset() {
-      delete[] data; data = NULL;
+      freeData(); data = NULL; ownsData = true;
       width = 0;
       height = 0;
       nbc = 0;
@@ -93,8 +115,9 @@ class Image {
 
   // reset the map (resize if needed) - no default value
   inline void reset( const int _width, const int _height ) {
-    if ( _width != width || _height != height ) {
-      delete[] data;
+    if ( _width != width || _height != height || !ownsData ) {
+      freeData();
+      ownsData = true;
       width  = _width;
       height = _height;
       nbc    = 3;
@@ -108,6 +131,9 @@ class Image {
     std::memset( data, val, width * height * nbc );
   }
 
+  // return the memory allocated by the pixels in bytes
+  inline size_t getByteSize( void ) const { return data != NULL ? (size_t)width * height * nbc : 0; }
+
   // no sanity check for performance reasons
   inline void fetchRGB( const size_t col, const size_t row, glm::vec3& rgb ) const {
     rgb.r = data[( row * width + col ) * nbc + 0];
@@ -121,6 +147,12 @@ class Image {
     data[( row * width + col ) * nbc + 1] = (unsigned char)rgb.g;
     data[( row * width + col ) * nbc + 2] = (unsigned char)rgb.b;
   }
+
+ private:
+  inline void freeData( void ) {
+    if ( ownsData ) delete[] data;
+    storage.reset();
+  }
 };
 
 // clamp the map i,j. j is flipped. mapCoord expressed in image space.
@@ -0,0 +1,73 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MM_MEMO_H_
+#define _MM_MEMO_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mm {
+
+// On disk store of metric results, one file per key in a local directory.
+// The key is a fingerprint of the inputs and parameters (see mmHash.h), the
+// entries use the checkpoint text format with a single record.
+// Entries are written to a temporary file then renamed, so that several
+// processes can share the store.
+class Memo {
+ public:
+  // the directory is created on first put
+  Memo( const std::string& directory = "" ) : _directory( directory ) {}
+
+  void               setDirectory( const std::string& directory ) { _directory = directory; }
+  const std::string& getDirectory( void ) const { return _directory; }
+
+  // reads the values of key, returns false if the entry does not exist or is invalid
+  bool get( uint64_t key, const std::string& mode, std::vector<double>& values ) const;
+
+  // stores the values of key, returns false on error
+  bool put( uint64_t key, const std::string& mode, const std::vector<double>& values ) const;
+
+  // path of the entry of key
+  std::string getFilename( uint64_t key ) const;
+
+ private:
+  std::string _directory;
+};
+
+}  // namespace mm
+
+#endif
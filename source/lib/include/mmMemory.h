@@ -0,0 +1,123 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MM_MEMORY_H_
+#define _MM_MEMORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mm {
+
+// Memory accounting of the processings (e.g. mm --memory).
+// The resident set size (RSS) of the process is sampled by a background thread and
+// its high-water mark is recorded for each stage, the stages being the ScopedTimer
+// scopes opened by the thread that enabled the accounting. When built with
+// MM_COUNT_ALLOCATIONS, the global operator new/delete are replaced by counting
+// versions and the high-water mark of the live heap bytes is recorded as well.
+class Memory {
+ public:
+  struct Stage {
+    std::string name;
+    size_t      order;      // begin order
+    size_t      depth;
+    size_t      rssBegin;   // RSS at stage begin in bytes
+    size_t      rssEnd;     // RSS at stage end in bytes
+    size_t      rssPeak;    // RSS high-water mark during the stage in bytes
+    size_t      heapPeak;   // live heap bytes high-water mark during the stage (MM_COUNT_ALLOCATIONS)
+  };
+
+  // starts the accounting for the calling thread, samples RSS every period milliseconds
+  static void enable( unsigned int period = 2 );
+
+  // true if enable was called
+  static bool isEnabled( void ) { return _enabled; }
+
+  // true if built with the counting allocator
+  static bool isCountingAllocations( void );
+
+  // current resident set size of the process in bytes, 0 if not supported
+  static size_t getCurrentRss( void );
+
+  // resident set size high-water mark of the process in bytes, 0 if not supported
+  static size_t getPeakRss( void );
+
+  // live heap bytes and number of allocations, 0 without MM_COUNT_ALLOCATIONS
+  static size_t getHeapBytes( void );
+  static size_t getHeapAllocations( void );
+
+  // stage boundaries, called by ScopedTimer
+  static void beginStage( const std::string& name );
+  static void endStage( void );
+
+  // RSS and heap high-water marks since the last resetFrame, including running stages
+  static size_t getFrameRssPeak( void );
+  static size_t getFrameHeapPeak( void );
+  // name of the completed stage with the highest RSS peak since the last resetFrame
+  static std::string getFramePeakStage( void );
+
+  // prints the stages completed since the last resetFrame as a table
+  static void printFrame( std::ostream& out, uint32_t frame, size_t modelBytes, size_t imageBytes );
+
+  // forgets the completed stages
+  static void resetFrame( void );
+
+  // columns appended to the csv outputs when enabled, empty strings otherwise
+  static std::string getCsvHeader( void );
+  static std::string getCsvValues( size_t modelBytes, size_t imageBytes );
+
+ private:
+  // updates _rssPeak with the current RSS, called by the sampling thread
+  static void sample( void );
+
+  static bool               _enabled;
+  static std::thread::id    _owner;
+  static std::mutex         _mutex;
+  static std::vector<Stage> _stages;   // stages completed since the last resetFrame
+  static std::vector<Stage> _running;  // stack of the running stages
+  static size_t             _order;    // number of stages begun
+  static size_t             _rssPeak;  // RSS high-water mark since the last stage boundary
+  static size_t             _frameRssPeak;
+  static size_t             _frameHeapPeak;
+};
+
+}  // namespace mm
+
+#endif
@@ -119,6 +119,7 @@ class Model {
     vertices.clear();
     uvcoords.clear();
     normals.clear();
+    colors.clear();
     faceNormals.clear();
     triangles.clear();
     trianglesuv.clear();
@@ -168,6 +169,13 @@ class Model {
   // return the number of face normals
   inline size_t getFaceNormalCount( void ) const { return faceNormals.size() / 3; }
 
+  // return the memory allocated by the attribute arrays in bytes
+  inline size_t getAttributesByteSize( void ) const {
+    return ( vertices.capacity() + uvcoords.capacity() + normals.capacity() + colors.capacity() +
+             faceNormals.capacity() ) * sizeof( float ) +
+           ( triangles.capacity() + trianglesuv.capacity() + triangleMatIdx.capacity() ) * sizeof( int );
+  }
+
   // return true if a set of neighbors for a given triangle is found
   inline bool getNeighborTriangles( const size_t idx, std::set<size_t>& res ) const {
     auto iter = perTriangleNeighborTriangles.find( idx );
@@ -41,6 +41,27 @@
 
 namespace mm {
 
+    // origin of the points generated by a sampler, one entry per output point,
+    // used to resample meshes that share the same connectivity (e.g. tracked sequences)
+    struct SampleTemplate {
+        uint64_t              checksum  = 0;      // connectivity checksum of the sampled model
+        bool                  hasNormal = false;  // points carry the face normal
+        bool                  hasColor  = false;  // points carry a color (texture or per vertex)
+        std::string           parameters;         // sampling mode and parameters that produced the points
+        std::vector<uint32_t> triIdx;             // source triangle of each point
+        std::vector<float>    coords;             // barycentric (u,v) and offset along face normal of each point
+
+        inline size_t size() const { return triIdx.size(); }
+
+        inline void reset() {
+            checksum  = 0;
+            hasNormal = hasColor = false;
+            parameters.clear();
+            triIdx.clear();
+            coords.clear();
+        }
+    };
+
     class Sample {
     public:
         Sample() {};
@@ -53,11 +74,26 @@ namespace mm {
             size_t       resolution,
             float        thickness,
             bool         bilinear,
-            bool         logProgress);
+            bool         logProgress,
+            SampleTemplate* sampleTemplate = nullptr);
+
+        // same as above with the bounding box of the input given by the caller (e.g. the whole model of a tile),
+        // the box and step are not logged
+        static void meshToPcFace(
+            const Model& input,
+            Model& output,
+            const std::vector<mm::ImagePtr>& textures,
+            size_t       resolution,
+            float        thickness,
+            bool         bilinear,
+            bool         logProgress,
+            const glm::vec3& minPos,
+            const glm::vec3& maxPos,
+            SampleTemplate* sampleTemplate = nullptr);
 
         // sample the mesh on a face basis
         // system will search the resolution according to the nbSamplesMin and nbSamplesMax parameters
-        // costly method, shall be used only for calibration
+        // the search uses a point count estimator, the sampling is usually performed only once
         static void meshToPcFace(
             const Model& input,
             Model& output,
@@ -68,7 +104,8 @@ namespace mm {
             float        thickness,
             bool         bilinear,
             bool         logProgress,
-            size_t& computedResolution);
+            size_t& computedResolution,
+            SampleTemplate* sampleTemplate = nullptr);
 
         // will sample the mesh on a grid basis of resolution gridRes
         static void meshToPcGrid(
@@ -83,11 +120,12 @@ namespace mm {
             glm::vec3& minPos,
             glm::vec3& maxPos,
             const bool   verbose = true,
-            std::vector<int>* faceIndexPerPoint = nullptr);
+            std::vector<int>* faceIndexPerPoint = nullptr,
+            SampleTemplate* sampleTemplate = nullptr);
 
         // will sample the mesh on a grid basis of resolution gridRes, result will be generated as float or integer
         // system will search the resolution according to the nbSamplesMin and nbSamplesMax parameters
-        // costly method, shall be used only for calibration
+        // the search uses a point count estimator, the sampling is usually performed only once
         static void meshToPcGrid(
             const Model& input,
             Model& output,
@@ -101,7 +139,8 @@ namespace mm {
             bool         useFixedPoint,
             glm::vec3& minPos,
             glm::vec3& maxPos,
-            size_t& computedResolution);
+            size_t& computedResolution,
+            SampleTemplate* sampleTemplate = nullptr);
 
         // revert sampling, guided by texture map
         static void meshToPcMap(
@@ -119,11 +158,12 @@ namespace mm {
             float        areaThreshold,
             bool         mapThreshold,
             bool         bilinear,
-            bool         logProgress);
+            bool         logProgress,
+            SampleTemplate* sampleTemplate = nullptr);
 
         // triangle dubdivision based, area stop criterion
         // system will search the resolution according to the nbSamplesMin and nbSamplesMax parameters
-        // costly method, shall be used only for calibration
+        // the search uses a point count estimator, the sampling is usually performed only once
         static void meshToPcDiv(
             const Model& input,
             Model& output,
@@ -133,7 +173,8 @@ namespace mm {
             size_t       maxIterations,
             bool         bilinear,
             bool         logProgress,
-            float& computedThres);
+            float& computedThres,
+            SampleTemplate* sampleTemplate = nullptr);
 
         // triangle dubdivision based, edge stop criterion
         static void meshToPcDivEdge(
@@ -144,11 +185,12 @@ namespace mm {
             size_t       resolution,
             bool         bilinear,
             bool         logProgress,
-            float& computedThres);
+            float& computedThres,
+            SampleTemplate* sampleTemplate = nullptr);
 
         // triangle dubdivision based, edge stop criterion
         // system will search the resolution according to the nbSamplesMin and nbSamplesMax parameters
-        // costly method, shall be used only for calibration
+        // the search uses a point count estimator, the sampling is usually performed only once
         static void meshToPcDivEdge(
             const Model& input,
             Model& output,
@@ -158,16 +200,55 @@ namespace mm {
             size_t       maxIterations,
             bool         bilinear,
             bool         logProgress,
-            float& computedThres);
+            float& computedThres,
+            SampleTemplate* sampleTemplate = nullptr);
 
         // pseudo random sampling with point targetPointCount stop criterion
+        // seed=0 uses the R2 low discrepancy sequence, other seeds a counter based generator,
+        // the result is the same for a given seed whatever the number of threads
         static void meshToPcPrnd(
             const Model& input,
             Model& output,
             const std::vector<mm::ImagePtr>& textures,
             size_t       targetPointCount,
             bool         bilinear,
+            bool         logProgress,
+            SampleTemplate* sampleTemplate = nullptr,
+            uint32_t     seed = 0);
+
+        // out of core sampling, the bounding box of the model is split in tiles^3 cells and each cell
+        // is sampled separately: sampler is invoked on a model holding all the vertices but only the
+        // triangles overlapping the cell (enlarged by margin, e.g. face thickness), so sampling parameters derived from the
+        // model box do not change. Only the generated points lying in the cell are kept, duplicate
+        // removal of the sampler is then exact, and they are handed to consumer. Peak memory is
+        // bounded by the content of a cell instead of the whole output. The bounding box of the model is
+        // computed once and given to sampler, which must use it instead of computing it on each tile.
+        // returns the number of points handed to consumer
+        static size_t meshToPcTiles(
+            const Model& input,
+            size_t       tiles,
+            float        margin,
+            const std::function<void( const Model& tile, const glm::vec3& minBox, const glm::vec3& maxBox, Model& points )>& sampler,
+            const std::function<void( const Model& points )>& consumer,
+            bool         logProgress);
+
+        // computes a checksum of the model connectivity (triangles, uv triangles and material indices)
+        static uint64_t connectivityChecksum( const Model& input );
+
+        // re-evaluates the points recorded in sampleTemplate on the input model
+        // positions, normals and colors are interpolated using the new vertex attributes and textures
+        // return false if the connectivity of input does not match the template
+        static bool meshToPcTemplate(
+            const Model& input,
+            Model& output,
+            const std::vector<mm::ImagePtr>& textures,
+            const SampleTemplate& sampleTemplate,
+            bool         bilinear,
             bool         logProgress);
+
+        // sample template sidecar file read/write, return false on error
+        static bool loadTemplate( const std::string& filename, SampleTemplate& sampleTemplate );
+        static bool saveTemplate( const std::string& filename, const SampleTemplate& sampleTemplate );
     };
 
 }  // namespace mm
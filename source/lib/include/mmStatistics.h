@@ -37,7 +37,11 @@
 
 #include <algorithm>  // for std::min and std::max
 #include <cmath>      // for pow and sqrt,
-#include <limits>     // for nan
+#include <cstdint>
+#include <limits>  // for nan
+#include <vector>
+
+#include "mmThreadPool.h"
 
 namespace mm {
 
@@ -53,49 +57,207 @@ struct Results {
   double      stdDev;
   long double sum;  // use long double to reduce risks of overflow
   double      minkowsky;
+  double      median;
+  double      p1;  // percentiles
+  double      p5;
+  double      p95;
+  double      p99;
+};
+
+// Mergeable quantile sketch, deterministic variant of the KLL compactors.
+// Level h holds samples of weight 2^h, when a level is full it is sorted and one sample
+// out of two is promoted to the next level. Quantiles are exact while less than capacity
+// samples were added, the rank error grows with the number of levels otherwise.
+class QuantileSketch {
+ public:
+  explicit QuantileSketch( size_t capacity = 2048 ) : _capacity( ( std::max )( capacity, (size_t)2 ) ) {}
+
+  inline void add( double value ) {
+    if ( std::isnan( value ) ) return;
+    if ( _levels.empty() ) _levels.resize( 1 );
+    _levels[0].push_back( value );
+    _count++;
+    if ( _levels[0].size() >= _capacity ) compress();
+  }
+
+  inline void merge( const QuantileSketch& other ) {
+    if ( _levels.size() < other._levels.size() ) _levels.resize( other._levels.size() );
+    for ( size_t h = 0; h < other._levels.size(); ++h )
+      _levels[h].insert( _levels[h].end(), other._levels[h].begin(), other._levels[h].end() );
+    _count += other._count;
+    compress();
+  }
+
+  inline uint64_t count( void ) const { return _count; }
+
+  // values at the quantiles qs in [0,1], linear interpolation between the closest ranks
+  inline std::vector<double> quantiles( const std::vector<double>& qs ) const {
+    std::vector<double> output( qs.size(), std::numeric_limits<double>::quiet_NaN() );
+    if ( _count == 0 ) return output;
+    // weighted samples sorted by value
+    std::vector<std::pair<double, uint64_t>> items;
+    for ( size_t h = 0; h < _levels.size(); ++h )
+      for ( const double value : _levels[h] ) items.push_back( std::make_pair( value, (uint64_t)1 << h ) );
+    std::sort( items.begin(), items.end() );
+    // the value of the sample of rank r
+    const auto valueAt = [&]( uint64_t rank ) {
+      uint64_t cumulated = 0;
+      for ( const auto& item : items ) {
+        cumulated += item.second;
+        if ( rank < cumulated ) return item.first;
+      }
+      return items.back().first;
+    };
+    for ( size_t i = 0; i < qs.size(); ++i ) {
+      const double   rank  = ( std::min )( ( std::max )( qs[i], 0.0 ), 1.0 ) * (double)( _count - 1 );
+      const uint64_t lower = (uint64_t)std::floor( rank );
+      const double   a     = valueAt( lower );
+      output[i]            = rank > (double)lower ? a + ( rank - (double)lower ) * ( valueAt( lower + 1 ) - a ) : a;
+    }
+    return output;
+  }
+
+ private:
+  // compacts the full levels, an odd sample stays in its level so the total weight is preserved
+  inline void compress( void ) {
+    for ( size_t h = 0; h < _levels.size(); ++h ) {
+      if ( _levels[h].size() < _capacity ) continue;
+      if ( h + 1 == _levels.size() ) _levels.resize( h + 2 );
+      if ( _parity.size() < _levels.size() ) _parity.resize( _levels.size(), 0 );
+      std::vector<double>& level = _levels[h];
+      std::sort( level.begin(), level.end() );
+      const size_t kept = level.size() % 2;
+      // alternates the promoted half so the errors of successive compactions cancel
+      for ( size_t i = kept + _parity[h]; i < level.size(); i += 2 ) _levels[h + 1].push_back( level[i] );
+      _parity[h] ^= 1;
+      level.resize( kept );
+    }
+  }
+
+  size_t                           _capacity;
+  uint64_t                         _count = 0;
+  std::vector<std::vector<double>> _levels;
+  std::vector<uint8_t>             _parity;
+};
+
+// One pass accumulator of the Results fields, two accumulators can be merged
+// so the samples can be split in chunks processed in parallel.
+// As in the former three pass implementation, min, max, sum, mean and percentiles
+// use the samples clipped to clip, variance and Minkowsky the raw samples (around the clipped mean).
+class Accumulator {
+ public:
+  explicit Accumulator( double clip = CLIP ) : _clip( clip ) {}
+
+  inline void add( double value ) {
+    const double sample = ( std::min )( value, _clip );
+    _count++;
+    if ( _count == 1 ) {
+      _min = _max = sample;
+    } else {
+      _max = ( std::max )( _max, sample );
+      _min = ( std::min )( _min, sample );
+    }
+    _sum += sample;
+    _mean += ( sample - _mean ) / (double)_count;
+    // Welford update of the raw moments, non finite values are kept aside
+    if ( std::isfinite( value ) ) {
+      _rawCount++;
+      const double delta = value - _rawMean;
+      _rawMean += delta / (double)_rawCount;
+      _rawM2 += delta * ( value - _rawMean );
+      const double a = std::abs( value );
+      _rawCubes += a * a * a;
+    } else {
+      _rawNonFinite += std::abs( value );
+    }
+    _sketch.add( sample );
+  }
+
+  inline void merge( const Accumulator& other ) {
+    if ( other._count == 0 ) return;
+    if ( _count == 0 ) {
+      *this = other;
+      return;
+    }
+    const double count = (double)( _count + other._count );
+    _min               = ( std::min )( _min, other._min );
+    _max               = ( std::max )( _max, other._max );
+    _sum += other._sum;
+    _mean += ( other._mean - _mean ) * ( (double)other._count / count );
+    _count += other._count;
+    if ( other._rawCount != 0 ) {
+      const double rawCount = (double)( _rawCount + other._rawCount );
+      const double delta    = other._rawMean - _rawMean;
+      _rawMean += delta * ( (double)other._rawCount / rawCount );
+      _rawM2 += other._rawM2 + delta * delta * (double)_rawCount * (double)other._rawCount / rawCount;
+      _rawCount += other._rawCount;
+    }
+    _rawCubes += other._rawCubes;
+    _rawNonFinite += other._rawNonFinite;
+    _sketch.merge( other._sketch );
+  }
+
+  inline uint64_t count( void ) const { return _count; }
+
+  inline void getResults( Results& output ) const {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    output           = { nan, nan, nan, nan, nan, nan, nan, nan, nan, nan, nan, nan };
+    if ( _count == 0 ) return;
+    const double n = (double)_count;
+    output.min     = _min;
+    output.max     = _max;
+    output.sum     = _sum;
+    output.mean    = _mean;
+    // sum of the squared deviations of the raw samples from the clipped mean
+    const double shift = _rawMean - _mean;
+    output.variance    = ( _rawM2 + (double)_rawCount * shift * shift ) / n + _rawNonFinite;
+    output.stdDev      = sqrt( output.variance );
+    // Minkowsky with parameter ms=3
+    output.minkowsky                      = std::cbrt( _rawCubes / n + _rawNonFinite );
+    const std::vector<double> percentiles = _sketch.quantiles( { 0.5, 0.01, 0.05, 0.95, 0.99 } );
+    output.median                         = percentiles[0];
+    output.p1                             = percentiles[1];
+    output.p5                             = percentiles[2];
+    output.p95                            = percentiles[3];
+    output.p99                            = percentiles[4];
+  }
+
+ private:
+  double         _clip;
+  uint64_t       _count = 0;
+  double         _min   = 0.0;
+  double         _max   = 0.0;
+  long double    _sum   = 0.0;
+  double         _mean  = 0.0;  // of the clipped samples
+  uint64_t       _rawCount     = 0;
+  double         _rawMean      = 0.0;
+  double         _rawM2        = 0.0;
+  double         _rawCubes     = 0.0;
+  double         _rawNonFinite = 0.0;  // inf or nan if such raw samples were added
+  QuantileSketch _sketch;
 };
 
 // sampler is a lambda func that takes size_t parameter and return associated
 // sample value as a double (use closure to store the iterated array of values).
+// The samples are read once, by chunks processed in parallel, so sampler must be thread safe.
+// The chunks do not depend on the thread count, neither do the results.
 template <typename F>
 inline void compute( size_t nbSamples, F&& sampler, Results& output, double clip = CLIP ) {
-  output.min       = std::numeric_limits<double>::quiet_NaN();
-  output.max       = std::numeric_limits<double>::quiet_NaN();
-  output.mean      = std::numeric_limits<double>::quiet_NaN();
-  output.variance  = std::numeric_limits<double>::quiet_NaN();
-  output.stdDev    = std::numeric_limits<double>::quiet_NaN();
-  output.sum       = std::numeric_limits<double>::quiet_NaN();
-  output.minkowsky = std::numeric_limits<double>::quiet_NaN();
-
-  if ( nbSamples == 0 ) { return; }
-
-  double fract     = 1.0 / nbSamples;
-  output.minkowsky = 0.0;
-
-  // init mean, min and max
-  const double sample = (std::min)( sampler( 0 ), clip);
-  output.mean         = fract * sample;  // we do not use sum for the computation since it might be overflow
-  output.max          = sample;
-  output.min          = sample;
-  output.sum          = sample;
-  // compute mean, min and max
-  for ( size_t i = 1; i < nbSamples; ++i ) {
-    const double sample = (std::min)( sampler( i ), clip);
-    output.mean += fract * sample;  // we do not use sum for the computation since it might be overflow
-    output.max = std::max( output.max, sample );
-    output.min = std::min( output.min, sample );
-    output.sum += sample;
-  }
-  // compute variance
-  output.variance = 0.0;
-  for ( size_t i = 0; i < nbSamples; ++i ) { output.variance += fract * pow( sampler( i ) - output.mean, 2.0 ); }
-  output.stdDev = sqrt( output.variance );
-
-  // compute Minkowsky with parameter ms=3
-  const double ms = 3;
-  // finalize the code here
-  for ( size_t i = 0; i < nbSamples; i++ ) { output.minkowsky += fract * pow( abs( sampler( i ) ), ms ); }
-  output.minkowsky = pow( output.minkowsky, 1.0 / ms );
+  const Accumulator accumulator = parallelReduce(
+    0,
+    nbSamples,
+    65536,
+    Accumulator( clip ),
+    [&]( size_t first, size_t last ) {
+      Accumulator chunk( clip );
+      for ( size_t i = first; i < last; ++i ) chunk.add( sampler( i ) );
+      return chunk;
+    },
+    []( Accumulator a, const Accumulator& b ) {
+      a.merge( b );
+      return a;
+    } );
+  accumulator.getResults( output );
 }
 
 //
@@ -107,6 +269,11 @@ inline void printToLog( Results& stats, std::string prefix, std::ostream& out )
   out << prefix << "Variance=" << stats.variance << std::endl;
   out << prefix << "StdDev=" << stats.stdDev << std::endl;
   out << prefix << "Minkowsky=" << stats.minkowsky << std::endl;
+  out << prefix << "Median=" << stats.median << std::endl;
+  out << prefix << "P1=" << stats.p1 << std::endl;
+  out << prefix << "P5=" << stats.p5 << std::endl;
+  out << prefix << "P95=" << stats.p95 << std::endl;
+  out << prefix << "P99=" << stats.p99 << std::endl;
 }
 
 };  // namespace Statistics
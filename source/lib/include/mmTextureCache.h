@@ -0,0 +1,73 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MM_TEXTURE_CACHE_H_
+#define _MM_TEXTURE_CACHE_H_
+
+#include <string>
+
+#include "mmImage.h"
+
+namespace mm {
+
+// On disk cache of the decoded texture maps, one file per source image in a local
+// directory (e.g. mm --textureCache). An entry stores the raw pixels after a page aligned
+// header, and is memory mapped into an image view instead of decoding the source again.
+// Entries are named by a hash of the absolute source path, size and modification time.
+// The hash of the source content is only checked again if the source was modified just
+// before its entry was written, when its time may not change on the next modification.
+// Entries are written to a temporary file then renamed, so that several processes can
+// share the cache.
+class TextureCache {
+ public:
+  // "" disables the cache (default), the directory is created on first save
+  static void               setDirectory( const std::string& directory );
+  static const std::string& getDirectory( void );
+  static bool               isEnabled( void );
+
+  // maps the entry of the image file filename into image,
+  // returns false if the cache is disabled or if there is no valid entry
+  static bool load( const std::string& filename, Image& image );
+
+  // stores the pixels of image decoded from the file filename, returns false on error
+  static bool save( const std::string& filename, const Image& image );
+
+  // path of the entry of the image file filename, "" if the file cannot be accessed
+  static std::string getEntryName( const std::string& filename );
+};
+
+}  // namespace mm
+
+#endif
@@ -0,0 +1,221 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _MM_THREAD_POOL_H_
+#define _MM_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mm {
+
+class TaskGroup;
+
+// Work stealing scheduler shared by the whole library.
+// Each thread owns a deque, it pushes and pops its own tasks at the back and steals
+// from the front of the other deques when its own deque is empty. Threads waiting
+// on a TaskGroup execute the pending tasks of that group meanwhile and sleep once
+// the remaining ones run on other threads, so nested parallel loops neither spin
+// nor create more threads than the pool size.
+class ThreadPool {
+ public:
+  // sets the number of threads used by the library (0 means hardware concurrency),
+  // the calling thread counts as one of them. Also sets the OpenMP thread count used
+  // by the dependencies. The running pool is kept if the count does not change,
+  // otherwise the live task groups are waited for before it is restarted, so it
+  // must not be called from a task.
+  static void setThreadCount( size_t count );
+
+  // restores the default count, as if setThreadCount was never called (e.g. between mm serve requests)
+  static void clearThreadCount( void );
+
+  // number of threads used by the library, workers plus calling thread
+  static size_t getThreadCount( void );
+
+  // true if setThreadCount was called (e.g. mm --threads)
+  static bool isThreadCountSet( void );
+
+  // the global pool, started on first use
+  static ThreadPool& instance( void );
+
+  ~ThreadPool();
+
+ private:
+  friend class TaskGroup;
+
+  struct Task {
+    std::function<void()> func;
+    TaskGroup*            group = nullptr;
+  };
+
+  struct Queue {
+    std::mutex       mutex;
+    std::deque<Task> tasks;
+  };
+
+  explicit ThreadPool( size_t threadCount );
+
+  // the global pool with one more live task group, the pool is not restarted until released
+  static ThreadPool& acquire( void );
+
+  // one less live task group
+  static void release( void );
+
+  // push to the deque of the calling thread (shared deque for non worker threads)
+  void push( Task&& task );
+
+  // runs one pending task of group (of any group if null), own deque first then steal,
+  // returns false if none found
+  bool tryRun( const TaskGroup* group = nullptr );
+
+  // pops from the back of own deque or steals from the front of others
+  bool take( Task& task, const TaskGroup* group );
+
+  void execute( Task& task );
+
+  void workerLoop( size_t index );
+
+  std::vector<std::unique_ptr<Queue>> _queues;  // one per worker, last one for non worker threads
+  std::vector<std::thread>            _threads;
+  std::mutex                          _sleepMutex;
+  std::condition_variable             _sleepCond;
+  std::atomic<size_t>                 _queued{ 0 };  // number of tasks waiting in the deques
+  bool                                _stop   = false;
+  size_t                              _groups = 0;  // live task groups, guarded by _instanceMutex
+
+  static std::unique_ptr<ThreadPool> _instance;
+  static std::mutex                  _instanceMutex;
+  static std::condition_variable     _releaseCond;
+  static size_t                      _threadCount;
+  static bool                        _threadCountSet;
+};
+
+// set of tasks that can be waited for, tasks may run other task groups
+class TaskGroup {
+ public:
+  TaskGroup() : _pool( ThreadPool::acquire() ) {}
+
+  // waits for the remaining tasks, exceptions are dropped, call wait() to get them
+  ~TaskGroup();
+
+  // schedules func, runs it immediately if the pool has a single thread
+  template <typename F>
+  void run( F&& func ) {
+    if ( _pool._threads.empty() ) {
+      try {
+        func();
+      } catch ( ... ) { setError( std::current_exception() ); }
+      return;
+    }
+    _pending.fetch_add( 1 );
+    _queued.fetch_add( 1 );
+    ThreadPool::Task task;
+    task.func  = std::forward<F>( func );
+    task.group = this;
+    _pool.push( std::move( task ) );
+    // wakes the waiting thread so it can run the new task
+    std::lock_guard<std::mutex> lock( _doneMutex );
+    _doneCond.notify_one();
+  }
+
+  // executes the pending tasks of the group until all of them are done,
+  // rethrows the first exception raised by a task of the group
+  void wait( void );
+
+ private:
+  friend class ThreadPool;
+
+  // runs the queued tasks of the group, sleeps while the others run on other threads
+  void waitTasks( void );
+
+  void setError( std::exception_ptr error );
+
+  ThreadPool&             _pool;
+  std::atomic<size_t>     _pending{ 0 };  // tasks not completed yet
+  std::atomic<size_t>     _queued{ 0 };   // tasks still waiting in the deques
+  std::mutex              _doneMutex;
+  std::condition_variable _doneCond;
+  std::mutex              _errorMutex;
+  std::exception_ptr      _error;
+};
+
+// calls body( i ) for each i in [begin, end), consecutive indices are processed
+// by chunks of grain values, each chunk is a task
+template <typename F>
+inline void parallelFor( size_t begin, size_t end, size_t grain, F&& body ) {
+  if ( end <= begin ) return;
+  grain = ( std::max )( grain, (size_t)1 );
+  if ( ThreadPool::getThreadCount() <= 1 || end - begin <= grain ) {
+    for ( size_t i = begin; i < end; ++i ) body( i );
+    return;
+  }
+  TaskGroup group;
+  for ( size_t first = begin; first < end; first += grain ) {
+    const size_t last = ( std::min )( end, first + grain );
+    group.run( [&body, first, last]() {
+      for ( size_t i = first; i < last; ++i ) body( i );
+    } );
+  }
+  group.wait();
+}
+
+// computes chunk( first, last ) for each chunk of grain values of [begin, end) in parallel,
+// then combines the partial results in chunk order using reduce( a, b ).
+// The chunks do not depend on the thread count, neither does the result.
+template <typename T, typename C, typename R>
+inline T parallelReduce( size_t begin, size_t end, size_t grain, const T& identity, C&& chunk, R&& reduce ) {
+  if ( end <= begin ) return identity;
+  grain = ( std::max )( grain, (size_t)1 );
+  const size_t   count = ( end - begin + grain - 1 ) / grain;
+  std::vector<T> partials( count, identity );
+  parallelFor( 0, count, 1, [&]( size_t c ) {
+    const size_t first = begin + c * grain;
+    partials[c]        = chunk( first, ( std::min )( end, first + grain ) );
+  } );
+  T result = identity;
+  for ( size_t c = 0; c < count; ++c ) result = reduce( result, partials[c] );
+  return result;
+}
+
+}  // namespace mm
+
+#endif
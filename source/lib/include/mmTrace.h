@@ -0,0 +1,126 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MM_TRACE_H_
+#define _MM_TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mm {
+
+// Wall clock instrumentation of the processings.
+// Timed scopes are recorded, when enabled (e.g. mm --trace), as Chrome trace events
+// that can be opened with chrome://tracing or https://ui.perfetto.dev.
+class Trace {
+ public:
+  // starts the recording, events are written to filename by save
+  static void enable( const std::string& filename );
+
+  // stops the recording and frees the recorded events
+  static void disable( void );
+
+  // true if enable was called
+  static bool isEnabled( void ) { return _enabled; }
+
+  // writes the recorded events in trace event JSON format, returns false on error
+  static bool save( void );
+
+  // wall time in microseconds since the start of the process
+  static uint64_t now( void );
+
+  // small sequential identifier of the calling thread, 0 for the first caller
+  static uint32_t threadId( void );
+
+  // records a complete event, begin and end in microseconds
+  static void record( const std::string& name, const char* category, uint64_t begin, uint64_t end, uint32_t depth );
+
+ private:
+  struct Event {
+    std::string name;
+    const char* category;
+    uint64_t    begin;
+    uint64_t    duration;
+    uint32_t    tid;
+    uint32_t    depth;
+  };
+
+  static std::atomic<bool>  _enabled;
+  static std::string        _filename;
+  static std::mutex         _mutex;
+  static std::vector<Event> _events;
+};
+
+// Measures the wall time of a scope and records it as a trace event on destruction
+// (or on stop). Scopes opened while another one is running on the same thread are
+// nested under it.
+// The scopes are also the stages of the memory accounting (see mmMemory.h).
+class ScopedTimer {
+ public:
+  ScopedTimer( const std::string& name, const char* category = "mm" );
+  ~ScopedTimer();
+
+  // ends the scope before destruction
+  void stop( void );
+
+  // ends the scope and starts a new one, for sequential phases
+  void restart( const std::string& name );
+
+  // elapsed wall time in seconds
+  double elapsed( void ) const;
+
+ private:
+  std::string _name;
+  const char* _category;
+  uint64_t    _begin;
+  uint64_t    _end;
+  uint32_t    _depth;
+  bool        _running;
+};
+
+}  // namespace mm
+
+#define MM_TRACE_CONCAT_( a, b ) a##b
+#define MM_TRACE_CONCAT( a, b ) MM_TRACE_CONCAT_( a, b )
+
+// times the enclosing scope
+#define MM_TRACE_SCOPE( name, category ) \
+  mm::ScopedTimer MM_TRACE_CONCAT( _mmScopedTimer, __LINE__ )( name, category )
+
+#endif
@@ -0,0 +1,152 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <iostream>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+#include "mmAsyncWriter.h"
+
+using namespace mm;
+
+// pending jobs per writer thread
+static const size_t s_jobsPerThread = 2;
+
+struct WriterJob {
+  std::string                 filename;
+  std::function<bool( void )> func;
+};
+
+struct WriterState {
+  std::mutex                         mutex;
+  std::condition_variable            wake;  // a job was queued or the threads must stop
+  std::condition_variable            done;  // a job was completed
+  std::vector<std::deque<WriterJob>> queues;
+  std::vector<std::thread>           threads;
+  std::map<std::string, size_t>      files;  // filename -> pending jobs
+  size_t                             pending  = 0;
+  size_t                             failures = 0;
+  bool                               stopping = false;
+
+  ~WriterState() { AsyncWriter::stop(); }
+};
+static WriterState s_state;
+
+static void writerLoop( size_t index ) {
+  while ( true ) {
+    WriterJob job;
+    {
+      std::unique_lock<std::mutex> lock( s_state.mutex );
+      s_state.wake.wait( lock, [index] { return s_state.stopping || !s_state.queues[index].empty(); } );
+      if ( s_state.queues[index].empty() ) return;
+      job = std::move( s_state.queues[index].front() );
+      s_state.queues[index].pop_front();
+    }
+    bool success = false;
+    try {
+      success = job.func();
+    } catch ( const std::exception& e ) { std::cerr << "Error: " << e.what() << std::endl; }
+    if ( !success ) std::cerr << "Error: could not write " << job.filename << std::endl;
+    {
+      std::lock_guard<std::mutex> lock( s_state.mutex );
+      s_state.pending--;
+      if ( !success ) s_state.failures++;
+      auto it = s_state.files.find( job.filename );
+      if ( --it->second == 0 ) s_state.files.erase( it );
+    }
+    s_state.done.notify_all();
+  }
+}
+
+//
+void AsyncWriter::start( size_t count ) {
+  stop();
+  if ( count == 0 ) return;
+  std::lock_guard<std::mutex> lock( s_state.mutex );
+  s_state.queues.resize( count );
+  for ( size_t i = 0; i < count; ++i ) s_state.threads.emplace_back( writerLoop, i );
+}
+
+//
+size_t AsyncWriter::stop( void ) {
+  {
+    std::lock_guard<std::mutex> lock( s_state.mutex );
+    s_state.stopping = true;
+  }
+  s_state.wake.notify_all();
+  for ( std::thread& thread : s_state.threads ) thread.join();
+  std::lock_guard<std::mutex> lock( s_state.mutex );
+  s_state.threads.clear();
+  s_state.queues.clear();
+  s_state.stopping      = false;
+  const size_t failures = s_state.failures;
+  s_state.failures      = 0;
+  return failures;
+}
+
+//
+bool AsyncWriter::isEnabled( void ) {
+  std::lock_guard<std::mutex> lock( s_state.mutex );
+  return !s_state.threads.empty();
+}
+
+//
+bool AsyncWriter::submit( const std::string& filename, std::function<bool( void )> job ) {
+  {
+    std::unique_lock<std::mutex> lock( s_state.mutex );
+    if ( !s_state.threads.empty() ) {
+      const size_t count = s_state.threads.size();
+      s_state.done.wait( lock, [count] { return s_state.pending < count * s_jobsPerThread; } );
+      // the jobs of a file go to the same thread, so they cannot overlap
+      s_state.queues[std::hash<std::string>()( filename ) % count].push_back( { filename, std::move( job ) } );
+      s_state.files[filename]++;
+      s_state.pending++;
+      lock.unlock();
+      s_state.wake.notify_all();
+      return true;
+    }
+  }
+  return job();
+}
+
+//
+void AsyncWriter::wait( const std::string& filename ) {
+  std::unique_lock<std::mutex> lock( s_state.mutex );
+  s_state.done.wait( lock, [&filename] { return s_state.files.find( filename ) == s_state.files.end(); } );
+}
@@ -0,0 +1,152 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+// internal headers
+#include "mmCheckpoint.h"
+
+using namespace mm;
+
+// writes one record line, doubles with full precision (inf and nan as text)
+static void writeRecord( std::ostream& out, uint32_t frame, const std::vector<double>& values ) {
+  out << frame;
+  for ( const double v : values ) out << " " << v;
+  out << "\n";
+}
+
+bool Checkpoint::exists( const std::string& filename ) {
+  std::ifstream in( filename );
+  return (bool)in;
+}
+
+bool Checkpoint::load( const std::string& filename, std::string& mode, Records& records ) {
+  std::ifstream in( filename, std::ios::binary );
+  if ( !in ) {
+    std::cerr << "Error: could not open checkpoint " << filename << std::endl;
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  std::string text = buffer.str();
+  // a write interrupted in the middle of a line leaves no end of line
+  const size_t end = text.find_last_of( '\n' );
+  if ( end + 1 != text.size() ) {
+    if ( end != std::string::npos )
+      std::cout << "Warning: dropping the incomplete last record of checkpoint " << filename << std::endl;
+    text.resize( end == std::string::npos ? 0 : end + 1 );
+  }
+  std::istringstream lines( text );
+  std::string        line;
+  // header
+  std::string magic;
+  uint32_t    fileVersion = 0;
+  if ( !std::getline( lines, line ) || !( std::istringstream( line ) >> magic >> fileVersion >> mode ) ||
+       magic != "mmcheckpoint" ) {
+    std::cerr << "Error: invalid checkpoint header in " << filename << std::endl;
+    return false;
+  }
+  if ( fileVersion != version ) {
+    std::cerr << "Error: checkpoint " << filename << " version " << fileVersion << " not supported, expected "
+              << version << std::endl;
+    return false;
+  }
+  // records, values parsed with strtod to support inf and nan
+  size_t valueCount = 0;
+  size_t lineIndex  = 1;
+  while ( std::getline( lines, line ) ) {
+    lineIndex++;
+    if ( line.empty() || line == "\r" ) continue;
+    std::istringstream  iss( line );
+    std::string         token;
+    std::vector<double> values;
+    long                frame = -1;
+    bool                valid = ( iss >> frame ) && frame >= 0;
+    while ( valid && iss >> token ) {
+      char* tokenEnd = NULL;
+      values.push_back( strtod( token.c_str(), &tokenEnd ) );
+      valid = *tokenEnd == '\0';
+    }
+    if ( valid && records.empty() ) valueCount = values.size();
+    if ( !valid || values.size() != valueCount ) {
+      std::cerr << "Error: invalid record line " << lineIndex << " of checkpoint " << filename << std::endl;
+      return false;
+    }
+    records[(uint32_t)frame] = values;
+  }
+  return true;
+}
+
+bool Checkpoint::save( const std::string& filename, const std::string& mode, const Records& records ) {
+  std::ofstream out( filename, std::ios::out | std::ios::binary );
+  if ( !out ) {
+    std::cerr << "Error: could not create checkpoint " << filename << std::endl;
+    return false;
+  }
+  out.precision( std::numeric_limits<double>::max_digits10 );
+  out << "mmcheckpoint " << version << " " << mode << "\n";
+  for ( const auto& record : records ) writeRecord( out, record.first, record.second );
+  out.close();
+  if ( !out ) {
+    std::cerr << "Error: could not write checkpoint " << filename << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool Checkpoint::append( const std::string&         filename,
+                         const std::string&         mode,
+                         uint32_t                   frame,
+                         const std::vector<double>& values ) {
+  const bool    create = !exists( filename );
+  std::ofstream out( filename, std::ios::out | std::ios::binary | std::ios::app );
+  if ( !out ) {
+    std::cerr << "Error: could not open checkpoint " << filename << std::endl;
+    return false;
+  }
+  out.precision( std::numeric_limits<double>::max_digits10 );
+  if ( create ) out << "mmcheckpoint " << version << " " << mode << "\n";
+  writeRecord( out, frame, values );
+  out.close();
+  if ( !out ) {
+    std::cerr << "Error: could not write checkpoint " << filename << std::endl;
+    return false;
+  }
+  return true;
+}
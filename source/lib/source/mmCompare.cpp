@@ -39,6 +39,7 @@
 #include <time.h>
 #include <math.h>
 #include <string>
+#include <cstring>
 #include <vector>
 // mathematics
 #include <glm/vec3.hpp>
@@ -63,6 +64,8 @@
 #include "mmStatistics.h"
 #include "mmCompare.h"
 #include "mmCompareTFAN.h"
+#include "mmThreadPool.h"
+#include "mmTrace.h"
 
 // "implementation" done in mmRendererHW
 #include <stb_image_write.h>
@@ -95,7 +98,7 @@ inline bool areTrianglesEqual( bool              unoriented,
                    || ( vA1 == vB2 && vA2 == vB1 && vA3 == vB3 ) ) );
 }
 
-Compare::Compare() : _hwRendererInitialized( false ) {}
+Compare::Compare() : _pccFramesPerPoint( 0 ), _hwRendererInitialized( false ) {}
 Compare::~Compare() {
   if ( _hwRendererInitialized ) { _hwRenderer.shutdown(); }
 }
@@ -111,9 +114,11 @@ int Compare::equ(
     mm::Model& outputA,
     mm::Model& outputB)
 {
-    // we test the maps
+    // we test the maps, a difference of the maps makes the result 1 if the geometries are equal
+    bool mapsEqual = true;
     if (mapSetA.size() != mapSetB.size()) {
         std::cout << "texture maps are not of equal: size of set A is diffrent from size of set B" << std::endl;
+        mapsEqual = false;
     }
     else if (mapSetA.size() == 0) {
         std::cout << "skipping texture maps comparison" << std::endl;
@@ -127,13 +132,16 @@ int Compare::equ(
             if (isMapAValid || isMapBValid) {
                 if (!isMapAValid) {
                     std::cout << "texture maps are not equal: mapA is null" << std::endl;
+                    mapsEqual = false;
                 }
                 else if (!isMapBValid) {
                     std::cout << "texture maps are not equal: mapB is null" << std::endl;
+                    mapsEqual = false;
                 }
                 else {
                     if (mapA->width != mapB->width || mapA->height != mapB->height) {
                         std::cout << "texture maps are not equal: dimensions are not equal" << std::endl;
+                        mapsEqual = false;
                     }
                     else {
                         size_t diffs = 0;
@@ -147,6 +155,7 @@ int Compare::equ(
                         }
                         if (diffs != 0) {
                             std::cout << "texture maps are not equal: " << diffs << "pixel differences" << std::endl;
+                            mapsEqual = false;
                         }
                         else {
                             std::cout << "texture maps are equal" << std::endl;
@@ -160,7 +169,7 @@ int Compare::equ(
   if ( inputA.triangles.size() != inputB.triangles.size() ) {
     std::cout << "meshes are not equal, number of triangles are different " << inputA.triangles.size() / 3 << " vs "
               << inputB.triangles.size() / 3 << std::endl;
-    return true;
+    return 1;
   }
 
   // mesh mode
@@ -199,7 +208,7 @@ int Compare::equ(
         if ( earlyReturn ) {
           std::cout << "meshes are not equal, early return." << std::endl;
           std::cout << "triangle number " << triIdx << " from A has no equivalent in B" << std::endl;
-          return true;
+          return 1;
         }
         ++diffs;
       }
@@ -234,7 +243,8 @@ int Compare::equ(
       }
       std::cout << "Normals differences: " << normalDiffs << std::endl;
     }
-    return true;
+    if ( diffs != 0 ) return epsilon > 0 ? (int)diffs : 1;
+    return mapsEqual ? 0 : 1;
   }
   // Point cloud mode, sort vertices then compare
   else {
@@ -275,15 +285,15 @@ int Compare::equ(
     if ( epsilon == 0 ) {
       if ( outputB.vertices == outputA.vertices ) {
         std::cout << "model vertices are equals" << std::endl;
-        return true;
+        return mapsEqual ? 0 : 1;
       } else {
         std::cout << "model vertices are not equals" << std::endl;
-        return true;
+        return 1;
       }
     } else {
       if ( outputA.vertices.size() != outputB.vertices.size() ) {
         std::cout << "model vertices are not equals" << std::endl;
-        return true;
+        return 1;
       }
       size_t count = 0;
       for ( size_t i = 0; i < outputA.vertices.size() / 3; i++ ) {
@@ -296,7 +306,8 @@ int Compare::equ(
       } else {
         std::cout << "model vertices are not equals, found " << count << " differences" << std::endl;
       }
-      return true;
+      if ( count != 0 ) return (int)count;
+      return mapsEqual ? 0 : 1;
     }
   }
 }
@@ -525,7 +536,7 @@ int Compare::topo(
   faceFile.open( faceMapFilename.c_str(), std::ios::in );
   if ( !faceFile ) {
     std::cerr << "Error: can't open topology face mapping file " << faceMapFilename << std::endl;
-    return false;
+    return -1;
   }
   // file parsing
   size_t      lineNo = 0;
@@ -538,19 +549,19 @@ int Compare::topo(
     for ( size_t index = 0; index < 2; ++index ) {
       if ( !( in >> faces[index] ) ) {
         std::cerr << "Error: " << faceMapFilename << ":" << lineNo << " missing face number " << index << std::endl;
-        return false;
+        return -1;
       }
       if ( faces[index] >= modelA.getTriangleCount() ) {
         std::cerr << "Error: " << faceMapFilename << ":" << lineNo << " face index out of range (faces[" << index
                   << "]=" << faces[index] << ") >= (modelA.getTriangleCount()=" << modelA.getTriangleCount() << ")"
                   << std::endl;
-        return false;
+        return -1;
       }
     }
     if ( visitedFace[faces[0]] ) {
       std::cerr << "Error: " << faceMapFilename << ":" << lineNo << " modelB face " << faces[0]
                 << " already associated with modelA face " << faceMap[faces[0]] << std::endl;
-      return false;
+      return -1;
     }
     visitedFace[faces[0]] = true;
     faceMap[faces[0]]     = faces[1];
@@ -582,7 +593,7 @@ int Compare::topo(
   vertexFile.open( vertexMapFilename.c_str(), std::ios::in );
   if ( !vertexFile ) {
     std::cerr << "Error: can't open topology vertex mapping file " << vertexMapFilename << std::endl;
-    return false;
+    return -1;
   }
   // file parsing
   lineNo = 0;
@@ -594,19 +605,19 @@ int Compare::topo(
     for ( size_t index = 0; index < 2; ++index ) {
       if ( !( in >> vertex[index] ) ) {
         std::cerr << "Error: " << vertexMapFilename << ":" << lineNo << " missing vertex number " << index << std::endl;
-        return false;
+        return -1;
       }
       if ( vertex[index] >= modelA.getPositionCount() ) {
         std::cerr << "Error: " << vertexMapFilename << ":" << lineNo << " vertex index out of range (vertex[" << index
                   << "]=" << vertex[index] << ") >= (modelA.getPositionCount()=" << modelA.getPositionCount() << ")"
                   << std::endl;
-        return false;
+        return -1;
       }
     }
     if ( visitedVertex[vertex[0]] ) {
       std::cerr << "Error: " << vertexMapFilename << ":" << lineNo << " modelB vertex " << vertex[0]
                 << " already associated with modelA vertex " << vertexMap[vertex[0]] << std::endl;
-      return false;
+      return -1;
     }
     visitedVertex[vertex[0]] = true;
     vertexMap[vertex[0]]     = vertex[1];
@@ -665,7 +676,10 @@ void sampleIfNeeded(
     // first reorder the model to prevent small variations
     // when having two similar topologies but not same orders of enumeration
     mm::Model reordered;
-    reorder( input, std::string( "oriented" ), reordered );
+    {
+      MM_TRACE_SCOPE( "reorder", "compare" );
+      reorder( input, std::string( "oriented" ), reordered );
+    }
 
     // then use face subdivision without map citerion and area 
     // threshold of 2.0, and maximum recursion depth of 3
@@ -683,6 +697,7 @@ int removeDuplicatePoints(
     int neighborsProc, 
     const bool verbose = true ) 
 {
+  MM_TRACE_SCOPE( "remove duplicate points", "compare" );
   // sort the point cloud
   std::vector<size_t> indices;
   indices.resize( pc.size );
@@ -712,12 +727,12 @@ int removeDuplicatePoints(
     auto it_next = it_seq + 1;
     if ( it_next != pc.end() ) {
       if ( *it_next < *it_seq && !errorFind ) {
-        printf( "WARNING: something went wrong between %zu and %zu \n", it_seq.idx, it_next.idx );
+        std::cout << "WARNING: something went wrong between " << it_seq.idx << " and " << it_next.idx << " " << std::endl;
         errorFind = true;
       }
     }
   }
-  if ( errorFind ) { printf( "WARNING: something went wrong in duplicate point sort process\n" ); }
+  if ( errorFind ) { std::cout << "WARNING: something went wrong in duplicate point sort process" << std::endl; }
   // Find runs of identical point positions
   for ( auto it_seq = pc.begin(); it_seq != pc.end(); ) {
     it_seq = std::adjacent_find( it_seq, pc.end() );
@@ -787,9 +802,9 @@ int removeDuplicatePoints(
 
   if ( verbose && duplicatesFound > 0 ) {
     switch ( dropDuplicates ) {
-    case 0: printf( "WARNING: %d points with same coordinates found in \n", duplicatesFound ); break;
-    case 1: printf( "WARNING: %d points with same coordinates found and dropped in\n", duplicatesFound ); break;
-    case 2: printf( "WARNING: %d points with same coordinates found and averaged in\n", duplicatesFound );
+    case 0: std::cout << "WARNING: " << duplicatesFound << " points with same coordinates found in " << std::endl; break;
+    case 1: std::cout << "WARNING: " << duplicatesFound << " points with same coordinates found and dropped in" << std::endl; break;
+    case 2: std::cout << "WARNING: " << duplicatesFound << " points with same coordinates found and averaged in" << std::endl;
     }
   }
   return 0;
@@ -805,6 +820,7 @@ void convertModel(
     const bool               verbose,
     const bool               removeDupPoint = true)
 {
+  MM_TRACE_SCOPE( "convert", "compare" );
   for ( size_t i = 0; i < inputModel.vertices.size() / 3; ++i ) {
     // push the positions
     outputModel.xyz.p.push_back( std::array<float, 3>(
@@ -845,7 +861,8 @@ int Compare::pcc(
     const bool verbose,
     const bool removeDupA,
     const bool removeDupB,
-    const bool calcMetPerPoint)
+    const bool calcMetPerPoint,
+    const std::string& perPointFilename)
 {
   // 1 - sample the models if needed
   sampleIfNeeded( modelA, mapSetA, outputA );
@@ -875,22 +892,32 @@ int Compare::pcc(
     params.bColor
     && ( outputA.colors.size() == outputA.vertices.size() && outputB.colors.size() == outputB.vertices.size() );
   params.mseSpace  = 1;
-  params.nbThreads = 1;
+  // single threaded unless a thread count is given (mm --threads), default results are unchanged
+  params.nbThreads = ThreadPool::isThreadCountSet() ? (int)ThreadPool::getThreadCount() : 1;
 
   // 3 - compute the metric
   pcc_quality::qMetric qm;
   const double         similarPointThreshold = 1e-20;
-  
+  ScopedTimer          metricTimer( "pcc metric", "compare" );
+
   if (calcMetPerPoint) {
+      // full per point metrics only live for the frame, the compact records are kept
       std::vector <pcc_quality::qMetric> qm_pointA(inCloud1.size);
       std::vector <pcc_quality::qMetric> qm_pointB(inCloud2.size);
       computeQualityMetric(inCloud1, inCloud1, inCloud2, params, qm, verbose, similarPointThreshold, &qm_pointA, &qm_pointB);
-      _pccResultsPerPoint[0].push_back(std::make_pair((uint32_t)_pccResultsPerPoint[0].size(), qm_pointA));
-      _pccResultsPerPoint[1].push_back(std::make_pair((uint32_t)_pccResultsPerPoint[1].size(), qm_pointB));
+      pccStorePerPoint( 0, qm_pointA );
+      pccStorePerPoint( 1, qm_pointB );
+      _pccFramesPerPoint++;
   }
   else {
       computeQualityMetric(inCloud1, inCloud1, inCloud2, params, qm, verbose, similarPointThreshold);
   }
+  metricTimer.stop();
+
+  // stream the per point results of the frame
+  if ( calcMetPerPoint && perPointFilename != "" ) {
+    if ( !pccSavePerPoint( perPointFilename ) ) return 1;
+  }
 
   // store results to compute statistics in finalize step
   _pccResults.push_back( std::make_pair( (uint32_t)_pccResults.size(), qm ) );
@@ -899,6 +926,84 @@ int Compare::pcc(
   return 0;
 }
 
+void Compare::pccStorePerPoint( const int abIndex, const std::vector<pcc_quality::qMetric>& qmPoints ) {
+  auto& records = _pccResultsPerPoint[abIndex];
+  auto& sums    = _pccSumsPerPoint[abIndex];
+  records.resize( qmPoints.size() );
+  // the first frame gives the point count of the averages
+  if ( _pccFramesPerPoint == 0 ) sums.assign( qmPoints.size() * 20, 0.0 );
+  const size_t sumCount = ( std::min )( qmPoints.size(), sums.size() / 20 );
+  parallelFor( 0, qmPoints.size(), 4096, [&]( size_t i ) {
+    const auto& qm = qmPoints[i];
+    auto&       r  = records[i];
+    r.psnr[0]      = (float)( std::min )( CLIP, qm.c2c_psnr );
+    r.psnr[1]      = (float)( std::min )( CLIP, qm.c2p_psnr );
+    r.psnr[2]      = (float)( std::min )( CLIP, qm.color_psnr[0] );
+    r.psnr[3]      = (float)( std::min )( CLIP, qm.color_psnr[1] );
+    r.psnr[4]      = (float)( std::min )( CLIP, qm.color_psnr[2] );
+    r.psnr[5]      = (float)( std::min )( CLIP, qm.c2c_hausdorff_psnr );
+    r.psnr[6]      = (float)( std::min )( CLIP, qm.c2p_hausdorff_psnr );
+    r.psnr[7]      = (float)( std::min )( CLIP, qm.color_rgb_hausdorff_psnr[0] );
+    r.psnr[8]      = (float)( std::min )( CLIP, qm.color_rgb_hausdorff_psnr[1] );
+    r.psnr[9]      = (float)( std::min )( CLIP, qm.color_rgb_hausdorff_psnr[2] );
+    r.mse[0]       = (float)( std::min )( CLIP, qm.c2c_mse );
+    r.mse[1]       = (float)( std::min )( CLIP, qm.c2p_mse );
+    r.mse[2]       = (float)( std::min )( CLIP, qm.color_mse[0] );
+    r.mse[3]       = (float)( std::min )( CLIP, qm.color_mse[1] );
+    r.mse[4]       = (float)( std::min )( CLIP, qm.color_mse[2] );
+    r.mse[5]       = (float)( std::min )( CLIP, qm.c2c_hausdorff );
+    r.mse[6]       = (float)( std::min )( CLIP, qm.c2p_hausdorff );
+    r.mse[7]       = (float)( std::min )( CLIP, qm.color_rgb_hausdorff[0] );
+    r.mse[8]       = (float)( std::min )( CLIP, qm.color_rgb_hausdorff[1] );
+    r.mse[9]       = (float)( std::min )( CLIP, qm.color_rgb_hausdorff[2] );
+    if ( i < sumCount ) {
+      double* sum = &sums[i * 20];
+      for ( size_t j = 0; j < 10; ++j ) {
+        sum[j] += r.psnr[j];
+        sum[10 + j] += r.mse[j];
+      }
+    }
+  } );
+}
+
+bool Compare::pccSavePerPoint( const std::string& filename ) {
+  ScopedTimer   timer( "save per point", "compare" );
+  std::ofstream fout( filename, std::ios::out | std::ios::binary );
+  if ( !fout ) {
+    std::cerr << "Error: could not create per point output file " << filename << std::endl;
+    return false;
+  }
+  static const char* fieldNames[20] = {
+    "c2c_psnr",    "c2p_psnr",    "color0_psnr",    "color1_psnr",    "color2_psnr",
+    "c2c_hd_psnr", "c2p_hd_psnr", "color0_hd_psnr", "color1_hd_psnr", "color2_hd_psnr",
+    "c2c_mse",     "c2p_mse",     "color0_mse",     "color1_mse",     "color2_mse",
+    "c2c_hd",      "c2p_hd",      "color0_hd",      "color1_hd",      "color2_hd" };
+  const uint32_t version    = 1;
+  const uint32_t fieldCount = 20;
+  const uint64_t counts[2]  = { _pccResultsPerPoint[0].size(), _pccResultsPerPoint[1].size() };
+  fout.write( "MMPP", 4 );
+  fout.write( (const char*)&version, sizeof( version ) );
+  fout.write( (const char*)&fieldCount, sizeof( fieldCount ) );
+  fout.write( (const char*)counts, sizeof( counts ) );
+  for ( auto name : fieldNames ) fout.write( name, strlen( name ) + 1 );
+  // one column at a time, the records are transposed in a single reusable buffer
+  std::vector<float> column;
+  for ( int ab = 0; ab < 2; ++ab ) {
+    const auto& records = _pccResultsPerPoint[ab];
+    column.resize( records.size() );
+    for ( size_t f = 0; f < fieldCount; ++f ) {
+      for ( size_t i = 0; i < records.size(); ++i )
+        column[i] = f < 10 ? records[i].psnr[f] : records[i].mse[f - 10];
+      fout.write( (const char*)column.data(), column.size() * sizeof( float ) );
+    }
+  }
+  if ( !fout ) {
+    std::cerr << "Error: could not write per point output file " << filename << std::endl;
+    return false;
+  }
+  return true;
+}
+
 // collect multi-frame statistics
 void Compare::pccFinalize( void ) {
   if ( _pccResults.size() > 0 ) {
@@ -934,39 +1039,19 @@ void Compare::pccFinalize( void ) {
 // utility func used by compare::pcqm
 // no sanity check, we assume the model is clean
 // and generated by sampling that allways generate content with color and normals
-void convertModel( const mm::Model& inputModel, PointSet& outputModel ) {
-  // init bbox boundaries
-  outputModel.xmin = outputModel.ymin = outputModel.zmin = std::numeric_limits<double>::max();
-  outputModel.xmax = outputModel.ymax = outputModel.zmax = std::numeric_limits<double>::min();
+void convertModel( const mm::Model& inputModel, CompactPointSet& outputModel ) {
+  MM_TRACE_SCOPE( "convert", "compare" );
+  // positions share the mm::Model layout
+  outputModel.positions = inputModel.vertices;
   // note that RGBA is not supported - no error checking
-  const bool haveColors = inputModel.colors.size() == inputModel.vertices.size();
-  // copy data
-  for ( size_t i = 0; i < inputModel.vertices.size() / 3; ++i ) {
-    Point point;
-    // push the positions
-    point.x = inputModel.vertices[i * 3];
-    point.y = inputModel.vertices[i * 3 + 1];
-    point.z = inputModel.vertices[i * 3 + 2];
-    // push the colors if any
-    // PointSet ingests RGB8 stored on double.
-    if ( haveColors ) {
-      point.r = (double)inputModel.colors[i * 3];
-      point.g = (double)inputModel.colors[i * 3 + 1];
-      point.b = (double)inputModel.colors[i * 3 + 2];
-    }
-    // PCQM needs valid color attributes we generate a pure white
-    else {
-      point.r = point.g = point.b = (double)255;
-    }
-    // will add the point and update bbox
-    outputModel.pts.push_back( point );
-    outputModel.xmax = outputModel.xmax > point.x ? outputModel.xmax : point.x;
-    outputModel.ymax = outputModel.ymax > point.y ? outputModel.ymax : point.y;
-    outputModel.zmax = outputModel.zmax > point.z ? outputModel.zmax : point.z;
-    outputModel.xmin = outputModel.xmin < point.x ? outputModel.xmin : point.x;
-    outputModel.ymin = outputModel.ymin < point.y ? outputModel.ymin : point.y;
-    outputModel.zmin = outputModel.zmin < point.z ? outputModel.zmin : point.z;
-  }
+  // PCQM needs valid color attributes, if none we generate a pure white
+  if ( inputModel.colors.size() == inputModel.vertices.size() )
+    outputModel.colors = inputModel.colors;
+  else
+    outputModel.colors.assign( inputModel.vertices.size(), 255.0f );
+  outputModel.lab.clear();
+  // init bbox boundaries
+  outputModel.computeBBox();
 }
 
 int Compare::pcqm(
@@ -986,8 +1071,8 @@ int Compare::pcqm(
   sampleIfNeeded( *modelB, mapSetB, *outputB );
 
   // 2 - transcode to PCQM internal format
-  PointSet inCloud1;
-  PointSet inCloud2;
+  CompactPointSet inCloud1;
+  CompactPointSet inCloud2;
 
   convertModel( *outputA, inCloud1 );
   convertModel( *outputB, inCloud2 );
@@ -995,8 +1080,14 @@ int Compare::pcqm(
   // 3 - compute the metric
   // ModelA is Reference model
   // switch ref anf deg as in original PCQM (order matters)
-  double pcqm =
-    compute_pcqm( inCloud2, inCloud1, "reffile", "regfile", radiusCurvature, thresholdKnnSearch, radiusFactor );
+  {
+    ScopedTimer treeTimer( "pcqm kdtree build", "compare" );
+    _pcqmReference = build_pcqm_reference_index( inCloud2, std::move( _pcqmReference ) );
+  }
+  ScopedTimer metricTimer( "pcqm metric", "compare" );
+  double      pcqm = compute_pcqm(
+    inCloud2, inCloud1, "reffile", "regfile", radiusCurvature, thresholdKnnSearch, radiusFactor, _pcqmReference );
+  metricTimer.stop();
 
   // compute PSNR
   // we use outputA as reference for PSNR signal dynamic
@@ -1101,22 +1192,22 @@ int Compare::ibsm(
   size_t      maskSizeSum        = 0;  // store the sum for final computation of the mean
   size_t      unmatchedPixelsSum = 0;  // store the sum of unmatched pixels for reporting
 
-  clock_t t1 = clock();
+  ScopedTimer reorderTimer( disableReordering ? "recopy" : "reorder", "compare" );
   if ( !disableReordering ) {
     // reorder the faces if needed, reordering is important for metric stability and
     // to get Infinite PSNR on equal meshes even with shuffled faces.
     mm::reorder( *modelA, "oriented", *outputA );
     mm::reorder( *modelB, "oriented", *outputB );
-    if ( verbose )
-      std::cout << "Time on mesh reordering = " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+    reorderTimer.stop();
+    if ( verbose ) std::cout << "Time on mesh reordering = " << reorderTimer.elapsed() << " sec." << std::endl;
   } else {
     // just replicate the input
     // outputs may have updated normals hereafter
     *outputA = *modelA;
     *outputB = *modelB;
+    reorderTimer.stop();
     if ( verbose )
-      std::cout << "Skipped reordering, time on mesh recopy = " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC
-                << " sec." << std::endl;
+      std::cout << "Skipped reordering, time on mesh recopy = " << reorderTimer.elapsed() << " sec." << std::endl;
   }
 
   const unsigned int width   = resolution;
@@ -1162,7 +1253,7 @@ int Compare::ibsm(
       std::cout << "render viewDir= " << viewDir[0] << " " << viewDir[1] << " " << viewDir[2] << std::endl;
       std::cout << "render viewUp= " << viewUp[0] << " " << viewUp[1] << " " << viewUp[2] << std::endl;
     }
-    clock_t t1 = clock();
+    ScopedTimer timer( "render buffers", "compare" );
 
     if ( renderer == "gl12_raster" ) {
       if ( disableCulling ) _hwRenderer.disableCulling();
@@ -1192,10 +1283,8 @@ int Compare::ibsm(
       if ( verbose ) std::cout << "Signal Dynamic = " << depthRangeRef << std::endl;
     }
 
-    clock_t t2 = clock();
-    if ( verbose ) {
-      std::cout << "Time on buffers rendering: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
-    }
+    if ( verbose ) { std::cout << "Time on buffers rendering: " << timer.elapsed() << " sec." << std::endl; }
+    timer.restart( "mse" );
     if ( outputPrefix != "" ) {
       const std::string fullPrefix =
         outputPrefix + "_" + std::to_string( _ibsmResults.size() ) + "_" + std::to_string( camIdx ) + "_";
@@ -1317,10 +1406,7 @@ int Compare::ibsm(
       // else we skip ~ add 0, because no depth exist in both buffers (faster processing)
     }
 
-    if ( verbose ) {
-      clock_t t3 = clock();
-      std::cout << "Time on MSE computing: " << ( (float)( t3 - t2 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
-    }
+    if ( verbose ) { std::cout << "Time on MSE computing: " << timer.elapsed() << " sec." << std::endl; }
   }
 
   // finally computes the MSE by dividing over total number of projected pixels
@@ -1444,17 +1530,9 @@ std::vector<double> Compare::getPccResults( const size_t index ) {
 std::vector<double> Compare::getPccResultsPerPoint(const int abIndex, const size_t index, const size_t pointIndex) {
     std::vector<double> results;
     results.resize(10, 0.0);
-    if (index < _pccResultsPerPoint[abIndex].size()) {
-        results[0] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].c2c_psnr);
-        results[1] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].c2p_psnr);
-        results[2] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_psnr[0]);
-        results[3] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_psnr[1]);
-        results[4] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_psnr[2]);
-        results[5] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].c2c_hausdorff_psnr);
-        results[6] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].c2p_hausdorff_psnr);
-        results[7] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_rgb_hausdorff_psnr[0]);
-        results[8] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_rgb_hausdorff_psnr[1]);
-        results[9] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_rgb_hausdorff_psnr[2]);
+    if (index + 1 == _pccFramesPerPoint && pointIndex < _pccResultsPerPoint[abIndex].size()) {
+        const auto& record = _pccResultsPerPoint[abIndex][pointIndex];
+        for (size_t j = 0; j < 10; j++) results[j] = record.psnr[j];
     }
     return results;
 }
@@ -1462,17 +1540,9 @@ std::vector<double> Compare::getPccResultsPerPoint(const int abIndex, const size
 std::vector<double> Compare::getPccResultsPerPointMse(const int abIndex, const size_t index, const size_t pointIndex) {
     std::vector<double> results;
     results.resize(10, 0.0);
-    if (index < _pccResultsPerPoint[abIndex].size()) {
-        results[0] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].c2c_mse);
-        results[1] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].c2p_mse);
-        results[2] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_mse[0]);
-        results[3] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_mse[1]);
-        results[4] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_mse[2]);
-        results[5] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].c2c_hausdorff);
-        results[6] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].c2p_hausdorff);
-        results[7] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_rgb_hausdorff[0]);
-        results[8] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_rgb_hausdorff[1]);
-        results[9] = (std::min)(CLIP, _pccResultsPerPoint[abIndex][index].second[pointIndex].color_rgb_hausdorff[2]);
+    if (index + 1 == _pccFramesPerPoint && pointIndex < _pccResultsPerPoint[abIndex].size()) {
+        const auto& record = _pccResultsPerPoint[abIndex][pointIndex];
+        for (size_t j = 0; j < 10; j++) results[j] = record.mse[j];
     }
     return results;
 }
@@ -1511,40 +1581,28 @@ std::vector<double> Compare::getFinalPcqmResults() {
   return results;
 }
 
-std::vector<std::vector<double>> Compare::getPccResultsPerPoint(const int abIndex) {
+// averages from the running sums, offset 0 for psnr and 10 for mse
+static std::vector<std::vector<double>> averagePerPoint(
+  const std::vector<double>& sums, const size_t frameCount, const size_t offset ) {
     std::vector<std::vector<double>> resultPerPoints;
-    if (_pccResultsPerPoint[abIndex].size() > 0) {
-        long pointCount = _pccResultsPerPoint[abIndex][0].second.size();
+    if (frameCount > 0) {
+        const size_t pointCount = sums.size() / 20;
         resultPerPoints.resize(pointCount);
-        for (long pi = 0; pi < pointCount; ++pi) {
-            auto results = getPccResultsPerPoint(abIndex, _pccResultsPerPoint[abIndex].size(), pi);
-            for (size_t i = 0; i < _pccResultsPerPoint[abIndex].size(); i++) {
-                const auto element = getPccResultsPerPoint(abIndex, i, pi);
-                for (size_t j = 0; j < results.size(); j++) results[j] += element[j];
-            }
-            for (auto& v : results) v /= (double)_pccResultsPerPoint[abIndex].size();
-            //resultPerPoints.push_back(results);
-            resultPerPoints[pi] = results;
+        for (size_t pi = 0; pi < pointCount; ++pi) {
+            auto& results = resultPerPoints[pi];
+            results.resize(10);
+            for (size_t j = 0; j < 10; j++) results[j] = sums[pi * 20 + offset + j] / (double)frameCount;
         }
     }
     return resultPerPoints;
 }
 
+std::vector<std::vector<double>> Compare::getPccResultsPerPoint(const int abIndex) {
+    return averagePerPoint(_pccSumsPerPoint[abIndex], _pccFramesPerPoint, 0);
+}
+
 std::vector<std::vector<double>> Compare::getPccResultsPerPointMse(const int abIndex) {
-    std::vector < std::vector<double>> resultPerPoints;
-    if (_pccResultsPerPoint[abIndex].size() > 0) {
-        long pointCount = _pccResultsPerPoint[abIndex][0].second.size();
-        for (long pi = 0; pi < pointCount; ++pi) {
-            auto results = getPccResultsPerPointMse(abIndex, _pccResultsPerPoint[abIndex].size(), pi);
-            for (size_t i = 0; i < _pccResultsPerPoint[abIndex].size(); i++) {
-                const auto element = getPccResultsPerPointMse(abIndex, i, pi);
-                for (size_t j = 0; j < results.size(); j++) results[j] += element[j];
-            }
-            for (auto& v : results) v /= (double)_pccResultsPerPoint[abIndex].size();
-            resultPerPoints.push_back(results);
-        }
-    }
-    return resultPerPoints;
+    return averagePerPoint(_pccSumsPerPoint[abIndex], _pccFramesPerPoint, 10);
 }
 
 std::vector<double> Compare::getIbsmResults( const size_t index ) {
@@ -1573,3 +1631,83 @@ std::vector<double> Compare::getFinalIbsmResults() {
   }
   return results;
 }
+
+// the serialized fields of the frame results, in checkpoint order
+static std::vector<double*> pccFields( pcc_quality::qMetric& qm ) {
+  return { &qm.c2c_mse,
+           &qm.c2c_hausdorff,
+           &qm.c2p_mse,
+           &qm.c2p_hausdorff,
+           &qm.color_mse[0],
+           &qm.color_mse[1],
+           &qm.color_mse[2],
+           &qm.color_rgb_hausdorff[0],
+           &qm.color_rgb_hausdorff[1],
+           &qm.color_rgb_hausdorff[2],
+           &qm.c2c_psnr,
+           &qm.c2c_hausdorff_psnr,
+           &qm.c2p_psnr,
+           &qm.c2p_hausdorff_psnr,
+           &qm.color_psnr[0],
+           &qm.color_psnr[1],
+           &qm.color_psnr[2],
+           &qm.color_rgb_hausdorff_psnr[0],
+           &qm.color_rgb_hausdorff_psnr[1],
+           &qm.color_rgb_hausdorff_psnr[2] };
+}
+
+static std::vector<double*> ibsmFields( Compare::IbsmResults& res ) {
+  std::vector<double*> fields;
+  for ( size_t c = 0; c < 4; ++c ) fields.push_back( &res.rgbMSE[c] );
+  for ( size_t c = 0; c < 4; ++c ) fields.push_back( &res.rgbPSNR[c] );
+  for ( size_t c = 0; c < 4; ++c ) fields.push_back( &res.yuvMSE[c] );
+  for ( size_t c = 0; c < 4; ++c ) fields.push_back( &res.yuvPSNR[c] );
+  fields.push_back( &res.depthMSE );
+  fields.push_back( &res.depthPSNR );
+  fields.push_back( &res.boxRatio );
+  fields.push_back( &res.unmatchedPixelPercentage );
+  return fields;
+}
+
+size_t Compare::getResultCount( const std::string& mode ) {
+  if ( mode == "pcc" ) return _pccResults.size();
+  if ( mode == "pcqm" ) return _pcqmResults.size();
+  if ( mode == "ibsm" ) return _ibsmResults.size();
+  return 0;
+}
+
+bool Compare::getResultValues( const std::string& mode, const size_t index, std::vector<double>& values ) {
+  values.clear();
+  if ( index >= getResultCount( mode ) ) return false;
+  if ( mode == "pcc" ) {
+    for ( const double* v : pccFields( _pccResults[index].second ) ) values.push_back( *v );
+  } else if ( mode == "pcqm" ) {
+    values.push_back( std::get<1>( _pcqmResults[index] ) );
+    values.push_back( std::get<2>( _pcqmResults[index] ) );
+  } else {
+    for ( const double* v : ibsmFields( _ibsmResults[index].second ) ) values.push_back( *v );
+  }
+  return true;
+}
+
+bool Compare::addResultValues( const std::string& mode, const std::vector<double>& values ) {
+  if ( mode == "pcc" ) {
+    pcc_quality::qMetric qm;
+    auto                 fields = pccFields( qm );
+    if ( values.size() != fields.size() ) return false;
+    for ( size_t i = 0; i < fields.size(); ++i ) *fields[i] = values[i];
+    _pccResults.push_back( std::make_pair( (uint32_t)_pccResults.size(), qm ) );
+  } else if ( mode == "pcqm" ) {
+    if ( values.size() != 2 ) return false;
+    _pcqmResults.push_back( std::make_tuple( (uint32_t)_pcqmResults.size(), values[0], values[1] ) );
+  } else if ( mode == "ibsm" ) {
+    IbsmResults res;
+    auto        fields = ibsmFields( res );
+    if ( values.size() != fields.size() ) return false;
+    for ( size_t i = 0; i < fields.size(); ++i ) *fields[i] = values[i];
+    _ibsmResults.push_back( std::make_pair( (uint32_t)_ibsmResults.size(), res ) );
+  } else {
+    return false;
+  }
+  return true;
+}
@@ -109,3 +109,63 @@ bool Geometry::evalRayTriangle( const glm::vec3& rayOrigin,
 
   return true;
 }
+
+// the operations are the ones of evalRayTriangle, in the same order, performed on
+// RAY_BATCH_SIZE lanes (glm::dot(a,b)=(a.x*b.x+a.y*b.y)+a.z*b.z, glm::cross expanded)
+size_t Geometry::evalRayTriangleBatch( const glm::vec3&       rayOrigin,
+                                       const glm::vec3&       rayDirection,
+                                       glm::vec3::length_type axis,
+                                       const float*           coords,
+                                       size_t                 count,
+                                       const glm::vec3&       v0,
+                                       const glm::vec3&       v1,
+                                       const glm::vec3&       v2,
+                                       bool*                  hits,
+                                       glm::vec3*             res,
+                                       float                  epsilon ) {
+  for ( size_t k = 0; k < count; ++k ) hits[k] = false;
+
+  // ray independent terms
+  const glm::vec3 edge1( v1 - v0 );
+  const glm::vec3 edge2( v2 - v0 );
+  const glm::vec3 pvec = glm::cross( rayDirection, edge2 );
+  const float     det  = glm::dot( edge1, pvec );
+  if ( det > -epsilon && det < epsilon ) return 0;
+  const float     inv_det = 1.0f / det;
+  const glm::vec3 dir     = rayDirection;
+  const glm::vec3 tbase   = rayOrigin - v0;
+
+  // the lanes, unused ones are filled with the last ray
+  float tx[RAY_BATCH_SIZE], ty[RAY_BATCH_SIZE], tz[RAY_BATCH_SIZE];
+  float lu[RAY_BATCH_SIZE], lv[RAY_BATCH_SIZE], lt[RAY_BATCH_SIZE];
+  int   lhit[RAY_BATCH_SIZE];
+  for ( size_t k = 0; k < RAY_BATCH_SIZE; ++k ) {
+    tx[k] = tbase.x;
+    ty[k] = tbase.y;
+    tz[k] = tbase.z;
+  }
+  float* ta = axis == 0 ? tx : ( axis == 1 ? ty : tz );
+  for ( size_t k = 0; k < RAY_BATCH_SIZE; ++k ) ta[k] = coords[k < count ? k : count - 1] - v0[axis];
+  // branchless body, each test is negated separately to keep the NaN behavior of evalRayTriangle
+  for ( size_t k = 0; k < RAY_BATCH_SIZE; ++k ) {
+    const float u  = ( ( tx[k] * pvec.x + ty[k] * pvec.y ) + tz[k] * pvec.z ) * inv_det;
+    const float qx = ty[k] * edge1.z - edge1.y * tz[k];
+    const float qy = tz[k] * edge1.x - edge1.z * tx[k];
+    const float qz = tx[k] * edge1.y - edge1.x * ty[k];
+    const float v  = ( ( dir.x * qx + dir.y * qy ) + dir.z * qz ) * inv_det;
+    lt[k]          = ( ( edge2.x * qx + edge2.y * qy ) + edge2.z * qz ) * inv_det;
+    lu[k]          = u;
+    lv[k]          = v;
+    lhit[k]        = (int)!( u < 0.0f ) & (int)!( u > 1.0f ) & (int)!( v < 0.0f ) & (int)!( u + v > 1.0f );
+  }
+
+  // push the results
+  size_t nbHits = 0;
+  for ( size_t k = 0; k < count; ++k ) {
+    if ( !lhit[k] ) continue;
+    hits[k] = true;
+    res[k]  = glm::vec3( lt[k], lu[k], lv[k] );
+    ++nbHits;
+  }
+  return nbHits;
+}
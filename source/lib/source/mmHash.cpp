@@ -0,0 +1,174 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// internal headers
+#include "mmHash.h"
+#include "mmModel.h"
+#include "mmImage.h"
+#include "mmThreadPool.h"
+
+using namespace mm;
+
+static const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+static const size_t   CHUNK  = 1 << 20;
+
+static inline uint64_t rotl( uint64_t x, int r ) { return ( x << r ) | ( x >> ( 64 - r ) ); }
+
+static inline uint64_t read64( const uint8_t* p ) {
+  uint64_t v;
+  std::memcpy( &v, p, sizeof( v ) );
+  return v;
+}
+
+static inline uint32_t read32( const uint8_t* p ) {
+  uint32_t v;
+  std::memcpy( &v, p, sizeof( v ) );
+  return v;
+}
+
+static inline uint64_t hashRound( uint64_t acc, uint64_t input ) {
+  acc += input * PRIME2;
+  acc = rotl( acc, 31 );
+  return acc * PRIME1;
+}
+
+static inline uint64_t mergeRound( uint64_t acc, uint64_t val ) {
+  acc ^= hashRound( 0, val );
+  return acc * PRIME1 + PRIME4;
+}
+
+// single threaded hash of a chunk, four independent lanes of 8 bytes
+static uint64_t hashChunk( const uint8_t* p, size_t size, uint64_t seed ) {
+  const uint8_t* const end = p + size;
+  uint64_t             h;
+  if ( size >= 32 ) {
+    uint64_t v1 = seed + PRIME1 + PRIME2;
+    uint64_t v2 = seed + PRIME2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - PRIME1;
+    for ( const uint8_t* const limit = end - 32; p <= limit; p += 32 ) {
+      v1 = hashRound( v1, read64( p ) );
+      v2 = hashRound( v2, read64( p + 8 ) );
+      v3 = hashRound( v3, read64( p + 16 ) );
+      v4 = hashRound( v4, read64( p + 24 ) );
+    }
+    h = rotl( v1, 1 ) + rotl( v2, 7 ) + rotl( v3, 12 ) + rotl( v4, 18 );
+    h = mergeRound( h, v1 );
+    h = mergeRound( h, v2 );
+    h = mergeRound( h, v3 );
+    h = mergeRound( h, v4 );
+  } else {
+    h = seed + PRIME5;
+  }
+  h += (uint64_t)size;
+  for ( ; p + 8 <= end; p += 8 ) h = rotl( h ^ hashRound( 0, read64( p ) ), 27 ) * PRIME1 + PRIME4;
+  if ( p + 4 <= end ) {
+    h = rotl( h ^ ( (uint64_t)read32( p ) * PRIME1 ), 23 ) * PRIME2 + PRIME3;
+    p += 4;
+  }
+  for ( ; p < end; ++p ) h = rotl( h ^ ( ( *p ) * PRIME5 ), 11 ) * PRIME1;
+  // avalanche
+  h ^= h >> 33;
+  h *= PRIME2;
+  h ^= h >> 29;
+  h *= PRIME3;
+  h ^= h >> 32;
+  return h;
+}
+
+uint64_t Hash::buffer( const void* data, size_t size, uint64_t seed ) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  if ( size <= CHUNK ) return hashChunk( bytes, size, seed );
+  // chunks hashed in parallel, then combined in order
+  const size_t          chunkCount = ( size + CHUNK - 1 ) / CHUNK;
+  std::vector<uint64_t> chunks( chunkCount );
+  parallelFor( 0, chunkCount, 1, [&]( size_t c ) {
+    const size_t first = c * CHUNK;
+    chunks[c]          = hashChunk( bytes + first, ( std::min )( CHUNK, size - first ), seed );
+  } );
+  uint64_t hash = combine( seed, (uint64_t)size );
+  for ( const uint64_t h : chunks ) hash = combine( hash, h );
+  return hash;
+}
+
+uint64_t Hash::combine( uint64_t hash, uint64_t value ) {
+  // splitmix64 finalizer of the mixed values
+  uint64_t z = hash ^ ( value + 0x9E3779B97F4A7C15ULL + ( hash << 6 ) + ( hash >> 2 ) );
+  z          = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+  z          = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+  return z ^ ( z >> 31 );
+}
+
+// the sizes are combined to separate the arrays
+template <typename T>
+static uint64_t combineArray( uint64_t hash, const std::vector<T>& array ) {
+  hash = Hash::combine( hash, (uint64_t)array.size() );
+  return Hash::combine( hash, Hash::buffer( array.data(), array.size() * sizeof( T ) ) );
+}
+
+uint64_t Hash::model( const Model& model ) {
+  uint64_t hash = 0;
+  hash          = combineArray( hash, model.vertices );
+  hash          = combineArray( hash, model.uvcoords );
+  hash          = combineArray( hash, model.normals );
+  hash          = combineArray( hash, model.colors );
+  hash          = combineArray( hash, model.faceNormals );
+  hash          = combineArray( hash, model.triangles );
+  hash          = combineArray( hash, model.trianglesuv );
+  hash          = combineArray( hash, model.triangleMatIdx );
+  return hash;
+}
+
+uint64_t Hash::image( const Image& image ) {
+  uint64_t hash = combine( 0, (uint64_t)image.width );
+  hash          = combine( hash, (uint64_t)image.height );
+  hash          = combine( hash, (uint64_t)image.nbc );
+  return combine( hash, buffer( image.data, image.getByteSize() ) );
+}
+
+std::string Hash::toHex( uint64_t hash ) {
+  static const char digits[] = "0123456789abcdef";
+  std::string       hex( 16, '0' );
+  for ( int i = 15; i >= 0; --i, hash >>= 4 ) hex[i] = digits[hash & 0xF];
+  return hex;
+}
@@ -44,7 +44,17 @@
 #include <unordered_map>
 #include <time.h>
 #include <cmath>
+#include <cstring>
 #include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <charconv>
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <limits.h>
+#  include <unistd.h>
+#  include <sys/uio.h>
+#endif
 // ply loader
 #define TINYPLY_IMPLEMENTATION
 #include "tinyply.h"
@@ -59,6 +69,10 @@
 #include <glm/gtx/string_cast.hpp>
 
 #include "mmIO.h"
+#include "mmTrace.h"
+#include "mmAsyncWriter.h"
+#include "mmThreadPool.h"
+#include "mmTextureCache.h"
 
 using namespace mm;
 
@@ -67,10 +81,92 @@ Context* IO::_context = NULL;
 // create the stores
 std::map<std::string, ModelPtr> IO::_models;
 std::map<std::string, ImagePtr> IO::_images;
+// protects the stores and the file cache, files are loaded and saved outside of the lock
+// (see mm --concurrent, commands sharing a name are never run concurrently)
+static std::mutex s_storeMutex;
+
+// attributes of the models of the store partially loaded from files (see loadModel)
+static std::map<std::string, uint32_t> s_partialModels;
+
+// persistent file cache
+struct FileCacheEntry {
+  ModelPtr                        model;
+  ImagePtr                        image;
+  std::filesystem::file_time_type time;
+  uintmax_t                       fileSize;
+  size_t                          bytes;
+  uint32_t                        attributes;  // attributes loaded from the file (see IO::loadModel)
+  uint64_t                        lastUse;
+};
+static std::map<std::string, FileCacheEntry> s_fileCache;  // absolute filename -> entry
+static size_t                                s_fileCacheMax   = 0;
+static size_t                                s_fileCacheBytes = 0;
+static uint64_t                              s_fileCacheClock = 0;
+
+// returns the valid entry of filename if any, stale entries are removed
+static FileCacheEntry* fileCacheFind( const std::string& filename, std::string& key ) {
+  if ( s_fileCacheMax == 0 ) return NULL;
+  std::error_code error;
+  key     = std::filesystem::absolute( filename, error ).string();
+  auto it = s_fileCache.find( key );
+  if ( it == s_fileCache.end() ) return NULL;
+  const auto time     = std::filesystem::last_write_time( key, error );
+  const auto fileSize = error ? 0 : std::filesystem::file_size( key, error );
+  if ( error || time != it->second.time || fileSize != it->second.fileSize ) {
+    s_fileCacheBytes -= it->second.bytes;
+    s_fileCache.erase( it );
+    return NULL;
+  }
+  it->second.lastUse = ++s_fileCacheClock;
+  return &it->second;
+}
+
+// adds a copy of the model or image, then frees the least recently used entries if needed
+static void fileCacheInsert( const std::string& key,
+                             const ModelPtr&    model,
+                             const ImagePtr&    image,
+                             uint32_t           attributes = IO::ALL ) {
+  if ( s_fileCacheMax == 0 || key.empty() ) return;
+  FileCacheEntry  entry;
+  std::error_code error;
+  entry.time     = std::filesystem::last_write_time( key, error );
+  entry.fileSize = error ? 0 : std::filesystem::file_size( key, error );
+  entry.bytes    = model ? model->getAttributesByteSize() : image->getByteSize();
+  if ( error || entry.bytes > s_fileCacheMax ) return;
+  entry.model   = model ? ModelPtr( new Model( *model ) ) : ModelPtr();
+  entry.image      = image ? ImagePtr( new Image( *image ) ) : ImagePtr();
+  entry.attributes = attributes;
+  entry.lastUse    = ++s_fileCacheClock;
+  s_fileCacheBytes += entry.bytes;
+  s_fileCache[key] = entry;
+  while ( s_fileCacheBytes > s_fileCacheMax ) {
+    auto lru = s_fileCache.begin();
+    for ( auto it = s_fileCache.begin(); it != s_fileCache.end(); ++it )
+      if ( it->second.lastUse < lru->second.lastUse ) lru = it;
+    s_fileCacheBytes -= lru->second.bytes;
+    s_fileCache.erase( lru );
+  }
+}
 
 //
 void IO::setContext( Context* context ) { _context = context; }
 
+//
+void IO::setFileCacheSize( size_t maxBytes ) {
+  std::lock_guard<std::mutex> lock( s_storeMutex );
+  s_fileCacheMax = maxBytes;
+  if ( maxBytes == 0 ) {
+    s_fileCache.clear();
+    s_fileCacheBytes = 0;
+  }
+}
+
+//
+size_t IO::getFileCacheByteSize( void ) {
+  std::lock_guard<std::mutex> lock( s_storeMutex );
+  return s_fileCacheBytes;
+}
+
 //
 std::string IO::resolveName( const uint32_t frame, const std::string& input ) {
   std::string output;
@@ -86,42 +182,131 @@ std::string IO::resolveName( const uint32_t frame, const std::string& input ) {
 }
 
 //
-ModelPtr IO::loadModel(std::string templateName)
+ModelPtr IO::loadModel(std::string templateName, uint32_t attributes)
 {
     std::string name = resolveName(_context->getFrame(), templateName);
-    std::map<std::string, ModelPtr>::iterator it = IO::_models.find(name);
-    if (it == IO::_models.end()) {
+    std::string cacheKey;
+    {
+        std::lock_guard<std::mutex> lock(s_storeMutex);
+        std::map<std::string, ModelPtr>::iterator it = IO::_models.find(name);
+        if (it != IO::_models.end()) {
+            // a partially loaded model is reloaded with the missing attributes
+            auto partial = s_partialModels.find(name);
+            if (partial == s_partialModels.end() || (attributes & ~partial->second) == 0)
+                return it->second;
+            attributes |= partial->second;
+        }
         if (name.substr(0, 3) == "ID:") {
             std::cout << "Error: model with id " << name << "not defined" << std::endl;
             return ModelPtr();
         }
-        else {  
-            // we try to load the model
-            ModelPtr model = ModelPtr(new Model());
-            if (IO::_loadModel(name, *model)) {
+        // copy of the cached model if the file did not change
+        FileCacheEntry* cached = fileCacheFind(name, cacheKey);
+        if (cached != NULL && cached->model) {
+            if ((attributes & ~cached->attributes) == 0) {
+                ModelPtr model = ModelPtr(new Model(*cached->model));
                 IO::_models[name] = model;
+                if (cached->attributes != ALL)
+                    s_partialModels[name] = cached->attributes;
+                else
+                    s_partialModels.erase(name);
                 return model;
             }
-            else
-                return ModelPtr();
+            attributes |= cached->attributes;
         }
     }
-    return it->second;
+    // we try to load the model, once written if saved by a previous frame
+    AsyncWriter::wait(name);
+    ModelPtr model = ModelPtr(new Model());
+    if (IO::_loadModel(name, *model, attributes)) {
+        std::lock_guard<std::mutex> lock(s_storeMutex);
+        IO::_models[name] = model;
+        if (attributes != ALL)
+            s_partialModels[name] = attributes;
+        else
+            s_partialModels.erase(name);
+        fileCacheInsert(cacheKey, model, ImagePtr(), attributes);
+        return model;
+    }
+    else
+        return ModelPtr();
 };
 
 //
 bool IO::saveModel( std::string templateName, ModelPtr model ) {
   std::string name = resolveName( _context->getFrame(), templateName );
-  std::map<std::string, ModelPtr>::iterator it = IO::_models.find( name );
-  if ( it != IO::_models.end() ) {
-    std::cout << "Warning: model with id " << name << " already defined, overwriting" << std::endl;
-    it->second = model; // previous model will be freed by the shared pointer
-  } else {
-    IO::_models[name] = model;
+  {
+    std::lock_guard<std::mutex> lock( s_storeMutex );
+    std::map<std::string, ModelPtr>::iterator it = IO::_models.find( name );
+    if ( it != IO::_models.end() ) {
+      std::cout << "Warning: model with id " << name << " already defined, overwriting" << std::endl;
+      it->second = model; // previous model will be freed by the shared pointer
+    } else {
+      IO::_models[name] = model;
+    }
+    s_partialModels.erase( name );
   }
   // save to file if not an id
-  if ( name.substr( 0, 3 ) != "ID:" ) { return IO::_saveModel( name, *model ); }
-  return true;
+  if ( name.substr( 0, 3 ) == "ID:" ) return true;
+  if ( !AsyncWriter::isEnabled() ) return IO::_saveModel( name, *model );
+  // the writer saves a copy, the stored model can be modified by the next commands
+  std::shared_ptr<const Model> snapshot( new Model( *model ) );
+  return AsyncWriter::submit( name, [name, snapshot]() { return IO::_saveModel( name, *snapshot ); } );
+}
+
+// video frames are read with _loadImageFromVideo
+static bool isVideoName( const std::string& templateName ) {
+  auto dotPos = templateName.find_last_of( "." );
+  if ( dotPos == std::string::npos ) return false;
+  std::string ext = templateName.substr( dotPos );
+  std::transform( ext.begin(), ext.end(), ext.begin(), []( unsigned char c ) { return std::tolower( c ); } );
+  return ext == ".yuv" || ext == ".rgb";
+}
+
+// loads the image file or video frame name, without the store.
+// the messages are written to log, images files can be loaded concurrently (see loadImages).
+static ImagePtr loadImageData( const std::string& templateName, const std::string& name, std::ostream& log ) {
+  ImagePtr image = ImagePtr( new Image() );
+
+  auto dotPos = templateName.find_last_of( "." );
+  if ( dotPos == std::string::npos ) {
+    log << "Error: missing map filename extension " << templateName << std::endl;
+    return ImagePtr();
+  }
+
+  if ( isVideoName( templateName ) ) {
+    // try to load as video
+    if ( !IO::_loadImageFromVideo( name, *image ) ) { return ImagePtr(); }
+  } else {
+    // copy of the cached image if the file did not change, video frames are not cached
+    std::string cacheKey;
+    bool        isCached = false;
+    {
+      std::lock_guard<std::mutex> lock( s_storeMutex );
+      FileCacheEntry*             cached = fileCacheFind( name, cacheKey );
+      if ( cached != NULL && cached->image ) {
+        *image   = *cached->image;
+        isCached = true;
+      }
+    }
+    if ( !isCached ) {
+      // try to load as image, once written if saved by a previous frame
+      AsyncWriter::wait( name );
+      // decoded pixels mapped from the texture cache if any (see mm --textureCache)
+      if ( TextureCache::load( name, *image ) ) {
+        log << "Input map: " << name << std::endl;
+        log << "Map restored from texture cache " << TextureCache::getEntryName( name ) << std::endl;
+      } else {
+        if ( !IO::_loadImage( name, *image, log ) ) { return ImagePtr(); }
+        if ( TextureCache::isEnabled() && !TextureCache::save( name, *image ) )
+          log << "Warning: could not save " << name << " to the texture cache " << TextureCache::getDirectory()
+              << std::endl;
+      }
+      std::lock_guard<std::mutex> lock( s_storeMutex );
+      fileCacheInsert( cacheKey, ModelPtr(), image );
+    }
+  }
+  return image;
 }
 
 //
@@ -129,11 +314,14 @@ ImagePtr IO::loadImage( std::string templateName ) {
   // The IO store is purged for each new frame.
   // So in case of video file without %d template we just use the filename (unchanged by resolveName).
   std::string name = resolveName( _context->getFrame(), templateName );
-  std::map<std::string, ImagePtr>::iterator it = IO::_images.find( name );
+  {
+    std::lock_guard<std::mutex> lock( s_storeMutex );
+    std::map<std::string, ImagePtr>::iterator it = IO::_images.find( name );
+
+    // use image/frame from store
+    if ( it != IO::_images.end() ) { return it->second; }
+  }
 
-  // use image/frame from store
-  if ( it != IO::_images.end() ) { return it->second; }
-  
   // not found in store but name is an ID => error
   // empty image will be added to the stiore with given ID
   if ( name.substr( 0, 3 ) == "ID:" ) {
@@ -142,39 +330,60 @@ ImagePtr IO::loadImage( std::string templateName ) {
   }
 
   // else try to load the image/frame
-  ImagePtr image = ImagePtr(new Image());
-
-  auto dotPos = templateName.find_last_of(".");
-  if (dotPos == std::string::npos) {
-      std::cout << "Error: missing map filename extension " << templateName << std::endl;
-      return ImagePtr();
-  }
-
-  std::string ext = templateName.substr(dotPos);
-  std::transform( ext.begin(), ext.end(), ext.begin(), []( unsigned char c ) { return std::tolower( c ); } );
-
-  if ( ext == ".yuv" || ext == ".rgb" ) {
-    // try to load as video
-    if ( !IO::_loadImageFromVideo( name, *image ) ) {
-        return ImagePtr();
-    }
-  } else {
-    // try to load as image
-    if ( !IO::_loadImage( name, *image ) ) {
-        return ImagePtr();
-    }
-  }
+  ImagePtr image = loadImageData( templateName, name, std::cout );
+  if ( !image ) return ImagePtr();
 
   // add to the store
+  std::lock_guard<std::mutex> lock( s_storeMutex );
   IO::_images[name] = image;
   return image;
 };
 
 bool IO::loadImages( const std::vector<std::string>& imageUrlList, std::vector<mm::ImagePtr>& images ) {
+  // the image files not in the store are decoded concurrently, once per name,
+  // their messages are printed hereafter in the order of the list
+  struct Decoded {
+    std::string        templateName;
+    std::string        name;
+    ImagePtr           image;
+    std::ostringstream log;
+  };
+  std::vector<Decoded>          decoded;
+  std::map<std::string, size_t> decodedIndex;  // name -> index in decoded
+  {
+    std::lock_guard<std::mutex> lock( s_storeMutex );
+    for ( const auto& url : imageUrlList ) {
+      if ( url.size() == 0 || isVideoName( url ) ) continue;
+      const std::string name = resolveName( _context->getFrame(), url );
+      if ( name.substr( 0, 3 ) == "ID:" || IO::_images.count( name ) || decodedIndex.count( name ) ) continue;
+      decodedIndex[name] = decoded.size();
+      decoded.emplace_back();
+      decoded.back().templateName = url;
+      decoded.back().name         = name;
+    }
+  }
+  parallelFor( 0, decoded.size(), 1, [&]( size_t i ) {
+    decoded[i].image = loadImageData( decoded[i].templateName, decoded[i].name, decoded[i].log );
+  } );
+
   bool res = true;
   for ( auto url : imageUrlList ) {
     if ( url.size() != 0 ) {
-      images.push_back( mm::IO::loadImage( url ) );  // thus if fails, the element of the array contains NULL
+      auto it = decodedIndex.find( resolveName( _context->getFrame(), url ) );
+      if ( it != decodedIndex.end() ) {
+        // first use of a decoded image, later uses of the name are found in the store
+        Decoded& entry = decoded[it->second];
+        std::cout << entry.log.str() << std::flush;
+        decodedIndex.erase( it );
+        if ( entry.image ) {
+          std::lock_guard<std::mutex> lock( s_storeMutex );
+          // keeps the image stored meanwhile by a concurrent command if any
+          entry.image = IO::_images.emplace( entry.name, entry.image ).first->second;
+        }
+        images.push_back( entry.image );  // thus if fails, the element of the array contains NULL
+      } else {
+        images.push_back( mm::IO::loadImage( url ) );  // thus if fails, the element of the array contains NULL
+      }
       res = res && isValid( images.back() );
     } else {
       // not an error, see method documentation
@@ -203,17 +412,40 @@ bool  IO::saveImage(std::string name, Image* image) {
 
 //
 void IO::purge( void ) {
+  std::lock_guard<std::mutex> lock( s_storeMutex );
   // free all the texture maps
   _images.clear();
 
   // free all the models
   _models.clear();
+  s_partialModels.clear();
+}
+
+//
+size_t IO::getModelsByteSize( void ) {
+  std::lock_guard<std::mutex> lock( s_storeMutex );
+  size_t                      bytes = 0;
+  for ( const auto& model : _models ) {
+    if ( model.second ) bytes += model.second->getAttributesByteSize();
+  }
+  return bytes;
+}
+
+//
+size_t IO::getImagesByteSize( void ) {
+  std::lock_guard<std::mutex> lock( s_storeMutex );
+  size_t                      bytes = 0;
+  for ( const auto& image : _images ) {
+    if ( image.second ) bytes += image.second->getByteSize();
+  }
+  return bytes;
 }
 
 ///////////////////////////
 // Private methods
 
-bool IO::_loadModel( std::string filename, Model& output ) {
+bool IO::_loadModel( std::string filename, Model& output, uint32_t attributes ) {
+  ScopedTimer timer( "load " + filename, "io" );
   bool success = true;
 
   // sanity check
@@ -229,19 +461,15 @@ bool IO::_loadModel( std::string filename, Model& output ) {
   // do the job
   if ( ext == "ply" ) {
     std::cout << "Loading file: " << filename << std::endl;
-    auto t1 = clock();
-    success = IO::_loadPly( filename, output );  // TODO handle read error
+    success = IO::_loadPly( filename, output, attributes );  // TODO handle read error
     if ( success ) {
-      auto t2 = clock();
-      std::cout << "Time on loading: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+      std::cout << "Time on loading: " << timer.elapsed() << " sec." << std::endl;
     }
   } else if ( ext == "obj" ) {
     std::cout << "Loading file: " << filename << std::endl;
-    auto t1 = clock();
-    success = IO::_loadObj( filename, output );  // TODO handle read error
+    success = IO::_loadObj( filename, output, attributes );  // TODO handle read error
     if ( success ) {
-      auto t2 = clock();
-      std::cout << "Time on loading: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+      std::cout << "Time on loading: " << timer.elapsed() << " sec." << std::endl;
     }
   } else {
     std::cout << "Error, invalid model filename extension (not in obj, ply)" << std::endl;
@@ -271,6 +499,7 @@ bool IO::_loadModel( std::string filename, Model& output ) {
 }
 
 bool IO::_saveModel( std::string filename, const Model& input ) {
+  ScopedTimer timer( "save " + filename, "io" );
   // sanity check
   if ( filename.size() < 5 ) {
     std::cout << "Error, invalid mesh file name " << filename << std::endl;
@@ -284,20 +513,16 @@ bool IO::_saveModel( std::string filename, const Model& input ) {
   // write output
   if ( out_ext == "ply" ) {
     std::cout << "Saving file: " << filename << std::endl;
-    auto t1  = clock();
     auto err = IO::_savePly( filename, input );
     if ( !err ) {
-      auto t2 = clock();
-      std::cout << "Time on saving: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+      std::cout << "Time on saving: " << timer.elapsed() << " sec." << std::endl;
     }
     return err;
   } else if ( out_ext == "obj" ) {
     std::cout << "Saving file: " << filename << std::endl;
-    auto t1  = clock();
     auto err = IO::_saveObj( filename, input );
     if ( !err ) {
-      auto t2 = clock();
-      std::cout << "Time on saving: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+      std::cout << "Time on saving: " << timer.elapsed() << " sec." << std::endl;
     }
     return err;
   } else {
@@ -484,7 +709,7 @@ public:
     }
 };
 
-bool IO::_loadObj(std::string filename, Model& output) {
+bool IO::_loadObj(std::string filename, Model& output, uint32_t attributes) {
 
     // find path to file for material loading
     std::string path = std::filesystem::path( filename ).parent_path().string();
@@ -503,6 +728,13 @@ bool IO::_loadObj(std::string filename, Model& output) {
     int nbTessPol = 0;  // number of polygons/quads tesselated
     int nbTessAdd = 0;  // number of triangles added by tesselation
     int matIdx = 0; // the material index, 0 by default (only used if multiple textures are present, indicated by a list of materials inside the material library file
+    // the lines of the attributes not requested are skipped without parsing (see skipLine hereafter)
+    const bool loadPositions = attributes & POSITIONS;
+    const bool loadColors    = attributes & COLORS;
+    const bool loadNormals   = attributes & NORMALS;
+    const bool loadUvs       = attributes & UVCOORDS;
+    const bool loadFaces     = attributes & FACES;
+    const bool loadMaterials = attributes & MATERIALS;
     // consume the first character
     if ((bs.skipSpaces() == bs.end) || (bs.getChar(c) == bs.end))
         return false;
@@ -516,7 +748,7 @@ bool IO::_loadObj(std::string filename, Model& output) {
             if (bs.getChar(c2) == bs.end)
                 return false;
 
-            if (c2 == ' ') {
+            if (c2 == ' ' && (loadPositions || loadColors)) {
                 // parse the position
                 for (int i = 0; i < 3; i++) {
                     double value = 0;
@@ -524,11 +756,11 @@ bool IO::_loadObj(std::string filename, Model& output) {
                         std::cerr << "Error: line " << bs.lc << " expected floating point value" << std::endl;
                     }
                     // may push zero to be "robust"
-                    output.vertices.push_back((float)value);
+                    if (loadPositions) output.vertices.push_back((float)value);
                 }
                 // parse the color if any (re map 0.0-1.0 to 0-255 internal color format)
                 double value = 0;
-                if (bs.getDouble(value)) {
+                if (loadColors && bs.getDouble(value)) {
                     output.colors.push_back(std::roundf((float)value * 255));
                     for (int i = 0; i < 2; i++) {
                         value = 0;
@@ -540,7 +772,7 @@ bool IO::_loadObj(std::string filename, Model& output) {
                     }
                 }
             }
-            else if (c2 == 'n') {
+            else if (c2 == 'n' && loadNormals) {
                 // parse the normal
                 for (int i = 0; i < 3; i++) {
                     double value = 0;
@@ -551,7 +783,7 @@ bool IO::_loadObj(std::string filename, Model& output) {
                     output.normals.push_back((float)value);
                 }
             }
-            else if (c2 == 't') {
+            else if (c2 == 't' && loadUvs) {
                 // parse the texture coordinate
                 for (int i = 0; i < 2; i++) {
                     double value = 0;
@@ -563,7 +795,7 @@ bool IO::_loadObj(std::string filename, Model& output) {
                 }
             }
         }
-        else if (c == 'f') {
+        else if (c == 'f' && loadFaces) {
             // max vertices for a polygon (the rest will be skiped)
             const auto maxVertices = 8;
             std::array<int32_t, 3> indices[maxVertices];
@@ -639,7 +871,7 @@ bool IO::_loadObj(std::string filename, Model& output) {
                 // Process the first triangle.
                 for (int i = 0; i < 3; ++i) {
                     output.triangles.push_back(indices[i][0] - 1);
-                    output.trianglesuv.push_back(indices[i][1] - 1);
+                    if (loadUvs) output.trianglesuv.push_back(indices[i][1] - 1);
                     // no normal index table for the time being
                 }
                 output.triangleMatIdx.push_back(matIdx);
@@ -650,11 +882,11 @@ bool IO::_loadObj(std::string filename, Model& output) {
                 // Iterate over start index
                 for (int si = 2; si < numValidIndices - 1; si++) {
                     output.triangles.push_back(indices[0][0] - 1);
-                    output.trianglesuv.push_back(indices[0][1] - 1);
+                    if (loadUvs) output.trianglesuv.push_back(indices[0][1] - 1);
                     // push the two other indices
                     for (int ci = 0; ci < 2; ci++) {
                         output.triangles.push_back(indices[si + ci][0] - 1);
-                        output.trianglesuv.push_back(indices[si + ci][1] - 1);
+                        if (loadUvs) output.trianglesuv.push_back(indices[si + ci][1] - 1);
                     }
                     output.triangleMatIdx.push_back(matIdx);
                 }
@@ -662,7 +894,7 @@ bool IO::_loadObj(std::string filename, Model& output) {
                 nbTessAdd += numValidIndices - 3;
             }
         }
-        else if (c == 'm') { 
+        else if (c == 'm' && loadMaterials) { 
             token="m";
             if ( bs.getWord( token ) != bs.end && token == "mtllib" ) {
                 std::string materialLibFilename;
@@ -679,7 +911,7 @@ bool IO::_loadObj(std::string filename, Model& output) {
             } 
         }
         
-        else if (c == 'u') {
+        else if (c == 'u' && loadMaterials) {
             token = "u";
             if ( bs.getWord( token ) != bs.end && token == "usemtl" ) {
                 // the materialIndex may be updated at this point
@@ -725,7 +957,8 @@ bool IO::_loadObj(std::string filename, Model& output) {
     return true;
 }
 #else
-bool IO::_loadObj(std::string filename, Model& output) {
+// parses all the attributes whatever the requested ones
+bool IO::_loadObj(std::string filename, Model& output, uint32_t attributes) {
 
     std::ifstream fin;
     // use a big 4MB buffer to accelerate reads
@@ -813,141 +1046,192 @@ bool IO::_loadObj(std::string filename, Model& output) {
 }
 #endif
 
-#define FAST_OBJ_WRITE
-#ifdef FAST_OBJ_WRITE
-
-// Buffer used for encoding float/int numbers.
-char num_buffer_[20];
+// Text encoding of the saved models.
+// The elements are split in ranges encoded in parallel, each range into its own buffer sized
+// by an upper bound of its text. Floats are encoded with std::to_chars as "%.9g" (9 digits
+// round trip any float) so the files are unchanged, then the buffers are written in order.
+static const size_t s_encodeGrain = 65536;
+// longest float (e.g. -1.17549435e-38) and int32 (e.g. -2147483648)
+static const size_t s_maxFloatChars = 16;
+static const size_t s_maxIntChars   = 11;
+
+static inline char* encodeFloat( char* ptr, float value ) {
+  return std::to_chars( ptr, ptr + s_maxFloatChars, value, std::chars_format::general, 9 ).ptr;
+}
 
-bool Encode(const void* data, size_t data_size, std::vector<char>& bitstream) {
-    const uint8_t* src_data = reinterpret_cast<const uint8_t*>(data);
-    bitstream.insert(bitstream.end(), src_data, src_data + data_size);
-    return true;
+static inline char* encodeInt( char* ptr, int32_t value ) {
+  return std::to_chars( ptr, ptr + s_maxIntChars, value ).ptr;
 }
 
-void EncodeFloat(float val, std::vector<char>& bitstream) {
-    snprintf(num_buffer_, sizeof(num_buffer_), "%.9g", val); //%.9g keeps backward compat with previous printer
-    Encode(num_buffer_, strlen(num_buffer_), bitstream);
+static inline char* encodeText( char* ptr, const std::string& text ) {
+  memcpy( ptr, text.data(), text.size() );
+  return ptr + text.size();
 }
 
-void EncodeFloatList(float* vals, int num_vals, std::vector<char>& bitstream) {
-    for (int i = 0; i < num_vals; ++i) {
-        if (i > 0) {
-            Encode(" ", 1, bitstream);
-        }
-        EncodeFloat(vals[i], bitstream);
-    }
+// appends the buffers of count elements, encode( ptr, i ) writes the text of element i
+// at ptr, at most maxChars characters, and returns the end of the text
+template <typename F>
+static void encodeRanges( size_t count, size_t maxChars, std::vector<std::vector<char>>& buffers, F&& encode ) {
+  const size_t first  = buffers.size();
+  const size_t ranges = ( count + s_encodeGrain - 1 ) / s_encodeGrain;
+  buffers.resize( first + ranges );
+  parallelFor( 0, ranges, 1, [&]( size_t range ) {
+    const size_t       begin  = range * s_encodeGrain;
+    const size_t       end    = ( std::min )( count, begin + s_encodeGrain );
+    std::vector<char>& buffer = buffers[first + range];
+    buffer.resize( ( end - begin ) * maxChars );
+    char* ptr = buffer.data();
+    for ( size_t i = begin; i < end; ++i ) ptr = encode( ptr, i );
+    buffer.resize( ptr - buffer.data() );
+  } );
 }
 
-void EncodeInt(int32_t val, std::vector<char>& bitstream) {
-    snprintf(num_buffer_, sizeof(num_buffer_), "%d", val);
-    Encode(num_buffer_, strlen(num_buffer_), bitstream);
+static void appendText( const std::string& text, std::vector<std::vector<char>>& buffers ) {
+  buffers.emplace_back( text.begin(), text.end() );
 }
-bool IO::_saveObj(std::string filename, const Model& input) {
 
-    FILE* fp = fopen(filename.c_str(), "w+");
-    if (!fp) {
-        std::cerr << "Error: can't open file " << filename << std::endl;
-        return false;
+// writes the buffers in order, with gathered writes if available
+static bool writeBuffers( const std::string& filename, const std::vector<std::vector<char>>& buffers ) {
+#ifndef _WIN32
+  const int fd = ::open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666 );
+  if ( fd < 0 ) {
+    std::cerr << "Error: can't open file " << filename << std::endl;
+    return false;
+  }
+#  ifndef IOV_MAX
+#    define IOV_MAX 1024
+#  endif
+  std::vector<iovec> iov;
+  for ( const auto& buffer : buffers )
+    if ( !buffer.empty() ) iov.push_back( { (void*)buffer.data(), buffer.size() } );
+  bool   success = true;
+  size_t index   = 0;
+  while ( success && index < iov.size() ) {
+    const ssize_t written = ::writev( fd, &iov[index], (int)( std::min )( iov.size() - index, (size_t)IOV_MAX ) );
+    if ( written < 0 ) {
+      success = errno == EINTR;
+      continue;
+    }
+    // skips the written buffers, the last one may be partially written
+    size_t remaining = (size_t)written;
+    while ( index < iov.size() && remaining >= iov[index].iov_len ) remaining -= iov[index++].iov_len;
+    if ( remaining != 0 ) {
+      iov[index].iov_base = (char*)iov[index].iov_base + remaining;
+      iov[index].iov_len -= remaining;
     }
+  }
+  success = ::close( fd ) == 0 && success;
+#else
+  // text mode as the former stream writers
+  FILE* fp = fopen( filename.c_str(), "w" );
+  if ( !fp ) {
+    std::cerr << "Error: can't open file " << filename << std::endl;
+    return false;
+  }
+  bool success = true;
+  for ( const auto& buffer : buffers )
+    success = success && fwrite( buffer.data(), 1, buffer.size(), fp ) == buffer.size();
+  success = fclose( fp ) == 0 && success;
+#endif
+  if ( !success ) std::cerr << "Error: can't write to file " << filename << std::endl;
+  return success;
+}
 
-    std::vector<char> bs; // the bitstream
+#define FAST_OBJ_WRITE
+#ifdef FAST_OBJ_WRITE
 
-    printf("_saveObj %-40s: V = %zu Vc = %zu N = %zu UV = %zu F = %zu Fuv = %zu \n",
-        filename.c_str(),
-        input.vertices.size() / 3,
-        input.colors.size() / 3,
-        input.normals.size() / 3,
-        input.uvcoords.size() / 2,
-        input.triangles.size() / 3,
-        input.trianglesuv.size() / 3);
-    fflush(stdout);
+bool IO::_saveObj( std::string filename, const Model& input ) {
+  // logged through std::cout so the line stays with the outputs of the command (see mm --concurrent)
+  char logBuffer[4096];
+  snprintf( logBuffer,
+            sizeof( logBuffer ),
+            "_saveObj %-40s: V = %zu Vc = %zu N = %zu UV = %zu F = %zu Fuv = %zu \n",
+            filename.c_str(),
+            input.vertices.size() / 3,
+            input.colors.size() / 3,
+            input.normals.size() / 3,
+            input.uvcoords.size() / 2,
+            input.triangles.size() / 3,
+            input.trianglesuv.size() / 3 );
+  std::cout << logBuffer << std::flush;
+
+  std::vector<std::vector<char>> buffers;
+  appendText( input.header + "\n", buffers );
 
-    Encode(input.header.data(), input.header.size(), bs);
-    Encode("\n", 1, bs);
-    int refTextId = input.triangleMatIdx.size() == 0 ? -1 : input.triangleMatIdx[0];
-    for (int i = 0; i < input.vertices.size() / 3; i++) {
-        Encode("v", 1, bs);
-        for (auto c = 0; c < 3; ++c) {
-            Encode(" ", 1, bs);
-            EncodeFloat(input.vertices[i * 3 + c], bs);
-        }
-        if (input.colors.size() == input.vertices.size()) {
-            for (auto c = 0; c < 3; ++c) {
-                Encode(" ", 1, bs);
-                EncodeFloat(input.colors[i * 3 + c] / 255, bs);
-            }
-        }
-        Encode("\n", 1, bs);
+  // vertices and colors
+  const bool hasColors = input.colors.size() == input.vertices.size();
+  encodeRanges( input.vertices.size() / 3, 2 + 6 * ( s_maxFloatChars + 1 ), buffers, [&]( char* ptr, size_t i ) {
+    *ptr++ = 'v';
+    for ( size_t c = 0; c < 3; ++c ) {
+      *ptr++ = ' ';
+      ptr    = encodeFloat( ptr, input.vertices[i * 3 + c] );
     }
-    for (int i = 0; i < input.normals.size() / 3; i++) {
-        Encode("vn", 2, bs);
-        for (auto c = 0; c < 3; ++c) {
-            Encode(" ", 1, bs);
-            EncodeFloat(input.normals[i * 3 + c], bs);
-        }
-        Encode("\n", 1, bs);
+    if ( hasColors ) {
+      for ( size_t c = 0; c < 3; ++c ) {
+        *ptr++ = ' ';
+        ptr    = encodeFloat( ptr, input.colors[i * 3 + c] / 255 );
+      }
     }
-    for (int i = 0; i < input.uvcoords.size() / 2; i++) {
-        Encode("vt", 2, bs);
-        for (auto c = 0; c < 2; ++c) {
-            Encode(" ", 1, bs);
-            EncodeFloat(input.uvcoords[i * 2 + c], bs);
-        }
-        Encode("\n", 1, bs);
+    *ptr++ = '\n';
+    return ptr;
+  } );
+  encodeRanges( input.normals.size() / 3, 3 + 3 * ( s_maxFloatChars + 1 ), buffers, [&]( char* ptr, size_t i ) {
+    *ptr++ = 'v';
+    *ptr++ = 'n';
+    for ( size_t c = 0; c < 3; ++c ) {
+      *ptr++ = ' ';
+      ptr    = encodeFloat( ptr, input.normals[i * 3 + c] );
     }
-    if (input.hasUvCoords()) {
-        if (input.materialNames.size() > 0) {
-            std::string materialName = "usemtl " + input.materialNames[refTextId] + "\n";
-            Encode(materialName.data(), materialName.size(), bs);
-        }
-        else
-            Encode("usemtl material0000\n", 20, bs);
+    *ptr++ = '\n';
+    return ptr;
+  } );
+  encodeRanges( input.uvcoords.size() / 2, 3 + 2 * ( s_maxFloatChars + 1 ), buffers, [&]( char* ptr, size_t i ) {
+    *ptr++ = 'v';
+    *ptr++ = 't';
+    for ( size_t c = 0; c < 2; ++c ) {
+      *ptr++ = ' ';
+      ptr    = encodeFloat( ptr, input.uvcoords[i * 2 + c] );
     }
-    for (int i = 0; i < input.triangles.size() / 3; i++) {
-        if (input.hasUvCoords() && refTextId != -1){
-            if(input.triangleMatIdx[i] != refTextId) {
-                refTextId = input.triangleMatIdx[i];
-                std::string materialName = "usemtl " + input.materialNames[refTextId] + "\n";
-                Encode(materialName.data(), materialName.size(), bs);
-            }
-        }
-        if (input.trianglesuv.size() == input.triangles.size()) {
-            Encode("f ", 2, bs);
-            for (auto c = 0; c < 3; ++c) {
-                if ( c > 0 ) Encode( " ", 1, bs );
-                EncodeInt(input.triangles[i * 3 + c] + 1, bs);
-                Encode("/", 1, bs);
-                EncodeInt(input.trianglesuv[i * 3 + c] + 1, bs);
-            }
-            Encode("\n", 1, bs);
-        }
-        else {
-            if (input.getUvCount() == input.getPositionCount()) {
-                Encode("f ", 2, bs);
-                for (auto c = 0; c < 3; ++c) {
-                    if ( c > 0 ) Encode( " ", 1, bs );
-                    EncodeInt(input.triangles[i * 3 + c] + 1, bs);
-                    Encode("/", 1, bs);
-                    EncodeInt(input.triangles[i * 3 + c] + 1, bs);
-                }
-                Encode("\n", 1, bs);
-            }
-            else {
-                Encode("f ", 2, bs);
-                for (auto c = 0; c < 3; ++c) {
-                    if ( c > 0 ) Encode( " ", 1, bs );
-                    EncodeInt(input.triangles[i * 3 + c] + 1, bs);
-                }
-                Encode("\n", 1, bs);
-            }
-        }
-    }
-
-    auto resSize = fwrite(bs.data(), sizeof(char), bs.size(), fp);
-    fclose(fp);
+    *ptr++ = '\n';
+    return ptr;
+  } );
+
+  // material of the first triangle, then a usemtl line each time the material changes
+  const int  refTextId    = input.triangleMatIdx.size() == 0 ? -1 : input.triangleMatIdx[0];
+  const bool useMaterials = input.hasUvCoords() && refTextId != -1;
+  if ( input.hasUvCoords() ) {
+    if ( input.materialNames.size() > 0 && refTextId != -1 )
+      appendText( "usemtl " + input.materialNames[refTextId] + "\n", buffers );
+    else
+      appendText( "usemtl material0000\n", buffers );
+  }
+  size_t maxMaterialChars = 0;
+  if ( useMaterials )
+    for ( const auto& name : input.materialNames ) maxMaterialChars = ( std::max )( maxMaterialChars, name.size() + 8 );
+
+  // faces, with uv indices if any
+  const bool hasTrianglesUv = input.trianglesuv.size() == input.triangles.size();
+  const bool hasVertexUv    = !hasTrianglesUv && input.getUvCount() == input.getPositionCount();
+  encodeRanges( input.triangles.size() / 3,
+                maxMaterialChars + 3 + 3 * ( 2 * s_maxIntChars + 2 ),
+                buffers,
+                [&]( char* ptr, size_t i ) {
+                  if ( useMaterials && i > 0 && input.triangleMatIdx[i] != input.triangleMatIdx[i - 1] )
+                    ptr = encodeText( ptr, "usemtl " + input.materialNames[input.triangleMatIdx[i]] + "\n" );
+                  *ptr++ = 'f';
+                  for ( size_t c = 0; c < 3; ++c ) {
+                    *ptr++ = ' ';
+                    ptr    = encodeInt( ptr, input.triangles[i * 3 + c] + 1 );
+                    if ( hasTrianglesUv || hasVertexUv ) {
+                      *ptr++ = '/';
+                      ptr = encodeInt( ptr, ( hasTrianglesUv ? input.trianglesuv : input.triangles )[i * 3 + c] + 1 );
+                    }
+                  }
+                  *ptr++ = '\n';
+                  return ptr;
+                } );
 
-    return resSize > 0;
+  return writeBuffers( filename, buffers );
 }
 
 #else
@@ -966,7 +1250,9 @@ bool IO::_saveObj(std::string filename, const Model& input) {
     // this is mandatory to print floats with full precision
     fout.precision(std::numeric_limits<float>::max_digits10);
 
-    printf("_saveObj %-40s: V = %zu Vc = %zu N = %zu UV = %zu F = %zu Fuv = %zu \n",
+    // logged through std::cout so the line stays with the outputs of the command (see mm --concurrent)
+    char logBuffer[4096];
+    snprintf(logBuffer, sizeof(logBuffer), "_saveObj %-40s: V = %zu Vc = %zu N = %zu UV = %zu F = %zu Fuv = %zu \n",
         filename.c_str(),
         input.vertices.size() / 3,
         input.colors.size() / 3,
@@ -974,7 +1260,7 @@ bool IO::_saveObj(std::string filename, const Model& input) {
         input.uvcoords.size() / 2,
         input.triangles.size() / 3,
         input.trianglesuv.size() / 3);
-    fflush(stdout);
+    std::cout << logBuffer << std::flush;
 
     fout << input.header << std::endl;
     for (int i = 0; i < input.vertices.size() / 3; i++) {
@@ -1065,7 +1351,7 @@ void set( std::shared_ptr<tinyply::PlyData> src,
   }
 }
 
-bool IO::_loadPly( std::string filename, Model& output ) {
+bool IO::_loadPly( std::string filename, Model& output, uint32_t attributes ) {
   std::unique_ptr<std::istream> file_stream;
   file_stream.reset( new std::ifstream( filename.c_str(), std::ios::binary ) );
   tinyply::PlyFile file;
@@ -1075,41 +1361,54 @@ bool IO::_loadPly( std::string filename, Model& output ) {
 
   // The header information can be used to programmatically extract properties on elements
   // known to exist in the header prior to reading the data. For brevity of this sample, properties
-  // like vertex position are hard-coded:
-  try {
-    _vertices = file.request_properties_from_element( "vertex", { "x", "y", "z" } );
-  } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
-  try {
-    _normals = file.request_properties_from_element( "vertex", { "nx", "ny", "nz" } );
-  } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
-
-  try {
-    _colors = file.request_properties_from_element( "vertex", { "red", "green", "blue" } );
-  } catch ( const std::exception& ) {}
-  try {
-    _colors = file.request_properties_from_element( "vertex", { "r", "g", "b" } );
-  } catch ( const std::exception& ) {}
-  try {
-    _colorsRGBA = file.request_properties_from_element( "vertex", { "red", "green", "blue", "alpha" } );
-  } catch ( const std::exception& ) {}
-
-  try {
-    _colorsRGBA = file.request_properties_from_element( "vertex", { "r", "g", "b", "a" } );
-  } catch ( const std::exception& ) {}
-
-  try {
-    _texcoords = file.request_properties_from_element( "vertex", { "texture_u", "texture_v" } );
-  } catch ( const std::exception& ) {}
+  // like vertex position are hard-coded. Only the requested attributes are extracted, the
+  // other properties are skipped by the reader.
+  if ( attributes & POSITIONS ) {
+    try {
+      _vertices = file.request_properties_from_element( "vertex", { "x", "y", "z" } );
+    } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
+  }
+  if ( attributes & NORMALS ) {
+    try {
+      _normals = file.request_properties_from_element( "vertex", { "nx", "ny", "nz" } );
+    } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
+  }
+
+  if ( attributes & COLORS ) {
+    try {
+      _colors = file.request_properties_from_element( "vertex", { "red", "green", "blue" } );
+    } catch ( const std::exception& ) {}
+    try {
+      _colors = file.request_properties_from_element( "vertex", { "r", "g", "b" } );
+    } catch ( const std::exception& ) {}
+    try {
+      _colorsRGBA = file.request_properties_from_element( "vertex", { "red", "green", "blue", "alpha" } );
+    } catch ( const std::exception& ) {}
+
+    try {
+      _colorsRGBA = file.request_properties_from_element( "vertex", { "r", "g", "b", "a" } );
+    } catch ( const std::exception& ) {}
+  }
+
+  if ( attributes & UVCOORDS ) {
+    try {
+      _texcoords = file.request_properties_from_element( "vertex", { "texture_u", "texture_v" } );
+    } catch ( const std::exception& ) {}
+  }
 
   // Providing a list size hint (the last argument) is a 2x performance improvement. If you have
   // arbitrary ply files, it is best to leave this 0.
-  try {
-    _faces = file.request_properties_from_element( "face", { "vertex_indices" }, 3 );
-  } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
+  if ( attributes & FACES ) {
+    try {
+      _faces = file.request_properties_from_element( "face", { "vertex_indices" }, 3 );
+    } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
+  }
 
-  try {
-    _uvfaces = file.request_properties_from_element( "face", { "texcoord" }, 6 );
-  } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
+  if ( attributes & UVCOORDS ) {
+    try {
+      _uvfaces = file.request_properties_from_element( "face", { "texcoord" }, 6 );
+    } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
+  }
 
   // // Tristrips must always be read with a 0 list size hint (unless you know exactly how many elements
   // // are specifically in the file, which is unlikely);
@@ -1136,84 +1435,164 @@ bool IO::_loadPly( std::string filename, Model& output ) {
 }
 
 bool IO::_savePly( std::string filename, const Model& input ) {
-  std::ofstream fout;
-  // use a big 4MB buffer to accelerate writes
-  char* buf = new char[4 * 1024 * 1024 + 1];
-  fout.rdbuf()->pubsetbuf( buf, 4 * 1024 * 1024 + 1 );
-  fout.open( filename.c_str(), std::ios::out );
-  if ( !fout ) {
-    std::cerr << "Error: can't open file " << filename << std::endl;
-    delete[] buf;
-    return false;
-  }
-  // this is mandatory to print floats with full precision
-  fout.precision( std::numeric_limits<float>::max_digits10 );
-
-  fout << "ply" << std::endl;
-  fout << "format ascii 1.0" << std::endl;
-  fout << "comment Generated by mmetric model processor" << std::endl;
-  fout << "element vertex " << input.vertices.size() / 3 << std::endl;
-  fout << "property float x" << std::endl;
-  fout << "property float y" << std::endl;
-  fout << "property float z" << std::endl;
-  // normals
-  if ( input.normals.size() == input.vertices.size() ) {
-    fout << "property float nx" << std::endl;
-    fout << "property float ny" << std::endl;
-    fout << "property float nz" << std::endl;
-  }
-  // colors
-  if ( input.colors.size() == input.vertices.size() ) {
-    fout << "property uchar red" << std::endl;
-    fout << "property uchar green" << std::endl;
-    fout << "property uchar blue" << std::endl;
+  const bool hasNormals = input.normals.size() == input.vertices.size();
+  const bool hasColors  = input.colors.size() == input.vertices.size();
+
+  std::string header = "ply\nformat ascii 1.0\ncomment Generated by mmetric model processor\n";
+  header += "element vertex " + std::to_string( input.vertices.size() / 3 ) + "\n";
+  header += "property float x\nproperty float y\nproperty float z\n";
+  if ( hasNormals ) header += "property float nx\nproperty float ny\nproperty float nz\n";
+  if ( hasColors ) header += "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+  if ( !input.triangles.empty() ) {
+    header += "element face " + std::to_string( input.triangles.size() / 3 ) + "\n";
+    header += "property list uchar int vertex_indices\n";
   }
+  header += "end_header\n";
+  // comments
+  for ( const auto& comment : input.comments ) header += comment + "\n";
+
+  std::vector<std::vector<char>> buffers;
+  appendText( header, buffers );
+
+  // vertices, normals and colors
+  encodeRanges( input.vertices.size() / 3, 1 + 6 * ( s_maxFloatChars + 1 ) + 3 * ( s_maxIntChars + 1 ), buffers,
+                [&]( char* ptr, size_t i ) {
+                  for ( size_t c = 0; c < 3; ++c ) {
+                    ptr    = encodeFloat( ptr, input.vertices[i * 3 + c] );
+                    *ptr++ = ' ';
+                  }
+                  if ( hasNormals ) {
+                    for ( size_t c = 0; c < 3; ++c ) {
+                      ptr    = encodeFloat( ptr, input.normals[i * 3 + c] );
+                      *ptr++ = ' ';
+                    }
+                  }
+                  if ( hasColors ) {
+                    for ( size_t c = 0; c < 3; ++c ) {
+                      if ( c > 0 ) *ptr++ = ' ';
+                      // same values as the former unsigned short stream output
+                      ptr = encodeInt( ptr, (unsigned short)( std::roundf( input.colors[i * 3 + c] ) ) );
+                    }
+                  }
+                  *ptr++ = '\n';
+                  return ptr;
+                } );
+  // topology
+  encodeRanges( input.triangles.size() / 3, 2 + 3 * ( s_maxIntChars + 1 ), buffers, [&]( char* ptr, size_t i ) {
+    *ptr++ = '3';
+    for ( size_t c = 0; c < 3; ++c ) {
+      *ptr++ = ' ';
+      ptr    = encodeInt( ptr, input.triangles[i * 3 + c] );
+    }
+    *ptr++ = '\n';
+    return ptr;
+  } );
 
-  if ( !input.triangles.empty() ) {
-    fout << "element face " << input.triangles.size() / 3 << std::endl;
-    fout << "property list uchar int vertex_indices" << std::endl;
+  return writeBuffers( filename, buffers );
+}
+
+// width of the vertex count field of the streamed ply header, patched on close
+#define PLY_STREAM_COUNT_WIDTH 20
+
+bool PlyStreamWriter::open( const std::string& filename ) {
+  close();
+  _file = fopen( filename.c_str(), "wb" );
+  if ( !_file ) {
+    std::cerr << "Error: can't open file " << filename << std::endl;
+    return false;
   }
-  fout << "end_header" << std::endl;
+  _filename  = filename;
+  _hasHeader = false;
+  _count     = 0;
+  return true;
+}
 
-  // comments
-  for ( int i = 0; i < input.comments.size(); i++ ) { fout << input.comments[i] << std::endl; }
+bool PlyStreamWriter::writeHeader( void ) {
+  std::string header = "ply\nformat binary_little_endian 1.0\ncomment Generated by mmetric model processor\n";
+  header += "element vertex ";
+  if ( fwrite( header.data(), 1, header.size(), _file ) != header.size() ) return false;
+  _countPos = ftell( _file );
+  header    = std::string( PLY_STREAM_COUNT_WIDTH, ' ' ) + "\n";
+  header += "property float x\nproperty float y\nproperty float z\n";
+  if ( _hasNormals ) header += "property float nx\nproperty float ny\nproperty float nz\n";
+  if ( _hasColors ) header += "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+  header += "end_header\n";
+  if ( fwrite( header.data(), 1, header.size(), _file ) != header.size() ) return false;
+  _hasHeader = true;
+  return true;
+}
 
-  // vertices and colors
-  for ( int i = 0; i < input.vertices.size() / 3; i++ ) {
-    fout << input.vertices[i * 3 + 0] << " " << input.vertices[i * 3 + 1] << " " << input.vertices[i * 3 + 2] << " ";
-    if ( input.normals.size() == input.vertices.size() ) {
-      fout << input.normals[i * 3 + 0] << " " << input.normals[i * 3 + 1] << " " << input.normals[i * 3 + 2] << " ";
+bool PlyStreamWriter::write( const Model& points ) {
+  if ( !_file ) return false;
+  const size_t count = points.getPositionCount();
+  if ( count == 0 ) return true;
+  const bool hasNormals = points.normals.size() == points.vertices.size();
+  const bool hasColors  = points.colors.size() == points.vertices.size();
+  if ( !_hasHeader ) {
+    _hasNormals = hasNormals;
+    _hasColors  = hasColors;
+    if ( !writeHeader() ) {
+      std::cerr << "Error: can't write to file " << _filename << std::endl;
+      return false;
     }
-    if ( input.colors.size() == input.vertices.size() ) {
-      // do not cast as char otherwise characters are printed instead if int8 values
-      fout << (unsigned short)( std::roundf( input.colors[i * 3 + 0] ) ) << " "
-           << (unsigned short)( std::roundf( input.colors[i * 3 + 1] ) ) << " "
-           << (unsigned short)( std::roundf( input.colors[i * 3 + 2] ) );
+  }
+  // encode the chunk
+  const size_t stride = 3 * sizeof( float ) + ( _hasNormals ? 3 * sizeof( float ) : 0 ) + ( _hasColors ? 3 : 0 );
+  _buffer.resize( count * stride );
+  char* ptr = _buffer.data();
+  for ( size_t i = 0; i < count; ++i ) {
+    memcpy( ptr, &points.vertices[i * 3], 3 * sizeof( float ) );
+    ptr += 3 * sizeof( float );
+    if ( _hasNormals ) {
+      if ( hasNormals ) memcpy( ptr, &points.normals[i * 3], 3 * sizeof( float ) );
+      else memset( ptr, 0, 3 * sizeof( float ) );
+      ptr += 3 * sizeof( float );
+    }
+    if ( _hasColors ) {
+      for ( size_t c = 0; c < 3; ++c ) {
+        const float col = hasColors ? std::roundf( points.colors[i * 3 + c] ) : 0.0F;
+        *ptr++          = (char)(unsigned char)std::min( 255.0F, std::max( 0.0F, col ) );
+      }
     }
-    fout << std::endl;
   }
-  // topology
-  for ( int i = 0; i < input.triangles.size() / 3; i++ ) {
-    fout << "3 " << input.triangles[i * 3 + 0] << " " << input.triangles[i * 3 + 1] << " " << input.triangles[i * 3 + 2]
-         << std::endl;
+  if ( fwrite( _buffer.data(), 1, _buffer.size(), _file ) != _buffer.size() ) {
+    std::cerr << "Error: can't write to file " << _filename << std::endl;
+    return false;
   }
-
-  fout.close();
-  delete[] buf;
+  _count += count;
   return true;
 }
 
-bool IO::_loadImage( std::string filename, Image& output ) {
+bool PlyStreamWriter::close( void ) {
+  if ( !_file ) return true;
+  bool success = _hasHeader || writeHeader();
+  // patch the vertex count
+  if ( success ) {
+    std::string count = std::to_string( _count );
+    success           = fseek( _file, _countPos, SEEK_SET ) == 0
+              && fwrite( count.data(), 1, count.size(), _file ) == count.size();
+  }
+  if ( !success ) std::cerr << "Error: can't write to file " << _filename << std::endl;
+  fclose( _file );
+  _file = nullptr;
+  _buffer.clear();
+  _buffer.shrink_to_fit();
+  return success;
+}
+
+bool IO::_loadImage( std::string filename, Image& output, std::ostream& log ) {
+  ScopedTimer timer( "load " + filename, "io" );
   // Reading map if needed
   if ( filename != "" ) {
-    std::cout << "Input map: " << filename << std::endl;
+    log << "Input map: " << filename << std::endl;
     output.data = stbi_load( filename.c_str(), &output.width, &output.height, &output.nbc, 0 );
     if ( output.data == NULL ) {
-      std::cout << "Error: opening file " << filename << std::endl;
+      log << "Error: opening file " << filename << std::endl;
       return false;
     }
+    log << "Time on decoding: " << timer.elapsed() << " sec." << std::endl;
   } else {
-    std::cout << "Error: invalid empty filename" << std::endl;
+    log << "Error: invalid empty filename" << std::endl;
     return false;
   }
 
@@ -1222,6 +1601,7 @@ bool IO::_loadImage( std::string filename, Image& output ) {
 }
 
 bool IO::_saveImage( std::string filename, const Image& input, bool flipVertically ) {
+  MM_TRACE_SCOPE( "save " + filename, "io" );
   // Writing map if needed
   if ( filename != "" ) {
     std::cout << "Output map: " << filename << std::endl;
@@ -1269,6 +1649,7 @@ bool IO::_saveImage( std::string filename, const Image& input, bool flipVertical
 }
 
 bool IO::_loadImageFromVideo( std::string filename, Image& output ) {
+  MM_TRACE_SCOPE( "load " + filename, "io" );
   // Reading map if needed
   if ( filename != "" ) {
     // parsing filename to extract metadata
@@ -0,0 +1,100 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <thread>
+#ifdef _WIN32
+#  include <process.h>
+#else
+#  include <unistd.h>
+#endif
+
+// internal headers
+#include "mmMemo.h"
+#include "mmHash.h"
+#include "mmCheckpoint.h"
+
+using namespace mm;
+
+std::string Memo::getFilename( uint64_t key ) const {
+  return ( std::filesystem::path( _directory ) / ( Hash::toHex( key ) + ".txt" ) ).string();
+}
+
+bool Memo::get( uint64_t key, const std::string& mode, std::vector<double>& values ) const {
+  const std::string filename = getFilename( key );
+  if ( !Checkpoint::exists( filename ) ) return false;
+  std::string         entryMode;
+  Checkpoint::Records records;
+  if ( !Checkpoint::load( filename, entryMode, records ) || entryMode != mode || records.size() != 1 ) {
+    std::cout << "Warning: ignoring invalid memo entry " << filename << std::endl;
+    return false;
+  }
+  values = records.begin()->second;
+  return true;
+}
+
+bool Memo::put( uint64_t key, const std::string& mode, const std::vector<double>& values ) const {
+  std::error_code error;
+  std::filesystem::create_directories( _directory, error );
+  if ( error ) {
+    std::cerr << "Error: could not create memo directory " << _directory << ", " << error.message() << std::endl;
+    return false;
+  }
+  // unique temporary name among the processes sharing the directory, the rename is atomic on
+  // a same file system
+#ifdef _WIN32
+  const long processId = (long)_getpid();
+#else
+  const long processId = (long)getpid();
+#endif
+  const std::string filename = getFilename( key );
+  const uint64_t    unique   = Hash::combine( std::hash<std::thread::id>()( std::this_thread::get_id() ),
+                                         std::chrono::steady_clock::now().time_since_epoch().count() );
+  const std::string tmpFilename =
+    filename + "." + std::to_string( processId ) + "." + Hash::toHex( unique ) + ".tmp";
+  Checkpoint::Records records;
+  records[0] = values;
+  if ( !Checkpoint::save( tmpFilename, mode, records ) ) return false;
+  std::filesystem::rename( tmpFilename, filename, error );
+  if ( error ) {
+    std::filesystem::remove( tmpFilename, error );
+    std::cerr << "Error: could not write memo entry " << filename << std::endl;
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,343 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <sstream>
+
+#if defined( _WIN32 )
+#  include <windows.h>
+#  include <psapi.h>
+#  pragma comment( lib, "psapi.lib" )
+#elif defined( __APPLE__ )
+#  include <mach/mach.h>
+#  include <sys/resource.h>
+#else
+#  include <sys/resource.h>
+#  include <unistd.h>
+#endif
+
+// internal headers
+#include "mmMemory.h"
+
+using namespace mm;
+
+bool                       Memory::_enabled = false;
+std::thread::id            Memory::_owner;
+std::mutex                 Memory::_mutex;
+std::vector<Memory::Stage> Memory::_stages;
+std::vector<Memory::Stage> Memory::_running;
+size_t                     Memory::_order         = 0;
+size_t                     Memory::_rssPeak       = 0;
+size_t                     Memory::_frameRssPeak  = 0;
+size_t                     Memory::_frameHeapPeak = 0;
+
+///////////////////////////
+// Counting allocator
+
+#ifdef MM_COUNT_ALLOCATIONS
+
+static std::atomic<size_t> s_heapBytes( 0 );
+static std::atomic<size_t> s_heapAllocations( 0 );
+static std::atomic<size_t> s_heapHighWater( 0 );
+
+// the block size is stored in front of each block
+static const size_t s_header = alignof( std::max_align_t );
+
+static void* countedAlloc( size_t size ) {
+  char* block = (char*)std::malloc( size + s_header );
+  if ( block == NULL ) return NULL;
+  *(size_t*)block = size;
+  s_heapAllocations++;
+  const size_t live = s_heapBytes.fetch_add( size ) + size;
+  size_t       high = s_heapHighWater.load();
+  while ( live > high && !s_heapHighWater.compare_exchange_weak( high, live ) ) {}
+  return block + s_header;
+}
+
+static void countedFree( void* ptr ) {
+  if ( ptr == NULL ) return;
+  char* block = (char*)ptr - s_header;
+  s_heapBytes.fetch_sub( *(size_t*)block );
+  std::free( block );
+}
+
+void* operator new( size_t size ) {
+  void* ptr = countedAlloc( size );
+  if ( ptr == NULL ) throw std::bad_alloc();
+  return ptr;
+}
+void* operator new[]( size_t size ) {
+  void* ptr = countedAlloc( size );
+  if ( ptr == NULL ) throw std::bad_alloc();
+  return ptr;
+}
+void* operator new( size_t size, const std::nothrow_t& ) noexcept { return countedAlloc( size ); }
+void* operator new[]( size_t size, const std::nothrow_t& ) noexcept { return countedAlloc( size ); }
+void  operator delete( void* ptr ) noexcept { countedFree( ptr ); }
+void  operator delete[]( void* ptr ) noexcept { countedFree( ptr ); }
+void  operator delete( void* ptr, size_t ) noexcept { countedFree( ptr ); }
+void  operator delete[]( void* ptr, size_t ) noexcept { countedFree( ptr ); }
+void  operator delete( void* ptr, const std::nothrow_t& ) noexcept { countedFree( ptr ); }
+void  operator delete[]( void* ptr, const std::nothrow_t& ) noexcept { countedFree( ptr ); }
+
+bool   Memory::isCountingAllocations( void ) { return true; }
+size_t Memory::getHeapBytes( void ) { return s_heapBytes.load(); }
+size_t Memory::getHeapAllocations( void ) { return s_heapAllocations.load(); }
+
+// returns the live bytes high-water mark and restarts it from the current live bytes
+static size_t resetHeapHighWater( void ) { return s_heapHighWater.exchange( s_heapBytes.load() ); }
+
+#else
+
+bool          Memory::isCountingAllocations( void ) { return false; }
+size_t        Memory::getHeapBytes( void ) { return 0; }
+size_t        Memory::getHeapAllocations( void ) { return 0; }
+static size_t resetHeapHighWater( void ) { return 0; }
+
+#endif
+
+///////////////////////////
+// Process memory
+
+size_t Memory::getCurrentRss( void ) {
+#if defined( _WIN32 )
+  PROCESS_MEMORY_COUNTERS counters;
+  if ( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) ) return 0;
+  return (size_t)counters.WorkingSetSize;
+#elif defined( __APPLE__ )
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+  if ( task_info( mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count ) != KERN_SUCCESS ) return 0;
+  return (size_t)info.resident_size;
+#else
+  FILE* file = std::fopen( "/proc/self/statm", "r" );
+  if ( file == NULL ) return 0;
+  unsigned long size = 0, resident = 0;
+  const int     read = std::fscanf( file, "%lu %lu", &size, &resident );
+  std::fclose( file );
+  if ( read != 2 ) return 0;
+  return (size_t)resident * (size_t)sysconf( _SC_PAGESIZE );
+#endif
+}
+
+size_t Memory::getPeakRss( void ) {
+#if defined( _WIN32 )
+  PROCESS_MEMORY_COUNTERS counters;
+  if ( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) ) return 0;
+  return (size_t)counters.PeakWorkingSetSize;
+#else
+  struct rusage usage;
+  if ( getrusage( RUSAGE_SELF, &usage ) != 0 ) return 0;
+#  if defined( __APPLE__ )
+  return (size_t)usage.ru_maxrss;  // bytes
+#  else
+  return (size_t)usage.ru_maxrss * 1024;  // kilobytes
+#  endif
+#endif
+}
+
+///////////////////////////
+// Stages
+
+// background RSS sampling, stopped at exit
+static struct Sampler {
+  std::thread             thread;
+  std::mutex              mutex;
+  std::condition_variable cond;
+  bool                    stop = false;
+  ~Sampler() {
+    if ( !thread.joinable() ) return;
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      stop = true;
+    }
+    cond.notify_all();
+    thread.join();
+  }
+} s_sampler;
+
+void Memory::enable( unsigned int period ) {
+  std::lock_guard<std::mutex> lock( _mutex );
+  if ( _enabled ) return;
+  _enabled = true;
+  _owner   = std::this_thread::get_id();
+  _rssPeak = getCurrentRss();
+  s_sampler.thread = std::thread( [period] {
+    std::unique_lock<std::mutex> lock( s_sampler.mutex );
+    while ( !s_sampler.cond.wait_for( lock, std::chrono::milliseconds( period ), [] { return s_sampler.stop; } ) ) {
+      Memory::sample();
+    }
+  } );
+}
+
+void Memory::sample( void ) {
+  const size_t                rss = getCurrentRss();
+  std::lock_guard<std::mutex> lock( _mutex );
+  _rssPeak = ( std::max )( _rssPeak, rss );
+}
+
+void Memory::beginStage( const std::string& name ) {
+  if ( !_enabled || std::this_thread::get_id() != _owner ) return;
+  const size_t                rss = getCurrentRss();
+  std::lock_guard<std::mutex> lock( _mutex );
+  // the peaks reached so far belong to the parent stage
+  const size_t heapPeak = resetHeapHighWater();
+  if ( !_running.empty() ) {
+    Stage& parent   = _running.back();
+    parent.rssPeak  = ( std::max )( { parent.rssPeak, _rssPeak, rss } );
+    parent.heapPeak = ( std::max )( parent.heapPeak, heapPeak );
+  }
+  _frameRssPeak  = ( std::max )( { _frameRssPeak, _rssPeak, rss } );
+  _frameHeapPeak = ( std::max )( _frameHeapPeak, heapPeak );
+  _rssPeak       = rss;
+  Stage stage;
+  stage.name     = name;
+  stage.order    = _order++;
+  stage.depth    = _running.size();
+  stage.rssBegin = rss;
+  stage.rssEnd   = rss;
+  stage.rssPeak  = rss;
+  stage.heapPeak = getHeapBytes();
+  _running.push_back( stage );
+}
+
+void Memory::endStage( void ) {
+  if ( !_enabled || std::this_thread::get_id() != _owner ) return;
+  const size_t                rss = getCurrentRss();
+  std::lock_guard<std::mutex> lock( _mutex );
+  if ( _running.empty() ) return;
+  Stage stage = _running.back();
+  _running.pop_back();
+  stage.rssEnd   = rss;
+  stage.rssPeak  = ( std::max )( { stage.rssPeak, _rssPeak, rss } );
+  stage.heapPeak = ( std::max )( stage.heapPeak, resetHeapHighWater() );
+  _rssPeak       = rss;
+  // the parent peaks include the child ones
+  if ( !_running.empty() ) {
+    _running.back().rssPeak  = ( std::max )( _running.back().rssPeak, stage.rssPeak );
+    _running.back().heapPeak = ( std::max )( _running.back().heapPeak, stage.heapPeak );
+  }
+  _frameRssPeak  = ( std::max )( _frameRssPeak, stage.rssPeak );
+  _frameHeapPeak = ( std::max )( _frameHeapPeak, stage.heapPeak );
+  _stages.push_back( stage );
+}
+
+size_t Memory::getFrameRssPeak( void ) {
+  const size_t                rss = getCurrentRss();
+  std::lock_guard<std::mutex> lock( _mutex );
+  return ( std::max )( { _frameRssPeak, _rssPeak, rss } );
+}
+
+size_t Memory::getFrameHeapPeak( void ) {
+  std::lock_guard<std::mutex> lock( _mutex );
+  size_t peak = _frameHeapPeak;
+#ifdef MM_COUNT_ALLOCATIONS
+  peak = ( std::max )( peak, s_heapHighWater.load() );
+#endif
+  return peak;
+}
+
+std::string Memory::getFramePeakStage( void ) {
+  std::lock_guard<std::mutex> lock( _mutex );
+  const Stage* peak = NULL;
+  for ( const Stage& stage : _stages ) {
+    // the deepest stage reaching the peak is the one responsible for it
+    if ( peak == NULL || stage.rssPeak > peak->rssPeak || ( stage.rssPeak == peak->rssPeak && stage.depth > peak->depth ) )
+      peak = &stage;
+  }
+  return peak != NULL ? peak->name : "";
+}
+
+// bytes to mega bytes with one decimal
+static std::string toMB( size_t bytes ) {
+  std::ostringstream str;
+  str << std::fixed << std::setprecision( 1 ) << (double)bytes / ( 1024.0 * 1024.0 );
+  return str.str();
+}
+
+void Memory::printFrame( std::ostream& out, uint32_t frame, size_t modelBytes, size_t imageBytes ) {
+  std::vector<Stage> stages;
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    stages = _stages;
+  }
+  std::sort( stages.begin(), stages.end(), []( const Stage& a, const Stage& b ) { return a.order < b.order; } );
+  size_t minDepth = stages.empty() ? 0 : stages[0].depth;
+  for ( const Stage& stage : stages ) minDepth = ( std::min )( minDepth, stage.depth );
+
+  const bool heap = isCountingAllocations();
+  out << "Memory usage of frame " << frame << " (MB):" << std::endl;
+  out << "  " << std::left << std::setw( 48 ) << "stage" << std::right << std::setw( 10 ) << "rss begin"
+      << std::setw( 10 ) << "rss end" << std::setw( 10 ) << "rss peak";
+  if ( heap ) out << std::setw( 11 ) << "heap peak";
+  out << std::endl;
+  for ( const Stage& stage : stages ) {
+    std::string name = std::string( 2 * ( stage.depth - minDepth ), ' ' ) + stage.name;
+    if ( name.size() > 47 ) name = name.substr( 0, 44 ) + "...";
+    out << "  " << std::left << std::setw( 48 ) << name << std::right << std::setw( 10 ) << toMB( stage.rssBegin )
+        << std::setw( 10 ) << toMB( stage.rssEnd ) << std::setw( 10 ) << toMB( stage.rssPeak );
+    if ( heap ) out << std::setw( 11 ) << toMB( stage.heapPeak );
+    out << std::endl;
+  }
+  out << "  models: " << toMB( modelBytes ) << ", images: " << toMB( imageBytes )
+      << ", process peak: " << toMB( getPeakRss() ) << std::endl;
+}
+
+void Memory::resetFrame( void ) {
+  std::lock_guard<std::mutex> lock( _mutex );
+  _stages.clear();
+  _frameRssPeak  = 0;
+  _frameHeapPeak = 0;
+}
+
+std::string Memory::getCsvHeader( void ) {
+  if ( !_enabled ) return "";
+  return ";mem_rssPeak;mem_heapPeak;mem_models;mem_images;mem_peakStage";
+}
+
+std::string Memory::getCsvValues( size_t modelBytes, size_t imageBytes ) {
+  if ( !_enabled ) return "";
+  std::ostringstream str;
+  str << ";" << getFrameRssPeak() << ";" << getFrameHeapPeak() << ";" << modelBytes << ";" << imageBytes << ";"
+      << getFramePeakStage();
+  return str.str();
+}
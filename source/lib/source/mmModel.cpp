@@ -47,6 +47,7 @@
 #include <glm/gtx/string_cast.hpp>
 // internal
 #include "mmModel.h"
+#include "mmTrace.h"
 
 using namespace mm;
 
@@ -170,7 +171,7 @@ void Model::computeNeighborTriangles( bool useIndices, bool skipNonManifold ) {
   std::cout << "-> Model::computeNeighborTriangles useIndices=" << ( useIndices ? "true" : "false" )
             << ", skipNonManifold = " << ( skipNonManifold ? "true" : "false" ) << std::endl;
 
-  clock_t t1 = clock();
+  ScopedTimer timer( "neighbor triangles", "model" );
 
   // clear map information on neigborhood
   perVertexTriangles.clear();
@@ -437,8 +438,8 @@ void Model::computeNeighborTriangles( bool useIndices, bool skipNonManifold ) {
   }
           */
 
-  clock_t t2 = clock();
-  std::cout << "<- Model::computeNeighborTriangles, time=" << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec."
+  timer.stop();
+  std::cout << "<- Model::computeNeighborTriangles, time=" << timer.elapsed() << " sec."
             << std::endl;
 }
 
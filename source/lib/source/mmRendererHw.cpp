@@ -54,6 +54,8 @@
 #include "mmImage.h"
 #include "mmGeometry.h"
 #include "mmRendererHw.h"
+#include "mmTrace.h"
+#include "mmAsyncWriter.h"
 
 using namespace mm;
 
@@ -138,7 +140,7 @@ void GLAPIENTRY MessageCallback( GLenum        source,
 
 // open the output render context and associated hidden window
 bool RendererHw::initialize( const unsigned int width, const unsigned int height ) {
-  clock_t t1 = clock();
+  ScopedTimer timer( "gl setup", "render" );
 
   _width  = width;
   _height = height;
@@ -211,7 +213,7 @@ bool RendererHw::initialize( const unsigned int width, const unsigned int height
     return false;
   }
 
-  std::cout << "Time on GL setup: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+  std::cout << "Time on GL setup: " << timer.elapsed() << " sec." << std::endl;
 
   return true;
 }
@@ -260,22 +262,21 @@ bool RendererHw::render(
 #endif
   GLint mvp_location, vpos_location, vcol_location, col_location, vtex_location, texture_location;
 
-  clock_t t1 = clock();
+  ScopedTimer timer( "reindex", "render" );
 
   // test if we render cpv and maps
   if ( model->trianglesuv.size() != 0 ) {
     if ( verbose ) std::cout << "Reindexing the model" << std::endl;
-    t1       = clock();
     ModelPtr tmpModel( new Model() );
     reindex( *model, *tmpModel );
     rndModel = tmpModel;
     if ( verbose )
-      std::cout << "Time on reindexing: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+      std::cout << "Time on reindexing: " << timer.elapsed() << " sec." << std::endl;
   }
   bool useCpv = rndModel->colors.size() == rndModel->vertices.size() && !isValid(map);
   bool useMap = rndModel->uvcoords.size() != 0 && isValid(map);
 
-  t1 = clock();
+  timer.restart( "shader compilation" );
 
   // NOTE: OpenGL error checks have been omitted for brevity
   if ( verbose ) std::cout << "Create shader " << std::endl;
@@ -347,8 +348,8 @@ bool RendererHw::render(
   }
 
   if ( verbose )
-    std::cout << "Time on shader compilation: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
-  t1 = clock();
+    std::cout << "Time on shader compilation: " << timer.elapsed() << " sec." << std::endl;
+  timer.restart( "model upload" );
   if ( verbose ) std::cout << "Upload model to GPU" << std::endl;
 
   glGenVertexArrays( 1, &VAO );
@@ -397,14 +398,13 @@ bool RendererHw::render(
   glBindVertexArray( 0 );                     // disable VAO
 
   if ( verbose )
-    std::cout << "Time on model upload to GPU: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec."
+    std::cout << "Time on model upload to GPU: " << timer.elapsed() << " sec."
               << std::endl;
-  t1 = clock();
+  timer.restart( "texture upload" );
 
   // Handle texture map
   unsigned int texture;
   if ( useMap ) {
-    t1 = clock();
     if ( verbose ) std::cout << "Upload texture to GPU" << std::endl;
     glGenTextures( 1, &texture );
     glBindTexture( GL_TEXTURE_2D, texture );
@@ -425,7 +425,7 @@ bool RendererHw::render(
     glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB, map->width, map->height, 0, inputFormat, GL_UNSIGNED_BYTE, map->data );
     // glGenerateMipmap(GL_TEXTURE_2D); // not sure if we shall use the mipmaps
     if ( verbose )
-      std::cout << "Time on texture upload to GPU: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec."
+      std::cout << "Time on texture upload to GPU: " << timer.elapsed() << " sec."
                 << std::endl;
   } else {
     glBindTexture( GL_TEXTURE_2D, 0 );
@@ -433,7 +433,7 @@ bool RendererHw::render(
 
   // Init finished now we render
   if ( verbose ) std::cout << "Start rendering" << std::endl;
-  t1 = clock();
+  timer.restart( "render" );
 
   // glfwGetFramebufferSize(window, &_width, &_height);
   float ratio = (float)width / (float)height;
@@ -500,8 +500,8 @@ bool RendererHw::render(
 
   // Now we readback
   if ( verbose )
-    std::cout << "Time on render: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
-  t1 = clock();
+    std::cout << "Time on render: " << timer.elapsed() << " sec." << std::endl;
+  timer.restart( "readback" );
 
   // frame buffer readback if needed
   if ( fbuffer.size() != 0 ) {
@@ -518,7 +518,7 @@ bool RendererHw::render(
   }
 
   if ( verbose )
-    std::cout << "Time on readback: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+    std::cout << "Time on readback: " << timer.elapsed() << " sec." << std::endl;
   
   return true;
 }
@@ -545,21 +545,29 @@ bool RendererHw::render(
   // render the model into memory buffers
   render( model, mapSet, fbuffer, zbuffer, width, height, viewDir, viewUp, bboxMin, bboxMax, useBBox, verbose );
 
-  clock_t t1 = clock();
+  ScopedTimer timer( "save render", "render" );
 
+  // the buffers are moved to the writer jobs (see AsyncWriter)
+  bool res = true;
   if ( outputImage != "" ) {
-    // Write image Y-flipped because OpenGL
-    stbi_write_png(
-      outputImage.c_str(), width, height, 4, fbuffer.data() + ( width * 4 * ( height - 1 ) ), -(int)width * 4 );
+    auto image = std::make_shared<std::vector<uint8_t>>( std::move( fbuffer ) );
+    res        = AsyncWriter::submit( outputImage, [=]() {
+      // Write image Y-flipped because OpenGL
+      const uint8_t* data = image->data() + ( width * 4 * ( height - 1 ) );
+      return stbi_write_png( outputImage.c_str(), width, height, 4, data, -(int)width * 4 ) != 0;
+    } );
   }
 
   if ( outputDepth != "" ) {
-    // Write depth splitted on RGBA
-    stbi_write_png(
-      outputDepth.c_str(), width, height, 4, (char*)zbuffer.data() + ( width * 4 * ( height - 1 ) ), -(int)width * 4 );
+    auto depth = std::make_shared<std::vector<float>>( std::move( zbuffer ) );
+    res        = AsyncWriter::submit( outputDepth, [=]() {
+      // Write depth splitted on RGBA
+      const char* data = (const char*)depth->data() + ( width * 4 * ( height - 1 ) );
+      return stbi_write_png( outputDepth.c_str(), width, height, 4, data, -(int)width * 4 ) != 0;
+    } ) && res;
   }
   if ( verbose )
-    std::cout << "Time on saving: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+    std::cout << "Time on saving: " << timer.elapsed() << " sec." << std::endl;
 
-  return true;
+  return res;
 }
@@ -50,6 +50,8 @@
 #include "mmImage.h"
 #include "mmGeometry.h"
 #include "mmRendererSw.h"
+#include "mmTrace.h"
+#include "mmAsyncWriter.h"
 
 using namespace mm;
 
@@ -311,7 +313,7 @@ bool RendererSw::render(
     bool                  useBBox,
     bool                  verbose)
 {
-  clock_t t1 = clock();
+  ScopedTimer timer( "render", "render" );
 
   glm::vec3 viewDirUnit = glm::normalize( viewDir );
   glm::vec3 viewUpUnit  = glm::normalize( viewUp );
@@ -376,9 +378,9 @@ bool RendererSw::render(
       if ( verbose ) std::cout << "Processing normals with \"noseams\" enabled..." << std::endl;
       model->computeVertexNormals( true, true );
       if ( verbose )
-        std::cout << "Time on processing normals: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec."
+        std::cout << "Time on processing normals: " << timer.elapsed() << " sec."
                   << std::endl;
-      t1 = clock();
+      timer.restart( "render" );
     } else {
       if ( verbose ) std::cout << "Using pre-defined model normals." << std::endl;
     }
@@ -387,9 +389,9 @@ bool RendererSw::render(
       if ( verbose ) std::cout << "Processing triangle normals " << std::endl;
       model->computeFaceNormals( true );
       if ( verbose )
-        std::cout << "Time on processing normals: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec."
+        std::cout << "Time on processing normals: " << timer.elapsed() << " sec."
                   << std::endl;
-      t1 = clock();
+      timer.restart( "render" );
     }
   }
 
@@ -449,7 +451,7 @@ bool RendererSw::render(
   }
 
   if ( verbose )
-    std::cout << "Time on render: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+    std::cout << "Time on render: " << timer.elapsed() << " sec." << std::endl;
 
   return true;
 }
@@ -476,22 +478,30 @@ bool RendererSw::render(
   // render the model into memory buffers
   render( model, mapSet, fbuffer, zbuffer, width, height, viewDir, viewUp, bboxMin, bboxMax, useBBox, verbose );
 
-  clock_t t1 = clock();
+  ScopedTimer timer( "save render", "render" );
 
+  // the buffers are moved to the writer jobs (see AsyncWriter)
+  bool res = true;
   if ( outputImage != "" ) {
-    // Write image Y-flipped because OpenGL
-    stbi_write_png(
-      outputImage.c_str(), width, height, 4, fbuffer.data() + ( width * 4 * ( height - 1 ) ), -(int)width * 4 );
+    auto image = std::make_shared<std::vector<uint8_t>>( std::move( fbuffer ) );
+    res        = AsyncWriter::submit( outputImage, [=]() {
+      // Write image Y-flipped because OpenGL
+      const uint8_t* data = image->data() + ( width * 4 * ( height - 1 ) );
+      return stbi_write_png( outputImage.c_str(), width, height, 4, data, -(int)width * 4 ) != 0;
+    } );
   }
 
   if ( outputDepth != "" ) {
-    // Write depth splitted on RGBA
-    stbi_write_png(
-      outputDepth.c_str(), width, height, 4, (char*)zbuffer.data() + ( width * 4 * ( height - 1 ) ), -(int)width * 4 );
+    auto depth = std::make_shared<std::vector<float>>( std::move( zbuffer ) );
+    res        = AsyncWriter::submit( outputDepth, [=]() {
+      // Write depth splitted on RGBA
+      const char* data = (const char*)depth->data() + ( width * 4 * ( height - 1 ) );
+      return stbi_write_png( outputDepth.c_str(), width, height, 4, data, -(int)width * 4 ) != 0;
+    } ) && res;
   }
 
   if ( verbose )
-    std::cout << "Time on saving: " << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
+    std::cout << "Time on saving: " << timer.elapsed() << " sec." << std::endl;
 
-  return true;
+  return res;
 }
\ No newline at end of file
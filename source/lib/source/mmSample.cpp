@@ -37,6 +37,9 @@
 #include <iostream>
 #include <fstream>
 #include <set>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 #include <time.h>
 #include <math.h>
 // mathematics
@@ -52,9 +55,113 @@
 #include "mmSample.h"
 #include "mmModel.h"
 #include "mmImage.h"
+#include "mmThreadPool.h"
+#include "mmTrace.h"
 
 using namespace mm;
 
+// records the origin of the points appended to output since the previous call,
+// all these points are attributed to the triangle triIdx (v1,v2,v3)
+static void recordTemplate( SampleTemplate*  sampleTemplate,
+                            const Model&     output,
+                            size_t           triIdx,
+                            const glm::vec3& v1,
+                            const glm::vec3& v2,
+                            const glm::vec3& v3 )
+{
+  if ( sampleTemplate == nullptr || sampleTemplate->size() == output.getPositionCount() ) return;
+
+  // project the points on the triangle plane and solve for the barycentrics in double precision
+  const glm::dvec3 e0    = glm::dvec3( v2 ) - glm::dvec3( v1 );
+  const glm::dvec3 e1    = glm::dvec3( v3 ) - glm::dvec3( v1 );
+  const glm::dvec3 n     = glm::normalize( glm::cross( e0, e1 ) );
+  const double     d00   = glm::dot( e0, e0 );
+  const double     d01   = glm::dot( e0, e1 );
+  const double     d11   = glm::dot( e1, e1 );
+  const double     denom = d00 * d11 - d01 * d01;
+
+  for ( size_t i = sampleTemplate->size(); i < output.getPositionCount(); ++i ) {
+    const glm::dvec3 d( (double)output.vertices[i * 3 + 0] - v1.x,
+                        (double)output.vertices[i * 3 + 1] - v1.y,
+                        (double)output.vertices[i * 3 + 2] - v1.z );
+    const double     h   = glm::dot( d, n );
+    const glm::dvec3 q   = d - h * n;
+    const double     d20 = glm::dot( q, e0 );
+    const double     d21 = glm::dot( q, e1 );
+    sampleTemplate->triIdx.push_back( (uint32_t)triIdx );
+    sampleTemplate->coords.push_back( (float)( ( d11 * d20 - d01 * d21 ) / denom ) );
+    sampleTemplate->coords.push_back( (float)( ( d00 * d21 - d01 * d20 ) / denom ) );
+    sampleTemplate->coords.push_back( (float)h );
+  }
+}
+
+// stores the connectivity checksum and the output attributes layout
+static void closeTemplate( SampleTemplate* sampleTemplate, const Model& input, const Model& output )
+{
+  if ( sampleTemplate == nullptr ) return;
+  sampleTemplate->checksum  = Sample::connectivityChecksum( input );
+  sampleTemplate->hasNormal = output.normals.size() != 0 && output.normals.size() == output.vertices.size();
+  sampleTemplate->hasColor  = output.colors.size() != 0 && output.colors.size() == output.vertices.size();
+}
+
+// search of the sampling parameter for the nbSamplesMin/nbSamplesMax calibration overloads
+// estimate(value) returns a fast approximation of the point count produced with the parameter value,
+// sample(value) runs the sampler and returns the real point count. The parameter is searched using the
+// estimator only and the sampler is then run once. If the real count falls out of [nbSamplesMin,nbSamplesMax]
+// the estimator is rescaled by the observed ratio and the search is performed again, up to maxIterations times.
+template <typename T, typename Estimate, typename Sampler>
+static T searchParameter( size_t   nbSamplesMin,
+                          size_t   nbSamplesMax,
+                          size_t   maxIterations,
+                          T        value,
+                          T        minValue,
+                          bool     increasing,
+                          Estimate estimate,
+                          Sampler  sample )
+{
+  const double   target = 0.5 * ( (double)nbSamplesMin + (double)nbSamplesMax );
+  double         scale  = 1.0;  // ratio of real versus estimated point count
+  size_t         iter   = 0;
+  std::vector<T> tested;  // parameters already used to run the sampler
+  const auto     below = [&]( T v ) { return scale * estimate( v ) < target; };
+  const auto     fewer = [&]( T v ) { return increasing ? std::max( minValue, (T)( v / 2 ) ) : (T)( v * 2 ); };
+  const auto     more  = [&]( T v ) { return increasing ? (T)( v * 2 ) : std::max( minValue, (T)( v / 2 ) ); };
+
+  while ( true ) {
+    // bracket the target, lo generates less points than target and hi more points
+    T lo = value, hi = value;
+    for ( int i = 0; i < 64 && !below( lo ); ++i ) lo = fewer( lo );
+    for ( int i = 0; i < 64 && below( hi ); ++i ) hi = more( hi );
+    // then bisect using the estimator only
+    for ( int i = 0; i < 64; ++i ) {
+      const T mid = std::is_integral<T>::value ? (T)( ( (double)lo + (double)hi ) / 2 ) : (T)( ( lo + hi ) / 2 );
+      if ( mid == lo || mid == hi ) break;
+      if ( below( mid ) ) lo = mid;
+      else hi = mid;
+    }
+    const T next = std::abs( scale * estimate( lo ) - target ) <= std::abs( scale * estimate( hi ) - target ) ? lo : hi;
+    // parameter already tested (no value fits the range), output of previous run is kept
+    if ( std::find( tested.begin(), tested.end(), next ) != tested.end() ) break;
+    tested.push_back( next );
+    value = next;
+
+    // run the sampler
+    const size_t count = sample( value );
+    std::cout << "  value=" << value << std::endl;
+    std::cout << "  estimated=" << (size_t)( scale * estimate( value ) ) << std::endl;
+    std::cout << "  posCount=" << count << std::endl;
+    if ( ( count >= nbSamplesMin && count <= nbSamplesMax ) || iter >= maxIterations ) break;
+    iter++;
+
+    // rescale the estimator
+    const double estimated = estimate( value );
+    if ( estimated <= 0.0 ) break;
+    scale = (double)count / estimated;
+  }
+  std::cout << "algorithm ended after " << iter << " iterations " << std::endl;
+  return value;
+}
+
 // this algorithm was originally developped by Owlii
 void Sample::meshToPcFace(
     const Model& input,
@@ -63,22 +170,41 @@ void Sample::meshToPcFace(
     size_t       resolution,
     float        thickness,
     bool         bilinear,
-    bool         logProgress)
+    bool         logProgress,
+    SampleTemplate* sampleTemplate)
 {
   // computes the bounding box of the vertices
   glm::vec3 minPos, maxPos;
   Geometry::computeBBox( input.vertices, minPos, maxPos );
   std::cout << "minbox = " << minPos[0] << "," << minPos[1] << "," << minPos[2] << std::endl;
   std::cout << "maxbox = " << maxPos[0] << "," << maxPos[1] << "," << maxPos[2] << std::endl;
+  const glm::vec3 diag = maxPos - minPos;
+  std::cout << "step = " << std::max( diag.x, std::max( diag.y, diag.z ) ) / resolution << std::endl;
 
+  meshToPcFace( input, output, textures, resolution, thickness, bilinear, logProgress, minPos, maxPos, sampleTemplate );
+}
+
+void Sample::meshToPcFace(
+    const Model& input,
+    Model& output,
+    const std::vector<mm::ImagePtr>& textures,
+    size_t       resolution,
+    float        thickness,
+    bool         bilinear,
+    bool         logProgress,
+    const glm::vec3& minPos,
+    const glm::vec3& maxPos,
+    SampleTemplate* sampleTemplate)
+{
+  MM_TRACE_SCOPE( "sample face", "sample" );
   // computes the sampling step
   glm::vec3 diag       = maxPos - minPos;
   float     boxMaxSize = std::max( diag.x, std::max( diag.y, diag.z ) );
   float     step       = boxMaxSize / resolution;
-  std::cout << "step = " << step << std::endl;
 
   // to prevent storing duplicate points, we use a ModelBuilder
   ModelBuilder builder( output );
+  if ( sampleTemplate ) sampleTemplate->reset();
 
   size_t skipped = 0;  // number of degenerate triangles
 
@@ -148,7 +274,9 @@ void Sample::meshToPcFace(
         }
       }
     }
+    recordTemplate( sampleTemplate, output, t, v1.pos, v2.pos, v3.pos );
   }
+  closeTemplate( sampleTemplate, input, output );
   if ( logProgress ) std::cout << std::endl;
   if ( skipped != 0 ) std::cout << "Skipped " << skipped << " degenerate triangles" << std::endl;
   if ( builder.foundCount != 0 ) std::cout << "Skipped " << builder.foundCount << " duplicate vertices" << std::endl;
@@ -165,44 +293,43 @@ void Sample::meshToPcFace(
     float        thickness,
     bool         bilinear,
     bool         logProgress,
-    size_t& computedResolution)
+    size_t& computedResolution,
+    SampleTemplate* sampleTemplate)
 {
-  size_t resolution = 1024;
-  meshToPcFace( input, output, textures, resolution, thickness, bilinear, logProgress );
-  // search to init the algo bounds
-  size_t minResolution = 0;
-  size_t maxResolution = 0;
-  //
-  size_t iter = 0;
-  while ( ( output.getPositionCount() < nbSamplesMin || output.getPositionCount() > nbSamplesMax )
-          && iter < maxIterations ) {
-    iter++;
-    // let's refine
-    if ( output.getPositionCount() < nbSamplesMin ) {  // need to add some points
-      minResolution = resolution;
-      if ( maxResolution == 0 ) {
-        resolution = minResolution * 2;
-      } else {
-        resolution = minResolution + ( maxResolution - minResolution ) / 2;
-      }
-    }
-    if ( output.getPositionCount() > nbSamplesMax ) {  // need to remove some points
-      maxResolution = resolution;
-      resolution    = minResolution + ( maxResolution - minResolution ) / 2;
+  MM_TRACE_SCOPE( "sample face", "sample" );
+  // the face sampler generates sum(floor(i*l23/l12)+1) points for i in [0,floor(l12/step)] per triangle and
+  // per thickness layer, approximated by replacing floor(x) with x-0.5
+  glm::vec3 minPos, maxPos;
+  Geometry::computeBBox( input.vertices, minPos, maxPos );
+  const glm::vec3         diag       = maxPos - minPos;
+  const double            boxMaxSize = std::max( diag.x, std::max( diag.y, diag.z ) );
+  std::vector<glm::dvec2> lengths;
+  for ( size_t t = 0; t < input.triangles.size() / 3; t++ ) {
+    Vertex v1, v2, v3;
+    fetchTriangle( input, t, false, false, false, v1, v2, v3 );
+    if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) continue;
+    lengths.push_back( glm::dvec2( glm::length( v2.pos - v1.pos ), glm::length( v3.pos - v2.pos ) ) );
+  }
+  const auto estimate = [&]( size_t resolution ) {
+    const double step   = boxMaxSize / resolution;
+    const double layers = 2.0 * std::floor( thickness / step ) + 1.0;
+    double       count  = 0.0;
+    for ( const auto& l : lengths ) {
+      const double n = std::floor( l.x / step );
+      count += l.y / l.x * n * ( n + 1.0 ) * 0.5 + ( n + 1.0 ) * 0.5;
     }
-    std::cout << "  posCount=" << output.getPositionCount() << std::endl;
-    std::cout << "  minResolution=" << minResolution << std::endl;
-    std::cout << "  maxResolution=" << maxResolution << std::endl;
-    std::cout << "  resolution=" << resolution << std::endl;
-    //
+    return count * layers;
+  };
+  const auto sample = [&]( size_t resolution ) {
     output.reset();
-    meshToPcFace( input, output, textures, resolution, thickness, bilinear, logProgress );
-  }
-  computedResolution = resolution;
-  std::cout << "algorithm ended after " << iter << " iterations " << std::endl;
+    meshToPcFace( input, output, textures, resolution, thickness, bilinear, logProgress, sampleTemplate );
+    return output.getPositionCount();
+  };
+  computedResolution =
+    searchParameter<size_t>( nbSamplesMin, nbSamplesMax, maxIterations, 1024, 1, true, estimate, sample );
 }
 
-// we use ray tracing to process the result, we could also use a rasterization (might be faster)
+// we use ray tracing to process the result, rays are evaluated by batches of RAY_BATCH_SIZE
 void Sample::meshToPcGrid(
     const Model& input,
     Model& output,
@@ -215,8 +342,10 @@ void Sample::meshToPcGrid(
     glm::vec3& minPos,
     glm::vec3& maxPos,
     const bool   verbose,
-    std::vector<int>* faceIndexPerPoint )
+    std::vector<int>* faceIndexPerPoint,
+    SampleTemplate* sampleTemplate )
 {
+  MM_TRACE_SCOPE( "sample grid", "sample" );
   // computes the bounding box of the vertices
   glm::vec3     minBox       = minPos;
   glm::vec3     maxBox       = maxPos;
@@ -276,6 +405,7 @@ void Sample::meshToPcGrid(
 
   // to prevent storing duplicate points, we use a ModelBuilder
   ModelBuilder builder( output );
+  if ( sampleTemplate ) sampleTemplate->reset();
 
   size_t skipped = 0;  // number of degenerate triangles
 
@@ -367,19 +497,47 @@ void Sample::meshToPcGrid(
       // on main axis from min to max
       rayDirection[mainAxis] = 1.0;
 
+      // the rays of a row are thrown by batches of RAY_BATCH_SIZE, if the triangle covers more than
+      // one batch, batches that do not overlap the triangle are discarded with a box intersection test
+      const bool testBatchBox = ( lcnt[secondAxis] + 1 ) * ( lcnt[thirdAxis] + 1 ) > RAY_BATCH_SIZE;
+
       // iterate the second axis with i
       for ( size_t i = 0; i <= lcnt[secondAxis]; ++i ) {
-        // iterate the third axis with j
-        for ( size_t j = 0; j <= lcnt[thirdAxis]; ++j ) {
-          // create the ray, starting from the face of the triangle bbox
-          rayOrigin[secondAxis] = minBox[secondAxis] + ( lmin[secondAxis] + i ) * stepSize[secondAxis];
-          rayOrigin[thirdAxis]  = minBox[thirdAxis] + ( lmin[thirdAxis] + j ) * stepSize[thirdAxis];
+        rayOrigin[secondAxis] = minBox[secondAxis] + ( lmin[secondAxis] + i ) * stepSize[secondAxis];
+        // iterate the third axis with j, by batches
+        for ( size_t j0 = 0; j0 <= lcnt[thirdAxis]; j0 += RAY_BATCH_SIZE ) {
+          // create the rays, starting from the face of the triangle bbox
+          float  coords[RAY_BATCH_SIZE];
+          size_t count = 0;
+          for ( size_t j = j0; count < RAY_BATCH_SIZE && j <= lcnt[thirdAxis]; ++j, ++count ) {
+            coords[count] = minBox[thirdAxis] + ( lmin[thirdAxis] + j ) * stepSize[thirdAxis];
+          }
+          // conservative box around the rays of the batch, enlarged by half a step on each side
+          if ( testBatchBox ) {
+            glm::vec3 batchMin, batchMax;
+            batchMin[mainAxis]   = triMinBox[mainAxis] - stepSize[mainAxis];
+            batchMax[mainAxis]   = triMaxBox[mainAxis] + stepSize[mainAxis];
+            batchMin[secondAxis] = rayOrigin[secondAxis] - 0.5F * stepSize[secondAxis];
+            batchMax[secondAxis] = rayOrigin[secondAxis] + 0.5F * stepSize[secondAxis];
+            batchMin[thirdAxis]  = coords[0] - 0.5F * stepSize[thirdAxis];
+            batchMax[thirdAxis]  = coords[count - 1] + 0.5F * stepSize[thirdAxis];
+            if ( !Geometry::triangleBoxIntersection( batchMin, batchMax, v1.pos, v2.pos, v3.pos ) ) continue;
+          }
+
+          //  triplets, x = t, y = u, z = v with t the parametric and (u,v) the barycentrics
+          glm::vec3 results[RAY_BATCH_SIZE];
+          bool      hits[RAY_BATCH_SIZE];
 
-          //  triplet, x = t, y = u, z = v with t the parametric and (u,v) the barycentrics
-          glm::vec3 res;
+          // let' throw the rays toward the triangle
+          if ( Geometry::evalRayTriangleBatch(
+                 rayOrigin, rayDirection, thirdAxis, coords, count, v1.pos, v2.pos, v3.pos, hits, results )
+               == 0 )
+            continue;
 
-          // let' throw the ray toward the triangle
-          if ( Geometry::evalRayTriangle( rayOrigin, rayDirection, v1.pos, v2.pos, v3.pos, res ) ) {
+          for ( size_t k = 0; k < count; ++k ) {
+            if ( !hits[k] ) continue;
+            rayOrigin[thirdAxis] = coords[k];
+            const glm::vec3& res = results[k];
             // we convert the result into a point with color
             Vertex v;
             v.pos       = rayOrigin + rayDirection * res[0];
@@ -423,7 +581,9 @@ void Sample::meshToPcGrid(
         }
       }
     }
+    recordTemplate( sampleTemplate, output, triIdx, v1.pos, v2.pos, v3.pos );
   }
+  closeTemplate( sampleTemplate, input, output );
   if( faceIndexPerPoint != nullptr ) *faceIndexPerPoint = faceIndexPerPointVec;
   if ( logProgress ) std::cout << std::endl;
   if ( verbose ) {
@@ -446,47 +606,46 @@ void Sample::meshToPcGrid(
     bool         useFixedPoint,
     glm::vec3& minPos,
     glm::vec3& maxPos,
-    size_t& computedResolution)
+    size_t& computedResolution,
+    SampleTemplate* sampleTemplate)
 {
-  size_t resolution = 1024;
-  meshToPcGrid( input, output, textures, resolution, bilinear, logProgress, useNormal, useFixedPoint, minPos, maxPos );
-  // search to init the algo bounds
-  size_t minResolution = 0;
-  size_t maxResolution = 0;
-  //
-  size_t iter = 0;
-  while ( ( output.getPositionCount() < nbSamplesMin || output.getPositionCount() > nbSamplesMax )
-          && iter < maxIterations ) {
-    iter++;
-    // let's refine
-    if ( output.getPositionCount() < nbSamplesMin ) {  // need to add some points
-      minResolution = resolution;
-      if ( maxResolution == 0 ) {
-        resolution = minResolution * 2;
-      } else {
-        resolution = minResolution + ( maxResolution - minResolution ) / 2;
-      }
-    }
-    if ( output.getPositionCount() > nbSamplesMax ) {  // need to remove some points
-      maxResolution = resolution;
-      resolution    = minResolution + ( maxResolution - minResolution ) / 2;
-    }
-    std::cout << "  posCount=" << output.getPositionCount() << std::endl;
-    std::cout << "  minResolution=" << minResolution << std::endl;
-    std::cout << "  maxResolution=" << maxResolution << std::endl;
-    std::cout << "  resolution=" << resolution << std::endl;
-    //
-    output.reset();
-    meshToPcGrid( input, output, textures, resolution, bilinear, logProgress, useNormal, useFixedPoint, minPos, maxPos );
+  MM_TRACE_SCOPE( "sample grid", "sample" );
+  // the grid sampler generates about one point per grid cell covered by the projection
+  // of the triangles on the planes orthogonal to the ray directions
+  glm::vec3 minBox = minPos;
+  glm::vec3 maxBox = maxPos;
+  if ( minPos == maxPos ) Geometry::computeBBox( input.vertices, minBox, maxBox );
+  const glm::vec3 diag          = maxBox - minBox;
+  const double    range         = std::max( std::max( diag.x, diag.y ), diag.z );
+  double          projectedArea = 0.0;
+  for ( size_t t = 0; t < input.triangles.size() / 3; t++ ) {
+    Vertex v1, v2, v3;
+    fetchTriangle( input, t, false, false, false, v1, v2, v3 );
+    const double areaYZ = Geometry::triangleAreaYZ( v1.pos, v2.pos, v3.pos );
+    const double areaXZ = Geometry::triangleAreaXZ( v1.pos, v2.pos, v3.pos );
+    const double areaXY = Geometry::triangleAreaXY( v1.pos, v2.pos, v3.pos );
+    if ( useNormal ) projectedArea += std::max( areaYZ, std::max( areaXZ, areaXY ) );
+    else projectedArea += areaYZ + areaXZ + areaXY;
   }
-  computedResolution = resolution;
-  std::cout << "algorithm ended after " << iter << " iterations " << std::endl;
+  const auto estimate = [&]( size_t resolution ) {
+    const double step = range / (double)( resolution - 1 );
+    return projectedArea / ( step * step );
+  };
+  const auto sample = [&]( size_t resolution ) {
+    output.reset();
+    meshToPcGrid( input, output, textures, resolution, bilinear, logProgress, useNormal, useFixedPoint, minPos, maxPos,
+                  true, nullptr, sampleTemplate );
+    return output.getPositionCount();
+  };
+  computedResolution =
+    searchParameter<size_t>( nbSamplesMin, nbSamplesMax, maxIterations, 1024, 2, true, estimate, sample );
 }
 
 // perform a reverse sampling of the texture map to generate mesh samples
 // the color of the point is then using the texel color => no filtering
 void Sample::meshToPcMap( const Model& input, Model& output, const std::vector<mm::ImagePtr>& textures, bool logProgress ) 
 {
+  MM_TRACE_SCOPE( "sample map", "sample" );
   if ( input.uvcoords.size() == 0 ) {
     std::cerr << "Error: cannot back sample model, no UV coordinates" << std::endl;
     return;
@@ -661,13 +820,16 @@ void Sample::meshToPcDiv(
     float        areaThreshold,
     bool         mapThreshold,
     bool         bilinear,
-    bool         logProgress)
+    bool         logProgress,
+    SampleTemplate* sampleTemplate)
 {
+  MM_TRACE_SCOPE( "sample sdiv", "sample" );
   // number of degenerate triangles
   size_t skipped = 0;
 
   // to prevent storing duplicate points, we use a ModelBuilder
   ModelBuilder builder( output );
+  if ( sampleTemplate ) sampleTemplate->reset();
 
   // For each triangle
   for ( size_t triIdx = 0; triIdx < input.triangles.size() / 3; ++triIdx ) {
@@ -699,7 +861,9 @@ void Sample::meshToPcDiv(
 
     // subdivide recursively
     subdivideTriangle( v1, v2, v3, image, areaThreshold, mapThreshold, bilinear, maxDepth-1, builder );
+    recordTemplate( sampleTemplate, output, triIdx, v1.pos, v2.pos, v3.pos );
   }
+  closeTemplate( sampleTemplate, input, output );
   if ( logProgress ) std::cout << std::endl;
   if ( skipped != 0 ) std::cout << "Skipped " << skipped << " degenerate triangles" << std::endl;
   if ( builder.foundCount != 0 ) std::cout << "Handled " << builder.foundCount << " duplicate vertices" << std::endl;
@@ -715,44 +879,36 @@ void Sample::meshToPcDiv(
     size_t       maxIterations,
     bool         bilinear,
     bool         logProgress,
-    float& computedThres)
+    float& computedThres,
+    SampleTemplate* sampleTemplate)
 {
-  float value = 1.0;
-  const auto maxDepth = 10000;
-  meshToPcDiv( input, output, textures, maxDepth, value, 0, bilinear, logProgress );
-  // search to init the algo bounds
-  float minBound = 0;
-  float maxBound = 0;
-  //
-  size_t iter = 0;
-  while ( ( output.getPositionCount() < nbSamplesMin || output.getPositionCount() > nbSamplesMax )
-          && iter < maxIterations ) {
-    iter++;
-    // let's refine
-    if ( output.getPositionCount() > nbSamplesMin ) {  // need to remove some points
-      minBound = value;
-      if ( maxBound == 0 ) {
-        value = minBound * 2;
-      } else {
-        value = minBound + ( maxBound - minBound ) / 2;
-      }
-    }
-    if ( output.getPositionCount() < nbSamplesMax ) {  // need to add some points
-      maxBound = value;
-      value    = minBound + ( maxBound - minBound ) / 2;
+  MM_TRACE_SCOPE( "sample sdiv", "sample" );
+  // each subdivision level splits the triangles in four until area < threshold, a triangle split
+  // in n=2^level segments per edge generates (n+1)*(n+2)/2 points
+  const auto          maxDepth = 10000;
+  std::vector<double> areas;
+  for ( size_t t = 0; t < input.triangles.size() / 3; t++ ) {
+    Vertex v1, v2, v3;
+    fetchTriangle( input, t, false, false, false, v1, v2, v3 );
+    const double area = Geometry::triangleArea( v1.pos, v2.pos, v3.pos );
+    if ( area >= DBL_EPSILON ) areas.push_back( area );
+  }
+  const auto estimate = [&]( float threshold ) {
+    double count = 0.0;
+    for ( const auto area : areas ) {
+      double n = 1.0;
+      for ( double sub = area; sub >= threshold && n < 1e9; sub *= 0.25 ) n *= 2.0;
+      count += ( n + 1.0 ) * ( n + 2.0 ) * 0.5;
     }
-    std::cout << "  posCount=" << output.getPositionCount() << std::endl;
-    std::cout << "  minBound=" << minBound << std::endl;
-    std::cout << "  maxBound=" << maxBound << std::endl;
-    std::cout << "  value=" << value << std::endl;
-    //
+    return count;
+  };
+  const auto sample = [&]( float threshold ) {
     output.reset();
-    meshToPcDiv( input, output, textures, maxDepth, value, 0, bilinear, logProgress );
-  }
-
-  computedThres = value;
-
-  std::cout << "algorithm ended after " << iter << " iterations " << std::endl;
+    meshToPcDiv( input, output, textures, maxDepth, threshold, 0, bilinear, logProgress, sampleTemplate );
+    return output.getPositionCount();
+  };
+  computedThres = searchParameter<float>(
+    nbSamplesMin, nbSamplesMax, maxIterations, 1.0F, std::numeric_limits<float>::min(), false, estimate, sample );
 }
 
 //                      //
@@ -873,8 +1029,10 @@ void Sample::meshToPcDivEdge(
     size_t       resolution,
     bool         bilinear,
     bool         logProgress,
-    float& computedThres)
+    float& computedThres,
+    SampleTemplate* sampleTemplate)
 {
+  MM_TRACE_SCOPE( "sample ediv", "sample" );
   float length = lengthThreshold;
 
   if ( length == 0 ) {
@@ -898,6 +1056,7 @@ void Sample::meshToPcDivEdge(
 
   // to prevent storing duplicate points, we use a ModelBuilder
   ModelBuilder builder( output );
+  if ( sampleTemplate ) sampleTemplate->reset();
 
   // number of degenerate triangles
   size_t skipped = 0;
@@ -932,7 +1091,9 @@ void Sample::meshToPcDivEdge(
 
     // subdivide recursively
     subdivideTriangleEdge( v1, v2, v3, image, length, bilinear, builder );
+    recordTemplate( sampleTemplate, output, triIdx, v1.pos, v2.pos, v3.pos );
   }
+  closeTemplate( sampleTemplate, input, output );
   if ( logProgress ) std::cout << std::endl;
   if ( skipped != 0 ) std::cout << "Skipped " << skipped << " degenerate triangles" << std::endl;
   if ( builder.foundCount != 0 ) std::cout << "Handled " << builder.foundCount << " duplicate vertices" << std::endl;
@@ -948,48 +1109,194 @@ void Sample::meshToPcDivEdge(
     size_t       maxIterations,
     bool         bilinear,
     bool         logProgress,
-    float& computedThres) 
+    float& computedThres,
+    SampleTemplate* sampleTemplate)
 {
-  float value = 1.0;
-  float unused;
-  meshToPcDivEdge( input, output, textures, value, 0, bilinear, logProgress, unused );
-  // search to init the algo bounds
-  float minBound = 0;
-  float maxBound = 0;
-  //
-  size_t iter = 0;
-  while ( ( output.getPositionCount() < nbSamplesMin || output.getPositionCount() > nbSamplesMax )
-          && iter < maxIterations ) {
-    iter++;
-    // let's refine
-    if ( output.getPositionCount() > nbSamplesMin ) {  // need to remove some points
-      minBound = value;
-      if ( maxBound == 0 ) {
-        value = minBound * 2;
-      } else {
-        value = minBound + ( maxBound - minBound ) / 2;
+  MM_TRACE_SCOPE( "sample ediv", "sample" );
+  // each edge is split in two until half length < threshold, a triangle with n1, n2 and n3 segments
+  // per edge generates about (n1*n2+n2*n3+n3*n1)/6+(n1+n2+n3)/2+1 points, i.e. (n+1)*(n+2)/2 if uniform
+  float                   unused;
+  std::vector<glm::dvec3> lengths;
+  for ( size_t t = 0; t < input.triangles.size() / 3; t++ ) {
+    Vertex v1, v2, v3;
+    fetchTriangle( input, t, false, false, false, v1, v2, v3 );
+    if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) continue;
+    lengths.push_back( glm::dvec3(
+      glm::length( v2.pos - v1.pos ), glm::length( v3.pos - v2.pos ), glm::length( v1.pos - v3.pos ) ) );
+  }
+  const auto estimate = [&]( float threshold ) {
+    double count = 0.0;
+    for ( const auto& l : lengths ) {
+      glm::dvec3 n( 1.0 );
+      for ( glm::dvec3::length_type c = 0; c < 3; c++ ) {
+        for ( double len = l[c]; len * 0.5 >= threshold && n[c] < 1e9; len *= 0.5 ) n[c] *= 2.0;
       }
+      count += ( n.x * n.y + n.y * n.z + n.z * n.x ) / 6.0 + ( n.x + n.y + n.z ) * 0.5 + 1.0;
     }
-    if ( output.getPositionCount() < nbSamplesMax ) {  // need to add some points
-      maxBound = value;
-      value    = minBound + ( maxBound - minBound ) / 2;
-    }
-    std::cout << "  posCount=" << output.getPositionCount() << std::endl;
-    std::cout << "  minBound=" << minBound << std::endl;
-    std::cout << "  maxBound=" << maxBound << std::endl;
-    std::cout << "  value=" << value << std::endl;
-    //
+    return count;
+  };
+  const auto sample = [&]( float threshold ) {
     output.reset();
-    meshToPcDivEdge( input, output, textures, value, 0, bilinear, logProgress, unused );
+    meshToPcDivEdge( input, output, textures, threshold, 0, bilinear, logProgress, unused, sampleTemplate );
+    return output.getPositionCount();
+  };
+  computedThres = searchParameter<float>(
+    nbSamplesMin, nbSamplesMax, maxIterations, 1.0F, std::numeric_limits<float>::min(), false, estimate, sample );
+}
+
+// counter based generator (Widynski's squares64), the value only depends on (ctr,key)
+// so the samples can be generated in any order or on any thread
+static inline uint64_t squares64( uint64_t ctr, uint64_t key )
+{
+  uint64_t t, x, y, z;
+  y = x = ctr * key;
+  z     = y + key;
+  x     = x * x + y;
+  x     = ( x >> 32 ) | ( x << 32 );
+  x     = x * x + z;
+  x     = ( x >> 32 ) | ( x << 32 );
+  x     = x * x + y;
+  x     = ( x >> 32 ) | ( x << 32 );
+  t = x = x * x + z;
+  x     = ( x >> 32 ) | ( x << 32 );
+  return t ^ ( ( x * x + y ) >> 32 );
+}
+
+// squares64 needs a key with irregular bits, derive it from the user seed with splitmix64
+static inline uint64_t prndKey( uint32_t seed )
+{
+  uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+  z          = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+  z          = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+  return ( z ^ ( z >> 31 ) ) | 1ULL;
+}
+
+// generates the samples of triangle triIdx in vertices, colors are already fetched from the texture
+// so the result can be pushed as is in the ModelBuilder. returns false if the triangle is degenerate.
+static bool prndTriangle( const Model&                     input,
+                          const std::vector<mm::ImagePtr>& textures,
+                          size_t                           triIdx,
+                          size_t                           targetPointCount,
+                          double                           totalArea,
+                          bool                             bilinear,
+                          uint32_t                         seed,
+                          std::vector<Vertex>&             vertices )
+{
+  const auto& image = getImage( textures, input.triangleMatIdx[triIdx] );
+
+  Vertex v1, v2, v3;
+  fetchTriangle(
+    input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
+
+  // check if triangle is not degenerate
+  if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) return false;
+
+  const auto triArea    = Geometry::triangleArea( v1.pos, v2.pos, v3.pos );
+  const auto pointCount = std::ceil( targetPointCount * triArea / totalArea );
+
+  // same color fetch as ModelBuilder::pushVertex( v, image, bilinear )
+  const bool useMap = v1.hasUVCoord && isValid( image );
+  auto       push   = [&]( const Vertex& v ) {
+    vertices.push_back( v );
+    if ( useMap ) {
+      Vertex& tmp = vertices.back();
+      if ( bilinear )
+        texture2D_bilinear( *image, v.uv, tmp.col );
+      else
+        texture2D( *image, v.uv, tmp.col );
+      tmp.hasUVCoord = false;
+      tmp.hasColor   = true;
+    }
+  };
+
+  // compute face normal (forces) - might be better as an option
+  glm::vec3 normal;
+  Geometry::triangleNormal( v1.pos, v2.pos, v3.pos, normal );
+  v1.nrm = v2.nrm = v3.nrm = normal;
+  v1.hasNormal = v2.hasNormal = v3.hasNormal = true;
+
+  // push the vertices
+  push( v1 );
+  push( v2 );
+  push( v3 );
+
+  const auto d12 = glm::distance( v1.pos, v2.pos );
+  const auto d23 = glm::distance( v2.pos, v3.pos );
+  const auto d31 = glm::distance( v3.pos, v1.pos );
+
+  glm::vec3 dpos0, dpos1, pos;
+  glm::vec2 duv0, duv1, uv;
+  if ( d12 >= d23 && d12 >= d31 ) {
+    uv   = v3.uv;
+    duv0 = v1.uv - v3.uv;
+    duv1 = v2.uv - v3.uv;
+
+    pos   = v3.pos;
+    dpos0 = v1.pos - v3.pos;
+    dpos1 = v2.pos - v3.pos;
+  } else if ( d31 >= d23 ) {
+    uv   = v2.uv;
+    duv0 = v1.uv - v2.uv;
+    duv1 = v3.uv - v2.uv;
+
+    pos   = v2.pos;
+    dpos0 = v1.pos - v2.pos;
+    dpos1 = v3.pos - v2.pos;
+  } else {
+    uv   = v1.uv;
+    duv0 = v2.uv - v1.uv;
+    duv1 = v3.uv - v1.uv;
+
+    pos   = v1.pos;
+    dpos0 = v2.pos - v1.pos;
+    dpos1 = v3.pos - v1.pos;
   }
-  computedThres = value;
-  std::cout << "algorithm ended after " << iter << " iterations " << std::endl;
+
+  // the new vertices
+  Vertex vertex;
+  // we use v1 as reference in term of components to push
+  vertex.hasColor   = v1.hasColor;
+  vertex.hasUVCoord = v1.hasUVCoord;
+  // forces normals, we use generated per face ones
+  vertex.hasNormal = true;
+
+  const auto     g   = 1.0f / 1.32471795572f;
+  const auto     g2  = g * g;
+  const uint64_t key = prndKey( seed );
+
+  for ( int i = 1; i < pointCount; ++i ) {
+    float x, y;
+    if ( seed == 0 ) {
+      // R2 low discrepancy sequence
+      const auto r1 = i * g;
+      const auto r2 = i * g2;
+      x             = r1 - std::floor( r1 );
+      y             = r2 - std::floor( r2 );
+    } else {
+      // counter (triIdx,i), 24 bits per coordinate to stay exact in float
+      const uint64_t r = squares64( ( (uint64_t)triIdx << 32 ) | (uint32_t)i, key );
+      x                = (float)( r >> 40 ) * ( 1.0f / 16777216.0f );
+      y                = (float)( ( r >> 8 ) & 0xFFFFFF ) * ( 1.0f / 16777216.0f );
+    }
+    if ( x + y > 1.0f ) {
+      x = 1.0f - x;
+      y = 1.0f - y;
+    }
+    vertex.pos = pos + x * dpos0 + y * dpos1;
+    vertex.uv  = uv + x * duv0 + y * duv1;
+    vertex.nrm = normal;
+    push( vertex );
+  }
+  return true;
 }
 
 // Use uniform sampling algorithm
 // Stop criterion generated point count
 // Implementation of the algorithm described in
 // http://extremelearning.com.au/evenly-distributing-points-in-a-triangle/
+// seed != 0 replaces the R2 sequence by pseudo random samples from a counter based generator.
+// Triangles are sampled in parallel blocks then merged in triangle order,
+// the output does not depend on the number of threads.
 
 void Sample::meshToPcPrnd(
     const Model& input,
@@ -997,13 +1304,17 @@ void Sample::meshToPcPrnd(
     const std::vector<mm::ImagePtr>& textures,
     size_t       targetPointCount,
     bool         bilinear,
-    bool         logProgress)
+    bool         logProgress,
+    SampleTemplate* sampleTemplate,
+    uint32_t     seed)
 {
+  MM_TRACE_SCOPE( "sample prnd", "sample" );
   // number of degenerate triangles
   size_t skipped = 0;
 
   // to prevent storing duplicate points, we use a ModelBuilder
   ModelBuilder builder( output );
+  if ( sampleTemplate ) sampleTemplate->reset();
   double       totalArea = 0.0f;
   for ( size_t triIdx = 0; triIdx < input.triangles.size() / 3; ++triIdx ) {
     Vertex v1, v2, v3;
@@ -1013,96 +1324,355 @@ void Sample::meshToPcPrnd(
     totalArea += Geometry::triangleArea( v1.pos, v2.pos, v3.pos );
   }
 
-  const auto g  = 1.0f / 1.32471795572f;
-  const auto g2 = g * g;
+  // triangles are processed by waves of blocks to bound the memory of the intermediate samples
+  const size_t                     triCount  = input.triangles.size() / 3;
+  const size_t                     blockSize = 256;
+  const size_t                     waveSize  = 64;
+  std::vector<std::vector<Vertex>> blockVertices( waveSize );
+  std::vector<std::vector<size_t>> blockEnds( waveSize );
+
+  for ( size_t waveStart = 0; waveStart < triCount; waveStart += blockSize * waveSize ) {
+    if ( logProgress ) std::cout << '\r' << waveStart << "/" << triCount << std::flush;
+    const size_t waveEnd  = std::min( triCount, waveStart + blockSize * waveSize );
+    const int    nbBlocks = (int)( ( waveEnd - waveStart + blockSize - 1 ) / blockSize );
+
+    // generate the samples of each block independently, one task per block
+    skipped += parallelReduce(
+      0, nbBlocks, 1, (size_t)0,
+      [&]( size_t b, size_t ) {
+        auto& vertices = blockVertices[b];
+        auto& ends     = blockEnds[b];
+        vertices.clear();
+        ends.clear();
+        size_t       blockSkipped = 0;
+        const size_t first        = waveStart + b * blockSize;
+        const size_t last         = std::min( waveEnd, first + blockSize );
+        for ( size_t triIdx = first; triIdx < last; ++triIdx ) {
+          if ( !prndTriangle( input, textures, triIdx, targetPointCount, totalArea, bilinear, seed, vertices ) )
+            ++blockSkipped;
+          ends.push_back( vertices.size() );
+        }
+        return blockSkipped;
+      },
+      []( size_t a, size_t b ) { return a + b; } );
+
+    // merge in triangle order so duplicates removal and templates are deterministic
+    for ( int b = 0; b < nbBlocks; ++b ) {
+      const auto&  vertices = blockVertices[b];
+      const size_t first    = waveStart + b * blockSize;
+      size_t       begin    = 0;
+      for ( size_t t = 0; t < blockEnds[b].size(); ++t ) {
+        for ( size_t i = begin; i < blockEnds[b][t]; ++i ) builder.pushVertex( vertices[i] );
+        begin = blockEnds[b][t];
+        if ( sampleTemplate ) {
+          Vertex v1, v2, v3;
+          fetchTriangle( input, first + t, false, false, false, v1, v2, v3 );
+          recordTemplate( sampleTemplate, output, first + t, v1.pos, v2.pos, v3.pos );
+        }
+      }
+    }
+  }
+  closeTemplate( sampleTemplate, input, output );
+  if ( logProgress ) std::cout << '\r' << triCount << "/" << triCount << std::endl;
+  if ( skipped != 0 ) std::cout << "Skipped " << skipped << " degenerate triangles" << std::endl;
+  if ( builder.foundCount != 0 ) std::cout << "Handled " << builder.foundCount << " duplicate vertices" << std::endl;
+  std::cout << "Generated " << output.vertices.size() / 3 << " points" << std::endl;
+}
 
-  // For each triangle
-  for ( size_t triIdx = 0; triIdx < input.triangles.size() / 3; ++triIdx ) {
-    if ( logProgress ) std::cout << '\r' << triIdx << "/" << input.triangles.size() / 3 << std::flush;
-    
-    const auto& image = getImage(textures, input.triangleMatIdx[triIdx]);
+// cell of the tile grid containing pos, positions out of the box are clamped to the border cells
+static inline glm::ivec3 tileCell( const glm::vec3& pos, const glm::vec3& minBox, const glm::vec3& tileSize, int tiles )
+{
+  glm::ivec3 cell( 0 );
+  for ( glm::vec3::length_type c = 0; c < 3; c++ ) {
+    if ( tileSize[c] > 0.0F ) {
+      cell[c] = std::min( tiles - 1, std::max( 0, (int)std::floor( ( pos[c] - minBox[c] ) / tileSize[c] ) ) );
+    }
+  }
+  return cell;
+}
 
-    Vertex v1, v2, v3;
-    fetchTriangle(
-      input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
+size_t Sample::meshToPcTiles(
+    const Model& input,
+    size_t       tiles,
+    float        margin,
+    const std::function<void( const Model& tile, const glm::vec3& minBox, const glm::vec3& maxBox, Model& points )>& sampler,
+    const std::function<void( const Model& points )>& consumer,
+    bool         logProgress)
+{
+  MM_TRACE_SCOPE( "sample tiles", "sample" );
+  const int nbTiles = (int)std::max( (size_t)1, tiles );
+  glm::vec3 minBox, maxBox;
+  Geometry::computeBBox( input.vertices, minBox, maxBox );
+  const glm::vec3 tileSize = ( maxBox - minBox ) / (float)nbTiles;
+  std::cout << "Sampling by " << nbTiles << "x" << nbTiles << "x" << nbTiles << " tiles" << std::endl;
+  std::cout << "  minbox = " << minBox[0] << "," << minBox[1] << "," << minBox[2] << std::endl;
+  std::cout << "  maxbox = " << maxBox[0] << "," << maxBox[1] << "," << maxBox[2] << std::endl;
+  std::cout << "  tileSize = " << tileSize[0] << "," << tileSize[1] << "," << tileSize[2] << std::endl;
+
+  // list of triangles per cell, from the triangle box enlarged by margin and a small tolerance
+  // so that points generated slightly out of the triangle box (rounding) are not lost
+  const glm::vec3 diag    = maxBox - minBox;
+  const float     enlarge = margin + 1e-4F * std::max( diag.x, std::max( diag.y, diag.z ) );
+  std::vector<std::vector<uint32_t>> cellTriangles( (size_t)nbTiles * nbTiles * nbTiles );
+  for ( size_t t = 0; t < input.triangles.size() / 3; t++ ) {
+    glm::vec3 v1, v2, v3, triMin, triMax;
+    input.fetchTriangleVertices( t, v1, v2, v3 );
+    Geometry::triangleBBox( v1, v2, v3, triMin, triMax );
+    const glm::ivec3 c0 = tileCell( triMin - glm::vec3( enlarge ), minBox, tileSize, nbTiles );
+    const glm::ivec3 c1 = tileCell( triMax + glm::vec3( enlarge ), minBox, tileSize, nbTiles );
+    for ( int z = c0.z; z <= c1.z; z++ )
+      for ( int y = c0.y; y <= c1.y; y++ )
+        for ( int x = c0.x; x <= c1.x; x++ )
+          cellTriangles[( (size_t)z * nbTiles + y ) * nbTiles + x].push_back( (uint32_t)t );
+  }
 
-    // check if triangle is not degenerate
-    if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) {
-      ++skipped;
-      continue;
+  // the tile model shares the vertex attributes of the input, only the triangles change
+  Model tile;
+  tile.vertices       = input.vertices;
+  tile.uvcoords       = input.uvcoords;
+  tile.normals        = input.normals;
+  tile.colors         = input.colors;
+  tile.materialNames  = input.materialNames;
+  tile.textureMapUrls = input.textureMapUrls;
+  const bool hasUvIdx = input.trianglesuv.size() == input.triangles.size();
+  const bool hasMatIdx = input.triangleMatIdx.size() == input.triangles.size() / 3;
+
+  size_t count = 0;
+  Model  points;
+  for ( size_t cellIdx = 0; cellIdx < cellTriangles.size(); cellIdx++ ) {
+    if ( logProgress ) std::cout << "Tile " << cellIdx << "/" << cellTriangles.size() << std::endl;
+    auto& triangles = cellTriangles[cellIdx];
+    if ( triangles.empty() ) continue;
+    const glm::ivec3 cell( cellIdx % nbTiles, ( cellIdx / nbTiles ) % nbTiles, cellIdx / ( (size_t)nbTiles * nbTiles ) );
+
+    tile.triangles.clear();
+    tile.trianglesuv.clear();
+    tile.triangleMatIdx.clear();
+    for ( const auto t : triangles ) {
+      for ( size_t i = 0; i < 3; i++ ) {
+        tile.triangles.push_back( input.triangles[t * 3 + i] );
+        if ( hasUvIdx ) tile.trianglesuv.push_back( input.trianglesuv[t * 3 + i] );
+      }
+      tile.triangleMatIdx.push_back( hasMatIdx ? input.triangleMatIdx[t] : 0 );
     }
+    std::vector<uint32_t>().swap( triangles );
+
+    points.reset();
+    sampler( tile, minBox, maxBox, points );
+
+    // keep only the points owned by the cell
+    const size_t nbPoints   = points.getPositionCount();
+    const bool   hasNormals = points.normals.size() == points.vertices.size();
+    const bool   hasColors  = points.colors.size() == points.vertices.size();
+    const bool   hasUvs     = points.uvcoords.size() / 2 == nbPoints;
+    size_t       kept       = 0;
+    for ( size_t i = 0; i < nbPoints; i++ ) {
+      if ( tileCell( points.fetchPosition( i ), minBox, tileSize, nbTiles ) != cell ) continue;
+      if ( kept != i ) {
+        std::copy( &points.vertices[i * 3], &points.vertices[i * 3 + 3], &points.vertices[kept * 3] );
+        if ( hasNormals ) std::copy( &points.normals[i * 3], &points.normals[i * 3 + 3], &points.normals[kept * 3] );
+        if ( hasColors ) std::copy( &points.colors[i * 3], &points.colors[i * 3 + 3], &points.colors[kept * 3] );
+        if ( hasUvs ) std::copy( &points.uvcoords[i * 2], &points.uvcoords[i * 2 + 2], &points.uvcoords[kept * 2] );
+      }
+      kept++;
+    }
+    points.vertices.resize( kept * 3 );
+    if ( hasNormals ) points.normals.resize( kept * 3 );
+    if ( hasColors ) points.colors.resize( kept * 3 );
+    if ( hasUvs ) points.uvcoords.resize( kept * 2 );
 
-    const auto triArea    = Geometry::triangleArea( v1.pos, v2.pos, v3.pos );
-    const auto pointCount = std::ceil( targetPointCount * triArea / totalArea );
-
-    // compute face normal (forces) - might be better as an option
-    glm::vec3 normal;
-    Geometry::triangleNormal( v1.pos, v2.pos, v3.pos, normal );
-    v1.nrm = v2.nrm = v3.nrm = normal;
-    v1.hasNormal = v2.hasNormal = v3.hasNormal = true;
+    consumer( points );
+    count += kept;
+  }
+  std::cout << "Generated " << count << " points" << std::endl;
+  return count;
+}
 
-    // push the vertices
-    builder.pushVertex( v1, image, bilinear );
-    builder.pushVertex( v2, image, bilinear );
-    builder.pushVertex( v3, image, bilinear );
+uint64_t Sample::connectivityChecksum( const Model& input )
+{
+  // FNV-1a on 32 bits words, sizes are hashed to separate the arrays
+  uint64_t   hash = 14695981039346656037ULL;
+  const auto mix  = [&hash]( uint32_t value ) {
+    hash ^= value;
+    hash *= 1099511628211ULL;
+  };
+  for ( const auto* indices : { &input.triangles, &input.trianglesuv, &input.triangleMatIdx } ) {
+    mix( (uint32_t)indices->size() );
+    for ( const int index : *indices ) mix( (uint32_t)index );
+  }
+  return hash;
+}
 
-    const auto d12 = glm::distance( v1.pos, v2.pos );
-    const auto d23 = glm::distance( v2.pos, v3.pos );
-    const auto d31 = glm::distance( v3.pos, v1.pos );
-
-    glm::vec3 dpos0, dpos1, pos;
-    glm::vec2 duv0, duv1, uv;
-    if ( d12 >= d23 && d12 >= d31 ) {
-      uv   = v3.uv;
-      duv0 = v1.uv - v3.uv;
-      duv1 = v2.uv - v3.uv;
-
-      pos   = v3.pos;
-      dpos0 = v1.pos - v3.pos;
-      dpos1 = v2.pos - v3.pos;
-    } else if ( d31 >= d23 ) {
-      uv   = v2.uv;
-      duv0 = v1.uv - v2.uv;
-      duv1 = v3.uv - v2.uv;
-
-      pos   = v2.pos;
-      dpos0 = v1.pos - v2.pos;
-      dpos1 = v3.pos - v2.pos;
-    } else {
-      uv   = v1.uv;
-      duv0 = v2.uv - v1.uv;
-      duv1 = v3.uv - v1.uv;
+// positions and attributes are re-evaluated for each point of the template, in the
+// template order, hence point count and ordering are preserved from frame to frame
+bool Sample::meshToPcTemplate(
+    const Model& input,
+    Model& output,
+    const std::vector<mm::ImagePtr>& textures,
+    const SampleTemplate& sampleTemplate,
+    bool         bilinear,
+    bool         logProgress)
+{
+  MM_TRACE_SCOPE( "sample template", "sample" );
+  if ( connectivityChecksum( input ) != sampleTemplate.checksum ) {
+    std::cout << "Template connectivity does not match the input model" << std::endl;
+    return false;
+  }
 
-      pos   = v1.pos;
-      dpos0 = v2.pos - v1.pos;
-      dpos1 = v3.pos - v1.pos;
+  const size_t pointCount = sampleTemplate.size();
+  output.vertices.resize( pointCount * 3 );
+  if ( sampleTemplate.hasNormal ) output.normals.resize( pointCount * 3 );
+  if ( sampleTemplate.hasColor ) output.colors.resize( pointCount * 3 );
+
+  const size_t triangleCount = input.triangles.size() / 3;
+  const bool   hasMatIdx     = input.triangleMatIdx.size() == triangleCount;
+  size_t       skipped       = 0;  // number of degenerate triangles
+  size_t       prevIdx       = input.triangles.size();
+  Vertex       v1, v2, v3;
+  glm::vec3    normal;
+  ImagePtr     image;
+
+  for ( size_t i = 0; i < pointCount; ++i ) {
+    const size_t triIdx = sampleTemplate.triIdx[i];
+
+    // points are grouped by triangle, fetch only once
+    if ( triIdx != prevIdx ) {
+      if ( triIdx >= triangleCount ) {
+        std::cerr << "Error: template triangle index " << triIdx << " out of range" << std::endl;
+        output.reset();
+        return false;
+      }
+      if ( logProgress ) std::cout << '\r' << triIdx << "/" << triangleCount << std::flush;
+      prevIdx = triIdx;
+      // material 0 if the model has no material per triangle, getImage falls back to map 0
+      image = getImage( textures, hasMatIdx ? input.triangleMatIdx[triIdx] : 0 );
+      fetchTriangle(
+        input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
+      // degenerate triangles collapse their points, no normal offset
+      if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) {
+        ++skipped;
+        normal = glm::vec3( 0.0F );
+      } else {
+        Geometry::triangleNormal( v1.pos, v2.pos, v3.pos, normal );
+      }
     }
 
-    // the new vertices
-    Vertex vertex;
-    // we use v1 as reference in term of components to push
-    vertex.hasColor   = v1.hasColor;
-    vertex.hasUVCoord = v1.hasUVCoord;
-    // forces normals, we use generated per face ones
-    vertex.hasNormal = true;
+    const float u = sampleTemplate.coords[i * 3 + 0];
+    const float v = sampleTemplate.coords[i * 3 + 1];
+    const float h = sampleTemplate.coords[i * 3 + 2];
 
-    for ( int i = 1; i < pointCount; ++i ) {
-      const auto r1 = i * g;
-      const auto r2 = i * g2;
-      auto       x  = r1 - std::floor( r1 );
-      auto       y  = r2 - std::floor( r2 );
-      if ( x + y > 1.0f ) {
-        x = 1.0f - x;
-        y = 1.0f - y;
+    glm::vec3 pos;
+    Geometry::triangleInterpolation( v1.pos, v2.pos, v3.pos, u, v, pos );
+    pos += h * normal;
+    for ( glm::vec3::length_type c = 0; c < 3; c++ ) output.vertices[i * 3 + c] = pos[c];
+
+    if ( sampleTemplate.hasNormal ) {
+      for ( glm::vec3::length_type c = 0; c < 3; c++ ) output.normals[i * 3 + c] = normal[c];
+    }
+
+    if ( sampleTemplate.hasColor ) {
+      glm::vec3 col( 0.0F );
+      if ( input.uvcoords.size() != 0 && isValid( image ) ) {  // use the texture map
+        glm::vec2 uv;
+        Geometry::triangleInterpolation( v1.uv, v2.uv, v3.uv, u, v, uv );
+        if ( bilinear ) texture2D_bilinear( *image, uv, col );
+        else texture2D( *image, uv, col );
+      } else if ( input.colors.size() != 0 ) {  // use color per vertex
+        col = v1.col * ( 1.0f - u - v ) + v2.col * u + v3.col * v;
       }
-      vertex.pos = pos + x * dpos0 + y * dpos1;
-      vertex.uv  = uv + x * duv0 + y * duv1;
-      vertex.nrm = normal;
-      builder.pushVertex( vertex, image, bilinear );
+      for ( glm::vec3::length_type c = 0; c < 3; c++ ) output.colors[i * 3 + c] = col[c];
     }
   }
   if ( logProgress ) std::cout << std::endl;
-  if ( skipped != 0 ) std::cout << "Skipped " << skipped << " degenerate triangles" << std::endl;
-  if ( builder.foundCount != 0 ) std::cout << "Handled " << builder.foundCount << " duplicate vertices" << std::endl;
+  if ( skipped != 0 ) std::cout << "Found " << skipped << " degenerate triangles" << std::endl;
   std::cout << "Generated " << output.vertices.size() / 3 << " points" << std::endl;
+  return true;
+}
+
+// template file layout, native endianness:
+// magic, version, checksum, hasNormal, hasColor, parameters size, parameters,
+// point count, triangle indices, coordinates
+static const char     templateMagic[8] = { 'm', 'm', 't', 'e', 'm', 'p', 'l', '\0' };
+static const uint32_t templateVersion  = 2;
+
+bool Sample::loadTemplate( const std::string& filename, SampleTemplate& sampleTemplate )
+{
+  std::ifstream fin( filename, std::ios::binary );
+  if ( !fin ) {
+    std::cerr << "Error: cannot open template file " << filename << std::endl;
+    return false;
+  }
+  char     magic[8];
+  uint32_t version    = 0;
+  uint8_t  hasNormal  = 0;
+  uint8_t  hasColor   = 0;
+  uint32_t paramSize  = 0;
+  uint64_t pointCount = 0;
+  fin.read( magic, sizeof( magic ) );
+  fin.read( (char*)&version, sizeof( version ) );
+  if ( !fin || std::memcmp( magic, templateMagic, sizeof( magic ) ) != 0 || version != templateVersion ) {
+    std::cerr << "Error: invalid template file " << filename << std::endl;
+    return false;
+  }
+  sampleTemplate.reset();
+  fin.read( (char*)&sampleTemplate.checksum, sizeof( sampleTemplate.checksum ) );
+  fin.read( (char*)&hasNormal, sizeof( hasNormal ) );
+  fin.read( (char*)&hasColor, sizeof( hasColor ) );
+  fin.read( (char*)&paramSize, sizeof( paramSize ) );
+  if ( fin && paramSize <= 4096 ) {
+    sampleTemplate.parameters.resize( paramSize );
+    fin.read( &sampleTemplate.parameters[0], paramSize );
+  } else {
+    fin.setstate( std::ios::failbit );
+  }
+  fin.read( (char*)&pointCount, sizeof( pointCount ) );
+  // triangle index and coordinates per point, the count must fit in the rest of the file
+  const uint64_t recordSize = sizeof( uint32_t ) + 3 * sizeof( float );
+  if ( fin ) {
+    const std::streampos pos = fin.tellg();
+    fin.seekg( 0, std::ios::end );
+    const uint64_t remaining = (uint64_t)( fin.tellg() - pos );
+    fin.seekg( pos );
+    if ( pointCount > remaining / recordSize ) {
+      std::cerr << "Error: truncated template file " << filename << std::endl;
+      sampleTemplate.reset();
+      return false;
+    }
+  }
+  sampleTemplate.hasNormal = hasNormal != 0;
+  sampleTemplate.hasColor  = hasColor != 0;
+  sampleTemplate.triIdx.resize( pointCount );
+  sampleTemplate.coords.resize( pointCount * 3 );
+  fin.read( (char*)sampleTemplate.triIdx.data(), pointCount * sizeof( uint32_t ) );
+  fin.read( (char*)sampleTemplate.coords.data(), pointCount * 3 * sizeof( float ) );
+  if ( !fin ) {
+    std::cerr << "Error: truncated template file " << filename << std::endl;
+    sampleTemplate.reset();
+    return false;
+  }
+  return true;
+}
+
+bool Sample::saveTemplate( const std::string& filename, const SampleTemplate& sampleTemplate )
+{
+  std::ofstream fout( filename, std::ios::binary );
+  if ( !fout ) {
+    std::cerr << "Error: cannot write template file " << filename << std::endl;
+    return false;
+  }
+  const uint8_t  hasNormal  = sampleTemplate.hasNormal ? 1 : 0;
+  const uint8_t  hasColor   = sampleTemplate.hasColor ? 1 : 0;
+  const uint32_t paramSize  = (uint32_t)sampleTemplate.parameters.size();
+  const uint64_t pointCount = sampleTemplate.size();
+  fout.write( templateMagic, sizeof( templateMagic ) );
+  fout.write( (const char*)&templateVersion, sizeof( templateVersion ) );
+  fout.write( (const char*)&sampleTemplate.checksum, sizeof( sampleTemplate.checksum ) );
+  fout.write( (const char*)&hasNormal, sizeof( hasNormal ) );
+  fout.write( (const char*)&hasColor, sizeof( hasColor ) );
+  fout.write( (const char*)&paramSize, sizeof( paramSize ) );
+  fout.write( sampleTemplate.parameters.data(), paramSize );
+  fout.write( (const char*)&pointCount, sizeof( pointCount ) );
+  fout.write( (const char*)sampleTemplate.triIdx.data(), pointCount * sizeof( uint32_t ) );
+  fout.write( (const char*)sampleTemplate.coords.data(), pointCount * 3 * sizeof( float ) );
+  return (bool)fout;
 }
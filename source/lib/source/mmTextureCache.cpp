@@ -0,0 +1,231 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#else
+#  include <process.h>
+#endif
+
+// internal headers
+#include "mmTextureCache.h"
+#include "mmHash.h"
+
+using namespace mm;
+
+// an entry is the header, zeros up to the pixels offset, then the raw pixels
+static const char     s_magic[8]   = { 'M', 'M', 'T', 'E', 'X', 'C', '0', '2' };
+static const uint64_t s_dataOffset = 4096;  // page aligned pixels
+// a source modified less than this before its entry was written may change again without a
+// new modification time (coarse file system clocks), its content hash is then checked
+static const int64_t s_timeMargin =
+  std::chrono::duration_cast<std::filesystem::file_time_type::duration>( std::chrono::seconds( 2 ) ).count();
+
+struct EntryHeader {
+  char     magic[8];
+  uint64_t sourceSize;
+  int64_t  sourceTime;
+  uint64_t sourceHash;
+  int64_t  entryTime;  // file clock time at which the source was hashed
+  int32_t  width;
+  int32_t  height;
+  int32_t  nbc;
+  int32_t  reserved;
+  uint64_t dataOffset;
+};
+
+static std::string s_directory;
+
+// absolute path, size and modification time of a source image file
+struct SourceInfo {
+  std::string path;
+  uint64_t    size;
+  int64_t     time;
+};
+
+// returns false if the file cannot be accessed
+static bool getSourceInfo( const std::string& filename, SourceInfo& source ) {
+  std::error_code error;
+  source.path = std::filesystem::absolute( filename, error ).string();
+  if ( error ) return false;
+  source.size = std::filesystem::file_size( source.path, error );
+  if ( error ) return false;
+  source.time = (int64_t)std::filesystem::last_write_time( source.path, error ).time_since_epoch().count();
+  return !error;
+}
+
+static std::string getEntryPath( const SourceInfo& source ) {
+  uint64_t key = Hash::string( source.path );
+  key          = Hash::combine( key, source.size );
+  key          = Hash::combine( key, (uint64_t)source.time );
+  return ( std::filesystem::path( s_directory ) / ( Hash::toHex( key ) + ".tex" ) ).string();
+}
+
+// hash of the content of the source file
+static bool hashSource( const SourceInfo& source, uint64_t& hash ) {
+  std::ifstream     file( source.path, std::ios::binary );
+  std::vector<char> content( source.size );
+  if ( !file || !file.read( content.data(), (std::streamsize)content.size() ) ) return false;
+  hash = Hash::buffer( content.data(), content.size() );
+  return true;
+}
+
+// maps the entry file in memory, or reads it if mapping is not available
+static bool mapEntry( const std::string& entryName, std::shared_ptr<void>& storage, uint64_t& size ) {
+#ifndef _WIN32
+  const int fd = ::open( entryName.c_str(), O_RDONLY );
+  if ( fd < 0 ) return false;
+  struct stat status;
+  if ( ::fstat( fd, &status ) != 0 || (uint64_t)status.st_size < s_dataOffset ) {
+    ::close( fd );
+    return false;
+  }
+  size = (uint64_t)status.st_size;
+  // private mapping, the entry is never modified through the image
+  void* base = ::mmap( NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+  ::close( fd );
+  if ( base == MAP_FAILED ) return false;
+  const size_t mapSize = (size_t)size;
+  storage              = std::shared_ptr<void>( base, [mapSize]( void* p ) { ::munmap( p, mapSize ); } );
+  return true;
+#else
+  std::ifstream entry( entryName, std::ios::binary | std::ios::ate );
+  if ( !entry ) return false;
+  size = (uint64_t)entry.tellg();
+  if ( size < s_dataOffset ) return false;
+  storage = std::shared_ptr<void>( new char[size], []( void* p ) { delete[] (char*)p; } );
+  entry.seekg( 0 );
+  return (bool)entry.read( (char*)storage.get(), (std::streamsize)size );
+#endif
+}
+
+void TextureCache::setDirectory( const std::string& directory ) {
+  // absolute, the served requests change the current directory
+  std::error_code error;
+  s_directory = directory.empty() ? directory : std::filesystem::absolute( directory, error ).string();
+  if ( error ) s_directory = directory;
+}
+
+const std::string& TextureCache::getDirectory( void ) { return s_directory; }
+
+bool TextureCache::isEnabled( void ) { return !s_directory.empty(); }
+
+std::string TextureCache::getEntryName( const std::string& filename ) {
+  SourceInfo source;
+  if ( s_directory.empty() || !getSourceInfo( filename, source ) ) return "";
+  return getEntryPath( source );
+}
+
+bool TextureCache::load( const std::string& filename, Image& image ) {
+  SourceInfo source;
+  if ( s_directory.empty() || !getSourceInfo( filename, source ) ) return false;
+  std::shared_ptr<void> storage;
+  uint64_t              entrySize = 0;
+  if ( !mapEntry( getEntryPath( source ), storage, entrySize ) ) return false;
+  EntryHeader header;
+  std::memcpy( &header, storage.get(), sizeof( header ) );
+  // stale or invalid entries are ignored, they are replaced by the next save
+  const uint64_t bytes      = (uint64_t)header.width * header.height * header.nbc;
+  uint64_t       sourceHash = 0;
+  if ( std::memcmp( header.magic, s_magic, sizeof( s_magic ) ) != 0 || header.sourceSize != source.size
+       || header.sourceTime != source.time || header.dataOffset != s_dataOffset || header.width <= 0
+       || header.height <= 0 || header.nbc <= 0 || entrySize < s_dataOffset + bytes ) {
+    return false;
+  }
+  // size and time are trusted, unless the source was modified just before the entry was written
+  if ( header.entryTime - header.sourceTime < s_timeMargin
+       && ( !hashSource( source, sourceHash ) || sourceHash != header.sourceHash ) ) {
+    return false;
+  }
+  image.setView( header.width, header.height, header.nbc, (unsigned char*)storage.get() + s_dataOffset, storage );
+  return true;
+}
+
+bool TextureCache::save( const std::string& filename, const Image& image ) {
+  SourceInfo source;
+  if ( s_directory.empty() || image.data == NULL || !getSourceInfo( filename, source ) ) return false;
+  EntryHeader header;
+  std::memset( &header, 0, sizeof( header ) );
+  std::memcpy( header.magic, s_magic, sizeof( s_magic ) );
+  header.sourceSize = source.size;
+  header.sourceTime = source.time;
+  header.width      = image.width;
+  header.height     = image.height;
+  header.nbc        = image.nbc;
+  header.dataOffset = s_dataOffset;
+  header.entryTime  = (int64_t)std::filesystem::file_time_type::clock::now().time_since_epoch().count();
+  if ( !hashSource( source, header.sourceHash ) ) return false;
+
+  std::error_code error;
+  std::filesystem::create_directories( s_directory, error );
+  if ( error ) return false;
+  // unique temporary name among the processes sharing the cache (thread ids repeat across
+  // processes), the rename is atomic on a same file system
+#ifdef _WIN32
+  const long processId = (long)_getpid();
+#else
+  const long processId = (long)getpid();
+#endif
+  const std::string entryName = getEntryPath( source );
+  const uint64_t    unique    = Hash::combine( std::hash<std::thread::id>()( std::this_thread::get_id() ),
+                                         std::chrono::steady_clock::now().time_since_epoch().count() );
+  const std::string tmpName =
+    entryName + "." + std::to_string( processId ) + "." + Hash::toHex( unique ) + ".tmp";
+  bool              success   = false;
+  {
+    std::ofstream     entry( tmpName, std::ios::binary );
+    std::vector<char> padding( s_dataOffset - sizeof( header ), 0 );
+    entry.write( (const char*)&header, sizeof( header ) );
+    entry.write( padding.data(), (std::streamsize)padding.size() );
+    entry.write( (const char*)image.data, (std::streamsize)image.getByteSize() );
+    success = (bool)entry;
+  }
+  if ( success ) std::filesystem::rename( tmpName, entryName, error );
+  if ( !success || error ) {
+    std::filesystem::remove( tmpName, error );
+    return false;
+  }
+  return true;
+}
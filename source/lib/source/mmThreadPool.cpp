@@ -0,0 +1,225 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef OPENMP_FOUND
+#  include <omp.h>
+#endif
+
+// internal headers
+#include "mmThreadPool.h"
+#include "mmTrace.h"
+
+using namespace mm;
+
+std::unique_ptr<ThreadPool> ThreadPool::_instance;
+std::mutex                  ThreadPool::_instanceMutex;
+std::condition_variable     ThreadPool::_releaseCond;
+size_t                      ThreadPool::_threadCount    = 0;
+bool                        ThreadPool::_threadCountSet = false;
+
+// index of the deque owned by the calling thread, -1 for non worker threads
+static thread_local int s_queueIndex = -1;
+
+void ThreadPool::setThreadCount( size_t count ) {
+  std::unique_lock<std::mutex> lock( _instanceMutex );
+  _threadCountSet = true;
+  count           = count != 0 ? count : ( std::max )( std::thread::hardware_concurrency(), 1u );
+  // restarted with the new size on next use, once the task groups using it are done
+  if ( count != _threadCount && _instance ) {
+    _releaseCond.wait( lock, [] { return _instance->_groups == 0; } );
+    _instance.reset();
+  }
+  _threadCount = count;
+#ifdef OPENMP_FOUND
+  omp_set_num_threads( (int)_threadCount );
+#endif
+}
+
+void ThreadPool::clearThreadCount( void ) {
+  if ( !isThreadCountSet() ) return;
+  setThreadCount( 0 );
+  std::lock_guard<std::mutex> lock( _instanceMutex );
+  _threadCountSet = false;
+}
+
+size_t ThreadPool::getThreadCount( void ) {
+  std::lock_guard<std::mutex> lock( _instanceMutex );
+  if ( _threadCount == 0 ) _threadCount = ( std::max )( std::thread::hardware_concurrency(), 1u );
+  return _threadCount;
+}
+
+bool ThreadPool::isThreadCountSet( void ) {
+  std::lock_guard<std::mutex> lock( _instanceMutex );
+  return _threadCountSet;
+}
+
+ThreadPool& ThreadPool::instance( void ) {
+  const size_t                threadCount = getThreadCount();
+  std::lock_guard<std::mutex> lock( _instanceMutex );
+  if ( !_instance ) _instance.reset( new ThreadPool( threadCount ) );
+  return *_instance;
+}
+
+ThreadPool& ThreadPool::acquire( void ) {
+  const size_t                threadCount = getThreadCount();
+  std::lock_guard<std::mutex> lock( _instanceMutex );
+  if ( !_instance ) _instance.reset( new ThreadPool( threadCount ) );
+  ++_instance->_groups;
+  return *_instance;
+}
+
+void ThreadPool::release( void ) {
+  std::lock_guard<std::mutex> lock( _instanceMutex );
+  if ( --_instance->_groups == 0 ) _releaseCond.notify_all();
+}
+
+ThreadPool::ThreadPool( size_t threadCount ) {
+  // the thread waiting on a task group is one of the threads
+  const size_t workerCount = threadCount > 1 ? threadCount - 1 : 0;
+  for ( size_t i = 0; i <= workerCount; ++i ) _queues.emplace_back( new Queue() );
+  for ( size_t i = 0; i < workerCount; ++i ) _threads.emplace_back( &ThreadPool::workerLoop, this, i );
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock( _sleepMutex );
+    _stop = true;
+  }
+  _sleepCond.notify_all();
+  for ( auto& thread : _threads ) thread.join();
+}
+
+void ThreadPool::push( Task&& task ) {
+  const size_t index = s_queueIndex >= 0 ? (size_t)s_queueIndex : _queues.size() - 1;
+  {
+    std::lock_guard<std::mutex> lock( _queues[index]->mutex );
+    _queues[index]->tasks.push_back( std::move( task ) );
+  }
+  _queued.fetch_add( 1 );
+  // lock so a worker cannot miss the wake up between its check and its wait
+  { std::lock_guard<std::mutex> lock( _sleepMutex ); }
+  _sleepCond.notify_one();
+}
+
+bool ThreadPool::take( Task& task, const TaskGroup* group ) {
+  if ( _queued.load() == 0 || ( group && group->_queued.load() == 0 ) ) return false;
+  const size_t own     = s_queueIndex >= 0 ? (size_t)s_queueIndex : _queues.size() - 1;
+  auto         matches = [group]( const Task& t ) { return !group || t.group == group; };
+  // own deque, most recent task first (its data is likely in cache)
+  {
+    std::lock_guard<std::mutex> lock( _queues[own]->mutex );
+    auto&                       tasks = _queues[own]->tasks;
+    auto                        it    = std::find_if( tasks.rbegin(), tasks.rend(), matches );
+    if ( it != tasks.rend() ) {
+      task = std::move( *it );
+      tasks.erase( std::next( it ).base() );
+      _queued.fetch_sub( 1 );
+      task.group->_queued.fetch_sub( 1 );
+      return true;
+    }
+  }
+  // steal the oldest task of the other deques
+  for ( size_t i = 1; i < _queues.size(); ++i ) {
+    Queue&                      victim = *_queues[( own + i ) % _queues.size()];
+    std::lock_guard<std::mutex> lock( victim.mutex );
+    auto                        it = std::find_if( victim.tasks.begin(), victim.tasks.end(), matches );
+    if ( it != victim.tasks.end() ) {
+      task = std::move( *it );
+      victim.tasks.erase( it );
+      _queued.fetch_sub( 1 );
+      task.group->_queued.fetch_sub( 1 );
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::execute( Task& task ) {
+  MM_TRACE_SCOPE( "task", "pool" );
+  TaskGroup& group = *task.group;
+  try {
+    task.func();
+  } catch ( ... ) { group.setError( std::current_exception() ); }
+  task.func = nullptr;
+  // under the lock, the waiting thread may destroy the group as soon as it is released
+  std::lock_guard<std::mutex> lock( group._doneMutex );
+  if ( group._pending.fetch_sub( 1 ) == 1 ) group._doneCond.notify_all();
+}
+
+bool ThreadPool::tryRun( const TaskGroup* group ) {
+  Task task;
+  if ( !take( task, group ) ) return false;
+  execute( task );
+  return true;
+}
+
+void ThreadPool::workerLoop( size_t index ) {
+  s_queueIndex = (int)index;
+  while ( true ) {
+    if ( tryRun() ) continue;
+    std::unique_lock<std::mutex> lock( _sleepMutex );
+    _sleepCond.wait( lock, [this] { return _stop || _queued.load() != 0; } );
+    if ( _stop ) return;
+  }
+}
+
+TaskGroup::~TaskGroup() {
+  waitTasks();
+  ThreadPool::release();
+}
+
+void TaskGroup::waitTasks( void ) {
+  while ( true ) {
+    // only the tasks of this group, an unrelated one could delay the return for long
+    if ( _pool.tryRun( this ) ) continue;
+    std::unique_lock<std::mutex> lock( _doneMutex );
+    _doneCond.wait( lock, [this] { return _pending.load() == 0 || _queued.load() != 0; } );
+    if ( _pending.load() == 0 ) return;
+  }
+}
+
+void TaskGroup::wait( void ) {
+  waitTasks();
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock( _errorMutex );
+    std::swap( error, _error );
+  }
+  if ( error ) std::rethrow_exception( error );
+}
+
+void TaskGroup::setError( std::exception_ptr error ) {
+  std::lock_guard<std::mutex> lock( _errorMutex );
+  if ( !_error ) _error = error;
+}
@@ -0,0 +1,167 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2021, InterDigital
+ * Copyright (c) 2021-2025, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the copyright holder(s) nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+
+// internal headers
+#include "mmMemory.h"
+#include "mmTrace.h"
+
+using namespace mm;
+
+std::atomic<bool>         Trace::_enabled( false );
+std::string               Trace::_filename;
+std::mutex                Trace::_mutex;
+std::vector<Trace::Event> Trace::_events;
+
+// origin of the trace time stamps
+static const std::chrono::steady_clock::time_point s_origin = std::chrono::steady_clock::now();
+
+// number of scopes running on the calling thread
+static thread_local uint32_t s_depth = 0;
+
+void Trace::enable( const std::string& filename ) {
+  std::lock_guard<std::mutex> lock( _mutex );
+  _filename = filename;
+  _enabled  = true;
+}
+
+void Trace::disable( void ) {
+  std::lock_guard<std::mutex> lock( _mutex );
+  _enabled = false;
+  _filename.clear();
+  _events.clear();
+}
+
+uint64_t Trace::now( void ) {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - s_origin )
+    .count();
+}
+
+uint32_t Trace::threadId( void ) {
+  static std::atomic<uint32_t> s_nextId( 0 );
+  static thread_local uint32_t s_id = s_nextId++;
+  return s_id;
+}
+
+void Trace::record( const std::string& name, const char* category, uint64_t begin, uint64_t end, uint32_t depth ) {
+  if ( !_enabled ) return;
+  Event event = { name, category, begin, end - begin, threadId(), depth };
+  std::lock_guard<std::mutex> lock( _mutex );
+  // disabled meanwhile, the events were freed
+  if ( _enabled ) _events.push_back( event );
+}
+
+// escapes a string for a JSON value
+static std::string escape( const std::string& str ) {
+  std::string res;
+  res.reserve( str.size() );
+  for ( const char c : str ) {
+    if ( c == '"' || c == '\\' ) {
+      res += '\\';
+      res += c;
+    } else if ( (unsigned char)c < 0x20 ) {
+      res += ' ';
+    } else {
+      res += c;
+    }
+  }
+  return res;
+}
+
+bool Trace::save( void ) {
+  std::lock_guard<std::mutex> lock( _mutex );
+  std::ofstream out( _filename );
+  if ( !out ) {
+    std::cerr << "Error: cannot open trace file " << _filename << std::endl;
+    return false;
+  }
+  // name the threads that recorded events
+  std::vector<bool> named;
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for ( const Event& event : _events ) {
+    if ( event.tid >= named.size() ) named.resize( event.tid + 1, false );
+    if ( !named[event.tid] ) {
+      named[event.tid] = true;
+      out << ( first ? "\n" : ",\n" ) << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << event.tid
+          << ",\"args\":{\"name\":\"" << ( event.tid == 0 ? "main" : "thread " + std::to_string( event.tid ) )
+          << "\"}}";
+      first = false;
+    }
+    out << ( first ? "\n" : ",\n" ) << "{\"name\":\"" << escape( event.name ) << "\",\"cat\":\"" << event.category
+        << "\",\"ph\":\"X\",\"ts\":" << event.begin << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":" << event.tid
+        << ",\"args\":{\"depth\":" << event.depth << "}}";
+    first = false;
+  }
+  out << "\n]}\n";
+  _events.clear();
+  if ( !out ) {
+    std::cerr << "Error: cannot write trace file " << _filename << std::endl;
+    return false;
+  }
+  return true;
+}
+
+ScopedTimer::ScopedTimer( const std::string& name, const char* category ) :
+  _name( name ), _category( category ), _begin( Trace::now() ), _end( 0 ), _depth( s_depth++ ), _running( true ) {
+  if ( Memory::isEnabled() ) Memory::beginStage( _name );
+}
+
+ScopedTimer::~ScopedTimer() { stop(); }
+
+void ScopedTimer::stop( void ) {
+  if ( !_running ) return;
+  _running = false;
+  _end     = Trace::now();
+  --s_depth;
+  Trace::record( _name, _category, _begin, _end, _depth );
+  if ( Memory::isEnabled() ) Memory::endStage();
+}
+
+void ScopedTimer::restart( const std::string& name ) {
+  stop();
+  _name    = name;
+  _begin   = Trace::now();
+  _depth   = s_depth++;
+  _running = true;
+  if ( Memory::isEnabled() ) Memory::beginStage( _name );
+}
+
+double ScopedTimer::elapsed( void ) const {
+  return (double)( ( _running ? Trace::now() : _end ) - _begin ) / 1000000.0;
+}
@@ -8,13 +8,18 @@
 tests=(
 "test-help"
 "test-analyse"
+"test-api"
 "test-compare-eq" 
 "test-compare-eqTFAN" 
 "test-compare-topo"
 "test-compare-pcc"
 "test-compare-ibsm"
+"test-compare-memo"
 "test-composed"
+"test-concurrent"
 "test-degrade"
+"test-generate"
+"test-merge"
 "test-normals"
 "test-quantize"
 "test-reindex"
@@ -25,6 +30,10 @@ tests=(
 "test-sample-map"
 "test-sample-sdiv"
 "test-sample-prnd"
+"test-sample-template"
+"test-serve"
+"test-texture-cache"
+"test-writers"
 )
 
 for test in ${tests[@]}; do
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+source config.sh
+
+# the api test program is built next to mm
+API=$(dirname ${CMD})/mmapitest
+if [ "$(uname)" != "Linux" ]; then API=${API}.exe; fi
+
+# loads, samples and compares the plane models through the C interface
+OUT=api_plane
+echo $OUT
+${API} ${DATA} > ${TMP}/${OUT}.txt 2>&1
+echo "exit code $?" >> ${TMP}/${OUT}.txt
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Sampled 100 points" 1
+fileHasString ${TMP}/${OUT}.txt "First point -5 -5 0 color 0 162 232" 1
+fileHasString ${TMP}/${OUT}.txt "Topology difference 0" 1
+fileHasString ${TMP}/${OUT}.txt "All api checks passed" 1
+fileHasString ${TMP}/${OUT}.txt "exit code 0" 1
@@ -0,0 +1,38 @@
+#!/bin/bash
+
+source config.sh
+
+# a two frames sequence of generated models and their distorted copies
+OUT=compare_memo_data
+echo $OUT
+$CMD sequence --firstFrame 1 --lastFrame 2 END \
+	generate --type sphere --triangles 2000 --colors --mapSize 256 --noise 0.01 \
+	--outputModel ${TMP}/${OUT}_%1d.obj --distortedModel ${TMP}/${OUT}_dis_%1d.obj > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+
+# the same comparison twice, the second run reads the results from the memo store
+for MODE in pcqm ibsm; do
+	OUT=compare_memo_${MODE}
+	echo $OUT
+	rm -rf ${TMP}/${OUT}_store ${TMP}/${OUT}_1.csv ${TMP}/${OUT}_2.csv
+	for RUN in 1 2; do
+		$CMD sequence --firstFrame 1 --lastFrame 2 END \
+			compare --mode ${MODE} --inputModelA ${TMP}/compare_memo_data_%1d.obj --inputModelB ${TMP}/compare_memo_data_dis_%1d.obj \
+			--memo ${TMP}/${OUT}_store --outputCsv ${TMP}/${OUT}_${RUN}.csv > ${TMP}/${OUT}_${RUN}.txt 2>&1
+		grep -iF "error" ${TMP}/${OUT}_${RUN}.txt
+	done
+	fileHasString ${TMP}/${OUT}_1.txt "Results restored from memo" 0
+	fileHasString ${TMP}/${OUT}_2.txt "Results restored from memo" 2
+	# same csv rows, ibsm processing time excluded
+	diff <(cut -d ';' -f 1-20 ${TMP}/${OUT}_1.csv) <(cut -d ';' -f 1-20 ${TMP}/${OUT}_2.csv)
+done
+
+# other parameters are not read from the store
+OUT=compare_memo_pcqm_params
+echo $OUT
+$CMD compare --mode pcqm --radiusFactor 3.0 --inputModelA ${TMP}/compare_memo_data_1.obj \
+	--inputModelB ${TMP}/compare_memo_data_dis_1.obj --memo ${TMP}/compare_memo_pcqm_store > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Results restored from memo" 0
+
+# EOF
@@ -4,6 +4,21 @@
 
 source config.sh
 
+# checks that the per point file $1.bin has, for A and B, as many points as the vertices of the models
+# in the log $1.txt, sets COUNT_A, COUNT_B and VALUES, the offset of the first value
+# layout: 28 bytes header, 216 bytes of field names, 20 float columns for A then for B
+function checkPerPoint {
+	local SIZE=$(wc -c < ${1}.bin)
+	local VERTICES=( $(grep "^  Vertices: " ${1}.txt | awk '{ print $2 }') )
+	read COUNT_A COUNT_B <<< $(od -A n -v -t u8 -j 12 -N 16 ${1}.bin)
+	VALUES=244
+	if [ "${COUNT_A}" != "${VERTICES[0]}" ] || [ "${COUNT_B}" != "${VERTICES[1]}" ]; then
+		echo "Error: ${1}.bin point counts ${COUNT_A} ${COUNT_B} differ from the model vertex counts ${VERTICES[*]}"
+	elif [ ${SIZE} -ne $(( VALUES + 20 * ( COUNT_A + COUNT_B ) * 4 )) ]; then
+		echo "Error: ${1}.bin size ${SIZE} does not match its point counts"
+	fi
+}
+
 STATS=${TMP}/compare_pcc.csv
 # reset csv stats file
 > ${STATS}
@@ -29,6 +44,44 @@ if [ "$1" == "" ] || [ "$1" == "ext" ] ||  [ "$1" == "$OUT" ]; then
 	fileHasString ${TMP}/${OUT}.txt "mseF,PSNR (p2plane): 66.4" 1
 fi
 
+# per point results
+OUT=compare_pcc_sphere_qp8_perpoint
+if [ "$1" == "" ] || [ "$1" == "ext" ] ||  [ "$1" == "$OUT" ]; then
+	echo $OUT
+	$CMD compare --mode pcc --inputModelA ${DATA}/sphere.obj --inputModelB ${DATA}/sphere_qp8.obj \
+		--outputPerPoint ${TMP}/${OUT}.bin > ${TMP}/${OUT}.txt 2>&1
+	grep -iF "error" ${TMP}/${OUT}.txt
+	fileHasString ${TMP}/${OUT}.txt "mseF,PSNR (p2plane): 66.4" 1
+	fileHasString ${TMP}/${OUT}.bin "MMPP" 1
+	fileHasString ${TMP}/${OUT}.bin "c2c_psnr" 1
+	checkPerPoint ${TMP}/${OUT}
+fi
+
+# per point results of the plane vertices shifted along the plane normal, all the points have the log PSNR
+OUT=compare_pcc_plane_shifted_perpoint
+if [ "$1" == "" ] || [ "$1" == "ext" ] ||  [ "$1" == "$OUT" ]; then
+	echo $OUT
+	awk '/^v /{ print }' ${DATA}/plane.obj > ${TMP}/${OUT}_A.obj
+	awk '/^v /{ $4 = $4 + 0.01; print }' ${DATA}/plane.obj > ${TMP}/${OUT}_B.obj
+	$CMD compare --mode pcc --inputModelA ${TMP}/${OUT}_A.obj --inputModelB ${TMP}/${OUT}_B.obj \
+		--outputPerPoint ${TMP}/${OUT}.bin > ${TMP}/${OUT}.txt 2>&1
+	grep -iF "error" ${TMP}/${OUT}.txt
+	checkPerPoint ${TMP}/${OUT}
+	PSNR=$(grep -F "mseF,PSNR (p2point):" ${TMP}/${OUT}.txt | head -1 | awk -F': ' '{ print $2 }')
+	# any of the 10 psnr columns of A or B
+	MATCH=0
+	for column in $(seq 0 9); do
+		for side in A B; do
+			if [ $side == A ]; then OFFSET=$(( VALUES + column * COUNT_A * 4 )); N=${COUNT_A};
+			else OFFSET=$(( VALUES + ( 20 * COUNT_A + column * COUNT_B ) * 4 )); N=${COUNT_B}; fi
+			od -A n -v -t f4 -j ${OFFSET} -N $(( N * 4 )) ${TMP}/${OUT}.bin | \
+				awk -v psnr=${PSNR} '{ for ( i = 1; i <= NF; ++i ) if ( $i - psnr > 0.001 || psnr - $i > 0.001 ) bad = 1 } END { exit bad }' \
+				&& MATCH=1
+		done
+	done
+	[ "${PSNR}" != "" ] && [ ${MATCH} == 1 ] || echo "Error: no per point column of ${TMP}/${OUT}.bin has the PSNR ${PSNR} of the log"
+fi
+
 ####
 # extended tests
 
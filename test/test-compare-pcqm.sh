@@ -85,3 +85,17 @@ if [ "$1" == "ext" ] || [ "$1" == "$OUT" ]; then
 	grep -iF "error" ${TMP}/${OUT}.txt
 	fileHasString ${TMP}/${OUT}.txt "PCQM-PSNR Mean=67.9765308" 1
 fi
+
+# test sequence mode against a static reference, reference KD-tree is built once
+OUT=compare_pcqm_basket_seq_static_ref
+if [ "$1" == "ext" ] || [ "$1" == "$OUT" ]; then
+	echo $OUT
+	$CMD sequence --firstFrame 1 --lastFrame 3 END \
+		compare --mode pcqm  \
+		--inputModelA ${DATA}/basketball_player_0000000%1d.obj \
+		--inputModelB ${DATA}/basketball_player_00000001.obj \
+		--outputCsv ${STATS} > ${TMP}/${OUT}.txt 2>&1
+	grep -iF "error" ${TMP}/${OUT}.txt
+	fileHasString ${TMP}/${OUT}.txt "Reusing reference KD-tree" 2
+	fileHasString ${TMP}/${OUT}.txt "PCQM-PSNR Mean=55.5468328" 1
+fi
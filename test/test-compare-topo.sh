@@ -30,6 +30,26 @@ if [ "$1" == "" ] || [ "$1" == "ext" ] || [ "$1" == "$OUT" ]; then
 	fileHasString ${TMP}/${OUT}.txt "Topologies are matching." 1
 fi
 
+# topo only loads the positions and triangles, the model is reloaded by the next command
+OUT=compare_topo_plane_partial_load
+if [ "$1" == "" ] || [ "$1" == "ext" ] || [ "$1" == "$OUT" ]; then
+	echo $OUT
+	$CMD  \
+		compare --mode topo  \
+		--inputModelA ${DATA}/plane.obj \
+		--inputModelB ${DATA}/plane_shifted.obj \
+		--faceMapFile ${DATA}/plane_shifted_topo_face.txt \
+		--vertexMapFile ${DATA}/plane_shifted_topo_vert.txt END \
+		reindex --sort oriented --inputModel ${DATA}/plane.obj --outputModel ${TMP}/${OUT}.obj \
+		 > ${TMP}/${OUT}.txt 2>&1
+	grep -iF "error" ${TMP}/${OUT}.txt
+	fileHasString ${TMP}/${OUT}.txt "Topologies are matching." 1
+	fileHasString ${TMP}/${OUT}.txt "^  UVs: 0$" 2
+	fileHasString ${TMP}/${OUT}.txt "^  UVs: 5$" 1
+	fileHasString ${TMP}/${OUT}.obj "^mtllib plane.mtl$" 1
+	fileHasString ${TMP}/${OUT}.obj "^vt " 5
+fi
+
 ####
 # external datasets
 
@@ -43,6 +43,37 @@ $CMD \
 grep -iF "error" ${TMP}/${OUT}.txt
 fileHasString ${TMP}/${OUT}.txt "mseF,PSNR (p2plane): 58.2" 1
 
+# same with wall clock timings saved as trace events
+OUT=composed_inmem_sample_face_sphere_trace
+echo $OUT
+$CMD --trace ${TMP}/${OUT}.json \
+	sample -i ${DATA}/sphere.obj -o ID:pc1 --mode face --resolution 50 --hideProgress END \
+	sample -i ${DATA}/sphere_qp8.obj -o ID:pc2 --mode face --resolution 10 --hideProgress END \
+	compare --mode pcc --inputModelA ID:pc1 --inputModelB ID:pc2 \
+	> ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "mseF,PSNR (p2plane): 58.2" 1
+fileHasString ${TMP}/${OUT}.json "\"traceEvents\"" 1
+fileHasString ${TMP}/${OUT}.json "\"name\":\"frame 0\"" 1
+fileHasString ${TMP}/${OUT}.json "\"name\":\"sample\",\"cat\":\"command\"" 2
+fileHasString ${TMP}/${OUT}.json "\"name\":\"pcc metric\"" 1
+
+# memory usage per frame, appended to the csv
+OUT=composed_sample_face_compare_sphere_pcqm_memory
+echo $OUT
+rm -f ${TMP}/${OUT}.csv
+$CMD --memory compare --mode pcqm \
+	--inputModelA ${TMP}/${OUT1}.ply \
+	--inputModelB ${TMP}/${OUT2}.ply \
+	--outputCsv ${TMP}/${OUT}.csv \
+	> ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "PCQM-PSNR=inf" 1
+fileHasString ${TMP}/${OUT}.txt "Memory usage of frame 0" 1
+fileHasString ${TMP}/${OUT}.txt "^        pcqm kdtree build " 1
+fileHasString ${TMP}/${OUT}.txt "^        pcqm metric " 1
+fileHasString ${TMP}/${OUT}.csv "mem_rssPeak;mem_heapPeak;mem_models;mem_images;mem_peakStage$" 1
+
 # external dataset
 if [ "$1" == "ext" ]; 
 then
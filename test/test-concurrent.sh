@@ -0,0 +1,49 @@
+#!/bin/bash
+
+source config.sh
+
+# two independent samplings compared, plus an independent quantization
+CHAIN="sample --mode face --inputModel ${DATA}/sphere.obj --outputModel ID:a END \
+	sample --mode face --inputModel ${DATA}/sphere_qp8.obj --outputModel ID:b END \
+	compare --mode ibsm --ibsmResolution 256 --ibsmCameraCount 4 --inputModelA ID:a --inputModelB ID:b END \
+	quantize --inputModel ${DATA}/plane.obj --qp 8 --outputModel"
+
+# reference sequential run
+OUT=concurrent_0
+echo $OUT
+$CMD --threads 4 $CHAIN ${TMP}/${OUT}.obj > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+
+# same results and logs in the same order, apart from the timings
+OUT=concurrent_1
+echo $OUT
+$CMD --threads 4 --concurrent $CHAIN ${TMP}/${OUT}.obj > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "^  2 compare after 0 1$" 1
+fileHasString ${TMP}/${OUT}.txt "^  3 quantize$" 1
+cmp ${TMP}/concurrent_0.obj ${TMP}/${OUT}.obj
+diff <(grep -v -iE "time|sec\.|^  [0-9] |^Concurrent" ${TMP}/concurrent_0.txt | sed 's/concurrent_0/concurrent_1/') \
+	<(grep -v -iE "time|sec\.|^  [0-9] |^Concurrent" ${TMP}/${OUT}.txt)
+
+# the dependent commands wait for the id they read
+OUT=concurrent_chain
+echo $OUT
+$CMD --threads 4 --concurrent \
+	quantize --inputModel ${DATA}/sphere.obj --qp 8 --outputModel ID:q END \
+	normals --inputModel ID:q --outputModel ID:n END \
+	reindex --sort oriented --inputModel ID:n --outputModel ${TMP}/${OUT}.obj > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "^  1 normals after 0$" 1
+fileHasString ${TMP}/${OUT}.txt "^  2 reindex after 1$" 1
+
+# short options are resources too
+OUT=concurrent_chain_short
+echo $OUT
+$CMD --threads 4 --concurrent \
+	quantize -i ${DATA}/sphere.obj --qp 8 -o ID:q END \
+	normals --inputModel ID:q -o ID:n END \
+	reindex --sort oriented -i ID:n --outputModel ${TMP}/${OUT}.obj > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "^  1 normals after 0$" 1
+fileHasString ${TMP}/${OUT}.txt "^  2 reindex after 1$" 1
+cmp ${TMP}/concurrent_chain.obj ${TMP}/${OUT}.obj
@@ -0,0 +1,39 @@
+#!/bin/bash
+
+source config.sh
+
+# textured sphere with two materials and its distorted copy, compared with ibsm
+OUT=generate_sphere_20k_mat2
+echo $OUT
+$CMD generate --type sphere --triangles 20000 --materials 2 --mapSize 256 --outputModel ${TMP}/${OUT}.obj \
+	--distortedModel ${TMP}/${OUT}_dis.obj > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Generated sphere: V = 9942 UV = 10296 F = 19880 Materials = 2" 1
+fileHasString ${TMP}/${OUT}.mtl "map_Kd ${OUT}_1.png" 1
+$CMD compare --mode ibsm --inputModelA ${TMP}/${OUT}.obj --inputModelB ${TMP}/${OUT}_dis.obj >> ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "^RGB PSNR = " 1
+
+# terrain with per vertex colors and normals, shuffled faces and non manifold edges
+OUT=generate_terrain_10k_nonmanifold
+echo $OUT
+$CMD generate --type terrain --triangles 10000 --mapSize 0 --colors --normals --shuffle --nonManifold 10 \
+	--outputModel ${TMP}/${OUT}.ply > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Generated terrain: V = 5194 UV = 0 F = 10092 Materials = 1" 1
+
+# colored point cloud
+OUT=generate_terrain_pcloud_20k
+echo $OUT
+$CMD generate --type terrain --points 20000 --outputModel ${TMP}/${OUT}.ply > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Generated terrain point cloud: V = 20164 UV = 0 F = 0 Materials = 0" 1
+
+# sequence, each frame uses its own seed
+OUT=generate_terrain_sequence
+echo $OUT
+$CMD sequence --firstFrame 1 --lastFrame 2 END \
+	generate --type terrain --triangles 2000 --outputModel ${TMP}/${OUT}_%1d.obj > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Generated terrain" 2
+if cmp -s ${TMP}/${OUT}_1.obj ${TMP}/${OUT}_2.obj; then echo "Error: frames 1 and 2 are identical"; fi
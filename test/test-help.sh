@@ -14,6 +14,18 @@ cmpOsLog helpRender
 $CMD degrade     > ${TMP}/helpDegrade.txt 2>&1
 cmpOsLog helpDegrade
 
+$CMD generate    > ${TMP}/helpGenerate.txt 2>&1
+cmpOsLog helpGenerate
+
+$CMD merge       > ${TMP}/helpMerge.txt 2>&1
+cmpOsLog helpMerge
+
+$CMD serve --help > ${TMP}/helpServe.txt 2>&1
+cmpOsLog helpServe
+
+$CMD client      > ${TMP}/helpClient.txt 2>&1
+cmpOsLog helpClient
+
 $CMD compare   > ${TMP}/helpCompare.txt 2>&1
 cmpOsLog helpCompare
 
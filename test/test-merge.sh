@@ -0,0 +1,68 @@
+#!/bin/bash
+
+source config.sh
+
+# a three frames sequence of generated models and their distorted copies
+OUT=merge_data
+echo $OUT
+$CMD sequence --firstFrame 1 --lastFrame 3 END \
+	generate --type terrain --triangles 2000 --colors --noise 0.01 \
+	--outputModel ${TMP}/${OUT}_%1d.obj --distortedModel ${TMP}/${OUT}_dis_%1d.obj > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+
+COMPARE="compare --mode pcqm --inputModelA ${TMP}/${OUT}_%1d.obj --inputModelB ${TMP}/${OUT}_dis_%1d.obj"
+# the sequence statistics lines
+STATS="^PCQM(-PSNR)? [[:alnum:]]+="
+
+# reference single run
+OUT=merge_pcqm_single
+echo $OUT
+rm -f ${TMP}/${OUT}.ckp
+$CMD sequence --firstFrame 1 --lastFrame 3 END $COMPARE --checkpoint ${TMP}/${OUT}.ckp > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.ckp "^mmcheckpoint 1 pcqm" 1
+
+# two shards merged, same checkpoint and statistics as the single run
+OUT=merge_pcqm_shards
+echo $OUT
+rm -f ${TMP}/${OUT}_0.ckp ${TMP}/${OUT}_1.ckp
+for shard in 0 1; do
+	$CMD sequence --firstFrame 1 --lastFrame 3 --frameShard ${shard}/2 END $COMPARE \
+		--checkpoint ${TMP}/${OUT}_${shard}.ckp > ${TMP}/${OUT}_${shard}.txt 2>&1
+	grep -iF "error" ${TMP}/${OUT}_${shard}.txt
+done
+fileHasString ${TMP}/${OUT}_0.txt "Processing frame" 1
+fileHasString ${TMP}/${OUT}_1.txt "Processing frame" 2
+$CMD merge --inputCheckpoints "${TMP}/${OUT}_0.ckp ${TMP}/${OUT}_1.ckp" \
+	--outputCheckpoint ${TMP}/${OUT}.ckp > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Merged 3 frames of mode pcqm in \[1,3\]" 1
+cmp ${TMP}/merge_pcqm_single.ckp ${TMP}/${OUT}.ckp
+diff <(grep -E "${STATS}" ${TMP}/merge_pcqm_single.txt) <(grep -E "${STATS}" ${TMP}/${OUT}.txt)
+
+# resume of an interrupted run, the first frame is restored
+OUT=merge_pcqm_resume
+echo $OUT
+head -n 2 ${TMP}/merge_pcqm_single.ckp > ${TMP}/${OUT}.ckp
+$CMD sequence --firstFrame 1 --lastFrame 3 END $COMPARE --checkpoint ${TMP}/${OUT}.ckp > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Frame 1 restored from checkpoint" 1
+cmp ${TMP}/merge_pcqm_single.ckp ${TMP}/${OUT}.ckp
+diff <(grep -E "${STATS}" ${TMP}/merge_pcqm_single.txt) <(grep -E "${STATS}" ${TMP}/${OUT}.txt)
+
+# frame lists
+OUT=merge_frame_list
+echo $OUT
+$CMD sequence --firstFrame 1 --lastFrame 9 --frames 2,4-6,8 --frameShard 1/2 END \
+	analyse --inputModel ${TMP}/merge_data_1.obj > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Processing frame [568]$" 3
+
+# a range outside the sequence is rejected before it is expanded
+OUT=merge_frame_list_range
+echo $OUT
+$CMD sequence --firstFrame 1 --lastFrame 9 --frames 0-4000000000 END \
+	analyse --inputModel ${TMP}/merge_data_1.obj > ${TMP}/${OUT}.txt 2>&1
+fileHasString ${TMP}/${OUT}.txt "Error: invalid --frames" 1
+
+# EOF
@@ -26,6 +26,17 @@ do
 	grep -iF "error" ${TMP}/${OUT}.txt
 	fileHasString ${TMP}/${OUT}.txt "Render ${renderer}_raster" 1
 
+	# maps of the material file decoded concurrently, same image and maps logged in the material order
+	OUT=render_plane_multimap_mtl_threads_1K_${renderer}
+	echo $OUT
+	$CMD --threads 4 render --renderer ${renderer}_raster --width=1024 --height=1024 --inputModel ${DATA}/plane_multi_map.obj \
+		--outputImage ${TMP}/${OUT}.png --outputDepth ${TMP}/${OUT}-depth.png > ${TMP}/${OUT}.txt 2>&1
+	grep -iF "error" ${TMP}/${OUT}.txt
+	fileHasString ${TMP}/${OUT}.txt "Render ${renderer}_raster" 1
+	fileHasString ${TMP}/${OUT}.txt "^Time on decoding: " 2
+	cmp ${TMP}/render_plane_multimap_mtl_1K_${renderer}.png ${TMP}/${OUT}.png
+	diff <(grep "^Input map: " ${TMP}/render_plane_multimap_mtl_1K_${renderer}.txt) <(grep "^Input map: " ${TMP}/${OUT}.txt)
+
 	# use multimap override texture names from command line (and swap texture compared to previous test left image is placed on the right and vice versa)
 	OUT=render_plane_multimap_cli_1K_${renderer}
 	echo $OUT
@@ -62,6 +62,13 @@ $CMD sample -i ${DATA}/degenerate.obj -m "" -o ${TMP}/${OUT}.ply --mode grid --h
 grep -iF "error" ${TMP}/${OUT}.txt
 fileHasString ${TMP}/${OUT}.txt "Skipped 1 degenerate triangles" 1
 
+# out of core sampling by tiles, same point set as sample_grid_sphere_10 in a different order
+OUT=sample_grid_sphere_10_stream
+echo $OUT
+$CMD sample -i ${DATA}/sphere.obj -m ${DATA}/plane.png -o ${TMP}/${OUT}.ply --mode grid --hideProgress --gridSize 10 --streamTiles 2 > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+cmp ${TMP}/${OUT}.ply ${REFS}/${OUT}.ply
+
 # extended tests
 if [ "$1" == "ext" ]; 
 then
@@ -49,6 +49,22 @@ $CMD sample -i ${DATA}/sphere_qp8.obj -o ${TMP}/${OUT}.ply --mode prnd --hidePro
 grep -iF "error" ${TMP}/${OUT}.txt
 cmp ${TMP}/${OUT}.ply ${REFS}/${OUT}.ply
 
+# counter based pseudo random generator
+OUT=sample_prnd_sphere_50_seed
+echo $OUT
+$CMD sample -i ${DATA}/sphere_qp8.obj -o ${TMP}/${OUT}.ply --mode prnd --hideProgress --nbSamples=50 --seed=7 \
+	> ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+cmp ${TMP}/${OUT}.ply ${REFS}/${OUT}.ply
+
+# same output whatever the thread count
+OUT=sample_prnd_sphere_50_seed_threads
+echo $OUT
+$CMD --threads 4 sample -i ${DATA}/sphere_qp8.obj -o ${TMP}/${OUT}.ply --mode prnd --hideProgress --nbSamples=50 --seed=7 \
+	> ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+cmp ${TMP}/${OUT}.ply ${REFS}/sample_prnd_sphere_50_seed.ply
+
 OUT=sample_prnd_sphere_qp8_50
 echo $OUT
 $CMD sample -i ${DATA}/sphere.obj -o ${TMP}/${OUT}.ply --mode prnd --hideProgress --nbSamples=50 \
@@ -0,0 +1,62 @@
+#!/bin/bash
+
+source config.sh
+
+TEMPLATE=${TMP}/sample_template.bin
+# reset template file
+rm -f ${TEMPLATE}
+
+# first run samples the mesh and records the template
+OUT=sample_template_grid_plane_10_record
+echo $OUT
+$CMD sample -i ${DATA}/plane.obj -m ${DATA}/plane_10_10.png -o ${TMP}/${OUT}.ply --mode grid --hideProgress --gridSize 10 --template ${TEMPLATE} > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Saving template" 1
+fileHasString ${TMP}/${OUT}.txt "Generated 100 points" 1
+
+# second run with same connectivity is evaluated from the template
+OUT=sample_template_grid_plane_10_reuse
+echo $OUT
+$CMD sample -i ${DATA}/plane.obj -m ${DATA}/plane_10_10.png -o ${TMP}/${OUT}.ply --mode grid --hideProgress --gridSize 10 --template ${TEMPLATE} > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Sampling from template" 1
+fileHasString ${TMP}/${OUT}.txt "Generated 100 points" 1
+
+# connectivity change falls back to full sampling and rewrites the template
+OUT=sample_template_grid_sphere_10_fallback
+echo $OUT
+$CMD sample -i ${DATA}/sphere.obj -m ${DATA}/plane.png -o ${TMP}/${OUT}.ply --mode grid --hideProgress --gridSize 10 --template ${TEMPLATE} > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Template connectivity does not match the input model" 1
+fileHasString ${TMP}/${OUT}.txt "Saving template" 1
+
+# parameter change falls back to full sampling and rewrites the template
+OUT=sample_template_grid_sphere_20_parameters
+echo $OUT
+$CMD sample -i ${DATA}/sphere.obj -m ${DATA}/plane.png -o ${TMP}/${OUT}.ply --mode grid --hideProgress --gridSize 20 --template ${TEMPLATE} > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "do not match the command line" 1
+fileHasString ${TMP}/${OUT}.txt "Saving template" 1
+
+# sequence of three frames, template is kept in memory after first frame
+OUT=sample_template_sdiv_plane_sequence
+echo $OUT
+rm -f ${TEMPLATE}
+$CMD sequence --firstFrame 1 --lastFrame 3 END \
+	sample -i ${DATA}/plane.obj -m ${DATA}/plane_10_10.png -o ${TMP}/${OUT}_%1d.ply --mode sdiv --hideProgress --template ${TEMPLATE} > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Saving template" 1
+fileHasString ${TMP}/${OUT}.txt "Sampling from template" 2
+
+# point count larger than the file, the template is rejected before any allocation
+OUT=sample_template_grid_plane_10_bad_count
+echo $OUT
+rm -f ${TEMPLATE}
+$CMD sample -i ${DATA}/plane.obj -m ${DATA}/plane_10_10.png -o ${TMP}/${OUT}.ply --mode grid --hideProgress --gridSize 10 --template ${TEMPLATE} > /dev/null 2>&1
+# the point count follows magic, version, checksum, flags, parameters size and parameters
+PARAM_SIZE=$(od -An -tu4 -j22 -N4 ${TEMPLATE} | tr -d ' ')
+printf '\xff\xff\xff\xff\xff\xff\x00\x00' | dd of=${TEMPLATE} bs=1 seek=$((26 + PARAM_SIZE)) conv=notrunc status=none
+$CMD sample -i ${DATA}/plane.obj -m ${DATA}/plane_10_10.png -o ${TMP}/${OUT}.ply --mode grid --hideProgress --gridSize 10 --template ${TEMPLATE} > ${TMP}/${OUT}.txt 2>&1
+fileHasString ${TMP}/${OUT}.txt "Error: truncated template file" 1
+fileHasString ${TMP}/${OUT}.txt "Saving template" 1
+fileHasString ${TMP}/${OUT}.txt "Generated 100 points" 1
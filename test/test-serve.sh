@@ -0,0 +1,80 @@
+#!/bin/bash
+
+source config.sh
+
+SOCKET=${TMP}/mm.sock
+COMPARE="compare --mode pcc --inputModelA ${DATA}/sphere.obj --inputModelB ${DATA}/sphere_qp8.obj"
+
+# reference direct run
+OUT=serve_direct
+echo $OUT
+$CMD $COMPARE --outputCsv ${TMP}/${OUT}.csv > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+
+# start the server
+OUT=serve
+echo $OUT
+$CMD serve --socket ${SOCKET} --cacheSize 64 > ${TMP}/${OUT}.txt 2>&1 &
+for i in $(seq 50); do [ -S ${SOCKET} ] && break; sleep 0.1; done
+fileHasString ${TMP}/${OUT}.txt "Listening to ${SOCKET}" 1
+
+# same outputs as the direct run, the second request uses the file cache
+for run in 1 2; do
+	OUT=serve_client_${run}
+	echo $OUT
+	$CMD client --socket ${SOCKET} $COMPARE --outputCsv ${TMP}/${OUT}.csv > ${TMP}/${OUT}.txt 2>&1
+	echo "exit code $?" >> ${TMP}/${OUT}.txt
+	grep -iF "error" ${TMP}/${OUT}.txt
+	fileHasString ${TMP}/${OUT}.txt "exit code 0" 1
+	cmp ${TMP}/serve_direct.csv ${TMP}/${OUT}.csv
+	diff <(grep -F "PSNR" ${TMP}/serve_direct.txt) <(grep -F "PSNR" ${TMP}/${OUT}.txt)
+done
+
+# the exit code and the errors of a failed request are forwarded
+OUT=serve_client_error
+echo $OUT
+$CMD client --socket ${SOCKET} compare --mode pcc --inputModelA ${DATA}/missing.obj \
+	--inputModelB ${DATA}/sphere_qp8.obj > ${TMP}/${OUT}.txt 2>&1
+echo "exit code $?" >> ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "exit code 0" 0
+fileHasString ${TMP}/${OUT}.txt "open file .*missing.obj" 1
+
+# stop the server
+OUT=serve_shutdown
+echo $OUT
+$CMD client --socket ${SOCKET} --shutdown > ${TMP}/${OUT}.txt 2>&1
+wait
+fileHasString ${TMP}/serve.txt "Shutdown requested" 1
+fileHasString ${TMP}/serve.txt "^Request [0-9]" 3
+[ -S ${SOCKET} ] && echo "Error: socket ${SOCKET} not removed"
+
+# a socket path naming a regular file is kept and the server does not start
+OUT=serve_not_socket
+echo $OUT
+echo "keep" > ${TMP}/${OUT}.csv
+$CMD serve --socket ${TMP}/${OUT}.csv > ${TMP}/${OUT}.txt 2>&1
+echo "exit code $?" >> ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "exists and is not a socket" 1
+fileHasString ${TMP}/${OUT}.txt "exit code 1" 1
+fileHasString ${TMP}/${OUT}.csv "keep" 1
+
+# a client sending an incomplete request is disconnected after --timeout, the next request is served
+OUT=serve_timeout
+if command -v python3 > /dev/null; then
+	echo $OUT
+	$CMD serve --socket ${SOCKET} --timeout 1 > ${TMP}/${OUT}.txt 2>&1 &
+	SERVER=$!
+	for i in $(seq 50); do [ -S ${SOCKET} ] && break; sleep 0.1; done
+	python3 -c "import socket, time; s = socket.socket(socket.AF_UNIX); s.connect('${SOCKET}'); s.sendall(b'MMSV'); time.sleep(10)" &
+	STALLED=$!
+	sleep 0.5
+	$CMD client --socket ${SOCKET} --shutdown > ${TMP}/${OUT}_client.txt 2>&1
+	echo "exit code $?" >> ${TMP}/${OUT}_client.txt
+	kill ${STALLED}
+	wait ${SERVER}
+	fileHasString ${TMP}/${OUT}.txt "Error: invalid request" 1
+	fileHasString ${TMP}/${OUT}.txt "Shutdown requested" 1
+	fileHasString ${TMP}/${OUT}_client.txt "exit code 0" 1
+fi
+
+# EOF
@@ -0,0 +1,42 @@
+#!/bin/bash
+
+source config.sh
+
+CACHE=${TMP}/texture_cache
+rm -rf ${CACHE}
+
+# maps decoded then saved to the cache
+OUT=texture_cache_miss
+echo $OUT
+$CMD --textureCache ${CACHE} sample -i ${DATA}/plane_multi_map.obj -o ${TMP}/${OUT}.ply --mode grid --hideProgress \
+	--gridSize 64 > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Time on decoding" 2
+fileHasString ${TMP}/${OUT}.txt "Map restored from texture cache" 0
+ls ${CACHE}/*.tex | wc -l | grep -q "^2$" || echo "Error: 2 texture cache entries expected in ${CACHE}"
+
+# maps mapped from the cache, same samples
+OUT=texture_cache_hit
+echo $OUT
+$CMD --textureCache ${CACHE} sample -i ${DATA}/plane_multi_map.obj -o ${TMP}/${OUT}.ply --mode grid --hideProgress \
+	--gridSize 64 > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Time on decoding" 0
+fileHasString ${TMP}/${OUT}.txt "Map restored from texture cache" 2
+cmp ${TMP}/texture_cache_miss.ply ${TMP}/${OUT}.ply
+
+# a modified map is decoded again
+OUT=texture_cache_stale
+echo $OUT
+cp ${DATA}/plane.png ${TMP}/${OUT}.png
+$CMD --textureCache ${CACHE} sample -i ${DATA}/plane.obj -m ${TMP}/${OUT}.png -o ${TMP}/${OUT}_0.ply --mode grid \
+	--hideProgress --gridSize 10 > ${TMP}/${OUT}_0.txt 2>&1
+cp ${DATA}/plane_10_10.png ${TMP}/${OUT}.png
+$CMD --textureCache ${CACHE} sample -i ${DATA}/plane.obj -m ${TMP}/${OUT}.png -o ${TMP}/${OUT}.ply --mode grid \
+	--hideProgress --gridSize 10 > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Time on decoding" 1
+fileHasString ${TMP}/${OUT}.txt "Map restored from texture cache" 0
+$CMD sample -i ${DATA}/plane.obj -m ${DATA}/plane_10_10.png -o ${TMP}/${OUT}_ref.ply --mode grid --hideProgress \
+	--gridSize 10 > ${TMP}/${OUT}_ref.txt 2>&1
+cmp ${TMP}/${OUT}_ref.ply ${TMP}/${OUT}.ply
@@ -0,0 +1,28 @@
+#!/bin/bash
+
+source config.sh
+
+# sequence of models and renders written by the commands then by background writers
+for WRITERS in 0 2; do
+	OUT=writers_${WRITERS}
+	echo $OUT
+	$CMD --writers ${WRITERS} sequence --firstFrame 1 --lastFrame 3 END \
+		quantize --inputModel ${DATA}/basketball_player_0000000%1d.obj --qp 10 --outputModel ${TMP}/${OUT}_%1d.obj END \
+		render --inputModel ${DATA}/plane.obj --width 256 --height 256 --outputImage ${TMP}/${OUT}_%1d.png > ${TMP}/${OUT}.txt 2>&1
+	grep -iF "error" ${TMP}/${OUT}.txt
+	fileHasString ${TMP}/${OUT}.txt "Saving file" 3
+done
+
+# same files
+for FRAME in 1 2 3; do
+	cmp ${TMP}/writers_0_${FRAME}.obj ${TMP}/writers_2_${FRAME}.obj
+	cmp ${TMP}/writers_0_${FRAME}.png ${TMP}/writers_2_${FRAME}.png
+done
+
+# failed writes are reported by the exit code
+OUT=writers_error
+echo $OUT
+$CMD --writers 2 quantize --inputModel ${DATA}/plane.obj --qp 8 --outputModel ${TMP}/missing/${OUT}.obj > ${TMP}/${OUT}.txt 2>&1
+echo "exit code $?" >> ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "exit code 0" 0
+fileHasString ${TMP}/${OUT}.txt "There was 1 write errors" 1